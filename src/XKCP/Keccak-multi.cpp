@@ -0,0 +1,150 @@
+#include <immintrin.h>
+#include <cstring>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include "Keccak-multi.hpp"
+#include "Keccak-more-compact.hpp"
+#include "KeccakP-1600-rounds.hpp"
+
+using namespace std;
+
+#define KECCAK256_RATE 136 // Bytes absorbed per permutation
+#define KECCAK256_RATE_LANES 17
+
+// 4 interleaved states, one per 64-bit element of an AVX2 register
+class KeccakLanesAVX2
+{
+public:
+    typedef __m256i Word;
+    static constexpr uint64_t Width = 4;
+    static inline Word Xor (Word a, Word b) { return _mm256_xor_si256(a, b); }
+    static inline Word Xor5 (Word a, Word b, Word c, Word d, Word e) { return _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(c, d)), e); }
+    template <int n> static inline Word Rol (Word a) { return _mm256_or_si256(_mm256_slli_epi64(a, n), _mm256_srli_epi64(a, 64 - n)); }
+    static inline Word Chi (Word a, Word b, Word c) { return _mm256_xor_si256(a, _mm256_andnot_si256(b, c)); }
+    static inline Word Constant (uint64_t c) { return _mm256_set1_epi64x(c); }
+    static inline Word Load (const uint64_t *p) { return _mm256_loadu_si256((const __m256i *)p); }
+    static inline void Store (uint64_t *p, Word a) { _mm256_storeu_si256((__m256i *)p, a); }
+};
+
+#ifdef __AVX512__
+// 8 interleaved states, one per 64-bit element of an AVX-512 register; rotations and 3-input logic are single instructions
+class KeccakLanesAVX512
+{
+public:
+    typedef __m512i Word;
+    static constexpr uint64_t Width = 8;
+    static inline Word Xor (Word a, Word b) { return _mm512_xor_si512(a, b); }
+    static inline Word Xor5 (Word a, Word b, Word c, Word d, Word e) { return _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a, b, c, 0x96), d, e, 0x96); }
+    template <int n> static inline Word Rol (Word a) { return _mm512_rol_epi64(a, n); }
+    static inline Word Chi (Word a, Word b, Word c) { return _mm512_ternarylogic_epi64(a, b, c, 0xD2); }
+    static inline Word Constant (uint64_t c) { return _mm512_set1_epi64(c); }
+    static inline Word Load (const uint64_t *p) { return _mm512_loadu_si512((const void *)p); }
+    static inline void Store (uint64_t *p, Word a) { _mm512_storeu_si512((void *)p, a); }
+};
+typedef KeccakLanesAVX512 KeccakLanesMulti;
+#else
+typedef KeccakLanesAVX2 KeccakLanesMulti;
+#endif
+
+// Hashes up to L::Width messages, one per state, absorbing one block of every message per permutation
+template <typename L>
+static void keccak256Group (uint64_t count, const uint64_t * indices, const uint8_t * const * pInputs, const uint64_t * pInputSizes, uint8_t (* pOutputs)[32])
+{
+    typename L::Word A[25];
+    for (uint64_t i = 0; i < 25; i++)
+    {
+        A[i] = L::Constant(0);
+    }
+
+    // Every message needs one block per rate bytes, plus the one containing the padding
+    uint64_t nBlocks[L::Width];
+    uint64_t maxBlocks = 0;
+    for (uint64_t j = 0; j < L::Width; j++)
+    {
+        nBlocks[j] = (j < count) ? pInputSizes[indices[j]]/KECCAK256_RATE + 1 : 0;
+        maxBlocks = max(maxBlocks, nBlocks[j]);
+    }
+
+    uint64_t block[KECCAK256_RATE_LANES][L::Width];
+    uint64_t digest[4][L::Width];
+    uint8_t lastBlock[KECCAK256_RATE];
+    for (uint64_t b = 0; b < maxBlocks; b++)
+    {
+        // Transpose the current block of every message into the lanes, padding the last one
+        bool bLastBlock = false;
+        for (uint64_t j = 0; j < L::Width; j++)
+        {
+            if (b >= nBlocks[j])
+            {
+                for (uint64_t i = 0; i < KECCAK256_RATE_LANES; i++)
+                {
+                    block[i][j] = 0;
+                }
+                continue;
+            }
+            const uint8_t *pBlock = pInputs[indices[j]] + b*KECCAK256_RATE;
+            if (b == nBlocks[j] - 1)
+            {
+                uint64_t rest = pInputSizes[indices[j]] - b*KECCAK256_RATE;
+                memset(lastBlock, 0, KECCAK256_RATE);
+                memcpy(lastBlock, pBlock, rest);
+                lastBlock[rest] ^= 0x01;
+                lastBlock[KECCAK256_RATE - 1] ^= 0x80;
+                pBlock = lastBlock;
+                bLastBlock = true;
+            }
+            for (uint64_t i = 0; i < KECCAK256_RATE_LANES; i++)
+            {
+                memcpy(&block[i][j], pBlock + 8*i, 8);
+            }
+        }
+
+        for (uint64_t i = 0; i < KECCAK256_RATE_LANES; i++)
+        {
+            A[i] = L::Xor(A[i], L::Load(block[i]));
+        }
+        KeccakP1600Rounds<L>(A);
+
+        // Copy the digests of the messages that have been completely absorbed
+        if (bLastBlock)
+        {
+            for (uint64_t i = 0; i < 4; i++)
+            {
+                L::Store(digest[i], A[i]);
+            }
+            for (uint64_t j = 0; j < count; j++)
+            {
+                if (b == nBlocks[j] - 1)
+                {
+                    for (uint64_t i = 0; i < 4; i++)
+                    {
+                        memcpy(pOutputs[indices[j]] + 8*i, &digest[i][j], 8);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void Keccak256Multi (uint64_t n, const uint8_t * const * pInputs, const uint64_t * pInputSizes, uint8_t (* pOutputs)[32])
+{
+    // Sort the messages by number of blocks, so that the ones hashed together need a similar number of permutations
+    vector<uint64_t> indices(n);
+    iota(indices.begin(), indices.end(), 0);
+    stable_sort(indices.begin(), indices.end(), [pInputSizes](uint64_t a, uint64_t b) { return pInputSizes[a]/KECCAK256_RATE < pInputSizes[b]/KECCAK256_RATE; });
+
+    uint64_t i = 0;
+    while (n - i > 1)
+    {
+        uint64_t count = min<uint64_t>(KeccakLanesMulti::Width, n - i);
+        keccak256Group<KeccakLanesMulti>(count, &indices[i], pInputs, pInputSizes, pOutputs);
+        i += count;
+    }
+
+    // A single message is faster with the 64-bit implementation
+    if (i < n)
+    {
+        Keccak(1088, 512, pInputs[indices[i]], pInputSizes[indices[i]], 0x1, pOutputs[indices[i]], 32);
+    }
+}
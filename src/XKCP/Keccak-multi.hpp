@@ -0,0 +1,17 @@
+#ifndef KECCAK_MULTI_HPP
+#define KECCAK_MULTI_HPP
+
+#include <cstdint>
+
+// Number of messages hashed in parallel by the multi-buffer Keccak, one per SIMD 64-bit element
+#ifdef __AVX512__
+#define KECCAK_MULTI_WIDTH 8
+#else
+#define KECCAK_MULTI_WIDTH 4
+#endif
+
+// Computes the Keccak-256 digests (Ethereum padding) of n independent messages, hashing KECCAK_MULTI_WIDTH of them
+// at a time with AVX2 (4) or AVX-512 (8) registers; messages are grouped by similar length to keep the lanes busy
+void Keccak256Multi (uint64_t n, const uint8_t * const * pInputs, const uint64_t * pInputSizes, uint8_t (* pOutputs)[32]);
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef KECCAK_P_1600_ROUNDS_HPP
+#define KECCAK_P_1600_ROUNDS_HPP
+
+#include <cstdint>
+
+// Keccak-f[1600] round constants
+static const uint64_t KeccakF1600RoundConstants[24] =
+{
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+// Keccak-f[1600] permutation with every round unrolled, generic on the lane type, so that the same code permutes one
+// state with 64-bit integers or several interleaved states with SIMD registers (one state per SIMD element).
+// L must provide the Word type and the Xor, Xor5, Rol<n>, Chi (a ^ (~b & c)) and Constant operations.
+template <typename L>
+inline void KeccakP1600Rounds (typename L::Word (&A)[25])
+{
+    typename L::Word C0, C1, C2, C3, C4, D0, D1, D2, D3, D4;
+    typename L::Word B0, B1, B2, B3, B4, B5, B6, B7, B8, B9, B10, B11, B12, B13, B14, B15, B16, B17, B18, B19, B20, B21, B22, B23, B24;
+    for (uint64_t round = 0; round < 24; round++)
+    {
+        C0 = L::Xor5(A[0], A[5], A[10], A[15], A[20]);
+        C1 = L::Xor5(A[1], A[6], A[11], A[16], A[21]);
+        C2 = L::Xor5(A[2], A[7], A[12], A[17], A[22]);
+        C3 = L::Xor5(A[3], A[8], A[13], A[18], A[23]);
+        C4 = L::Xor5(A[4], A[9], A[14], A[19], A[24]);
+        D0 = L::Xor(C4, L::template Rol<1>(C1));
+        D1 = L::Xor(C0, L::template Rol<1>(C2));
+        D2 = L::Xor(C1, L::template Rol<1>(C3));
+        D3 = L::Xor(C2, L::template Rol<1>(C4));
+        D4 = L::Xor(C3, L::template Rol<1>(C0));
+        B0 = L::Xor(A[0], D0);
+        B1 = L::template Rol<44>(L::Xor(A[6], D1));
+        B2 = L::template Rol<43>(L::Xor(A[12], D2));
+        B3 = L::template Rol<21>(L::Xor(A[18], D3));
+        B4 = L::template Rol<14>(L::Xor(A[24], D4));
+        B5 = L::template Rol<28>(L::Xor(A[3], D3));
+        B6 = L::template Rol<20>(L::Xor(A[9], D4));
+        B7 = L::template Rol<3>(L::Xor(A[10], D0));
+        B8 = L::template Rol<45>(L::Xor(A[16], D1));
+        B9 = L::template Rol<61>(L::Xor(A[22], D2));
+        B10 = L::template Rol<1>(L::Xor(A[1], D1));
+        B11 = L::template Rol<6>(L::Xor(A[7], D2));
+        B12 = L::template Rol<25>(L::Xor(A[13], D3));
+        B13 = L::template Rol<8>(L::Xor(A[19], D4));
+        B14 = L::template Rol<18>(L::Xor(A[20], D0));
+        B15 = L::template Rol<27>(L::Xor(A[4], D4));
+        B16 = L::template Rol<36>(L::Xor(A[5], D0));
+        B17 = L::template Rol<10>(L::Xor(A[11], D1));
+        B18 = L::template Rol<15>(L::Xor(A[17], D2));
+        B19 = L::template Rol<56>(L::Xor(A[23], D3));
+        B20 = L::template Rol<62>(L::Xor(A[2], D2));
+        B21 = L::template Rol<55>(L::Xor(A[8], D3));
+        B22 = L::template Rol<39>(L::Xor(A[14], D4));
+        B23 = L::template Rol<41>(L::Xor(A[15], D0));
+        B24 = L::template Rol<2>(L::Xor(A[21], D1));
+        A[0] = L::Chi(B0, B1, B2);
+        A[1] = L::Chi(B1, B2, B3);
+        A[2] = L::Chi(B2, B3, B4);
+        A[3] = L::Chi(B3, B4, B0);
+        A[4] = L::Chi(B4, B0, B1);
+        A[5] = L::Chi(B5, B6, B7);
+        A[6] = L::Chi(B6, B7, B8);
+        A[7] = L::Chi(B7, B8, B9);
+        A[8] = L::Chi(B8, B9, B5);
+        A[9] = L::Chi(B9, B5, B6);
+        A[10] = L::Chi(B10, B11, B12);
+        A[11] = L::Chi(B11, B12, B13);
+        A[12] = L::Chi(B12, B13, B14);
+        A[13] = L::Chi(B13, B14, B10);
+        A[14] = L::Chi(B14, B10, B11);
+        A[15] = L::Chi(B15, B16, B17);
+        A[16] = L::Chi(B16, B17, B18);
+        A[17] = L::Chi(B17, B18, B19);
+        A[18] = L::Chi(B18, B19, B15);
+        A[19] = L::Chi(B19, B15, B16);
+        A[20] = L::Chi(B20, B21, B22);
+        A[21] = L::Chi(B21, B22, B23);
+        A[22] = L::Chi(B22, B23, B24);
+        A[23] = L::Chi(B23, B24, B20);
+        A[24] = L::Chi(B24, B20, B21);
+        A[0] = L::Xor(A[0], L::Constant(KeccakF1600RoundConstants[round]));
+    }
+}
+
+#endif
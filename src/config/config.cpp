@@ -123,6 +123,7 @@ void Config::load(json &config)
     ParseBool(config, "runAggregatorServer", "RUN_AGGREGATOR_SERVER", runAggregatorServer, false);
     ParseBool(config, "runAggregatorClient", "RUN_AGGREGATOR_CLIENT", runAggregatorClient, false);
     ParseBool(config, "runAggregatorClientMock", "RUN_AGGREGATOR_CLIENT_MOCK", runAggregatorClientMock, false);
+    ParseBool(config, "runMetricsServer", "RUN_METRICS_SERVER", runMetricsServer, false);
 
     // Run file
     ParseBool(config, "runFileGenBatchProof", "RUN_FILE_GEN_BATCH_PROOF", runFileGenBatchProof, false);
@@ -130,16 +131,22 @@ void Config::load(json &config)
     ParseBool(config, "runFileGenFinalProof", "RUN_FILE_GEN_FINAL_PROOF", runFileGenFinalProof, false);
     ParseBool(config, "runFileProcessBatch", "RUN_FILE_PROCESS_BATCH", runFileProcessBatch, false);
     ParseBool(config, "runFileProcessBatchMultithread", "RUN_FILE_PROCESS_BATCH_MULTITHREAD", runFileProcessBatchMultithread, false);
+    ParseBool(config, "runBatchReplay", "RUN_BATCH_REPLAY", runBatchReplay, false);
+    ParseU64(config, "batchReplayThreads", "BATCH_REPLAY_THREADS", batchReplayThreads, 8);
+    ParseU64(config, "batchReplayRounds", "BATCH_REPLAY_ROUNDS", batchReplayRounds, 2);
     ParseBool(config, "runFileExecute", "RUN_FILE_EXECUTE", runFileExecute, false);
 
     // Tests
     ParseBool(config, "runKeccakScriptGenerator", "RUN_KECCAK_SCRIPT_GENERATOR", runKeccakScriptGenerator, false);
     ParseBool(config, "runSHA256ScriptGenerator", "RUN_SHA256_SCRIPT_GENERATOR", runSHA256ScriptGenerator, false);
+    ParseBool(config, "runWitnessDBConverter", "RUN_WITNESS_DB_CONVERTER", runWitnessDBConverter, false);
     ParseBool(config, "runKeccakTest", "RUN_KECCAK_TEST", runKeccakTest, false);
     ParseBool(config, "runStorageSMTest", "RUN_STORAGE_SM_TEST", runStorageSMTest, false);
     ParseBool(config, "runClimbKeySMTest", "RUN_CLIMBKEY_SM_TEST", runClimbKeySMTest, false);
     ParseBool(config, "runBinarySMTest", "RUN_BINARY_SM_TEST", runBinarySMTest, false);
     ParseBool(config, "runMemAlignSMTest", "RUN_MEM_ALIGN_SM_TEST", runMemAlignSMTest, false);
+    ParseBool(config, "runMemorySMTest", "RUN_MEMORY_SM_TEST", runMemorySMTest, false);
+    ParseBool(config, "runPoseidonGSMTest", "RUN_POSEIDONG_SM_TEST", runPoseidonGSMTest, false);
     ParseBool(config, "runSHA256Test", "RUN_SHA256_TEST", runSHA256Test, false);
     ParseBool(config, "runBlakeTest", "RUN_BLAKE_TEST", runBlakeTest, false);
     ParseBool(config, "runECRecoverTest", "RUN_ECRECOVER_TEST", runECRecoverTest, false);
@@ -150,6 +157,12 @@ void Config::load(json &config)
     ParseBool(config, "runPageManagerTest", "RUN_PAGE_MANAGER_TEST", runPageManagerTest, false);
     ParseBool(config, "runKeyValueTreeTest", "RUN_KEY_VALUE_TREE_TEST", runKeyValueTreeTest, false);
     ParseBool(config, "runSMT64Test", "RUN_SMT64_TEST", runSMT64Test, false);
+    ParseBool(config, "runMerkleTreeBN128PerformanceTest", "RUN_MERKLE_TREE_BN128_PERFORMANCE_TEST", runMerkleTreeBN128PerformanceTest, false);
+    ParseBool(config, "runMultiexpFixedBasesPerformanceTest", "RUN_MULTIEXP_FIXED_BASES_PERFORMANCE_TEST", runMultiexpFixedBasesPerformanceTest, false);
+    ParseBool(config, "runMultiexpBatchAffinePerformanceTest", "RUN_MULTIEXP_BATCH_AFFINE_PERFORMANCE_TEST", runMultiexpBatchAffinePerformanceTest, false);
+    ParseBool(config, "runFullTraceDeltaPerformanceTest", "RUN_FULL_TRACE_DELTA_PERFORMANCE_TEST", runFullTraceDeltaPerformanceTest, false);
+    ParseBool(config, "runDataStreamPerformanceTest", "RUN_DATA_STREAM_PERFORMANCE_TEST", runDataStreamPerformanceTest, false);
+    ParseBool(config, "runWitnessDBPerformanceTest", "RUN_WITNESS_DB_PERFORMANCE_TEST", runWitnessDBPerformanceTest, false);
     ParseBool(config, "runUnitTest", "RUN_UNIT_TEST", runUnitTest, false);
 
     // Main SM executor
@@ -191,12 +204,17 @@ void Config::load(json &config)
 
     // Server and client ports, hosts, etc.
     ParseU16(config, "executorServerPort", "EXECUTOR_SERVER_PORT", executorServerPort, 50071);
+    ParseBool(config, "executorServerAsync", "EXECUTOR_SERVER_ASYNC", executorServerAsync, false);
+    ParseU64(config, "executorServerIOThreads", "EXECUTOR_SERVER_IO_THREADS", executorServerIOThreads, 2);
+    ParseU64(config, "executorServerQueueSize", "EXECUTOR_SERVER_QUEUE_SIZE", executorServerQueueSize, 64);
+    ParseU64(config, "executorServerQueueAgingTime", "EXECUTOR_SERVER_QUEUE_AGING_TIME", executorServerQueueAgingTime, 2000);
     ParseU16(config, "executorClientPort", "EXECUTOR_CLIENT_PORT", executorClientPort, 50071);
     ParseString(config, "executorClientHost", "EXECUTOR_CLIENT_HOST", executorClientHost, "127.0.0.1");
     ParseU64(config, "executorClientLoops", "EXECUTOR_CLIENT_LOOPS", executorClientLoops, 1);
     ParseBool(config, "executorClientCheckNewStateRoot", "EXECUTOR_CLIENT_CHECK_NEW_STATE_ROOT", executorClientCheckNewStateRoot, false);
     ParseBool(config, "executorClientResetDB", "EXECUTOR_CLIENT_RESET_DB", executorClientResetDB, false);
     ParseU16(config, "hashDBServerPort", "HASHDB_SERVER_PORT", hashDBServerPort, 50061);
+    ParseU16(config, "metricsServerPort", "METRICS_SERVER_PORT", metricsServerPort, 9091);
     ParseString(config, "hashDBURL", "HASHDB_URL", hashDBURL, "local");
     //ParseBool(config, "hashDB64", "HASHDB64", hashDB64, false);
     hashDB64 = false; // Do not use in production; under development
@@ -216,6 +234,8 @@ void Config::load(json &config)
     // Logs
     ParseBool(config, "executorROMLineTraces", "EXECUTOR_ROM_LINE_TRACES", executorROMLineTraces, false);
     ParseBool(config, "executorTimeStatistics", "EXECUTOR_TIME_STATISTICS", executorTimeStatistics, false);
+    ParseBool(config, "executorROMProfile", "EXECUTOR_ROM_PROFILE", executorROMProfile, false);
+    ParseU64(config, "executorROMProfileSaveInterval", "EXECUTOR_ROM_PROFILE_SAVE_INTERVAL", executorROMProfileSaveInterval, 60);
     ParseBool(config, "opcodeTracer", "OPCODE_TRACER", opcodeTracer, false);
     ParseBool(config, "logRemoteDbReads", "LOG_REMOTE_DB_READS", logRemoteDbReads, false);
     ParseBool(config, "logExecutorServerInput", "LOG_EXECUTOR_SERVER_INPUT", logExecutorServerInput, false);
@@ -299,6 +319,10 @@ void Config::load(json &config)
     // Threads
     ParseU64(config, "cleanerPollingPeriod", "CLEANER_POLLING_PERIOD", cleanerPollingPeriod, 600);
     ParseU64(config, "requestsPersistence", "REQUESTS_PERSISTENCE", requestsPersistence, 3600);
+    ParseBool(config, "proverPipeline", "PROVER_PIPELINE", proverPipeline, false);
+    ParseU64(config, "proverPipelineBuffers", "PROVER_PIPELINE_BUFFERS", proverPipelineBuffers, 1);
+    ParseU64(config, "multiexpFixedBasesMemory", "MULTIEXP_FIXED_BASES_MEMORY", multiexpFixedBasesMemory, 0);
+    ParseBool(config, "fflonkZkeyInPlace", "FFLONK_ZKEY_IN_PLACE", fflonkZkeyInPlace, false);
     ParseU64(config, "maxExecutorThreads", "MAX_EXECUTOR_THREADS", maxExecutorThreads, 20);
     ParseU64(config, "maxProverThreads", "MAX_PROVER_THREADS", maxProverThreads, 8);
     ParseU64(config, "maxHashDBThreads", "MAX_HASHDB_THREADS", maxHashDBThreads, 8);
@@ -308,11 +332,17 @@ void Config::load(json &config)
 
     // Memory allocation
     ParseU64(config, "fullTracerTraceReserveSize", "FULL_TRACER_TRACE_RESERVE_SIZE", fullTracerTraceReserveSize, 256*1024);
+    ParseBool(config, "fullTracerDeltaTrace", "FULL_TRACER_DELTA_TRACE", fullTracerDeltaTrace, false);
 
     // ECRecover
-    //ParseBool(config, "ECRecoverPrecalc", "ECRECOVER_PRECALC", ECRecoverPrecalc, false);
-    ECRecoverPrecalc = false; // Do not use in production; under development
+    ParseBool(config, "ECRecoverPrecalc", "ECRECOVER_PRECALC", ECRecoverPrecalc, false); // Under development; not for production
     ParseU64(config, "ECRecoverPrecalcNThreads", "ECRECOVER_PRECALC_N_THREADS", ECRecoverPrecalcNThreads, 16);
+    ParseBool(config, "ECRecoverBatchPrecalc", "ECRECOVER_BATCH_PRECALC", ECRecoverBatchPrecalc, true);
+    ParseBool(config, "batchExecutionCache", "BATCH_EXECUTION_CACHE", batchExecutionCache, false);
+    ParseU64(config, "batchExecutionCacheSize", "BATCH_EXECUTION_CACHE_SIZE", batchExecutionCacheSize, 16);
+    ParseU64(config, "bytecodeHashCacheSize", "BYTECODE_HASH_CACHE_SIZE", bytecodeHashCacheSize, 64);
+    ParseU64(config, "bytecodeHashNThreads", "BYTECODE_HASH_N_THREADS", bytecodeHashNThreads, 16);
+    ParseBool(config, "witnessDB", "WITNESS_DB", witnessDB, false);
 
     // Logs
     ParseBool(config, "jsonLogs", "JSON_LOGS", jsonLogs, false);
@@ -338,6 +368,7 @@ void Config::print(void)
     zklog.info("    runAggregatorClient=" + to_string(runAggregatorClient));
     if (runAggregatorClientMock)
         zklog.info("    runAggregatorClientMock=true");
+    zklog.info("    runMetricsServer=" + to_string(runMetricsServer));
     if (runFileGenBatchProof)
         zklog.info("    runFileGenBatchProof=true");
     if (runFileGenAggregatedProof)
@@ -348,6 +379,12 @@ void Config::print(void)
         zklog.info("    runFileProcessBatch=true");
     if (runFileProcessBatchMultithread)
         zklog.info("    runFileProcessBatchMultithread=true");
+    if (runBatchReplay)
+    {
+        zklog.info("    runBatchReplay=true");
+        zklog.info("    batchReplayThreads=" + to_string(batchReplayThreads));
+        zklog.info("    batchReplayRounds=" + to_string(batchReplayRounds));
+    }
     if (runFileExecute)
         zklog.info("    runFileExecute=true");
 
@@ -355,6 +392,8 @@ void Config::print(void)
         zklog.info("    runKeccakScriptGenerator=true");
     if (runSHA256ScriptGenerator)
         zklog.info("    runSHA256ScriptGenerator=true");
+    if (runWitnessDBConverter)
+        zklog.info("    runWitnessDBConverter=true");
     if (runKeccakTest)
         zklog.info("    runKeccakTest=true");
     if (runStorageSMTest)
@@ -365,6 +404,10 @@ void Config::print(void)
         zklog.info("    runBinarySMTest=true");
     if (runMemAlignSMTest)
         zklog.info("    runMemAlignSMTest=true");
+    if (runMemorySMTest)
+        zklog.info("    runMemorySMTest=true");
+    if (runPoseidonGSMTest)
+        zklog.info("    runPoseidonGSMTest=true");
     if (runSHA256Test)
         zklog.info("    runSHA256Test=true");
     if (runBlakeTest)
@@ -386,6 +429,18 @@ void Config::print(void)
         zklog.info("    runKeyValueTreeTest=true");
     if (runSMT64Test)
         zklog.info("    runSMT64Test=true");
+    if (runMerkleTreeBN128PerformanceTest)
+        zklog.info("    runMerkleTreeBN128PerformanceTest=true");
+    if (runMultiexpFixedBasesPerformanceTest)
+        zklog.info("    runMultiexpFixedBasesPerformanceTest=true");
+    if (runMultiexpBatchAffinePerformanceTest)
+        zklog.info("    runMultiexpBatchAffinePerformanceTest=true");
+    if (runFullTraceDeltaPerformanceTest)
+        zklog.info("    runFullTraceDeltaPerformanceTest=true");
+    if (runDataStreamPerformanceTest)
+        zklog.info("    runDataStreamPerformanceTest=true");
+    if (runWitnessDBPerformanceTest)
+        zklog.info("    runWitnessDBPerformanceTest=true");
     if (runUnitTest)
         zklog.info("    runUnitTest=true");
 
@@ -396,6 +451,12 @@ void Config::print(void)
     if (executorROMLineTraces)
         zklog.info("    executorROMLineTraces=true");
 
+    if (executorROMProfile)
+    {
+        zklog.info("    executorROMProfile=true");
+        zklog.info("    executorROMProfileSaveInterval=" + to_string(executorROMProfileSaveInterval));
+    }
+
     zklog.info("    executorTimeStatistics=" + to_string(executorTimeStatistics));
 
     if (saveRequestToFile)
@@ -435,12 +496,17 @@ void Config::print(void)
         zklog.info("    dontLoadRomOffsets=true");
 
     zklog.info("    executorServerPort=" + to_string(executorServerPort));
+    zklog.info("    executorServerAsync=" + to_string(executorServerAsync));
+    zklog.info("    executorServerIOThreads=" + to_string(executorServerIOThreads));
+    zklog.info("    executorServerQueueSize=" + to_string(executorServerQueueSize));
+    zklog.info("    executorServerQueueAgingTime=" + to_string(executorServerQueueAgingTime));
     zklog.info("    executorClientPort=" + to_string(executorClientPort));
     zklog.info("    executorClientHost=" + executorClientHost);
     zklog.info("    executorClientLoops=" + to_string(executorClientLoops));
     zklog.info("    executorClientCheckNewStateRoot=" + to_string(executorClientCheckNewStateRoot));
     zklog.info("    executorClientResetDB=" + to_string(executorClientResetDB));
     zklog.info("    hashDBServerPort=" + to_string(hashDBServerPort));
+    zklog.info("    metricsServerPort=" + to_string(metricsServerPort));
     zklog.info("    hashDBURL=" + hashDBURL);
     zklog.info("    hashDB64=" + to_string(hashDB64));
     zklog.info("    kvDBMaxVersions=" + to_string(kvDBMaxVersions));
@@ -508,6 +574,11 @@ void Config::print(void)
     zklog.info("    stateManagerPurge=" + to_string(stateManagerPurge));
     zklog.info("    cleanerPollingPeriod=" + to_string(cleanerPollingPeriod));
     zklog.info("    requestsPersistence=" + to_string(requestsPersistence));
+    zklog.info("    proverPipeline=" + to_string(proverPipeline));
+    zklog.info("    proverPipelineBuffers=" + to_string(proverPipelineBuffers));
+    zklog.info("    multiexpFixedBasesMemory=" + to_string(multiexpFixedBasesMemory));
+    if (fflonkZkeyInPlace)
+        zklog.info("    fflonkZkeyInPlace=true");
     zklog.info("    maxExecutorThreads=" + to_string(maxExecutorThreads));
     zklog.info("    maxProverThreads=" + to_string(maxProverThreads));
     zklog.info("    maxHashDBThreads=" + to_string(maxHashDBThreads));
@@ -522,8 +593,15 @@ void Config::print(void)
     zklog.info("    dbProgramCacheSize=" + to_string(dbProgramCacheSize));
     zklog.info("    loadDBToMemTimeout=" + to_string(loadDBToMemTimeout));
     zklog.info("    fullTracerTraceReserveSize=" + to_string(fullTracerTraceReserveSize));
+    zklog.info("    fullTracerDeltaTrace=" + to_string(fullTracerDeltaTrace));
     zklog.info("    ECRecoverPrecalc=" + to_string(ECRecoverPrecalc));
     zklog.info("    ECRecoverPrecalcNThreads=" + to_string(ECRecoverPrecalcNThreads));
+    zklog.info("    ECRecoverBatchPrecalc=" + to_string(ECRecoverBatchPrecalc));
+    zklog.info("    batchExecutionCache=" + to_string(batchExecutionCache));
+    zklog.info("    batchExecutionCacheSize=" + to_string(batchExecutionCacheSize));
+    zklog.info("    bytecodeHashCacheSize=" + to_string(bytecodeHashCacheSize));
+    zklog.info("    bytecodeHashNThreads=" + to_string(bytecodeHashNThreads));
+    zklog.info("    witnessDB=" + to_string(witnessDB));
 }
 
 bool Config::check (void)
@@ -696,5 +774,11 @@ bool Config::check (void)
         bError = true;
     }
 
+    if (proverPipeline && (proverPipelineBuffers == 0))
+    {
+        zklog.error("proverPipeline=true but proverPipelineBuffers=0");
+        bError = true;
+    }
+
     return bError;
 }
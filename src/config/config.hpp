@@ -22,21 +22,28 @@ public:
     bool runAggregatorServer;
     bool runAggregatorClient;
     bool runAggregatorClientMock;
+    bool runMetricsServer;
 
     bool runFileGenBatchProof;              // Proof of 1 batch = Executor + Stark + StarkC12a + Recursive1
     bool runFileGenAggregatedProof;         // Proof of 2 batches = Recursive2 (of the 2 batches StarkC12a)
     bool runFileGenFinalProof;              // Final proof of an aggregated proof = RecursiveF + Groth16 (Snark)
     bool runFileProcessBatch;               // Executor (only main SM)
     bool runFileProcessBatchMultithread;    // Executor (only main SM) in parallel
+    bool runBatchReplay;                    // Executor (only main SM) of a folder of batches in parallel, with throughput report
+    uint64_t batchReplayThreads;
+    uint64_t batchReplayRounds;
     bool runFileExecute;                    // Executor (all SMs)
 
     bool runKeccakScriptGenerator;
     bool runSHA256ScriptGenerator;
+    bool runWitnessDBConverter;
     bool runKeccakTest;
     bool runStorageSMTest;
     bool runClimbKeySMTest;
     bool runBinarySMTest;
     bool runMemAlignSMTest;
+    bool runMemorySMTest;
+    bool runPoseidonGSMTest;
     bool runSHA256Test;
     bool runBlakeTest;
     bool runECRecoverTest;
@@ -47,6 +54,12 @@ public:
     bool runPageManagerTest;
     bool runKeyValueTreeTest;
     bool runSMT64Test;
+    bool runMerkleTreeBN128PerformanceTest;
+    bool runMultiexpFixedBasesPerformanceTest;
+    bool runMultiexpBatchAffinePerformanceTest;
+    bool runFullTraceDeltaPerformanceTest;
+    bool runDataStreamPerformanceTest;
+    bool runWitnessDBPerformanceTest;
     bool runUnitTest;
 
     bool executeInParallel;
@@ -77,6 +90,10 @@ public:
 
     // Executor service
     uint16_t executorServerPort;
+    bool executorServerAsync;
+    uint64_t executorServerIOThreads;
+    uint64_t executorServerQueueSize;
+    uint64_t executorServerQueueAgingTime;
     uint16_t executorClientPort;
     string executorClientHost;
     uint64_t executorClientLoops;
@@ -102,9 +119,14 @@ public:
     uint64_t aggregatorClientMaxStreams; // Max number of streams, used to limit E2E test execution; if 0 then there is no limit
     uint64_t aggregatorClientMaxRecvMsgSize; // Max received message size, in bytes
 
+    // Metrics service
+    uint16_t metricsServerPort;
+
     // Executor debugging
     bool executorROMLineTraces;
     bool executorTimeStatistics;
+    bool executorROMProfile;
+    uint64_t executorROMProfileSaveInterval;
     bool opcodeTracer;
     bool logRemoteDbReads;
     bool logExecutorServerInput; // Logs all inputs, before processing
@@ -188,15 +210,28 @@ public:
     // Infrastructure
     uint64_t cleanerPollingPeriod;
     uint64_t requestsPersistence;
+    bool proverPipeline;
+    uint64_t proverPipelineBuffers;
+    uint64_t multiexpFixedBasesMemory; // MB; 0 disables it
+    bool fflonkZkeyInPlace; // Requires the zkey file data to be kept loaded while the prover is alive
     uint64_t maxExecutorThreads;
     uint64_t maxProverThreads;
     uint64_t maxHashDBThreads;
     string proverName;
     uint64_t fullTracerTraceReserveSize;
+    bool fullTracerDeltaTrace;
 
     // EC Recover
     bool ECRecoverPrecalc;
     uint64_t ECRecoverPrecalcNThreads;
+    bool ECRecoverBatchPrecalc;
+
+    // Batch execution cache
+    bool batchExecutionCache;
+    uint64_t batchExecutionCacheSize;
+    uint64_t bytecodeHashCacheSize;
+    uint64_t bytecodeHashNThreads;
+    bool witnessDB;
 
     // Logs format
     bool jsonLogs;
@@ -66,6 +66,7 @@
 /* Prover defines */
 //#define PROVER_USE_PROOF_GOOD_JSON
 //#define PROVER_INJECT_ZKIN_JSON
+//#define LOG_FFLONK_MEMORY_USAGE // If defined, the fflonk prover logs the resident memory and its peak growth after every round
 
 /* Hash DB*/
 //#define HASHDB_LOCK // If defined, the HashDB class will use a lock in all its methods, i.e. they will be serialized
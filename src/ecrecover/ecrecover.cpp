@@ -1498,15 +1498,46 @@ int mulPointEcJacobian1bitSave(const mpz_class &p1_x, const mpz_class &p1_y, con
     mpz_clear(rawK1);
     mpz_clear(rawK2);
 
-     // save results
-     if(nthreads < 1) nthreads = 1;
+    // save results, converting the points to affine with a Montgomery batch inversion of their z per thread,
+    // so that each thread computes a single field inversion instead of one per point
+    if(nthreads < 1) nthreads = 1;
+    if(nthreads > npoint) nthreads = (npoint > 0) ? npoint : 1;
+    RawFec::Element zProducts[512];
 #pragma omp parallel for num_threads(nthreads)
-    for (int i = 0; i < npoint; i++)
+    for (int t = 0; t < nthreads; t++)
     {
-        int id1 = 3*i;
-        int id2 = 2*(i+npoint_p11);
-        assert(fec.eq(buffer_[id1 + 2], fec.zero()) == 0);
-        Jacobian2Affine(buffer_[id1 ], buffer_[id1 + 1], buffer_[id1 + 2], buffer[id2 ], buffer[id2 + 1]);
+        int first = (npoint * t) / nthreads;
+        int last = (npoint * (t + 1)) / nthreads;
+        if (first == last) continue;
+
+        // zProducts[i] = z[first] * ... * z[i]
+        for (int i = first; i < last; i++)
+        {
+            assert(fec.eq(buffer_[3*i + 2], fec.zero()) == 0);
+            if (i == first) zProducts[i] = buffer_[3*i + 2];
+            else fec.mul(zProducts[i], zProducts[i - 1], buffer_[3*i + 2]);
+        }
+
+        // inv = 1/(z[first] * ... * z[i]), walking backwards
+        RawFec::Element inv, z_inv, z_inv_sq, z_inv_cube;
+        fec.inv(inv, zProducts[last - 1]);
+        for (int i = last - 1; i >= first; i--)
+        {
+            if (i > first)
+            {
+                fec.mul(z_inv, inv, zProducts[i - 1]);
+                fec.mul(inv, inv, buffer_[3*i + 2]);
+            }
+            else
+            {
+                z_inv = inv;
+            }
+            int id2 = 2*(i+npoint_p11);
+            fec.square(z_inv_sq, z_inv);
+            fec.mul(z_inv_cube, z_inv_sq, z_inv);
+            fec.mul(buffer[id2], buffer_[3*i], z_inv_sq);
+            fec.mul(buffer[id2 + 1], buffer_[3*i + 1], z_inv_cube);
+        }
     }
     return 2*(npoint+npoint_p11);
 }
@@ -0,0 +1,298 @@
+#include <map>
+#include "batch_execution_cache.hpp"
+#include "scalar.hpp"
+#include "zklog.hpp"
+
+BatchExecutionCache batchExecutionCache;
+
+/************************/
+/* Cache entry methods  */
+/************************/
+
+bool BatchExecutionCacheEntry::getKeccak (const vector<uint8_t> &data, mpz_class &digest)
+{
+    if (bRecording)
+    {
+        return false;
+    }
+    unordered_map<string, mpz_class>::const_iterator it;
+    it = keccak.find(string((const char *)data.data(), data.size()));
+    if (it == keccak.end())
+    {
+        misses++;
+        return false;
+    }
+    digest = it->second;
+    hits++;
+    return true;
+}
+
+bool BatchExecutionCacheEntry::getPoseidon (const vector<uint8_t> &data, mpz_class &digest)
+{
+    if (bRecording)
+    {
+        return false;
+    }
+    unordered_map<string, mpz_class>::const_iterator it;
+    it = poseidon.find(string((const char *)data.data(), data.size()));
+    if (it == poseidon.end())
+    {
+        misses++;
+        return false;
+    }
+    digest = it->second;
+    hits++;
+    return true;
+}
+
+bool BatchExecutionCacheEntry::getECRecoverPrecalc (const string &key, RawFec::Element *buffer, int &posUsed)
+{
+    if (bRecording)
+    {
+        return false;
+    }
+    unordered_map<string, vector<RawFec::Element>>::const_iterator it;
+    it = ecRecoverPrecalc.find(key);
+    if (it == ecRecoverPrecalc.end())
+    {
+        misses++;
+        return false;
+    }
+    for (uint64_t i=0; i<it->second.size(); i++)
+    {
+        buffer[i] = it->second[i];
+    }
+    posUsed = it->second.size();
+    hits++;
+    return true;
+}
+
+void BatchExecutionCacheEntry::setKeccak (const vector<uint8_t> &data, const mpz_class &digest)
+{
+    if (bRecording)
+    {
+        keccak[string((const char *)data.data(), data.size())] = digest;
+    }
+}
+
+void BatchExecutionCacheEntry::setPoseidon (const vector<uint8_t> &data, const mpz_class &digest)
+{
+    if (bRecording)
+    {
+        poseidon[string((const char *)data.data(), data.size())] = digest;
+    }
+}
+
+void BatchExecutionCacheEntry::setECRecoverPrecalc (const string &key, const RawFec::Element *buffer, int posUsed)
+{
+    // Only successful precalculations are stored; a miss will recalculate the rest
+    if (bRecording && (posUsed > 0))
+    {
+        ecRecoverPrecalc[key] = vector<RawFec::Element>(buffer, buffer + posUsed);
+    }
+}
+
+bool BatchExecutionCacheEntry::canServe (const Input &input) const
+{
+    // bUpdateMerkleTree only changes where the new state is persisted, and bSkipVerifyL1InfoRoot only skips an in-memory
+    // check of the L1 info tree proofs, so neither of them changes the state read by the execution.
+    // Without counters, the execution does not stop when it runs out of counters, so it reads at least the same state.
+    // Skipping the first change L2 block check or the block info root write skips state reads.
+    return (bNoCounters || !input.bNoCounters) &&
+           (!bSkipFirstChangeL2Block || input.bSkipFirstChangeL2Block) &&
+           (!bSkipWriteBlockInfoRoot || input.bSkipWriteBlockInfoRoot) &&
+           (gasLimit == input.debug.gasLimit);
+}
+
+string BatchExecutionCacheEntry::getECRecoverKey (const mpz_class &signature, const mpz_class &r, const mpz_class &s, const mpz_class &v)
+{
+    return signature.get_str(16) + ":" + r.get_str(16) + ":" + s.get_str(16) + ":" + v.get_str(16);
+}
+
+/******************/
+/* Cache methods  */
+/******************/
+
+BatchExecutionCache::~BatchExecutionCache ()
+{
+    unordered_map<string, BatchExecutionCacheEntry *>::iterator it;
+    for (it = entries.begin(); it != entries.end(); it++)
+    {
+        delete it->second;
+    }
+}
+
+string BatchExecutionCache::getKey (const Input &input)
+{
+    const PublicInputs &publicInputs = input.publicInputsExtended.publicInputs;
+
+    // Serialize all the fields that can change the state read by the batch execution, or its results; the old
+    // accumulated input hash and batch number only change the new accumulated input hash, which is not cached
+    string data;
+    data += to_string(publicInputs.forkID) + ":";
+    data += publicInputs.oldStateRoot.get_str(16) + ":";
+    data += to_string(publicInputs.chainID) + ":";
+    data += publicInputs.globalExitRoot.get_str(16) + ":";
+    data += publicInputs.l1InfoRoot.get_str(16) + ":";
+    data += to_string(publicInputs.timestamp) + ":";
+    data += to_string(publicInputs.timestampLimit) + ":";
+    data += publicInputs.forcedBlockHashL1.get_str(16) + ":";
+    data += publicInputs.sequencerAddr.get_str(16) + ":";
+    data += input.from + ":";
+    data += ba2string(publicInputs.batchL2Data) + ":";
+    data += ba2string(publicInputs.witness) + ":";
+    data += ba2string(publicInputs.dataStream) + ":";
+
+    // L1 info tree data is an unordered map, so serialize it sorted by index
+    map<uint64_t, const L1Data *> l1InfoTreeData;
+    unordered_map<uint64_t, L1Data>::const_iterator it;
+    for (it = input.l1InfoTreeData.begin(); it != input.l1InfoTreeData.end(); it++)
+    {
+        l1InfoTreeData[it->first] = &it->second;
+    }
+    map<uint64_t, const L1Data *>::const_iterator itSorted;
+    for (itSorted = l1InfoTreeData.begin(); itSorted != l1InfoTreeData.end(); itSorted++)
+    {
+        data += to_string(itSorted->first) + ":";
+        data += itSorted->second->globalExitRoot.get_str(16) + ":";
+        data += itSorted->second->blockHashL1.get_str(16) + ":";
+        data += to_string(itSorted->second->minTimestamp) + ":";
+        for (uint64_t i=0; i<itSorted->second->smtProof.size(); i++)
+        {
+            data += itSorted->second->smtProof[i].get_str(16) + ",";
+        }
+        data += ":";
+    }
+
+    // State override is an unordered map of accounts, with unordered maps of slots, so serialize them sorted
+    map<string, const OverrideEntry *> stateOverride;
+    unordered_map<string, OverrideEntry>::const_iterator itOverride;
+    for (itOverride = input.stateOverride.begin(); itOverride != input.stateOverride.end(); itOverride++)
+    {
+        stateOverride[itOverride->first] = &itOverride->second;
+    }
+    map<string, const OverrideEntry *>::const_iterator itOverrideSorted;
+    for (itOverrideSorted = stateOverride.begin(); itOverrideSorted != stateOverride.end(); itOverrideSorted++)
+    {
+        const OverrideEntry &entry = *itOverrideSorted->second;
+        data += itOverrideSorted->first + ":";
+        data += to_string(entry.bBalance) + ":";
+        data += entry.balance.get_str(16) + ":";
+        data += to_string(entry.nonce) + ":";
+        data += ba2string(entry.code.data(), entry.code.size()) + ":";
+        const unordered_map<string, mpz_class> * slots[2] = {&entry.state, &entry.stateDiff};
+        for (uint64_t i=0; i<2; i++)
+        {
+            map<string, mpz_class> sortedSlots(slots[i]->begin(), slots[i]->end());
+            map<string, mpz_class>::const_iterator itSlot;
+            for (itSlot = sortedSlots.begin(); itSlot != sortedSlots.end(); itSlot++)
+            {
+                data += itSlot->first + "=" + itSlot->second.get_str(16) + ",";
+            }
+            data += ":";
+        }
+    }
+
+    return keccak256((const uint8_t *)data.c_str(), data.size());
+}
+
+void BatchExecutionCache::add (const string &key, BatchExecutionCacheEntry *pEntry)
+{
+    zkassert(pEntry != NULL);
+
+    Lock();
+
+    // If the cache is disabled, discard the entry
+    if (maxEntries == 0)
+    {
+        Unlock();
+        delete pEntry;
+        return;
+    }
+
+    // If there is already an entry for this key, replace it
+    unordered_map<string, BatchExecutionCacheEntry *>::iterator it;
+    it = entries.find(key);
+    if (it != entries.end())
+    {
+        delete it->second;
+        it->second = pEntry;
+        Unlock();
+        return;
+    }
+
+    // Evict the oldest entries, if full
+    while (entries.size() >= maxEntries)
+    {
+        it = entries.find(order[0]);
+        if (it != entries.end())
+        {
+            delete it->second;
+            entries.erase(it);
+        }
+        order.erase(order.begin());
+    }
+
+    // Add the new entry
+    entries[key] = pEntry;
+    order.emplace_back(key);
+
+    Unlock();
+}
+
+BatchExecutionCacheEntry * BatchExecutionCache::take (const string &key, const Input &input)
+{
+    BatchExecutionCacheEntry * pEntry = NULL;
+
+    Lock();
+
+    // An entry that cannot serve this input is kept, since it can still serve other requests of the same batch
+    unordered_map<string, BatchExecutionCacheEntry *>::iterator it;
+    it = entries.find(key);
+    if ((it != entries.end()) && it->second->canServe(input))
+    {
+        pEntry = it->second;
+        entries.erase(it);
+        for (uint64_t i=0; i<order.size(); i++)
+        {
+            if (order[i] == key)
+            {
+                order.erase(order.begin() + i);
+                break;
+            }
+        }
+    }
+
+    Unlock();
+
+    if (pEntry == NULL)
+    {
+        batchMisses++;
+    }
+    else
+    {
+        pEntry->bRecording = false;
+        batchHits++;
+    }
+
+    return pEntry;
+}
+
+void BatchExecutionCache::addStats (const BatchExecutionCacheEntry &entry)
+{
+    resultHits += entry.hits;
+    resultMisses += entry.misses;
+}
+
+void BatchExecutionCache::print (void)
+{
+    Lock();
+    uint64_t size = entries.size();
+    Unlock();
+
+    zklog.info("BatchExecutionCache::print() entries=" + to_string(size) + "/" + to_string(maxEntries) +
+        " batchHits=" + to_string(batchHits) +
+        " batchMisses=" + to_string(batchMisses) +
+        " resultHits=" + to_string(resultHits) +
+        " resultMisses=" + to_string(resultMisses));
+}
@@ -0,0 +1,115 @@
+#ifndef BATCH_EXECUTION_CACHE_HPP
+#define BATCH_EXECUTION_CACHE_HPP
+
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <pthread.h>
+#include <gmpxx.h>
+#include "config.hpp"
+#include "input.hpp"
+#include "database_map.hpp"
+#include "ffiasm/fec.hpp"
+
+using namespace std;
+
+// Data obtained while executing a batch in process batch mode, to be reused when the same batch is executed
+// again to generate its proof: database reads, and keccak, linear poseidon and ECRecover precalculated results
+class BatchExecutionCacheEntry
+{
+public:
+    bool bRecording; // True while the process batch execution is filling the entry; false when it is being reused
+    DatabaseMap::MTMap db; // State tree nodes read during the execution
+    DatabaseMap::ProgramMap contractsBytecode; // Programs read during the execution
+    unordered_map<string, mpz_class> keccak; // Keccak digests, by hashed data
+    unordered_map<string, mpz_class> poseidon; // Linear poseidon digests, by hashed data
+    unordered_map<string, vector<RawFec::Element>> ecRecoverPrecalc; // ECRecover precalculated buffers, by signature, r, s and v
+
+    // Flags of the recorded execution that change the state it reads
+    bool bNoCounters;
+    bool bSkipFirstChangeL2Block;
+    bool bSkipWriteBlockInfoRoot;
+    uint64_t gasLimit;
+
+    // Reuse counters
+    uint64_t hits;
+    uint64_t misses;
+
+    BatchExecutionCacheEntry(const Input &input) :
+        bRecording(true),
+        bNoCounters(input.bNoCounters),
+        bSkipFirstChangeL2Block(input.bSkipFirstChangeL2Block),
+        bSkipWriteBlockInfoRoot(input.bSkipWriteBlockInfoRoot),
+        gasLimit(input.debug.gasLimit),
+        hits(0),
+        misses(0) {};
+
+    // Returns true if the recorded execution read at least the state that the execution of this input will read
+    bool canServe (const Input &input) const;
+
+    // Getters return true if the result was found; they only look for it when the entry is being reused
+    bool getKeccak (const vector<uint8_t> &data, mpz_class &digest);
+    bool getPoseidon (const vector<uint8_t> &data, mpz_class &digest);
+    bool getECRecoverPrecalc (const string &key, RawFec::Element *buffer, int &posUsed);
+
+    // Setters only store the result when the entry is being recorded
+    void setKeccak (const vector<uint8_t> &data, const mpz_class &digest);
+    void setPoseidon (const vector<uint8_t> &data, const mpz_class &digest);
+    void setECRecoverPrecalc (const string &key, const RawFec::Element *buffer, int posUsed);
+
+    static string getECRecoverKey (const mpz_class &signature, const mpz_class &r, const mpz_class &s, const mpz_class &v);
+};
+
+class BatchExecutionCache
+{
+private:
+    unordered_map<string, BatchExecutionCacheEntry *> entries; // Entries by batch input hash
+    vector<string> order; // Input hashes, in insertion order, to evict the oldest entries first
+    uint64_t maxEntries;
+    pthread_mutex_t mutex; // Mutex to protect the entries map
+
+    // Statistics
+    atomic<uint64_t> batchHits;
+    atomic<uint64_t> batchMisses;
+    atomic<uint64_t> resultHits;
+    atomic<uint64_t> resultMisses;
+
+public:
+    BatchExecutionCache () : maxEntries(0), batchHits(0), batchMisses(0), resultHits(0), resultMisses(0)
+    {
+        // Init mutex
+        pthread_mutex_init(&mutex, NULL);
+    };
+    ~BatchExecutionCache ();
+
+    void init (const Config &config)
+    {
+        maxEntries = config.batchExecutionCacheSize;
+    }
+
+    // Returns the hash of the input fields that determine the state read by the batch execution and its results,
+    // including the state override; the execution flags are checked by BatchExecutionCacheEntry::canServe()
+    static string getKey (const Input &input);
+
+    // Stores an entry, taking ownership of it, and evicts the oldest ones if the cache is full
+    void add (const string &key, BatchExecutionCacheEntry *pEntry);
+
+    // Returns the entry of this input hash, if any and if it can serve this input, removing it from the cache and
+    // transferring its ownership to the caller
+    BatchExecutionCacheEntry * take (const string &key, const Input &input);
+
+    // Accumulates the reuse counters of an entry, once it is not used any more
+    void addStats (const BatchExecutionCacheEntry &entry);
+
+    void print (void);
+
+private:
+    // Lock/Unlock
+    void Lock(void) { pthread_mutex_lock(&mutex); };
+    void Unlock(void) { pthread_mutex_unlock(&mutex); };
+};
+
+extern BatchExecutionCache batchExecutionCache;
+
+#endif
@@ -0,0 +1,97 @@
+#include "bytecode_hash_cache.hpp"
+#include "zklog.hpp"
+
+BytecodeHashCache bytecodeHashCache;
+
+bool BytecodeHashCache::get (const vector<uint8_t> &bytecode, Goldilocks::Element (&hash)[4], uint64_t &time)
+{
+    if (maxSize == 0)
+    {
+        return false;
+    }
+
+    Lock();
+
+    unordered_map<string, Entry>::iterator it;
+    it = entries.find(string((const char *)bytecode.data(), bytecode.size()));
+    if (it == entries.end())
+    {
+        Unlock();
+        misses++;
+        return false;
+    }
+
+    // Move it to the front of the LRU list
+    lru.splice(lru.begin(), lru, it->second.lru);
+
+    for (uint64_t i=0; i<4; i++)
+    {
+        hash[i] = it->second.hash[i];
+    }
+    time = it->second.time;
+
+    Unlock();
+
+    hits++;
+    savedTime += time;
+    return true;
+}
+
+void BytecodeHashCache::add (const vector<uint8_t> &bytecode, const Goldilocks::Element (&hash)[4], uint64_t time)
+{
+    // Do not store bytecodes that would not fit
+    if (bytecode.size() > maxSize)
+    {
+        return;
+    }
+
+    Lock();
+
+    // If another execution already added it, there is nothing to do
+    string key((const char *)bytecode.data(), bytecode.size());
+    if (entries.find(key) != entries.end())
+    {
+        Unlock();
+        return;
+    }
+
+    // Evict the least recently used entries, if full
+    while ((size + bytecode.size() > maxSize) && !lru.empty())
+    {
+        unordered_map<string, Entry>::iterator it = entries.find(*lru.back());
+        lru.pop_back();
+        if (it != entries.end())
+        {
+            size -= it->first.size();
+            entries.erase(it);
+        }
+    }
+
+    // Add the new entry
+    pair<unordered_map<string, Entry>::iterator, bool> result = entries.emplace(key, Entry());
+    Entry &entry = result.first->second;
+    for (uint64_t i=0; i<4; i++)
+    {
+        entry.hash[i] = hash[i];
+    }
+    entry.time = time;
+    lru.push_front(&result.first->first);
+    entry.lru = lru.begin();
+    size += bytecode.size();
+
+    Unlock();
+}
+
+void BytecodeHashCache::print (void)
+{
+    Lock();
+    uint64_t nEntries = entries.size();
+    uint64_t currentSize = size;
+    Unlock();
+
+    zklog.info("BytecodeHashCache::print() entries=" + to_string(nEntries) +
+        " size=" + to_string(currentSize) + "/" + to_string(maxSize) + " B" +
+        " hits=" + to_string(hits) +
+        " misses=" + to_string(misses) +
+        " savedTime=" + to_string(savedTime) + " us");
+}
@@ -0,0 +1,69 @@
+#ifndef BYTECODE_HASH_CACHE_HPP
+#define BYTECODE_HASH_CACHE_HPP
+
+#include <unordered_map>
+#include <list>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <pthread.h>
+#include "config.hpp"
+#include "goldilocks_base_field.hpp"
+
+using namespace std;
+
+// Process-wide cache of linear poseidon hashes, by bytecode content, shared by all the batch executions, so that
+// popular contracts are not hashed again in every batch; the least recently used bytecodes are evicted first
+class BytecodeHashCache
+{
+private:
+    class Entry
+    {
+    public:
+        Goldilocks::Element hash[4];
+        uint64_t time; // Time spent calculating the hash, in us
+        list<const string *>::iterator lru; // Position in the LRU list
+    };
+
+    unordered_map<string, Entry> entries; // Entries by bytecode content
+    list<const string *> lru; // Entry keys, most recently used first
+    uint64_t size; // Bytes used by the bytecodes
+    uint64_t maxSize; // Maximum bytes used by the bytecodes; 0 disables the cache
+    pthread_mutex_t mutex; // Mutex to protect the entries map
+
+    // Statistics
+    atomic<uint64_t> hits;
+    atomic<uint64_t> misses;
+    atomic<uint64_t> savedTime; // us
+
+public:
+    BytecodeHashCache () : size(0), maxSize(0), hits(0), misses(0), savedTime(0)
+    {
+        // Init mutex
+        pthread_mutex_init(&mutex, NULL);
+    };
+
+    void init (const Config &config)
+    {
+        maxSize = config.bytecodeHashCacheSize*1024*1024;
+    }
+
+    bool enabled (void) { return maxSize > 0; }
+
+    // Returns true if the hash of this bytecode was found, and the time it took to calculate it
+    bool get (const vector<uint8_t> &bytecode, Goldilocks::Element (&hash)[4], uint64_t &time);
+
+    // Stores the hash of a bytecode, and evicts the least recently used ones if the cache is full
+    void add (const vector<uint8_t> &bytecode, const Goldilocks::Element (&hash)[4], uint64_t time);
+
+    void print (void);
+
+private:
+    // Lock/Unlock
+    void Lock(void) { pthread_mutex_lock(&mutex); };
+    void Unlock(void) { pthread_mutex_unlock(&mutex); };
+};
+
+extern BytecodeHashCache bytecodeHashCache;
+
+#endif
@@ -0,0 +1,137 @@
+#include "ecrecover_batch_precalc.hpp"
+#include "batch_execution_cache.hpp"
+#include "ecrecover.hpp"
+#include "scalar.hpp"
+#include "zklog.hpp"
+
+// Batch L2 data transactions are made of an RLP list followed by r(32) + s(32) + v(1) + effectivePercentage(1);
+// the signed hash is the keccak of the RLP list, as it is.  Since fork 7 they can be preceded by change L2 block
+// transactions: type(1) + deltaTimestamp(4) + indexL1InfoTree(4)
+#define CHANGE_L2_BLOCK_TX_TYPE 0x0b
+#define CHANGE_L2_BLOCK_TX_SIZE 9
+#define TX_SIGNATURE_SIZE 66
+
+struct ECRecoverBatchPrecalcTx
+{
+    const uint8_t *pRlp;
+    uint64_t rlpSize;
+    mpz_class signature;
+    mpz_class r;
+    mpz_class s;
+    mpz_class v;
+    vector<RawFec::Element> buffer;
+};
+
+uint64_t ECRecoverBatchPrecalc::precalculate (const string &batchL2Data, uint64_t nThreads)
+{
+    const uint8_t *pData = (const uint8_t *)batchL2Data.data();
+    uint64_t size = batchL2Data.size();
+
+    // Extract the signature data of every transaction
+    vector<ECRecoverBatchPrecalcTx> txs;
+    uint64_t p = 0;
+    while (p < size)
+    {
+        if (pData[p] == CHANGE_L2_BLOCK_TX_TYPE)
+        {
+            p += CHANGE_L2_BLOCK_TX_SIZE;
+            continue;
+        }
+
+        // Get the RLP list length
+        uint64_t headerSize, listSize;
+        if ((pData[p] >= 0xc0) && (pData[p] <= 0xf7))
+        {
+            headerSize = 1;
+            listSize = pData[p] - 0xc0;
+        }
+        else if (pData[p] > 0xf7)
+        {
+            uint64_t lengthSize = pData[p] - 0xf7;
+            if ((lengthSize > 8) || (p + 1 + lengthSize > size))
+            {
+                break;
+            }
+            headerSize = 1 + lengthSize;
+            listSize = 0;
+            for (uint64_t i=0; i<lengthSize; i++)
+            {
+                listSize = (listSize << 8) | pData[p + 1 + i];
+            }
+        }
+        else
+        {
+            // Not a transaction; the ROM will reject the batch, and the ECRecover calls will not be precalculated
+            break;
+        }
+        if ((listSize > size) || (p + headerSize + listSize + TX_SIGNATURE_SIZE > size))
+        {
+            break;
+        }
+
+        ECRecoverBatchPrecalcTx tx;
+        tx.pRlp = pData + p;
+        tx.rlpSize = headerSize + listSize;
+        p += headerSize + listSize;
+        ba2scalar(pData + p, 32, tx.r);
+        ba2scalar(pData + p + 32, 32, tx.s);
+        tx.v = pData[p + 64];
+        p += TX_SIGNATURE_SIZE;
+        txs.emplace_back(tx);
+    }
+
+    // Calculate the signed hashes of all the transactions in one call, several of them in parallel
+    vector<const uint8_t *> rlps(txs.size());
+    vector<uint64_t> rlpSizes(txs.size());
+    vector<mpz_class *> signatures(txs.size());
+    for (uint64_t i=0; i<txs.size(); i++)
+    {
+        rlps[i] = txs[i].pRlp;
+        rlpSizes[i] = txs[i].rlpSize;
+        signatures[i] = &txs[i].signature;
+    }
+    keccak256(txs.size(), rlps.data(), rlpSizes.data(), signatures.data());
+
+    // Precalculate all of them in parallel, one thread per transaction
+    if (nThreads == 0)
+    {
+        nThreads = 1;
+    }
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+    for (uint64_t i=0; i<txs.size(); i++)
+    {
+        RawFec::Element buffer[1026];
+        int posUsed = ECRecoverPrecalc(txs[i].signature, txs[i].r, txs[i].s, txs[i].v, false, buffer, 1);
+        if (posUsed > 0)
+        {
+            txs[i].buffer.assign(buffer, buffer + posUsed);
+        }
+    }
+
+    // Memoize the results, by the same key used by the batch execution cache
+    for (uint64_t i=0; i<txs.size(); i++)
+    {
+        if (txs[i].buffer.size() > 0)
+        {
+            precalc[BatchExecutionCacheEntry::getECRecoverKey(txs[i].signature, txs[i].r, txs[i].s, txs[i].v)] = txs[i].buffer;
+        }
+    }
+
+    return txs.size();
+}
+
+bool ECRecoverBatchPrecalc::get (const string &key, RawFec::Element *buffer, int &posUsed) const
+{
+    unordered_map<string, vector<RawFec::Element>>::const_iterator it;
+    it = precalc.find(key);
+    if (it == precalc.end())
+    {
+        return false;
+    }
+    for (uint64_t i=0; i<it->second.size(); i++)
+    {
+        buffer[i] = it->second[i];
+    }
+    posUsed = it->second.size();
+    return true;
+}
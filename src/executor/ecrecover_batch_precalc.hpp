@@ -0,0 +1,29 @@
+#ifndef ECRECOVER_BATCH_PRECALC_HPP
+#define ECRECOVER_BATCH_PRECALC_HPP
+
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include "ffiasm/fec.hpp"
+
+using namespace std;
+
+// ECRecover precalculated buffers of all the transactions of a batch, calculated in parallel before executing it,
+// so that the main executor only has to look them up when the ROM reaches the ECRecover arguments
+class ECRecoverBatchPrecalc
+{
+private:
+    unordered_map<string, vector<RawFec::Element>> precalc; // Precalculated buffers, by signature, r, s and v
+
+public:
+    // Parses the transactions of a batch L2 data and precalculates their signatures, using nThreads threads;
+    // returns the number of transactions found
+    uint64_t precalculate (const string &batchL2Data, uint64_t nThreads);
+
+    // Returns true if the precalculated buffer of this ECRecover key was found, copying it into buffer
+    bool get (const string &key, RawFec::Element *buffer, int &posUsed) const;
+
+    bool empty (void) const { return precalc.empty(); };
+};
+
+#endif
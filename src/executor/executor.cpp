@@ -19,6 +19,22 @@
 // Reduced version: only 1 evaluation is allocated, and some asserts are disabled
 void Executor::process_batch (ProverRequest &proverRequest)
 {
+    // Only the fork 9 main executors read a binary witness database; for previous forks, load its content into the
+    // input db and contracts bytecode, which they load into the hashdb
+    if (!proverRequest.input.witnessDBFile.empty() && (proverRequest.input.publicInputsExtended.publicInputs.forkID < 9))
+    {
+        zkresult zkr = proverRequest.witnessDB.open(proverRequest.input.witnessDBFile);
+        if (zkr != ZKR_SUCCESS)
+        {
+            proverRequest.result = zkr;
+            zklog.error("Executor::process_batch() failed calling witnessDB.open() of file=" + proverRequest.input.witnessDBFile + " result=" + zkresult2string(zkr));
+            return;
+        }
+        proverRequest.witnessDB.toMaps(proverRequest.input.db, proverRequest.input.contractsBytecode);
+        proverRequest.witnessDB.close();
+        proverRequest.input.witnessDBFile.clear();
+    }
+
     // Execute the Main State Machine
     switch (proverRequest.input.publicInputsExtended.publicInputs.forkID)
     {
@@ -20,6 +20,8 @@ public:
         typename BaseField::Element y;
     };
 
+    typedef typename BaseField::Element FieldElement;
+
 private: 
 
     void initCurve(typename BaseField::Element &aa, typename BaseField::Element &ab, typename BaseField::Element &agx, typename BaseField::Element &agy);
@@ -124,6 +126,10 @@ public:
         ParallelMultiexp<Curve<BaseField>> pm(*this);
         pm.multiexp(r, bases, scalars, scalarSize, n, nx, x, nThreads);
     }
+    void multiMulByScalar(Point &r, MultiexpFixedBases<Curve<BaseField>> &fixedBases, uint8_t* scalars, unsigned int scalarSize, unsigned int n, unsigned int nThreads=0) {
+        ParallelMultiexp<Curve<BaseField>> pm(*this);
+        pm.multiexp(r, fixedBases, scalars, scalarSize, n, nThreads);
+    }
 #ifdef COUNT_OPS
     void resetCounters();
     void printCounters();
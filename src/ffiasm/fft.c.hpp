@@ -28,6 +28,12 @@ static inline u_int64_t BR(u_int64_t x, u_int64_t domainPow)
 
 #define ROOT(s,j) (rootsOfUnit[(1<<(s))+(j)])
 
+template <typename Field>
+std::mutex FFT<Field>::sharedRootsMutex;
+
+template <typename Field>
+std::weak_ptr<typename FFT<Field>::Roots> FFT<Field>::sharedRoots;
+
 template <typename Field>
 FFT<Field>::FFT(u_int64_t maxDomainSize, uint32_t _nThreads) {
     nThreads = _nThreads==0 ? omp_get_max_threads() : _nThreads;
@@ -35,6 +41,25 @@ FFT<Field>::FFT(u_int64_t maxDomainSize, uint32_t _nThreads) {
 
     u_int32_t domainPow = log2(maxDomainSize);
 
+    // Reuse the roots of unity of another FFT of this field, if they are big enough
+    {
+        std::lock_guard<std::mutex> lock(sharedRootsMutex);
+        pRoots = sharedRoots.lock();
+        if (!pRoots || (pRoots->s < domainPow)) {
+            pRoots = std::make_shared<Roots>();
+            initRoots(*pRoots, domainPow);
+            sharedRoots = pRoots;
+        }
+    }
+    s = pRoots->s;
+    f.copy(nqr, pRoots->nqr);
+    roots = pRoots->roots;
+    powTwoInv = pRoots->powTwoInv;
+    twiddles = pRoots->twiddles;
+}
+
+template <typename Field>
+void FFT<Field>::initRoots(Roots &r, u_int32_t domainPow) {
     mpz_t m_qm1d2;
     mpz_t m_q;
     mpz_t m_nqr;
@@ -56,16 +81,17 @@ FFT<Field>::FFT(u_int64_t maxDomainSize, uint32_t _nThreads) {
         mpz_powm(m_aux, m_nqr, m_qm1d2, m_q);
     }
 
-    f.fromMpz(nqr, m_nqr);
+    f.fromMpz(r.nqr, m_nqr);
 
     // std::cout << "nqr: " << f.toString(nqr) << std::endl;
 
-    s = 1;
+    u_int32_t s = 1;
     mpz_set(m_aux, m_qm1d2);
     while ((!mpz_tstbit(m_aux, 0))&&(s<domainPow)) {
         mpz_fdiv_q_2exp(m_aux, m_aux, 1);
         s++;
     }
+    r.s = s;
 
     if (s<domainPow) {
         throw std::range_error("Domain size too big for the curve");
@@ -73,8 +99,8 @@ FFT<Field>::FFT(u_int64_t maxDomainSize, uint32_t _nThreads) {
 
     uint64_t nRoots = 1LL << s;
 
-    roots = new Element[nRoots];
-    powTwoInv = new Element[s+1];
+    Element *roots = r.roots = new Element[nRoots];
+    Element *powTwoInv = r.powTwoInv = new Element[s+1];
 
     f.copy(roots[0], f.one());
     f.copy(powTwoInv[0], f.one());
@@ -108,6 +134,14 @@ FFT<Field>::FFT(u_int64_t maxDomainSize, uint32_t _nThreads) {
         f.mul(powTwoInv[i], powTwoInv[i-1], powTwoInv[1]);
     }
 
+    u_int32_t blockPow = s < FFT_CACHE_BLOCK_POW ? s : FFT_CACHE_BLOCK_POW;
+    r.twiddles = new Element[1 << blockPow];
+    for (u_int32_t st=1; st<=blockPow; st++) {
+        for (u_int64_t j=0; j<(1ULL << (st-1)); j++) {
+            f.copy(r.twiddles[(1 << (st-1)) + j], roots[j << (s-st)]);
+        }
+    }
+
     mpz_clear(m_qm1d2);
     mpz_clear(m_q);
     mpz_clear(m_nqr);
@@ -116,8 +150,6 @@ FFT<Field>::FFT(u_int64_t maxDomainSize, uint32_t _nThreads) {
 
 template <typename Field>
 FFT<Field>::~FFT() {
-    delete[] roots;
-    delete[] powTwoInv;
 }
 
 /*
@@ -157,34 +189,135 @@ void FFT<Field>::reversePermutation(Element *a, u_int64_t n) {
 
 template <typename Field>
 void FFT<Field>::reversePermutation(Element *a, u_int64_t n) {
-    int domainPow = log2(n);
+    u_int32_t domainPow = log2(n);
+    u_int32_t t = FFT_REVERSE_TILE_POW;
+    if (domainPow <= 2*t) {
+        for (u_int64_t i=0; i<n; i++) {
+            Element tmp;
+            u_int64_t r = BR(i, domainPow);
+            if (i>r) {
+                f.copy(tmp, a[i]);
+                f.copy(a[i], a[r]);
+                f.copy(a[r], tmp);
+            }
+        }
+        return;
+    }
+
+    // Index i = (hi, mid, lo), with t bits hi and lo, is swapped with (BR(lo), BR(mid), BR(hi)), so every swap is
+    // between the tiles of mid and BR(mid), which fit in cache, instead of between random positions
+    u_int32_t midPow = domainPow - 2*t;
+    u_int64_t tileSize = 1 << t;
     #pragma omp parallel for
-    for (u_int64_t i=0; i<n; i++) {
-        Element tmp;
-        u_int64_t r = BR(i, domainPow);
-        if (i>r) {
-            f.copy(tmp, a[i]);
-            f.copy(a[i], a[r]);
-            f.copy(a[r], tmp);
+    for (u_int64_t mid=0; mid<((u_int64_t)1 << midPow); mid++) {
+        u_int64_t rmid = BR(mid, midPow);
+        if (rmid < mid) continue;
+        for (u_int64_t hi=0; hi<tileSize; hi++) {
+            for (u_int64_t lo=0; lo<tileSize; lo++) {
+                u_int64_t i = (hi << (domainPow-t)) | (mid << t) | lo;
+                u_int64_t r = (BR(lo, t) << (domainPow-t)) | (rmid << t) | BR(hi, t);
+                if ((rmid == mid) && (i >= r)) continue;
+                Element tmp;
+                f.copy(tmp, a[i]);
+                f.copy(a[i], a[r]);
+                f.copy(a[r], tmp);
+            }
         }
     }
 }
 
+// Two DIT stages at once: stage s (w1 = root(s, j)) and stage s+1 (w2 = root(s+1, j), w3 = root(s+1, j+h)) over
+// the elements a[0], a[h], a[2h] and a[3h], with h = 2^(s-1), so they are loaded and stored only once
+template <typename Field>
+inline void FFT<Field>::butterfly4(Element *a, u_int64_t h, Element &w1, Element &w2, Element &w3) {
+    Element t0, t1, u0, u1, u2, u3;
+    f.mul(t0, w1, a[h]);
+    f.mul(t1, w1, a[3*h]);
+    f.add(u0, a[0], t0);
+    f.sub(u1, a[0], t0);
+    f.add(u2, a[2*h], t1);
+    f.sub(u3, a[2*h], t1);
+    f.mul(t0, w2, u2);
+    f.mul(t1, w3, u3);
+    f.add(a[0], u0, t0);
+    f.sub(a[2*h], u0, t0);
+    f.add(a[h], u1, t1);
+    f.sub(a[3*h], u1, t1);
+}
 
 template <typename Field>
 void FFT<Field>::fft(Element *a, u_int64_t n) {
-    reversePermutation(a, n);
+    fft(&a, 1, n);
+}
+
+template <typename Field>
+void FFT<Field>::fft(Element **pols, u_int32_t nPols, u_int64_t n) {
+    for (u_int32_t p=0; p<nPols; p++) {
+        reversePermutation(pols[p], n);
+    }
     u_int64_t domainPow =log2(n);
     assert(((u_int64_t)1 << domainPow) == n);
-    for (u_int32_t s=1; s<=domainPow; s++) {
+
+    // The stages that only combine elements of the same block are done block by block, while it is in cache,
+    // two stages at a time
+    u_int32_t blockPow = domainPow < FFT_CACHE_BLOCK_POW ? domainPow : FFT_CACHE_BLOCK_POW;
+    u_int64_t blockSize = 1 << blockPow;
+    u_int64_t nBlocks = n >> blockPow;
+    #pragma omp parallel for
+    for (u_int64_t b=0; b<nPols*nBlocks; b++) {
+        Element *a = pols[b / nBlocks] + (b % nBlocks)*blockSize;
+        u_int32_t s = 1;
+        for (; s+1<=blockPow; s+=2) {
+            u_int64_t h = 1 << (s-1);
+            Element *w1 = &twiddles[h];
+            Element *w2 = &twiddles[2*h];
+            for (u_int64_t i=0; i< (blockSize>>2); i++) {
+                u_int64_t k=(i/h)*4*h;
+                u_int64_t j=i%h;
+                butterfly4(&a[k+j], h, w1[j], w2[j], w2[j+h]);
+            }
+        }
+        if (s == blockPow) {
+            u_int64_t mdiv2 = 1 << (s-1);
+            u_int64_t m = mdiv2 << 1;
+            for (u_int64_t i=0; i< (blockSize>>1); i++) {
+                Element t;
+                Element u;
+                u_int64_t k=(i/mdiv2)*m;
+                u_int64_t j=i%mdiv2;
+
+                f.mul(t, twiddles[mdiv2 + j], a[k+j+mdiv2]);
+                f.copy(u,a[k+j]);
+                f.add(a[k+j], t, u);
+                f.sub(a[k+j+mdiv2], u, t);
+            }
+        }
+    }
+
+    // The rest of the stages, over all the polynomials at once, two stages per pass over the memory
+    u_int64_t nDiv2 = n >> 1;
+    u_int64_t nDiv4 = n >> 2;
+    u_int32_t s = blockPow+1;
+    for (; s+1<=domainPow; s+=2) {
+        u_int64_t h = 1 << (s-1);
+        #pragma omp parallel for
+        for (u_int64_t i=0; i< nPols*nDiv4; i++) {
+            Element *a = pols[i / nDiv4];
+            u_int64_t k=((i % nDiv4)/h)*4*h;
+            u_int64_t j=(i % nDiv4)%h;
+            butterfly4(&a[k+j], h, root(s, j), root(s+1, j), root(s+1, j+h));
+        }
+    }
+    if (s == domainPow) {
         u_int64_t m = 1 << s;
         u_int64_t mdiv2 = m >> 1;
         #pragma omp parallel for
-        for (u_int64_t i=0; i< (n>>1); i++) {
+        for (u_int64_t i=0; i< nPols*nDiv2; i++) {
+            Element *a = pols[i / nDiv2];
             Element t;
             Element u;
-            u_int64_t k=(i/mdiv2)*m;
-            u_int64_t j=i%mdiv2;
+            u_int64_t k=((i % nDiv2)/mdiv2)*m;
+            u_int64_t j=(i % nDiv2)%mdiv2;
 
             f.mul(t, root(s, j), a[k+j+mdiv2]);
             f.copy(u,a[k+j]);
@@ -194,6 +327,31 @@ void FFT<Field>::fft(Element *a, u_int64_t n) {
     }
 }
 
+template <typename Field>
+void FFT<Field>::ifftShift(Element **pols, u_int32_t nPols, u_int64_t n) {
+    fft(pols, nPols, n);
+    u_int64_t domainPow =log2(n);
+    u_int64_t nDiv2= n >> 1;
+    #pragma omp parallel for
+    for (u_int64_t i=0; i<nPols*nDiv2; i++) {
+        Element *a = pols[i / nDiv2];
+        u_int64_t idx = i % nDiv2;
+        if (idx == 0) {
+            f.mul(a[0], a[0], powTwoInv[domainPow]);
+            f.mul(a[nDiv2], a[nDiv2], powTwoInv[domainPow]);
+            f.mul(a[nDiv2], a[nDiv2], root(domainPow+1, nDiv2));
+            continue;
+        }
+        Element tmp;
+        u_int64_t r = n-idx;
+        f.copy(tmp, a[idx]);
+        f.mul(a[idx], a[r], powTwoInv[domainPow]);
+        f.mul(a[idx], a[idx], root(domainPow+1, idx));
+        f.mul(a[r], tmp, powTwoInv[domainPow]);
+        f.mul(a[r], a[r], root(domainPow+1, r));
+    }
+}
+
 template <typename Field>
 void FFT<Field>::ifft(Element *a, u_int64_t n ) {
     fft(a, n);
@@ -1,20 +1,46 @@
 #ifndef FFT_H
 #define FFT_H
 
+#include <memory>
+#include <mutex>
+
+// The first butterfly stages work within blocks of this many elements (log2), which stay in cache
+#define FFT_CACHE_BLOCK_POW 12
+// The bit reversal permutation swaps tiles of 2^FFT_REVERSE_TILE_POW x 2^FFT_REVERSE_TILE_POW elements
+#define FFT_REVERSE_TILE_POW 4
+
 template <typename Field>
 class FFT {
     Field f;
     typedef typename Field::Element Element;
 
+    // Roots of unity of the biggest domain requested so far, shared by all the FFTs of the same field, since
+    // root(domainPow, idx) is the same element for any bigger table
+    struct Roots {
+        u_int32_t s;
+        Element nqr;
+        Element *roots;
+        Element *powTwoInv;
+        Element *twiddles; // Twiddles of the in-cache stages, contiguous by stage: twiddles[2^(s-1) + j] = root(s, j)
+        Roots() : roots(NULL), powTwoInv(NULL), twiddles(NULL) {}
+        ~Roots() { delete[] roots; delete[] powTwoInv; delete[] twiddles; }
+    };
+    static std::mutex sharedRootsMutex;
+    static std::weak_ptr<Roots> sharedRoots;
+    std::shared_ptr<Roots> pRoots;
+
     u_int32_t s;
     Element nqr;
     Element *roots;
     Element *powTwoInv;
+    Element *twiddles;
     u_int32_t nThreads;
 
+    void initRoots(Roots &r, u_int32_t domainPow);
     void reversePermutationInnerLoop(Element *a, u_int64_t from, u_int64_t to, u_int32_t domainPow);
     void reversePermutation(Element *a, u_int64_t n);
     void fftInnerLoop(Element *a, u_int64_t from, u_int64_t to, u_int32_t s);
+    inline void butterfly4(Element *a, u_int64_t h, Element &w1, Element &w2, Element &w3);
     void finalInverseInner(Element *a, u_int64_t from, u_int64_t to, u_int32_t domainPow);
 
 public:
@@ -24,6 +50,11 @@ public:
     void fft(Element *a, u_int64_t n );
     void ifft(Element *a, u_int64_t n );
 
+    // Batched versions, that transform nPols polynomials of the same size in the same parallel passes
+    void fft(Element **pols, u_int32_t nPols, u_int64_t n);
+    // Inverse FFT followed by the multiplication of coefficient i by root(log2(n)+1, i), in the same final pass
+    void ifftShift(Element **pols, u_int32_t nPols, u_int64_t n);
+
     u_int32_t log2(u_int64_t n);
     inline Element &root(u_int32_t domainPow, u_int64_t idx) { return roots[ idx << (s-domainPow)]; }
 
@@ -1,5 +1,7 @@
 #include <omp.h>
 #include <memory.h>
+#include <vector>
+#include <cassert>
 #include "misc.hpp"
 /*
 template <typename Curve>
@@ -63,6 +65,23 @@ void ParallelMultiexp<Curve>::processChunk(uint64_t idChunk, uint64_t nX, uint64
     }
 }
 
+template <typename Curve>
+void ParallelMultiexp<Curve>::processRound(MultiexpFixedBases<Curve> &fixedBases, uint64_t idRound) {
+    #pragma omp parallel for
+    for(uint64_t k=0; k<fixedBases.nTables*n; k++) {
+        uint64_t j = k / n;
+        uint64_t i = k % n;
+        uint64_t idChunk = j*fixedBases.nRounds + idRound;
+        if (idChunk >= nChunks) continue;
+        if (g.isZero(bases[i])) continue;
+        uint64_t chunkValue = getChunk(i, idChunk);
+        if (chunkValue) {
+            int idThread = omp_get_thread_num();
+            g.add(accs[idThread*accsPerChunk+chunkValue].p, accs[idThread*accsPerChunk+chunkValue].p, fixedBases.table(j)[i]);
+        }
+    }
+}
+
 template <typename Curve>
 void ParallelMultiexp<Curve>::packThreads() {
     #pragma omp parallel for
@@ -111,6 +130,318 @@ void ParallelMultiexp<Curve>::reduce(typename Curve::Point &res, uint64_t nBits)
     delete[] sall;
 }
 
+template <typename Curve>
+uint64_t ParallelMultiexp<Curve>::getBit(uint64_t scalarIdx, uint64_t bitIdx) {
+    if (bitIdx >= scalarSize*8) return 0;
+    return (scalars[scalarIdx*scalarSize + bitIdx/8] >> (bitIdx%8)) & 1;
+}
+
+// Chunk value minus 2^bitsPerChunk if its top bit is set, plus the carry of the previous chunk
+template <typename Curve>
+int64_t ParallelMultiexp<Curve>::getSignedChunk(uint64_t scalarIdx, uint64_t chunkIdx) {
+    int64_t v = chunkIdx*bitsPerChunk < scalarSize*8 ? getChunk(scalarIdx, chunkIdx) : 0;
+    if (v >> (bitsPerChunk-1)) v -= int64_t(1) << bitsPerChunk;
+    if (chunkIdx > 0) v += getBit(scalarIdx, chunkIdx*bitsPerChunk - 1);
+    return v;
+}
+
+// Returns true if the carry of the last chunk of any scalar needs an additional chunk
+template <typename Curve>
+bool ParallelMultiexp<Curve>::needsCarryChunk() {
+    uint64_t bitIdx = nChunks*bitsPerChunk - 1;
+    if (bitIdx >= scalarSize*8) return false;
+    uint64_t found = 0;
+    #pragma omp parallel for reduction(|:found)
+    for (uint64_t i=0; i<n; i++) {
+        found |= getBit(i, bitIdx);
+    }
+    return found != 0;
+}
+
+// Adds every point k with a non zero getChunkValue(k) to the bucket of its absolute value, negated if it is
+// negative. Points are sorted by bucket, and every group of points is reduced as a tree: at every level the
+// points of each bucket are added in pairs, and all the pairs of the group share a single inversion
+template <typename Curve>
+template <typename GetPoint, typename GetChunk>
+void ParallelMultiexp<Curve>::accumulateBatchAffine(uint64_t nPoints, GetPoint getPoint, GetChunk getChunkValue) {
+    typedef typename Curve::FieldElement FieldElement;
+    typedef typename Curve::PointAffine PointAffine;
+    const uint32_t signBit = 1u << 31;
+
+    // Counting sort of the points by bucket; the sign of the chunk is kept in the top bit of the point index
+    uint64_t nBuckets = accsPerChunk;
+    uint64_t pointsPerThread = (nPoints + nThreads - 1) / nThreads;
+    std::vector<uint32_t> counts(nThreads*nBuckets, 0);
+    #pragma omp parallel for
+    for (uint64_t t=0; t<nThreads; t++) {
+        uint32_t *c = &counts[t*nBuckets];
+        for (uint64_t k=t*pointsPerThread; (k<(t+1)*pointsPerThread) && (k<nPoints); k++) {
+            int64_t v = getChunkValue(k);
+            if (v) c[v < 0 ? -v : v]++;
+        }
+    }
+    std::vector<uint64_t> bucketStart(nBuckets + 1);
+    uint64_t pos = 0;
+    for (uint64_t b=0; b<nBuckets; b++) {
+        bucketStart[b] = pos;
+        for (uint64_t t=0; t<nThreads; t++) {
+            uint32_t c = counts[t*nBuckets + b];
+            counts[t*nBuckets + b] = pos;
+            pos += c;
+        }
+    }
+    bucketStart[nBuckets] = pos;
+    std::vector<uint32_t> sorted(pos);
+    #pragma omp parallel for
+    for (uint64_t t=0; t<nThreads; t++) {
+        uint32_t *c = &counts[t*nBuckets];
+        for (uint64_t k=t*pointsPerThread; (k<(t+1)*pointsPerThread) && (k<nPoints); k++) {
+            int64_t v = getChunkValue(k);
+            if (v > 0) sorted[c[v]++] = k;
+            if (v < 0) sorted[c[-v]++] = k | signBit;
+        }
+    }
+
+    // Split the buckets in groups of up to PME2_BATCH_AFFINE_GROUP_SIZE points; bigger buckets are split in
+    // several groups, and their partial sums are added at the end
+    struct Segment {
+        uint64_t bucket;
+        uint64_t start;
+        uint64_t len;
+        bool split;
+    };
+    std::vector<Segment> segments;
+    std::vector<uint64_t> groupStart(1, 0);
+    uint64_t groupSize = 0;
+    for (uint64_t b=1; b<nBuckets; b++) {
+        uint64_t len = bucketStart[b+1] - bucketStart[b];
+        if (len == 0) continue;
+        if (len > PME2_BATCH_AFFINE_GROUP_SIZE) {
+            if (groupSize > 0) {
+                groupStart.push_back(segments.size());
+                groupSize = 0;
+            }
+            for (uint64_t s=bucketStart[b]; s<bucketStart[b+1]; s+=PME2_BATCH_AFFINE_GROUP_SIZE) {
+                uint64_t l = bucketStart[b+1] - s < PME2_BATCH_AFFINE_GROUP_SIZE ? bucketStart[b+1] - s : PME2_BATCH_AFFINE_GROUP_SIZE;
+                segments.push_back({b, s, l, true});
+                groupStart.push_back(segments.size());
+            }
+            continue;
+        }
+        if (groupSize + len > PME2_BATCH_AFFINE_GROUP_SIZE) {
+            groupStart.push_back(segments.size());
+            groupSize = 0;
+        }
+        segments.push_back({b, bucketStart[b], len, false});
+        groupSize += len;
+    }
+    if (groupSize > 0) groupStart.push_back(segments.size());
+    uint64_t nGroups = groupStart.size() - 1;
+    std::vector<PointAffine> splitSums(segments.size());
+
+    #pragma omp parallel
+    {
+        struct Pair {
+            uint64_t a;
+            uint64_t b;
+            uint64_t dst;
+            uint8_t type;
+        };
+        enum { pairAdd, pairDbl, pairA, pairB, pairZero };
+        std::vector<PointAffine> p(PME2_BATCH_AFFINE_GROUP_SIZE);
+        std::vector<uint8_t> isZero(PME2_BATCH_AFFINE_GROUP_SIZE);
+        std::vector<Pair> pairs(PME2_BATCH_AFFINE_GROUP_SIZE/2);
+        std::vector<FieldElement> den(PME2_BATCH_AFFINE_GROUP_SIZE/2);
+        std::vector<FieldElement> prod(PME2_BATCH_AFFINE_GROUP_SIZE/2);
+        std::vector<uint64_t> segStart(PME2_BATCH_AFFINE_GROUP_SIZE);
+        std::vector<uint64_t> segLen(PME2_BATCH_AFFINE_GROUP_SIZE);
+
+        #pragma omp for schedule(dynamic)
+        for (uint64_t gr=0; gr<nGroups; gr++) {
+            uint64_t nSegs = groupStart[gr+1] - groupStart[gr];
+            Segment *segs = &segments[groupStart[gr]];
+
+            // Load the points of the group
+            uint64_t m = 0;
+            for (uint64_t s=0; s<nSegs; s++) {
+                segStart[s] = m;
+                segLen[s] = segs[s].len;
+                for (uint64_t i=0; i<segs[s].len; i++) {
+                    uint32_t e = sorted[segs[s].start + i];
+                    g.copy(p[m], getPoint(e & ~signBit));
+                    if (e & signBit) g.F.neg(p[m].y, p[m].y);
+                    isZero[m] = 0;
+                    m++;
+                }
+            }
+
+            while (true) {
+                // Collect the pairs of this level and their denominators
+                uint64_t nPairs = 0;
+                for (uint64_t s=0; s<nSegs; s++) {
+                    for (uint64_t k=0; k<segLen[s]/2; k++) {
+                        Pair &pr = pairs[nPairs];
+                        pr.a = segStart[s] + 2*k;
+                        pr.b = pr.a + 1;
+                        pr.dst = segStart[s] + k;
+                        PointAffine &pa = p[pr.a];
+                        PointAffine &pb = p[pr.b];
+                        if (isZero[pr.a] && isZero[pr.b]) {
+                            pr.type = pairZero;
+                        } else if (isZero[pr.b]) {
+                            pr.type = pairA;
+                        } else if (isZero[pr.a]) {
+                            pr.type = pairB;
+                        } else if (!g.F.eq(pa.x, pb.x)) {
+                            pr.type = pairAdd;
+                        } else if (g.F.eq(pa.y, pb.y) && !g.F.isZero(pa.y)) {
+                            pr.type = pairDbl;
+                        } else {
+                            pr.type = pairZero;
+                        }
+                        if (pr.type == pairAdd) {
+                            g.F.sub(den[nPairs], pb.x, pa.x);
+                        } else if (pr.type == pairDbl) {
+                            g.F.add(den[nPairs], pa.y, pa.y);
+                        } else {
+                            g.F.copy(den[nPairs], g.F.one());
+                        }
+                        nPairs++;
+                    }
+                }
+                if (nPairs == 0) break;
+
+                // Montgomery's trick: den[i] = 1/den[i] with a single inversion
+                g.F.copy(prod[0], den[0]);
+                for (uint64_t i=1; i<nPairs; i++) g.F.mul(prod[i], prod[i-1], den[i]);
+                FieldElement inv;
+                g.F.inv(inv, prod[nPairs-1]);
+                for (uint64_t i=nPairs-1; i>0; i--) {
+                    FieldElement aux;
+                    g.F.mul(aux, inv, prod[i-1]);
+                    g.F.mul(inv, inv, den[i]);
+                    g.F.copy(den[i], aux);
+                }
+                g.F.copy(den[0], inv);
+
+                // Add the pairs; every result is stored before its operands, which are not read any more
+                for (uint64_t i=0; i<nPairs; i++) {
+                    Pair &pr = pairs[i];
+                    PointAffine &pa = p[pr.a];
+                    PointAffine &pb = p[pr.b];
+                    if (pr.type == pairAdd || pr.type == pairDbl) {
+                        FieldElement lambda, aux;
+                        if (pr.type == pairAdd) {
+                            g.F.sub(aux, pb.y, pa.y);
+                        } else {
+                            g.F.square(aux, pa.x);
+                            FieldElement aux3;
+                            g.F.add(aux3, aux, aux);
+                            g.F.add(aux, aux3, aux);
+                            g.F.add(aux, aux, g.a());
+                        }
+                        g.F.mul(lambda, aux, den[i]);
+                        FieldElement x3, y3;
+                        g.F.square(x3, lambda);
+                        g.F.sub(x3, x3, pa.x);
+                        g.F.sub(x3, x3, pb.x);
+                        g.F.sub(aux, pa.x, x3);
+                        g.F.mul(y3, lambda, aux);
+                        g.F.sub(y3, y3, pa.y);
+                        g.F.copy(p[pr.dst].x, x3);
+                        g.F.copy(p[pr.dst].y, y3);
+                        isZero[pr.dst] = 0;
+                    } else if (pr.type == pairA) {
+                        if (pr.dst != pr.a) g.copy(p[pr.dst], pa);
+                        isZero[pr.dst] = 0;
+                    } else if (pr.type == pairB) {
+                        g.copy(p[pr.dst], pb);
+                        isZero[pr.dst] = 0;
+                    } else {
+                        isZero[pr.dst] = 1;
+                    }
+                }
+
+                // Move the odd points after the results
+                for (uint64_t s=0; s<nSegs; s++) {
+                    if (segLen[s] & 1) {
+                        uint64_t src = segStart[s] + segLen[s] - 1;
+                        uint64_t dst = segStart[s] + segLen[s]/2;
+                        if (src != dst) {
+                            g.copy(p[dst], p[src]);
+                            isZero[dst] = isZero[src];
+                        }
+                    }
+                    segLen[s] = (segLen[s] + 1)/2;
+                }
+            }
+
+            // Store the sums of the buckets
+            for (uint64_t s=0; s<nSegs; s++) {
+                uint64_t i = segStart[s];
+                if (segs[s].split) {
+                    if (isZero[i]) {
+                        g.copy(splitSums[groupStart[gr] + s], g.zeroAffine());
+                    } else {
+                        g.copy(splitSums[groupStart[gr] + s], p[i]);
+                    }
+                } else {
+                    if (isZero[i]) {
+                        g.copy(accs[segs[s].bucket].p, g.zero());
+                    } else {
+                        g.copy(accs[segs[s].bucket].p, p[i]);
+                    }
+                }
+            }
+        }
+    }
+
+    for (uint64_t s=0; s<segments.size(); s++) {
+        if (segments[s].split && !g.isZero(splitSums[s])) {
+            g.add(accs[segments[s].bucket].p, accs[segments[s].bucket].p, splitSums[s]);
+        }
+    }
+}
+
+// Reduces the signed chunk buckets 1..2^(bitsPerChunk-1)
+template <typename Curve>
+void ParallelMultiexp<Curve>::reduceSigned(typename Curve::Point &res) {
+    uint64_t top = accsPerChunk - 1;
+    reduce(res, bitsPerChunk - 1);
+    if (!g.isZero(accs[top].p)) {
+        for (uint64_t k=0; k<bitsPerChunk-1; k++) g.dbl(accs[top].p, accs[top].p);
+        g.add(res, res, accs[top].p);
+        g.copy(accs[top].p, g.zero());
+    }
+}
+
+template <typename Curve>
+void ParallelMultiexp<Curve>::multiexpBatchAffine(typename Curve::Point &r) {
+    if (needsCarryChunk()) nChunks++;
+    accsPerChunk = (1 << (bitsPerChunk-1)) + 1;
+
+    typename Curve::Point *chunkResults = new typename Curve::Point[nChunks];
+    accs = new PaddedPoint[accsPerChunk];
+    for (uint64_t i=0; i<accsPerChunk; i++) g.copy(accs[i].p, g.zero());
+
+    for (uint64_t i=0; i<nChunks; i++) {
+        accumulateBatchAffine(n,
+            [&](uint64_t k) -> typename Curve::PointAffine & { return bases[k]; },
+            [&](uint64_t k) -> int64_t { return g.isZero(bases[k]) ? 0 : getSignedChunk(k, i); });
+        reduceSigned(chunkResults[i]);
+    }
+
+    delete[] accs;
+
+    g.copy(r, chunkResults[nChunks-1]);
+    for  (int j=nChunks-2; j>=0; j--) {
+        for (uint64_t k=0; k<bitsPerChunk; k++) g.dbl(r,r);
+        g.add(r, r, chunkResults[j]);
+    }
+
+    delete[] chunkResults;
+}
+
 template <typename Curve>
 void ParallelMultiexp<Curve>::multiexp(typename Curve::Point &r, typename Curve::PointAffine *_bases, uint8_t* _scalars, uint64_t _scalarSize, uint64_t _n, uint64_t _nThreads) {
     nThreads = _nThreads==0 ? omp_get_max_threads() : _nThreads;
@@ -133,6 +464,12 @@ void ParallelMultiexp<Curve>::multiexp(typename Curve::Point &r, typename Curve:
     if (bitsPerChunk > PME2_MAX_CHUNK_SIZE_BITS) bitsPerChunk = PME2_MAX_CHUNK_SIZE_BITS;
     if (bitsPerChunk < PME2_MIN_CHUNK_SIZE_BITS) bitsPerChunk = PME2_MIN_CHUNK_SIZE_BITS;
     nChunks = ((scalarSize*8 - 1 ) / bitsPerChunk)+1;
+
+    if (batchAffine && (n >= PME2_BATCH_AFFINE_MIN_N) && (n < (1ULL << 31))) {
+        multiexpBatchAffine(r);
+        return;
+    }
+
     accsPerChunk = 1 << bitsPerChunk;  // In the chunks last bit is always zero.
 
     typename Curve::Point *chunkResults = new typename Curve::Point[nChunks];
@@ -213,3 +550,139 @@ void ParallelMultiexp<Curve>::multiexp(typename Curve::Point &r,
 
     delete[] chunkResults;
 }
+
+
+template <typename Curve>
+MultiexpFixedBases<Curve>::MultiexpFixedBases(Curve &g, typename Curve::PointAffine *_bases, uint64_t _n, uint64_t _scalarSize, uint64_t maxMemory) {
+    bases = _bases;
+    n = _n;
+    scalarSize = _scalarSize;
+    tables = NULL;
+
+    // Same chunk size that the multiexp of n bases uses
+    bitsPerChunk = n < 2*PME2_PACK_FACTOR ? 0 : log2((uint32_t)(n / PME2_PACK_FACTOR));
+    if (bitsPerChunk > PME2_MAX_CHUNK_SIZE_BITS) bitsPerChunk = PME2_MAX_CHUNK_SIZE_BITS;
+    if (bitsPerChunk < PME2_MIN_CHUNK_SIZE_BITS) bitsPerChunk = PME2_MIN_CHUNK_SIZE_BITS;
+    nChunks = ((scalarSize*8 - 1 ) / bitsPerChunk)+1;
+
+    uint64_t tableSize = n*sizeof(typename Curve::PointAffine);
+    nTables = tableSize == 0 ? 1 : 1 + maxMemory / tableSize;
+    if (nTables > nChunks) nTables = nChunks;
+    nRounds = ((nChunks - 1) / nTables) + 1;
+    // Use the minimum number of tables that gives this number of rounds
+    nTables = ((nChunks - 1) / nRounds) + 1;
+    if (nTables == 1) return;
+
+    tables = new typename Curve::PointAffine[(nTables - 1)*n];
+    uint64_t shift = nRounds*bitsPerChunk;
+
+    // Every table is the previous one doubled shift times; the conversion to affine of every block of points
+    // shares a single inversion
+    #pragma omp parallel for
+    for (uint64_t b=0; b<n; b+=PME2_FIXED_BASES_BLOCK_SIZE) {
+        uint64_t blockSize = n - b < PME2_FIXED_BASES_BLOCK_SIZE ? n - b : PME2_FIXED_BASES_BLOCK_SIZE;
+        std::vector<typename Curve::Point> points(blockSize);
+        std::vector<typename Curve::FieldElement> acc(blockSize);
+        for (uint64_t i=0; i<blockSize; i++) {
+            g.copy(points[i], bases[b+i]);
+        }
+        for (uint64_t j=1; j<nTables; j++) {
+            typename Curve::PointAffine *t = &tables[(j-1)*n + b];
+            for (uint64_t i=0; i<blockSize; i++) {
+                for (uint64_t k=0; k<shift; k++) g.dbl(points[i], points[i]);
+            }
+
+            // Batch inversion of zz*zzz of the non zero points
+            typename Curve::FieldElement aux;
+            g.F.copy(aux, g.F.one());
+            for (uint64_t i=0; i<blockSize; i++) {
+                g.F.copy(acc[i], aux);
+                if (g.isZero(points[i])) continue;
+                typename Curve::FieldElement zz3;
+                g.F.mul(zz3, points[i].zz, points[i].zzz);
+                g.F.mul(aux, aux, zz3);
+            }
+            g.F.inv(aux, aux);
+            for (uint64_t i=blockSize; i-- > 0;) {
+                if (g.isZero(points[i])) {
+                    g.F.copy(t[i].x, g.F.zero());
+                    g.F.copy(t[i].y, g.F.zero());
+                    continue;
+                }
+                typename Curve::FieldElement inv, zz3;
+                g.F.mul(inv, aux, acc[i]); // 1/(zz*zzz)
+                g.F.mul(zz3, points[i].zz, points[i].zzz);
+                g.F.mul(aux, aux, zz3);
+                typename Curve::FieldElement invZz, invZzz;
+                g.F.mul(invZz, inv, points[i].zzz);
+                g.F.mul(invZzz, inv, points[i].zz);
+                g.F.mul(t[i].x, points[i].x, invZz);
+                g.F.mul(t[i].y, points[i].y, invZzz);
+            }
+        }
+    }
+}
+
+template <typename Curve>
+void ParallelMultiexp<Curve>::multiexp(typename Curve::Point &r, MultiexpFixedBases<Curve> &fixedBases, uint8_t* _scalars, uint64_t _scalarSize, uint64_t _n, uint64_t _nThreads) {
+    assert(_n <= fixedBases.n);
+    assert(_scalarSize == fixedBases.scalarSize);
+    nThreads = _nThreads==0 ? omp_get_max_threads() : _nThreads;
+    bases = fixedBases.bases;
+    scalars = _scalars;
+    scalarSize = _scalarSize;
+    n = _n;
+
+    ThreadLimit threadLimit (nThreads);
+
+    if (n==0) {
+        g.copy(r, g.zero());
+        return;
+    }
+    if (n==1) {
+        g.mulByScalar(r, bases[0], scalars, scalarSize);
+        return;
+    }
+    bitsPerChunk = fixedBases.bitsPerChunk;
+    nChunks = fixedBases.nChunks;
+
+    typename Curve::Point *roundResults = new typename Curve::Point[fixedBases.nRounds];
+
+    // The tables have no room for a carry chunk, so signed chunks are only used if no scalar needs it
+    uint64_t nPoints = fixedBases.nTables*n;
+    if (batchAffine && (n >= PME2_BATCH_AFFINE_MIN_N) && (nPoints < (1ULL << 31)) && !needsCarryChunk()) {
+        accsPerChunk = (1 << (bitsPerChunk-1)) + 1;
+        accs = new PaddedPoint[accsPerChunk];
+        for (uint64_t i=0; i<accsPerChunk; i++) g.copy(accs[i].p, g.zero());
+
+        for (uint64_t i=0; i<fixedBases.nRounds; i++) {
+            accumulateBatchAffine(nPoints,
+                [&](uint64_t k) -> typename Curve::PointAffine & { return fixedBases.table(k / n)[k % n]; },
+                [&](uint64_t k) -> int64_t {
+                    uint64_t idChunk = (k / n)*fixedBases.nRounds + i;
+                    return (idChunk >= nChunks) || g.isZero(bases[k % n]) ? 0 : getSignedChunk(k % n, idChunk);
+                });
+            reduceSigned(roundResults[i]);
+        }
+    } else {
+        accsPerChunk = 1 << bitsPerChunk;  // In the chunks last bit is always zero.
+        accs = new PaddedPoint[nThreads*accsPerChunk];
+        initAccs();
+
+        for (uint64_t i=0; i<fixedBases.nRounds; i++) {
+            processRound(fixedBases, i);
+            packThreads();
+            reduce(roundResults[i], bitsPerChunk);
+        }
+    }
+
+    delete[] accs;
+
+    g.copy(r, roundResults[fixedBases.nRounds-1]);
+    for  (int j=fixedBases.nRounds-2; j>=0; j--) {
+        for (uint64_t k=0; k<bitsPerChunk; k++) g.dbl(r,r);
+        g.add(r, r, roundResults[j]);
+    }
+
+    delete[] roundResults;
+}
@@ -4,6 +4,32 @@
 #define PME2_PACK_FACTOR 2
 #define PME2_MAX_CHUNK_SIZE_BITS 16
 #define PME2_MIN_CHUNK_SIZE_BITS 2
+#define PME2_FIXED_BASES_BLOCK_SIZE 1024 // Points converted to affine with a single inversion when precomputing fixed bases
+#define PME2_BATCH_AFFINE_MIN_N 4096 // Minimum number of points to accumulate the buckets in batch affine mode
+#define PME2_BATCH_AFFINE_GROUP_SIZE 2048 // Points added in affine form sharing one inversion per tree level
+
+// Multiples of a set of bases that do not change between multiexps (e.g. zkey points), precomputed once.
+// Table j holds 2^(j*nRounds*bitsPerChunk) times every base (table 0 are the bases themselves), so that the
+// chunks j*nRounds + g of all the tables are accumulated in the same buckets, and a multiexp only needs nRounds
+// bucket reductions instead of one per chunk. nTables is limited by the memory budget
+template <typename Curve>
+class MultiexpFixedBases {
+public:
+    typename Curve::PointAffine *bases;
+    uint64_t n;
+    uint64_t scalarSize;
+    uint64_t bitsPerChunk;
+    uint64_t nChunks;
+    uint64_t nTables;
+    uint64_t nRounds;
+    typename Curve::PointAffine *tables; // Tables 1..nTables-1, n points each
+
+    MultiexpFixedBases(Curve &g, typename Curve::PointAffine *_bases, uint64_t _n, uint64_t _scalarSize, uint64_t maxMemory);
+    ~MultiexpFixedBases() { delete[] tables; }
+
+    typename Curve::PointAffine *table(uint64_t j) { return j == 0 ? bases : &tables[(j-1)*n]; }
+    uint64_t memory() { return (nTables - 1)*n*sizeof(typename Curve::PointAffine); }
+};
 
 template <typename Curve>
 class ParallelMultiexp {
@@ -29,11 +55,24 @@ class ParallelMultiexp {
     uint64_t getChunk(uint64_t scalarIdx, uint64_t chunkIdx);
     void processChunk(uint64_t idxChunk);
     void processChunk(uint64_t idxChunk, uint64_t nx, uint64_t x[]);
+    void processRound(MultiexpFixedBases<Curve> &fixedBases, uint64_t idxRound);
     void packThreads();
     void reduce(typename Curve::Point &res, uint64_t nBits);
 
+    // Batch affine mode: scalars are recoded in signed chunks in [-2^(bitsPerChunk-1), 2^(bitsPerChunk-1)], so only
+    // half of the buckets are needed, and the points of every bucket are added in affine form, sharing one field
+    // inversion (Montgomery's trick) among all the independent additions of a group of points
+    bool batchAffine;
+    uint64_t getBit(uint64_t scalarIdx, uint64_t bitIdx);
+    int64_t getSignedChunk(uint64_t scalarIdx, uint64_t chunkIdx);
+    bool needsCarryChunk();
+    template <typename GetPoint, typename GetChunk>
+    void accumulateBatchAffine(uint64_t nPoints, GetPoint getPoint, GetChunk getChunkValue);
+    void reduceSigned(typename Curve::Point &res);
+    void multiexpBatchAffine(typename Curve::Point &r);
+
 public:
-    ParallelMultiexp(Curve &_g): g(_g) {}
+    ParallelMultiexp(Curve &_g, bool _batchAffine = true): g(_g), batchAffine(_batchAffine) {}
     void multiexp(typename Curve::Point &r, typename Curve::PointAffine *_bases, uint8_t* _scalars, uint64_t _scalarSize, uint64_t _n, uint64_t _nThreads=0);
     void multiexp(typename Curve::Point &r,
                   typename Curve::PointAffine *_bases,
@@ -43,6 +82,8 @@ public:
                   uint64_t nx,
                   uint64_t x[],
                   uint64_t _nThreads=0);
+    // Multiexp of the first _n precomputed fixed bases
+    void multiexp(typename Curve::Point &r, MultiexpFixedBases<Curve> &fixedBases, uint8_t* _scalars, uint64_t _scalarSize, uint64_t _n, uint64_t _nThreads=0);
 
 };
 
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <thread>
 #include "database.hpp"
+#include "witness_db.hpp"
 #include "config.hpp"
 #include "scalar.hpp"
 #include "zkassert.hpp"
@@ -14,6 +15,7 @@
 #include "exit_process.hpp"
 #include "zkmax.hpp"
 #include "hashdb_remote.hpp"
+#include "metrics.hpp"
 
 #ifdef DATABASE_USE_CACHE
 
@@ -105,10 +107,42 @@ void Database::init(void)
         useRemoteDB = false;
     }
 
+#ifdef DATABASE_USE_CACHE
+    // Export the cache statistics when the metrics are scraped
+    metrics.addCollector(databaseCollectMetrics, NULL);
+#endif
+
     // Mark the database as initialized
     bInitialized = true;
 }
 
+#ifdef DATABASE_USE_CACHE
+void databaseCollectMetrics (void * pArg)
+{
+    static uint64_t metricCacheAttempts = metrics.registerGauge("zkprover_hashdb_cache_attempts", "cache=\"nodes\"", "Database cache find attempts");
+    static uint64_t metricCacheHits = metrics.registerGauge("zkprover_hashdb_cache_hits", "cache=\"nodes\"", "Database cache find hits");
+    static uint64_t metricCacheSize = metrics.registerGauge("zkprover_hashdb_cache_size_bytes", "cache=\"nodes\"", "Database cache current size, in bytes");
+    static uint64_t metricProgramCacheAttempts = metrics.registerGauge("zkprover_hashdb_cache_attempts", "cache=\"program\"");
+    static uint64_t metricProgramCacheHits = metrics.registerGauge("zkprover_hashdb_cache_hits", "cache=\"program\"");
+    static uint64_t metricProgramCacheSize = metrics.registerGauge("zkprover_hashdb_cache_size_bytes", "cache=\"program\"");
+
+    if (Database::useAssociativeCache)
+    {
+        metrics.set(metricCacheAttempts, Database::dbMTACache.getAttempts());
+        metrics.set(metricCacheHits, Database::dbMTACache.getHits());
+    }
+    else
+    {
+        metrics.set(metricCacheAttempts, Database::dbMTCache.getAttempts());
+        metrics.set(metricCacheHits, Database::dbMTCache.getHits());
+        metrics.set(metricCacheSize, Database::dbMTCache.getCurrentSize());
+    }
+    metrics.set(metricProgramCacheAttempts, Database::dbProgramCache.getAttempts());
+    metrics.set(metricProgramCacheHits, Database::dbProgramCache.getHits());
+    metrics.set(metricProgramCacheSize, Database::dbProgramCache.getCurrentSize());
+}
+#endif
+
 zkresult Database::read(const string &_key, Goldilocks::Element (&vkey)[4], vector<Goldilocks::Element> &value, DatabaseMap *dbReadLog, const bool update,  bool *keys, uint64_t level)
 {
     // Check that it has been initialized before
@@ -121,6 +155,14 @@ zkresult Database::read(const string &_key, Goldilocks::Element (&vkey)[4], vect
     struct timeval t;
     if (dbReadLog != NULL) gettimeofday(&t, NULL);
 
+    // Metrics of the reads, by source
+    static uint64_t metricReadsCache = metrics.registerCounter("zkprover_hashdb_reads_total", "source=\"cache\"", "Database node reads, by source");
+    static uint64_t metricReadsMultiWrite = metrics.registerCounter("zkprover_hashdb_reads_total", "source=\"multiwrite\"");
+    static uint64_t metricReadsWitness = metrics.registerCounter("zkprover_hashdb_reads_total", "source=\"witness\"");
+    static uint64_t metricReadsTree = metrics.registerCounter("zkprover_hashdb_reads_total", "source=\"tree\"");
+    static uint64_t metricReadsRemote = metrics.registerCounter("zkprover_hashdb_reads_total", "source=\"remote\"");
+    static uint64_t metricRemoteReadTime = metrics.registerHistogram("zkprover_hashdb_remote_read_us", "", "Time spent reading a node from the remote database, including retries, in us");
+
     zkresult r = ZKR_UNSPECIFIED;
 
     // Normalize key format
@@ -132,11 +174,13 @@ zkresult Database::read(const string &_key, Goldilocks::Element (&vkey)[4], vect
     if(usingAssociativeCache() && dbMTACache.findKey(vkey,value)){
 
         if (dbReadLog != NULL) dbReadLog->add(key, value, true, TimeDiff(t));
+        metrics.add(metricReadsCache);
         r = ZKR_SUCCESS;
 
     } else if( dbMTCache.enabled() && dbMTCache.find(key, value)){
         
         if (dbReadLog != NULL) dbReadLog->add(key, value, true, TimeDiff(t));
+        metrics.add(metricReadsCache);
         r = ZKR_SUCCESS;
     }
     else
@@ -146,6 +190,7 @@ zkresult Database::read(const string &_key, Goldilocks::Element (&vkey)[4], vect
     {
         // Add to the read log
         if (dbReadLog != NULL) dbReadLog->add(key, value, true, TimeDiff(t));
+        metrics.add(metricReadsMultiWrite);
 
 #ifdef DATABASE_USE_CACHE
         // Store it locally to avoid any future remote access for this key
@@ -158,9 +203,20 @@ zkresult Database::read(const string &_key, Goldilocks::Element (&vkey)[4], vect
 #endif
         r = ZKR_SUCCESS;
     }
+    // If the request carries a witness database, read it from there, without caching it
+    else if ((dbReadLog != NULL) && (dbReadLog->getWitnessDB() != NULL) && dbReadLog->getWitnessDB()->read(vkey, value))
+    {
+        // Add to the read log
+        dbReadLog->add(key, value, true, TimeDiff(t));
+        metrics.add(metricReadsWitness);
+
+        r = ZKR_SUCCESS;
+    }
     // If get tree is configured, read the tree from the branch (key hash) to the leaf (keys since level)
     else if (useRemoteDB && config.dbGetTree && (keys != NULL))
     {
+        metrics.add(metricReadsTree);
+
         // Get the tree
         uint64_t numberOfFields;
         r = readTreeRemote(key, keys, level, numberOfFields);
@@ -226,6 +282,9 @@ zkresult Database::read(const string &_key, Goldilocks::Element (&vkey)[4], vect
         }*/
 
         // Otherwise, read it remotelly, up to two times
+        metrics.add(metricReadsRemote);
+        struct timeval tRemote;
+        gettimeofday(&tRemote, NULL);
         string sData;
         r = readRemote(false, key, sData);
         if ( (r != ZKR_SUCCESS) && (config.dbReadRetryDelay > 0) )
@@ -244,6 +303,7 @@ zkresult Database::read(const string &_key, Goldilocks::Element (&vkey)[4], vect
                 zklog.warning("Database::read() retried readRemote() after dbReadRetryDelay=" + to_string(config.dbReadRetryDelay) + "us and failed with error=" + zkresult2string(r) + " i=" + to_string(i));
             }
         }
+        metrics.observe(metricRemoteReadTime, TimeDiff(tRemote));
         if (r == ZKR_SUCCESS)
         {
             string2fea(fr, sData, value);
@@ -1234,7 +1294,15 @@ zkresult Database::getProgram(const string &_key, vector<uint8_t> &data, Databas
     }
     else
 #endif
-    if (useRemoteDB)
+    // If the request carries a witness database, read it from there, without caching it
+    if ((dbReadLog != NULL) && (dbReadLog->getWitnessDB() != NULL) && dbReadLog->getWitnessDB()->getProgram(key, data))
+    {
+        // Add to the read log
+        dbReadLog->add(key, data, true, TimeDiff(t));
+
+        r = ZKR_SUCCESS;
+    }
+    else if (useRemoteDB)
     {
         // Otherwise, read it remotelly
         string sData;
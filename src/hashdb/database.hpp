@@ -132,4 +132,9 @@ void *dbCacheSynchThread(void *arg);
 
 void loadDb2MemCache(const Config &config);
 
+#ifdef DATABASE_USE_CACHE
+// Metrics collector of the cache statistics
+void databaseCollectMetrics(void *pArg);
+#endif
+
 #endif
\ No newline at end of file
@@ -43,6 +43,8 @@ class DatabaseMTAssociativeCache
         inline bool enabled() const { return (log2IndexesSize > 0); };
         inline uint32_t getCacheSize()  const { return cacheSize; };
         inline uint32_t getIndexesSize() const { return indexesSize; };
+        inline uint64_t getAttempts() const { return attempts; };
+        inline uint64_t getHits() const { return hits; };
         inline void clear(){
             if(enabled()){
                 postConstruct(log2IndexesSize, log2CacheSize, name);                
@@ -51,6 +51,8 @@ public:
 public:
     uint64_t getMaxSize(void) { return maxSize; };
     uint64_t getCurrentSize(void) { return currentSize; };
+    uint64_t getAttempts(void) { return attempts; };
+    uint64_t getHits(void) { return hits; };
     bool enabled() {return (maxSize > 0);};
     void setMaxSize(int64_t size) { maxSize = size; }; // size is in bytes, 0 = no cache
     void setName(const char * pChar) { name = pChar; };
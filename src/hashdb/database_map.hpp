@@ -10,6 +10,7 @@ using namespace std;
 using json = nlohmann::json;
 
 class DatabaseMap;
+class WitnessDB;
 
 
 class DatabaseMap
@@ -34,6 +35,7 @@ private:
     bool saveKeys = false;
     onChangeCallbackFunctionPtr cbFunction = NULL;
     void *cbInstance = NULL;
+    const WitnessDB *pWitnessDB = NULL; // Read-only witness nodes and programs source of the request, if any
 
     uint64_t mtCachedTimes;
     uint64_t mtCachedTime;
@@ -114,6 +116,8 @@ public:
     void setOnChangeCallback(void *instance, onChangeCallbackFunctionPtr function);
     inline void setSaveKeys(const bool saveKeys_){ saveKeys = saveKeys_; };
     inline bool getSaveKeys(){ return saveKeys; };
+    inline void setWitnessDB(const WitnessDB *pWitnessDB_){ pWitnessDB = pWitnessDB_; };
+    inline const WitnessDB * getWitnessDB(){ return pWitnessDB; };
     void print(void);
 };
 
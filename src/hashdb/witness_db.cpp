@@ -0,0 +1,453 @@
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include "witness_db.hpp"
+#include "scalar.hpp"
+#include "utils.hpp"
+#include "zklog.hpp"
+
+static inline uint64_t readU64 (const uint8_t * pData)
+{
+    uint64_t value;
+    memcpy(&value, pData, 8);
+    return value;
+}
+
+static inline void appendU64 (string &output, uint64_t value)
+{
+    output.append((const char *)&value, 8);
+}
+
+// Converts a key hash string (up to 64 hex chars, with or without 0x) into a 32B big endian key
+static bool hexKey2binary (const string &key, uint8_t (&binaryKey)[WITNESS_DB_KEY_SIZE])
+{
+    uint64_t start = ((key.size() >= 2) && (key[0] == '0') && ((key[1] == 'x') || (key[1] == 'X'))) ? 2 : 0;
+    uint64_t length = key.size() - start;
+    if (length > 2*WITNESS_DB_KEY_SIZE)
+    {
+        return false;
+    }
+
+    // Left-pad with zeros up to 64 hex chars
+    memset(binaryKey, 0, WITNESS_DB_KEY_SIZE);
+    for (uint64_t i=0; i<length; i++)
+    {
+        char c = key[start + i];
+        if (!isxdigit(c))
+        {
+            return false;
+        }
+        uint64_t nibble = 2*WITNESS_DB_KEY_SIZE - length + i;
+        binaryKey[nibble/2] |= (nibble & 1) ? char2byte(c) : (char2byte(c) << 4);
+    }
+    return true;
+}
+
+// Binary search of a key in an array of records sorted by key; returns NULL if not present
+static const uint8_t * findRecord (const uint8_t * pRecords, uint64_t nRecords, uint64_t recordSize, const uint8_t * pKey)
+{
+    uint64_t low = 0;
+    uint64_t high = nRecords;
+    while (low < high)
+    {
+        uint64_t middle = low + (high - low)/2;
+        const uint8_t * pRecord = pRecords + middle*recordSize;
+        int result = memcmp(pRecord, pKey, WITNESS_DB_KEY_SIZE);
+        if (result == 0)
+        {
+            return pRecord;
+        }
+        if (result < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return NULL;
+}
+
+WitnessDB::WitnessDB () :
+    pData(NULL),
+    dataSize(0),
+    pMappedFile(NULL),
+    nNodes(0),
+    nPrograms(0),
+    nodeValuesSize(0),
+    programDataSize(0),
+    pNodes(NULL),
+    pPrograms(NULL),
+    pNodeValues(NULL),
+    pProgramData(NULL)
+{
+}
+
+WitnessDB::~WitnessDB ()
+{
+    close();
+}
+
+void WitnessDB::close (void)
+{
+    if (pMappedFile != NULL)
+    {
+        unmapFile(pMappedFile, dataSize);
+        pMappedFile = NULL;
+    }
+    buffer.clear();
+    buffer.shrink_to_fit();
+    pData = NULL;
+    dataSize = 0;
+    nNodes = 0;
+    nPrograms = 0;
+    nodeValuesSize = 0;
+    programDataSize = 0;
+    pNodes = NULL;
+    pPrograms = NULL;
+    pNodeValues = NULL;
+    pProgramData = NULL;
+}
+
+zkresult WitnessDB::open (const string &fileName)
+{
+    close();
+
+    if (!fileExists(fileName))
+    {
+        zklog.error("WitnessDB::open() could not find file " + fileName);
+        return ZKR_DB_ERROR;
+    }
+    uint64_t size = fileSize(fileName);
+    if (size < WITNESS_DB_HEADER_SIZE)
+    {
+        zklog.error("WitnessDB::open() found too small file " + fileName + " size=" + to_string(size));
+        return ZKR_DB_ERROR;
+    }
+
+    pMappedFile = mapFile(fileName, size, false);
+    pData = (const uint8_t *)pMappedFile;
+    dataSize = size;
+
+    zkresult zkr = parse();
+    if (zkr != ZKR_SUCCESS)
+    {
+        zklog.error("WitnessDB::open() failed parsing file " + fileName);
+        close();
+    }
+    return zkr;
+}
+
+zkresult WitnessDB::build (const DatabaseMap::MTMap &db, const DatabaseMap::ProgramMap &programs)
+{
+    close();
+
+    zkresult zkr = serialize(db, programs, buffer);
+    if (zkr != ZKR_SUCCESS)
+    {
+        close();
+        return zkr;
+    }
+    pData = (const uint8_t *)buffer.data();
+    dataSize = buffer.size();
+
+    zkr = parse();
+    if (zkr != ZKR_SUCCESS)
+    {
+        close();
+    }
+    return zkr;
+}
+
+zkresult WitnessDB::save (const string &fileName) const
+{
+    ofstream outfile(fileName, ios::out | ios::binary | ios::trunc);
+    if (!outfile.is_open())
+    {
+        zklog.error("WitnessDB::save() failed opening file " + fileName);
+        return ZKR_DB_ERROR;
+    }
+    outfile.write((const char *)pData, dataSize);
+    outfile.close();
+    if (outfile.fail())
+    {
+        zklog.error("WitnessDB::save() failed writing file " + fileName);
+        return ZKR_DB_ERROR;
+    }
+    return ZKR_SUCCESS;
+}
+
+zkresult WitnessDB::parse (void)
+{
+    // Check the header
+    if ((dataSize < WITNESS_DB_HEADER_SIZE) || (memcmp(pData, WITNESS_DB_MAGIC, 8) != 0))
+    {
+        zklog.error("WitnessDB::parse() found an invalid header");
+        return ZKR_DB_ERROR;
+    }
+    nNodes = readU64(pData + 8);
+    nPrograms = readU64(pData + 16);
+    nodeValuesSize = readU64(pData + 24);
+    programDataSize = readU64(pData + 32);
+
+    // Check the sizes, avoiding overflows
+    uint64_t remaining = dataSize - WITNESS_DB_HEADER_SIZE;
+    if (nNodes > remaining/WITNESS_DB_NODE_SIZE)
+    {
+        zklog.error("WitnessDB::parse() found too many nodes=" + to_string(nNodes) + " dataSize=" + to_string(dataSize));
+        return ZKR_DB_ERROR;
+    }
+    remaining -= nNodes*WITNESS_DB_NODE_SIZE;
+    if (nPrograms > remaining/WITNESS_DB_PROGRAM_SIZE)
+    {
+        zklog.error("WitnessDB::parse() found too many programs=" + to_string(nPrograms) + " dataSize=" + to_string(dataSize));
+        return ZKR_DB_ERROR;
+    }
+    remaining -= nPrograms*WITNESS_DB_PROGRAM_SIZE;
+    if (nodeValuesSize > remaining/8)
+    {
+        zklog.error("WitnessDB::parse() found too many node values=" + to_string(nodeValuesSize) + " dataSize=" + to_string(dataSize));
+        return ZKR_DB_ERROR;
+    }
+    remaining -= nodeValuesSize*8;
+    if (programDataSize != remaining)
+    {
+        zklog.error("WitnessDB::parse() found programDataSize=" + to_string(programDataSize) + " != remaining=" + to_string(remaining));
+        return ZKR_DB_ERROR;
+    }
+    pNodes = pData + WITNESS_DB_HEADER_SIZE;
+    pPrograms = pNodes + nNodes*WITNESS_DB_NODE_SIZE;
+    pNodeValues = pPrograms + nPrograms*WITNESS_DB_PROGRAM_SIZE;
+    pProgramData = pNodeValues + nodeValuesSize*8;
+
+    // Check that the nodes are sorted by key without duplicates, and within the node values
+    for (uint64_t i=0; i<nNodes; i++)
+    {
+        const uint8_t * pNode = pNodes + i*WITNESS_DB_NODE_SIZE;
+        if ((i > 0) && (memcmp(pNode - WITNESS_DB_NODE_SIZE, pNode, WITNESS_DB_KEY_SIZE) >= 0))
+        {
+            zklog.error("WitnessDB::parse() found unsorted node i=" + to_string(i));
+            return ZKR_DB_ERROR;
+        }
+        uint64_t offset = readU64(pNode + WITNESS_DB_KEY_SIZE);
+        uint64_t size = readU64(pNode + WITNESS_DB_KEY_SIZE + 8);
+        if ((size > nodeValuesSize) || (offset > nodeValuesSize - size))
+        {
+            zklog.error("WitnessDB::parse() found node i=" + to_string(i) + " out of range offset=" + to_string(offset) + " size=" + to_string(size));
+            return ZKR_DB_ERROR;
+        }
+    }
+
+    // Check that the node values are valid field elements
+    for (uint64_t i=0; i<nodeValuesSize; i++)
+    {
+        if (readU64(pNodeValues + i*8) >= GOLDILOCKS_PRIME)
+        {
+            zklog.error("WitnessDB::parse() found invalid field element in node values i=" + to_string(i));
+            return ZKR_DB_ERROR;
+        }
+    }
+
+    // Check that the programs are sorted by key without duplicates, and within the program data
+    for (uint64_t i=0; i<nPrograms; i++)
+    {
+        const uint8_t * pProgram = pPrograms + i*WITNESS_DB_PROGRAM_SIZE;
+        if ((i > 0) && (memcmp(pProgram - WITNESS_DB_PROGRAM_SIZE, pProgram, WITNESS_DB_KEY_SIZE) >= 0))
+        {
+            zklog.error("WitnessDB::parse() found unsorted program i=" + to_string(i));
+            return ZKR_DB_ERROR;
+        }
+        uint64_t offset = readU64(pProgram + WITNESS_DB_KEY_SIZE);
+        uint64_t size = readU64(pProgram + WITNESS_DB_KEY_SIZE + 8);
+        if ((size > programDataSize) || (offset > programDataSize - size))
+        {
+            zklog.error("WitnessDB::parse() found program i=" + to_string(i) + " out of range offset=" + to_string(offset) + " size=" + to_string(size));
+            return ZKR_DB_ERROR;
+        }
+    }
+
+    return ZKR_SUCCESS;
+}
+
+bool WitnessDB::read (const Goldilocks::Element (&key)[4], vector<Goldilocks::Element> &value) const
+{
+    // Build the big endian key, as in its hash string
+    uint8_t binaryKey[WITNESS_DB_KEY_SIZE];
+    for (uint64_t i=0; i<4; i++)
+    {
+        uint64_t fe = Goldilocks::toU64(key[3 - i]);
+        for (uint64_t j=0; j<8; j++)
+        {
+            binaryKey[i*8 + j] = fe >> (56 - j*8);
+        }
+    }
+
+    const uint8_t * pNode = findRecord(pNodes, nNodes, WITNESS_DB_NODE_SIZE, binaryKey);
+    if (pNode == NULL)
+    {
+        return false;
+    }
+    const uint8_t * pValue = pNodeValues + readU64(pNode + WITNESS_DB_KEY_SIZE)*8;
+    uint64_t size = readU64(pNode + WITNESS_DB_KEY_SIZE + 8);
+    value.resize(size);
+    for (uint64_t i=0; i<size; i++)
+    {
+        value[i] = Goldilocks::fromU64(readU64(pValue + i*8));
+    }
+    return true;
+}
+
+bool WitnessDB::getProgram (const string &key, vector<uint8_t> &data) const
+{
+    uint8_t binaryKey[WITNESS_DB_KEY_SIZE];
+    if (!hexKey2binary(key, binaryKey))
+    {
+        return false;
+    }
+    const uint8_t * pProgram = findRecord(pPrograms, nPrograms, WITNESS_DB_PROGRAM_SIZE, binaryKey);
+    if (pProgram == NULL)
+    {
+        return false;
+    }
+    const uint8_t * pBytecode = pProgramData + readU64(pProgram + WITNESS_DB_KEY_SIZE);
+    data.assign(pBytecode, pBytecode + readU64(pProgram + WITNESS_DB_KEY_SIZE + 8));
+    return true;
+}
+
+void WitnessDB::toMaps (DatabaseMap::MTMap &db, DatabaseMap::ProgramMap &programs) const
+{
+    for (uint64_t i=0; i<nNodes; i++)
+    {
+        const uint8_t * pNode = pNodes + i*WITNESS_DB_NODE_SIZE;
+        const uint8_t * pValue = pNodeValues + readU64(pNode + WITNESS_DB_KEY_SIZE)*8;
+        uint64_t size = readU64(pNode + WITNESS_DB_KEY_SIZE + 8);
+        vector<Goldilocks::Element> &value = db[ba2string(pNode, WITNESS_DB_KEY_SIZE)];
+        value.resize(size);
+        for (uint64_t j=0; j<size; j++)
+        {
+            value[j] = Goldilocks::fromU64(readU64(pValue + j*8));
+        }
+    }
+    for (uint64_t i=0; i<nPrograms; i++)
+    {
+        const uint8_t * pProgram = pPrograms + i*WITNESS_DB_PROGRAM_SIZE;
+        const uint8_t * pBytecode = pProgramData + readU64(pProgram + WITNESS_DB_KEY_SIZE);
+        programs[ba2string(pProgram, WITNESS_DB_KEY_SIZE)].assign(pBytecode, pBytecode + readU64(pProgram + WITNESS_DB_KEY_SIZE + 8));
+    }
+}
+
+class WitnessDBSortKey
+{
+public:
+    uint8_t key[WITNESS_DB_KEY_SIZE];
+    const void * pValue; // vector<Goldilocks::Element> for nodes, vector<uint8_t> for programs
+    bool operator< (const WitnessDBSortKey &other) const { return memcmp(key, other.key, WITNESS_DB_KEY_SIZE) < 0; };
+};
+
+zkresult WitnessDB::serialize (const DatabaseMap::MTMap &db, const DatabaseMap::ProgramMap &programs, string &output)
+{
+    // Convert and sort the node keys
+    vector<WitnessDBSortKey> nodeKeys;
+    nodeKeys.reserve(db.size());
+    uint64_t nodeValuesSize = 0;
+    for (DatabaseMap::MTMap::const_iterator it = db.begin(); it != db.end(); it++)
+    {
+        WitnessDBSortKey sortKey;
+        if (!hexKey2binary(it->first, sortKey.key))
+        {
+            zklog.error("WitnessDB::serialize() found invalid node key=" + it->first);
+            return ZKR_DB_ERROR;
+        }
+        sortKey.pValue = &it->second;
+        nodeKeys.emplace_back(sortKey);
+        nodeValuesSize += it->second.size();
+    }
+    sort(nodeKeys.begin(), nodeKeys.end());
+
+    // Convert and sort the program keys
+    vector<WitnessDBSortKey> programKeys;
+    programKeys.reserve(programs.size());
+    uint64_t programDataSize = 0;
+    for (DatabaseMap::ProgramMap::const_iterator it = programs.begin(); it != programs.end(); it++)
+    {
+        WitnessDBSortKey sortKey;
+        if (!hexKey2binary(it->first, sortKey.key))
+        {
+            zklog.error("WitnessDB::serialize() found invalid program key=" + it->first);
+            return ZKR_DB_ERROR;
+        }
+        sortKey.pValue = &it->second;
+        programKeys.emplace_back(sortKey);
+        programDataSize += it->second.size();
+    }
+    sort(programKeys.begin(), programKeys.end());
+
+    // Keys that only differ in format, e.g. case or 0x prefix, are the same key
+    for (uint64_t i=1; i<nodeKeys.size(); i++)
+    {
+        if (memcmp(nodeKeys[i-1].key, nodeKeys[i].key, WITNESS_DB_KEY_SIZE) == 0)
+        {
+            zklog.error("WitnessDB::serialize() found duplicated node key=" + ba2string(nodeKeys[i].key, WITNESS_DB_KEY_SIZE));
+            return ZKR_DB_ERROR;
+        }
+    }
+    for (uint64_t i=1; i<programKeys.size(); i++)
+    {
+        if (memcmp(programKeys[i-1].key, programKeys[i].key, WITNESS_DB_KEY_SIZE) == 0)
+        {
+            zklog.error("WitnessDB::serialize() found duplicated program key=" + ba2string(programKeys[i].key, WITNESS_DB_KEY_SIZE));
+            return ZKR_DB_ERROR;
+        }
+    }
+
+    // Header
+    output.clear();
+    output.reserve(WITNESS_DB_HEADER_SIZE + nodeKeys.size()*WITNESS_DB_NODE_SIZE + programKeys.size()*WITNESS_DB_PROGRAM_SIZE + nodeValuesSize*8 + programDataSize);
+    output.append(WITNESS_DB_MAGIC, 8);
+    appendU64(output, nodeKeys.size());
+    appendU64(output, programKeys.size());
+    appendU64(output, nodeValuesSize);
+    appendU64(output, programDataSize);
+
+    // Node index
+    uint64_t offset = 0;
+    for (uint64_t i=0; i<nodeKeys.size(); i++)
+    {
+        const vector<Goldilocks::Element> &value = *(const vector<Goldilocks::Element> *)nodeKeys[i].pValue;
+        output.append((const char *)nodeKeys[i].key, WITNESS_DB_KEY_SIZE);
+        appendU64(output, offset);
+        appendU64(output, value.size());
+        offset += value.size();
+    }
+
+    // Program index
+    offset = 0;
+    for (uint64_t i=0; i<programKeys.size(); i++)
+    {
+        const vector<uint8_t> &bytecode = *(const vector<uint8_t> *)programKeys[i].pValue;
+        output.append((const char *)programKeys[i].key, WITNESS_DB_KEY_SIZE);
+        appendU64(output, offset);
+        appendU64(output, bytecode.size());
+        offset += bytecode.size();
+    }
+
+    // Node values
+    for (uint64_t i=0; i<nodeKeys.size(); i++)
+    {
+        const vector<Goldilocks::Element> &value = *(const vector<Goldilocks::Element> *)nodeKeys[i].pValue;
+        for (uint64_t j=0; j<value.size(); j++)
+        {
+            appendU64(output, Goldilocks::toU64(value[j]));
+        }
+    }
+
+    // Program data
+    for (uint64_t i=0; i<programKeys.size(); i++)
+    {
+        const vector<uint8_t> &bytecode = *(const vector<uint8_t> *)programKeys[i].pValue;
+        output.append((const char *)bytecode.data(), bytecode.size());
+    }
+
+    return ZKR_SUCCESS;
+}
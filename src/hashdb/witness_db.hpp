@@ -0,0 +1,85 @@
+#ifndef WITNESS_DB_HPP
+#define WITNESS_DB_HPP
+
+#include <string>
+#include <vector>
+#include "goldilocks_base_field.hpp"
+#include "database_map.hpp"
+#include "zkresult.hpp"
+
+using namespace std;
+
+/*
+    Binary witness database format, with all integers in little endian:
+    - header: magic "zkwdb002" (8B), number of nodes (8B), number of programs (8B), number of field elements of the
+      node values (8B), program data size (8B)
+    - nodes, sorted by key: 32B big endian key hash, followed by offset (8B) and size (8B) in node values, counted in
+      field elements (48B)
+    - programs, sorted by key: 32B big endian key hash, followed by offset (8B) and size (8B) in program data (48B)
+    - node values: concatenated nodes value, as field elements of 8B each
+    - program data: concatenated programs bytecode
+*/
+
+#define WITNESS_DB_MAGIC "zkwdb002"
+#define WITNESS_DB_HEADER_SIZE 40
+#define WITNESS_DB_KEY_SIZE 32
+#define WITNESS_DB_NODE_SIZE (WITNESS_DB_KEY_SIZE + 8 + 8)
+#define WITNESS_DB_PROGRAM_SIZE (WITNESS_DB_KEY_SIZE + 8 + 8)
+
+// Read-only source of the witness state tree nodes and programs of a batch, mapped from a file or built from the input
+// database maps, which is consulted by the database reads instead of loading the witness into the hashdb
+class WitnessDB
+{
+private:
+    const uint8_t * pData; // Witness database content, mapped or in buffer
+    uint64_t dataSize;
+    void * pMappedFile; // Mapped file, if opened from a file
+    string buffer; // Owned content, if built from maps
+
+    uint64_t nNodes;
+    uint64_t nPrograms;
+    uint64_t nodeValuesSize; // In field elements
+    uint64_t programDataSize;
+    const uint8_t * pNodes;
+    const uint8_t * pPrograms;
+    const uint8_t * pNodeValues;
+    const uint8_t * pProgramData;
+
+    // Checks the content format, and sets the nodes and programs pointers
+    zkresult parse (void);
+
+public:
+    WitnessDB ();
+    ~WitnessDB ();
+    WitnessDB (const WitnessDB &) = delete;
+    WitnessDB & operator= (const WitnessDB &) = delete;
+
+    // Maps a binary witness database file
+    zkresult open (const string &fileName);
+
+    // Builds the binary witness database from the input database maps
+    zkresult build (const DatabaseMap::MTMap &db, const DatabaseMap::ProgramMap &programs);
+
+    // Writes the binary witness database into a file
+    zkresult save (const string &fileName) const;
+
+    void close (void);
+    bool isOpen (void) const { return pData != NULL; };
+    uint64_t getNodesSize (void) const { return nNodes; };
+    uint64_t getProgramsSize (void) const { return nPrograms; };
+    uint64_t getDataSize (void) const { return dataSize; };
+
+    // Looks up a node by its key hash; returns false if not present
+    bool read (const Goldilocks::Element (&key)[4], vector<Goldilocks::Element> &value) const;
+
+    // Looks up a program by its key hash string; returns false if not present
+    bool getProgram (const string &key, vector<uint8_t> &data) const;
+
+    // Converts the binary witness database back into database maps
+    void toMaps (DatabaseMap::MTMap &db, DatabaseMap::ProgramMap &programs) const;
+
+    // Serializes database maps into a binary witness database; node values keep their number of field elements
+    static zkresult serialize (const DatabaseMap::MTMap &db, const DatabaseMap::ProgramMap &programs, string &output);
+};
+
+#endif
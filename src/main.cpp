@@ -27,8 +27,11 @@
 #include "sm/climb_key/climb_key_test.hpp"
 #include "sm/binary/binary_test.hpp"
 #include "sm/mem_align/mem_align_test.hpp"
+#include "sm/memory/memory_test.hpp"
+#include "sm/poseidon_g/poseidon_g_test.hpp"
 #include "timer.hpp"
 #include "hashdb/hashdb_server.hpp"
+#include "service/metrics/metrics_server.hpp"
 #include "service/hashdb/hashdb_test.hpp"
 #include "service/hashdb/hashdb.hpp"
 #include "sha256_test.hpp"
@@ -49,6 +52,14 @@
 #include "page_manager_test.hpp"
 #include "zkglobals.hpp"
 #include "key_value_tree_test.hpp"
+#include "merkle_tree_bn128_performance_test.hpp"
+#include "multiexp_fixed_bases_performance_test.hpp"
+#include "multiexp_batch_affine_performance_test.hpp"
+#include "full_trace_delta_performance_test.hpp"
+#include "data_stream_test.hpp"
+#include "witness_db.hpp"
+#include "witness_db_performance_test.hpp"
+#include "batch_replay_test.hpp"
 
 using namespace std;
 using json = nlohmann::json;
@@ -111,6 +122,46 @@ void runFileGenBatchProof(Goldilocks fr, Prover &prover, Config &config)
     prover.genBatchProof(&proverRequest);
 }
 
+void runFileGenBatchProofPipeline(Goldilocks fr, Prover &prover, Config &config, const vector<string> &inputFiles)
+{
+    // Submit all the requests to the prover, so that its pipeline can overlap the executor and STARK stages of consecutive batches
+    vector<string> uuids;
+    for (uint64_t i = 0; i < inputFiles.size(); i++)
+    {
+        // Create and init an empty prover request; it will be deleted by the prover cleaner thread once completed
+        ProverRequest *pProverRequest = new ProverRequest(fr, config, prt_genBatchProof);
+        json inputJson;
+        file2json(inputFiles[i], inputJson);
+        zkresult zkResult = pProverRequest->input.load(inputJson);
+        if (zkResult != ZKR_SUCCESS)
+        {
+            zklog.error("runFileGenBatchProofPipeline() failed calling proverRequest.input.load() zkResult=" + to_string(zkResult) + "=" + zkresult2string(zkResult) + " inputFile=" + inputFiles[i]);
+            exitProcess();
+        }
+
+        // Create full tracer based on fork ID
+        pProverRequest->CreateFullTracer();
+        if (pProverRequest->result != ZKR_SUCCESS)
+        {
+            zklog.error("runFileGenBatchProofPipeline() failed calling proverRequest.CreateFullTracer() zkResult=" + to_string(pProverRequest->result) + "=" + zkresult2string(pProverRequest->result));
+            exitProcess();
+        }
+
+        zklog.info("runFileGenBatchProofPipeline() submitting inputFile=" + inputFiles[i]);
+        uuids.emplace_back(prover.submitRequest(pProverRequest));
+    }
+
+    // Wait for all of them to complete
+    for (uint64_t i = 0; i < uuids.size(); i++)
+    {
+        ProverRequest *pProverRequest = prover.waitForRequestToComplete(uuids[i], 24 * 3600);
+        if ((pProverRequest == NULL) || (pProverRequest->result != ZKR_SUCCESS))
+        {
+            zklog.error("runFileGenBatchProofPipeline() failed generating the batch proof of inputFile=" + inputFiles[i]);
+        }
+    }
+}
+
 void runFileGenAggregatedProof(Goldilocks fr, Prover &prover, Config &config)
 {
     // Load and parse input JSON file
@@ -290,6 +341,44 @@ void runFileExecute(Goldilocks fr, Prover &prover, Config &config)
     prover.execute(&proverRequest);
 }
 
+void runWitnessDBConverter(Goldilocks fr, const string &inputFile)
+{
+    // Load and parse input JSON file
+    json inputJson;
+    file2json(inputFile, inputJson);
+    Input input(fr);
+    zkresult zkResult = input.load(inputJson);
+    if (zkResult != ZKR_SUCCESS)
+    {
+        zklog.error("runWitnessDBConverter() failed calling input.load() zkResult=" + to_string(zkResult) + "=" + zkresult2string(zkResult) + " inputFile=" + inputFile);
+        exitProcess();
+    }
+
+    // Build the binary witness database from the input db and contractsBytecode, and save it
+    WitnessDB witnessDB;
+    zkResult = witnessDB.build(input.db, input.contractsBytecode);
+    if (zkResult != ZKR_SUCCESS)
+    {
+        zklog.error("runWitnessDBConverter() failed calling witnessDB.build() zkResult=" + to_string(zkResult) + "=" + zkresult2string(zkResult) + " inputFile=" + inputFile);
+        exitProcess();
+    }
+    string witnessDBFile = inputFile + ".witnessdb";
+    zkResult = witnessDB.save(witnessDBFile);
+    if (zkResult != ZKR_SUCCESS)
+    {
+        zklog.error("runWitnessDBConverter() failed calling witnessDB.save() zkResult=" + to_string(zkResult) + "=" + zkresult2string(zkResult) + " witnessDBFile=" + witnessDBFile);
+        exitProcess();
+    }
+
+    // Save an input JSON file that refers to the binary witness database, instead of containing the witness state
+    inputJson.erase("db");
+    inputJson.erase("contractsBytecode");
+    inputJson["witnessDB"] = witnessDBFile;
+    json2file(inputJson, witnessDBFile + ".json");
+
+    zklog.info("runWitnessDBConverter() converted inputFile=" + inputFile + " into witnessDBFile=" + witnessDBFile + " nodes=" + to_string(witnessDB.getNodesSize()) + " programs=" + to_string(witnessDB.getProgramsSize()) + " size=" + to_string(witnessDB.getDataSize()) + "B");
+}
+
 int main(int argc, char **argv)
 {
     /* CONFIG */
@@ -401,6 +490,26 @@ int main(int argc, char **argv)
         SHA256GenerateScript(config);
     }
 
+    // Convert input JSON files into binary witness database files
+    if (config.runWitnessDBConverter)
+    {
+        if (config.inputFile.back() == '/') // Convert all input files in the folder
+        {
+            vector<string> files = getFolderFiles(config.inputFile, true);
+            for (size_t i = 0; i < files.size(); i++)
+            {
+                if ((files[i].size() > 5) && (files[i].substr(files[i].size() - 5) == ".json") && (files[i].find(".witnessdb") == string::npos))
+                {
+                    runWitnessDBConverter(fr, config.inputFile + files[i]);
+                }
+            }
+        }
+        else
+        {
+            runWitnessDBConverter(fr, config.inputFile);
+        }
+    }
+
 #ifdef DATABASE_USE_CACHE
 
     /* INIT DB CACHE */
@@ -473,6 +582,18 @@ int main(int argc, char **argv)
         MemAlignSMTest(fr, config);
     }
 
+    // Test Memory and MemAlign SMs performance
+    if (config.runMemorySMTest)
+    {
+        MemorySMTest(fr, poseidon, config);
+    }
+
+    // Test PoseidonG SM
+    if (config.runPoseidonGSMTest)
+    {
+        PoseidonGSMTest(fr, poseidon, config);
+    }
+
     // Test SHA256
     if (config.runSHA256Test)
     {
@@ -525,6 +646,42 @@ int main(int argc, char **argv)
         Smt64Test(config);
     }
 
+    // Test BN128 merkle tree performance
+    if (config.runMerkleTreeBN128PerformanceTest)
+    {
+        MerkleTreeBN128PerformanceTest(config);
+    }
+
+    // Test fixed-base multiexp performance
+    if (config.runMultiexpFixedBasesPerformanceTest)
+    {
+        MultiexpFixedBasesPerformanceTest(config);
+    }
+
+    // Test batch affine multiexp performance
+    if (config.runMultiexpBatchAffinePerformanceTest)
+    {
+        MultiexpBatchAffinePerformanceTest(config);
+    }
+
+    // Test full tracer delta trace performance
+    if (config.runFullTraceDeltaPerformanceTest)
+    {
+        FullTraceDeltaPerformanceTest(config);
+    }
+
+    // Test data stream decoding performance
+    if (config.runDataStreamPerformanceTest)
+    {
+        DataStreamPerformanceTest(config);
+    }
+
+    // Test binary witness database performance
+    if (config.runWitnessDBPerformanceTest)
+    {
+        WitnessDBPerformanceTest(fr, config);
+    }
+
     // Unit test
     if (config.runUnitTest)
     {
@@ -536,7 +693,7 @@ int main(int argc, char **argv)
         !config.runHashDBServer && !config.runHashDBTest &&
         !config.runAggregatorServer && !config.runAggregatorClient && !config.runAggregatorClientMock &&
         !config.runFileGenBatchProof && !config.runFileGenAggregatedProof && !config.runFileGenFinalProof &&
-        !config.runFileProcessBatch && !config.runFileProcessBatchMultithread && !config.runFileExecute)
+        !config.runFileProcessBatch && !config.runFileProcessBatchMultithread && !config.runBatchReplay && !config.runFileExecute)
     {
         return 0;
     }
@@ -560,6 +717,16 @@ int main(int argc, char **argv)
 
     /* SERVERS */
 
+    // Create the metrics server and run it, if configured; its thread runs until the process exits
+    MetricsServer *pMetricsServer = NULL;
+    if (config.runMetricsServer)
+    {
+        pMetricsServer = new MetricsServer(config);
+        zkassert(pMetricsServer != NULL);
+        zklog.info("Launching metrics server thread...");
+        pMetricsServer->runThread();
+    }
+
     // Create the HashDB server and run it, if configured
     HashDBServer *pHashDBServer = NULL;
     if (config.runHashDBServer)
@@ -601,13 +768,25 @@ int main(int argc, char **argv)
             Config tmpConfig = config;
             // Get files sorted alphabetically from the folder
             vector<string> files = getFolderFiles(config.inputFile, true);
-            // Process each input file in order
-            for (size_t i = 0; i < files.size(); i++)
+            if (config.proverPipeline)
             {
-                tmpConfig.inputFile = config.inputFile + files[i];
-                zklog.info("runFileGenBatchProof inputFile=" + tmpConfig.inputFile);
-                // Call the prover
-                runFileGenBatchProof(fr, prover, tmpConfig);
+                // Generate all the proofs through the prover pipeline
+                for (size_t i = 0; i < files.size(); i++)
+                {
+                    files[i] = config.inputFile + files[i];
+                }
+                runFileGenBatchProofPipeline(fr, prover, config, files);
+            }
+            else
+            {
+                // Process each input file in order
+                for (size_t i = 0; i < files.size(); i++)
+                {
+                    tmpConfig.inputFile = config.inputFile + files[i];
+                    zklog.info("runFileGenBatchProof inputFile=" + tmpConfig.inputFile);
+                    // Call the prover
+                    runFileGenBatchProof(fr, prover, tmpConfig);
+                }
             }
         }
         else
@@ -694,6 +873,12 @@ int main(int argc, char **argv)
         runFileProcessBatchMultithread(fr, prover, config);
     }
 
+    // Replay (no proof generation) the input files of a folder in parallel, and report the throughput
+    if (config.runBatchReplay)
+    {
+        BatchReplayTest(fr, prover, config);
+    }
+
     // Execute (no proof generation) the input file, in all SMs
     if (config.runFileExecute)
     {
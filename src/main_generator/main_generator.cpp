@@ -245,6 +245,11 @@ string generate(const json &rom, uint64_t forkID, string forkNamespace, const st
         if (!bFastMode)
             code += "#include \"goldilocks_precomputed.hpp\"\n";
         code += "#include \"ecrecover.hpp\"\n";
+        if (forkID >= 9)
+        {
+            code += "#include \"ecrecover_batch_precalc.hpp\"\n";
+            code += "#include \"bytecode_hash_cache.hpp\"\n";
+        }
 
     }
     code += "\n";
@@ -343,8 +348,49 @@ string generate(const json &rom, uint64_t forkID, string forkNamespace, const st
     code += "    remove(\"c.txt\");\n";
     code += "#endif\n\n";
 
+    if (forkID >= 9)
+    {
+        code += "    // Read the input witness state from a binary witness database, instead of loading it into the hashdb, when it is\n";
+        code += "    // local and reachable through the database read log, and the new state is not persisted into a shared database,\n";
+        code += "    // which would then miss the witness nodes it refers to\n";
+        code += "    bool bWitnessDB = false;\n";
+        code += "    bool bWitnessDBReadable = mainExecutor.config.witnessDB && (mainExecutor.config.hashDBURL == \"local\") && !mainExecutor.config.hashDB64 && (!proverRequest.input.bUpdateMerkleTree || (mainExecutor.config.databaseURL == \"local\")) && (proverRequest.dbReadLog != NULL);\n";
+        code += "    if (!proverRequest.input.witnessDBFile.empty())\n";
+        code += "    {\n";
+        code += "        zkresult zkr = proverRequest.witnessDB.open(proverRequest.input.witnessDBFile);\n";
+        code += "        if (zkr != ZKR_SUCCESS)\n";
+        code += "        {\n";
+        code += "            proverRequest.result = zkr;\n";
+        code += "            zklog.error(\"" + functionName + "() failed calling witnessDB.open() of file=\" + proverRequest.input.witnessDBFile + \" result=\" + zkresult2string(zkr));\n";
+        code += "            return;\n";
+        code += "        }\n";
+        code += "        if (!bWitnessDBReadable)\n";
+        code += "        {\n";
+        code += "            proverRequest.witnessDB.toMaps(proverRequest.input.db, proverRequest.input.contractsBytecode);\n";
+        code += "            proverRequest.witnessDB.close();\n";
+        code += "        }\n";
+        code += "    }\n";
+        code += "    else if (bWitnessDBReadable && ((proverRequest.input.db.size() > 0) || (proverRequest.input.contractsBytecode.size() > 0)))\n";
+        code += "    {\n";
+        code += "        zkresult zkr = proverRequest.witnessDB.build(proverRequest.input.db, proverRequest.input.contractsBytecode);\n";
+        code += "        if (zkr != ZKR_SUCCESS)\n";
+        code += "        {\n";
+        code += "            zklog.warning(\"" + functionName + "() failed calling witnessDB.build() result=\" + zkresult2string(zkr) + \"; loading the witness into the hashdb\");\n";
+        code += "        }\n";
+        code += "    }\n";
+        code += "    if (proverRequest.witnessDB.isOpen())\n";
+        code += "    {\n";
+        code += "        proverRequest.dbReadLog->setWitnessDB(&proverRequest.witnessDB);\n";
+        code += "        bWitnessDB = true;\n";
+        code += "    }\n\n";
+    }
+    else
+    {
+        code += "    bool bWitnessDB = false;\n\n";
+    }
+
     code += "    // Copy input database content into context database\n";
-    code += "    if (proverRequest.input.db.size() > 0)\n";
+    code += "    if (!bWitnessDB && (proverRequest.input.db.size() > 0))\n";
     code += "    {\n";
     code += "        Goldilocks::Element stateRoot[4];\n";
     code += "        scalar2fea(fr, proverRequest.input.publicInputsExtended.publicInputs.oldStateRoot, stateRoot);\n";
@@ -357,7 +403,7 @@ string generate(const json &rom, uint64_t forkID, string forkNamespace, const st
     code += "    }\n\n";
 
     code += "    // Copy input contracts database content into context database (dbProgram)\n";
-    code += "    if (proverRequest.input.contractsBytecode.size() > 0)\n";
+    code += "    if (!bWitnessDB && (proverRequest.input.contractsBytecode.size() > 0))\n";
     code += "    {\n";
     code += "        mainExecutor.pHashDB->loadProgramDB(proverRequest.input.contractsBytecode, true);\n";
     code += "        mainExecutor.pHashDB->flush(emptyString, emptyString, proverRequest.input.bUpdateMerkleTree ? PERSISTENCE_DATABASE : PERSISTENCE_CACHE, flushId, lastSentFlushId);\n";
@@ -367,6 +413,31 @@ string generate(const json &rom, uint64_t forkID, string forkNamespace, const st
     code += "        }\n";
     code += "    }\n\n";
 
+    if (forkID >= 9)
+    {
+        code += "    // Precalculate the ECRecover of all the batch transactions in parallel, unless a previous execution already did it\n";
+        code += "    ECRecoverBatchPrecalc ecRecoverBatchPrecalc;\n";
+        code += "    if (mainExecutor.config.ECRecoverPrecalc && mainExecutor.config.ECRecoverBatchPrecalc && ((proverRequest.pBatchExecutionCacheEntry == NULL) || proverRequest.pBatchExecutionCacheEntry->bRecording))\n";
+        code += "    {\n";
+        code += "        ecRecoverBatchPrecalc.precalculate(proverRequest.input.publicInputsExtended.publicInputs.batchL2Data, mainExecutor.config.ECRecoverPrecalcNThreads);\n";
+        code += "    }\n\n";
+
+        code += "    // Hash the bytecodes of the state override in parallel, so that they are found in the bytecode hash cache\n";
+        code += "    if (proverRequest.input.stateOverride.size() > 0)\n";
+        code += "    {\n";
+        code += "        vector<const vector<uint8_t> *> bytecodes;\n";
+        code += "        unordered_map<string, OverrideEntry>::const_iterator it;\n";
+        code += "        for (it = proverRequest.input.stateOverride.begin(); it != proverRequest.input.stateOverride.end(); it++)\n";
+        code += "        {\n";
+        code += "            if (it->second.code.size() > 0)\n";
+        code += "            {\n";
+        code += "                bytecodes.push_back(&it->second.code);\n";
+        code += "            }\n";
+        code += "        }\n";
+        code += "        mainExecutor.bytecodeLinearPoseidon(ctx, bytecodes);\n";
+        code += "    }\n\n";
+    }
+
     code += "    // opN are local, uncommitted polynomials\n";
     code += "    Goldilocks::Element op0, op1, op2, op3, op4, op5, op6, op7;\n";
 
@@ -488,6 +559,13 @@ string generate(const json &rom, uint64_t forkID, string forkNamespace, const st
     code += "    ctx.pEvaluation = &i;\n";
     code += "    ctx.pZKPC = &zkPC; // Pointer to the zkPC\n\n";
 
+    // Profile of the steps and cycles spent in every ROM line
+    if (forkID >= 9)
+    {
+        code += "    bool bRomProfile = mainExecutor.config.executorROMProfile;\n";
+        code += "    RomProfile romProfile(bRomProfile ? rom.size : 0);\n\n";
+    }
+
     // Declare currentRCX only if repeat instruction is used
     for (uint64_t zkPC=0; zkPC<rom["program"].size(); zkPC++)
     {
@@ -583,6 +661,15 @@ string generate(const json &rom, uint64_t forkID, string forkNamespace, const st
         //    code += "// ";
         code += functionName + "_rom_line_" + to_string(zkPC) + ": //" + string(rom["program"][zkPC]["fileName"]) + ":" + to_string(rom["program"][zkPC]["line"]) + "=[" + removeDuplicateSpaces(string(rom["program"][zkPC]["lineStr"])) + "]\n\n";
 
+        // ROM PROFILE
+        if (forkID >= 9)
+        {
+            code += "    if (bRomProfile)\n";
+            code += "    {\n";
+            code += "        romProfile.step(" + to_string(zkPC) + ");\n";
+            code += "    }\n\n";
+        }
+
         // START LOGS
         code += "#ifdef LOG_COMPLETED_STEPS_TO_FILE\n";
         code += "    fi0=fi1=fi2=fi3=fi4=fi5=fi6=fi7=fr.zero();\n";
@@ -618,7 +705,33 @@ string generate(const json &rom, uint64_t forkID, string forkNamespace, const st
                 code += "       fea2scalar(fr, v_, pols.D0[i], pols.D1[i], pols.D2[i], pols.D3[i], pols.D4[i], pols.D5[i], pols.D6[i], pols.D7[i]);\n";
                 
             }
-            code += "       ctx.ecRecoverPrecalcBuffer.posUsed = ECRecoverPrecalc(signature_, r_, s_, v_, false, ctx.ecRecoverPrecalcBuffer.buffer, ctx.config.ECRecoverPrecalcNThreads);\n";
+            if (forkID >= 9)
+            {
+                code += "       // Reuse the points precalculated by the batch pre-pass or by a previous execution of this batch, if available\n";
+                code += "       string ecRecoverKey;\n";
+                code += "       if ((proverRequest.pBatchExecutionCacheEntry != NULL) || !ecRecoverBatchPrecalc.empty())\n";
+                code += "       {\n";
+                code += "           ecRecoverKey = BatchExecutionCacheEntry::getECRecoverKey(signature_, r_, s_, v_);\n";
+                code += "       }\n";
+                code += "       bool bFound = ecRecoverBatchPrecalc.get(ecRecoverKey, ctx.ecRecoverPrecalcBuffer.buffer, ctx.ecRecoverPrecalcBuffer.posUsed);\n";
+                code += "       bool bFoundInCache = false;\n";
+                code += "       if (!bFound && (proverRequest.pBatchExecutionCacheEntry != NULL))\n";
+                code += "       {\n";
+                code += "           bFound = bFoundInCache = proverRequest.pBatchExecutionCacheEntry->getECRecoverPrecalc(ecRecoverKey, ctx.ecRecoverPrecalcBuffer.buffer, ctx.ecRecoverPrecalcBuffer.posUsed);\n";
+                code += "       }\n";
+                code += "       if (!bFound)\n";
+                code += "       {\n";
+                code += "           ctx.ecRecoverPrecalcBuffer.posUsed = ECRecoverPrecalc(signature_, r_, s_, v_, false, ctx.ecRecoverPrecalcBuffer.buffer, ctx.config.ECRecoverPrecalcNThreads);\n";
+                code += "       }\n";
+                code += "       if (!bFoundInCache && (proverRequest.pBatchExecutionCacheEntry != NULL))\n";
+                code += "       {\n";
+                code += "           proverRequest.pBatchExecutionCacheEntry->setECRecoverPrecalc(ecRecoverKey, ctx.ecRecoverPrecalcBuffer.buffer, ctx.ecRecoverPrecalcBuffer.posUsed);\n";
+                code += "       }\n";
+            }
+            else
+            {
+                code += "       ctx.ecRecoverPrecalcBuffer.posUsed = ECRecoverPrecalc(signature_, r_, s_, v_, false, ctx.ecRecoverPrecalcBuffer.buffer, ctx.config.ECRecoverPrecalcNThreads);\n";
+            }
             code += "       ctx.ecRecoverPrecalcBuffer.pos=0;\n";
             code += "       if (ctx.ecRecoverPrecalcBuffer.posUsed > 0) ctx.ecRecoverPrecalcBuffer.filled = true;\n";
             code += "    }\n";
@@ -1263,7 +1376,7 @@ code += "    #ifdef LOG_TIME_STATISTICS_MAIN_EXECUTOR\n";
                     code += "                gettimeofday(&t, NULL);\n";
 code += "    #endif\n";
                     code += "                Goldilocks::Element result[4];\n";
-                    code += "                mainExecutor.linearPoseidon(ctx, itStateOverride->second.code, result);\n";
+                    code += "                mainExecutor." + string(forkID >= 9 ? "bytecodeLinearPoseidon" : "linearPoseidon") + "(ctx, itStateOverride->second.code, result);\n";
 code += "    #ifdef LOG_TIME_STATISTICS_MAIN_EXECUTOR\n";
                     code += "                mainMetrics.add(\"Poseidon\", TimeDiff(t));\n";
 code += "    #endif\n";
@@ -3294,7 +3407,22 @@ code += "    #endif\n";
             code += "#ifdef LOG_TIME_STATISTICS_MAIN_EXECUTOR\n";
             code += "        gettimeofday(&t, NULL);\n";
             code += "#endif\n";
-            code += "        keccak256(hashIterator->second.data.data(), hashIterator->second.data.size(), hashIterator->second.digest);\n";
+            if (forkID >= 9)
+            {
+                code += "        // Reuse the digest calculated by a previous execution of this batch, if available\n";
+                code += "        if ((proverRequest.pBatchExecutionCacheEntry == NULL) || !proverRequest.pBatchExecutionCacheEntry->getKeccak(hashIterator->second.data, hashIterator->second.digest))\n";
+                code += "        {\n";
+                code += "            keccak256(hashIterator->second.data.data(), hashIterator->second.data.size(), hashIterator->second.digest);\n";
+                code += "            if (proverRequest.pBatchExecutionCacheEntry != NULL)\n";
+                code += "            {\n";
+                code += "                proverRequest.pBatchExecutionCacheEntry->setKeccak(hashIterator->second.data, hashIterator->second.digest);\n";
+                code += "            }\n";
+                code += "        }\n";
+            }
+            else
+            {
+                code += "        keccak256(hashIterator->second.data.data(), hashIterator->second.data.size(), hashIterator->second.digest);\n";
+            }
             code += "#ifdef LOG_TIME_STATISTICS_MAIN_EXECUTOR\n";
             code += "        mainMetrics.add(\"Keccak\", TimeDiff(t));\n";
             code += "#endif\n";
@@ -3592,8 +3720,37 @@ code += "    #endif\n";
             code += "        gettimeofday(&t, NULL);\n";
             code += "#endif\n";
             code += "        Goldilocks::Element result[4];\n";
-            code += "        mainExecutor.linearPoseidon(ctx, hashIterator->second.data, result);\n";
-            code += "        fea2scalar(fr, hashIterator->second.digest, result);\n";
+            if (forkID >= 9)
+            {
+                code += "        // Reuse the digest calculated by a previous execution of this batch, if available\n";
+                code += "        if ((proverRequest.pBatchExecutionCacheEntry != NULL) && proverRequest.pBatchExecutionCacheEntry->getPoseidon(hashIterator->second.data, hashIterator->second.digest))\n";
+                code += "        {\n";
+                code += "            scalar2fea(fr, hashIterator->second.digest, result);\n";
+                code += "        }\n";
+                code += "        else\n";
+                code += "        {\n";
+                // Only the deployed contract bytecodes, hashed by hashPoseidonLinearFromMemory, are worth caching across batches
+                if (rom["labels"].contains("hashPoseidonLinearFromMemory") && (zkPC >= rom["labels"]["hashPoseidonLinearFromMemory"]) &&
+                    rom["labels"].contains("hashPoseidonReturn") && (zkPC < rom["labels"]["hashPoseidonReturn"]))
+                {
+                    code += "            mainExecutor.bytecodeLinearPoseidon(ctx, hashIterator->second.data, result);\n";
+                }
+                else
+                {
+                    code += "            mainExecutor.linearPoseidon(ctx, hashIterator->second.data, result);\n";
+                }
+                code += "            fea2scalar(fr, hashIterator->second.digest, result);\n";
+                code += "            if (proverRequest.pBatchExecutionCacheEntry != NULL)\n";
+                code += "            {\n";
+                code += "                proverRequest.pBatchExecutionCacheEntry->setPoseidon(hashIterator->second.data, hashIterator->second.digest);\n";
+                code += "            }\n";
+                code += "        }\n";
+            }
+            else
+            {
+                code += "        mainExecutor.linearPoseidon(ctx, hashIterator->second.data, result);\n";
+                code += "        fea2scalar(fr, hashIterator->second.digest, result);\n";
+            }
             code += "#ifdef LOG_TIME_STATISTICS_MAIN_EXECUTOR\n";
             code += "        mainMetrics.add(\"Poseidon\", TimeDiff(t));\n";
             code += "#endif\n";
@@ -6065,6 +6222,20 @@ code += "    #endif\n";
 
     code += functionName + "_end:\n\n";
 
+    if (forkID >= 9)
+    {
+        code += "    // Accumulate and save the ROM profile\n";
+        code += "    if (bRomProfile)\n";
+        code += "    {\n";
+        code += "        romProfile.stop();\n";
+        code += "        mainExecutor.romProfiler.add(romProfile);\n";
+        code += "        if (mainExecutor.romProfiler.isSaveDue(mainExecutor.config.executorROMProfileSaveInterval))\n";
+        code += "        {\n";
+        code += "            mainExecutor.romProfiler.save(mainExecutor.config.outputPath + \"/rom_profile_" + forkNamespace + "\");\n";
+        code += "        }\n";
+        code += "    }\n\n";
+    }
+
 
     code += "    // Copy the counters\n";
     code += "    proverRequest.counters.arith = fr.toU64(pols.cntArith[0]);\n";
@@ -6320,11 +6491,23 @@ code += "    #endif\n";
     code += "        mainMetrics.print(\"Main Executor calls\");\n";
     code += "        evalCommandMetrics.print(\"Main Executor eval command calls\");\n";
     code += "    }\n";
+    code += "    if (proverRequest.pMainMetrics != NULL)\n";
+    code += "    {\n";
+    code += "        proverRequest.pMainMetrics->add(mainMetrics);\n";
+    code += "    }\n";
     code += "#endif\n\n";
     
     code += "    if (mainExecutor.config.dbMetrics) proverRequest.dbReadLog->print();\n\n";
 
     code += "    zklog.info(\"" + functionName + "() done lastStep=\" + to_string(ctx.lastStep) + \" (\" + to_string((double(ctx.lastStep)*100)/mainExecutor.N) + \"%)\", &proverRequest.tags);\n\n";
+    if (forkID >= 9)
+    {
+        code += "    if (bytecodeHashCache.enabled())\n";
+        code += "    {\n";
+        code += "        zklog.info(\"" + functionName + "() bytecode hashes hits=\" + to_string(ctx.bytecodeHashHits) + \" misses=\" + to_string(ctx.bytecodeHashMisses) + \" savedTime=\" + to_string(ctx.bytecodeHashSavedTime) + \" us\", &proverRequest.tags);\n";
+        code += "        bytecodeHashCache.print();\n";
+        code += "    }\n\n";
+    }
 
     code += "    return;\n\n";
 
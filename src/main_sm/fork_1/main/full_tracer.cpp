@@ -1014,7 +1014,7 @@ void FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
     
     if (ctx.proverRequest.input.traceConfig.bGenerateStack)
     {
-        vector<mpz_class> finalStack;
+        vector<Bytes32> finalStack;
 
         // Get context offset
         uint64_t offsetCtx = fr.toU64(ctx.pols.CTX[*ctx.pStep]) * 0x40000;
@@ -1032,11 +1032,11 @@ void FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
             Fea stack = it->second;
             mpz_class stackScalar;
             fea2scalar(ctx.fr, stackScalar, stack.fe0, stack.fe1, stack.fe2, stack.fe3, stack.fe4, stack.fe5, stack.fe6, stack.fe7);
-            finalStack.push_back(stackScalar);
+            finalStack.emplace_back(stackScalar);
         }
 
         // save stack to opcode trace
-        singleInfo.stack = finalStack;
+        singleInfo.stack.swap(finalStack);
     }
 
 #ifdef LOG_TIME_STATISTICS
@@ -1056,14 +1056,14 @@ void FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
         singleInfo.gas_refund = auxScalar.get_ui();
         //singleInfo.error = "";
         fea2scalar(ctx.fr, auxScalar, ctx.pols.SR0[*ctx.pStep], ctx.pols.SR1[*ctx.pStep], ctx.pols.SR2[*ctx.pStep], ctx.pols.SR3[*ctx.pStep], ctx.pols.SR4[*ctx.pStep], ctx.pols.SR5[*ctx.pStep], ctx.pols.SR6[*ctx.pStep], ctx.pols.SR7[*ctx.pStep]);
-        singleInfo.state_root = NormalizeTo0xNFormat(auxScalar.get_str(16), 64);
+        singleInfo.state_root.fromScalar(auxScalar);
 
         // Add contract info
         getVarFromCtx(ctx, false, ctx.rom.txDestAddrOffset, auxScalar);
-        singleInfo.contract.address = NormalizeToNFormat(auxScalar.get_str(16), 40);
+        singleInfo.contract.address.fromScalar(auxScalar);
 
         getVarFromCtx(ctx, false, ctx.rom.txSrcAddrOffset, auxScalar);
-        singleInfo.contract.caller = NormalizeToNFormat(auxScalar.get_str(16), 40);
+        singleInfo.contract.caller.fromScalar(auxScalar);
 
         getVarFromCtx(ctx, false, ctx.rom.txValueOffset, auxScalar);
         singleInfo.contract.value = auxScalar;
@@ -1282,7 +1282,7 @@ void FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
     {
         mpz_class auxScalar;
         getVarFromCtx(ctx, false, ctx.rom.storageAddrOffset, auxScalar);
-        singleInfo.contract.caller = NormalizeToNFormat(auxScalar.get_str(16), 40);
+        singleInfo.contract.caller.fromScalar(auxScalar);
     }
         
     // If is an ether transfer, don't add stop opcode to trace
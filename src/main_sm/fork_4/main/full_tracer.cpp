@@ -1202,7 +1202,7 @@ zkresult FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
     
     if (ctx.proverRequest.input.traceConfig.bGenerateStack)
     {
-        vector<mpz_class> finalStack;
+        vector<Bytes32> finalStack;
 
         // Get context offset
         uint64_t offsetCtx = fr.toU64(ctx.pols.CTX[*ctx.pStep]) * 0x40000;
@@ -1224,11 +1224,11 @@ zkresult FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
                 zklog.error("FullTracer::onOpcode() failed calling fea2scalar(stackScalar)");
                 return ZKR_SM_MAIN_FEA2SCALAR;
             }
-            finalStack.push_back(stackScalar);
+            finalStack.emplace_back(stackScalar);
         }
 
         // save stack to opcode trace
-        singleInfo.stack = finalStack;
+        singleInfo.stack.swap(finalStack);
     }
 
 #ifdef LOG_TIME_STATISTICS
@@ -1261,7 +1261,7 @@ zkresult FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
             zklog.error("FullTracer::onOpcode() failed calling fea2scalar()");
             return ZKR_SM_MAIN_FEA2SCALAR;
         }
-        singleInfo.state_root = NormalizeTo0xNFormat(auxScalar.get_str(16), 64);
+        singleInfo.state_root.fromScalar(auxScalar);
 
         // Add contract info
         zkr = getVarFromCtx(ctx, false, ctx.rom.txDestAddrOffset, auxScalar);
@@ -1270,7 +1270,7 @@ zkresult FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
             zklog.error("FullTracer::onOpcode() failed calling getVarFromCtx(ctx.rom.txDestAddrOffset)");
             return zkr;
         }
-        singleInfo.contract.address = NormalizeToNFormat(auxScalar.get_str(16), 40);
+        singleInfo.contract.address.fromScalar(auxScalar);
 
         zkr = getVarFromCtx(ctx, false, ctx.rom.txSrcAddrOffset, auxScalar);
         if (zkr != ZKR_SUCCESS)
@@ -1278,7 +1278,7 @@ zkresult FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
             zklog.error("FullTracer::onOpcode() failed calling getVarFromCtx(ctx.rom.txSrcAddrOffset)");
             return zkr;
         }
-        singleInfo.contract.caller = NormalizeToNFormat(auxScalar.get_str(16), 40);
+        singleInfo.contract.caller.fromScalar(auxScalar);
 
         zkr = getVarFromCtx(ctx, false, ctx.rom.txValueOffset, auxScalar);
         if (zkr != ZKR_SUCCESS)
@@ -1602,7 +1602,7 @@ zkresult FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
             zklog.error("FullTracer::onOpcode() failed calling getVarFromCtx(ctx.rom.storageAddrOffset)");
             return zkr;
         }
-        singleInfo.contract.caller = NormalizeToNFormat(auxScalar.get_str(16), 40);
+        singleInfo.contract.caller.fromScalar(auxScalar);
     }
         
     // If is an ether transfer, don't add stop opcode to trace
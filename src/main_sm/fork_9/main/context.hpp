@@ -156,6 +156,9 @@ public:
     mpz_class totalTransferredBalance; // Total transferred balance of all accounts, which should be 0 after any transfer
     EllipticCurveAddition lastECAdd; // Micro-cache of the last couple of added points, and the result
     ECRecoverPrecalcBuffer ecRecoverPrecalcBuffer; // Buffer for precalculated points for ECRecover
+    uint64_t bytecodeHashHits; // Bytecode linear poseidon hashes found in the bytecode hash cache
+    uint64_t bytecodeHashMisses; // Bytecode linear poseidon hashes calculated
+    uint64_t bytecodeHashSavedTime; // Time saved by the bytecode hash cache hits, in us
 
     // Evaluations data
     uint64_t * pZKPC; // Zero-knowledge program counter
@@ -187,6 +190,9 @@ public:
         lastStep(0),
         lastECAdd(fec),
         ecRecoverPrecalcBuffer(),
+        bytecodeHashHits(0),
+        bytecodeHashMisses(0),
+        bytecodeHashSavedTime(0),
         pZKPC(NULL),
         pStep(NULL),
         pEvaluation(NULL),
@@ -262,6 +262,13 @@ inline uint64_t getCurrentTime (void)
     return tv.tv_sec * 1000000 + tv.tv_usec;
 }
 
+// Compare two memory words, used by the delta trace mode to skip the words that did not change
+inline bool feaEqual (const Fea &a, const Fea &b)
+{
+    return fr.equal(a.fe0, b.fe0) && fr.equal(a.fe1, b.fe1) && fr.equal(a.fe2, b.fe2) && fr.equal(a.fe3, b.fe3) &&
+           fr.equal(a.fe4, b.fe4) && fr.equal(a.fe5, b.fe5) && fr.equal(a.fe6, b.fe6) && fr.equal(a.fe7, b.fe7);
+}
+
 using namespace rlp;
 
 // Returns a transaction hash from transaction params
@@ -1074,6 +1081,9 @@ zkresult FullTracer::onProcessTx (Context &ctx, const RomCommand &cmd)
 
     // Reset previous memory
     previousMemory = "";
+    lastMemory.clear();
+    lastMemoryWords.clear();
+    previousStack.clear();
     
     txTime = getCurrentTime();
 
@@ -1123,6 +1133,19 @@ zkresult FullTracer::onUpdateStorage(Context &ctx, const RomCommand &cmd)
         }
         string storageAddress = NormalizeTo0xNFormat(auxScalar.get_str(16), 64);
 
+        // In delta trace mode, only record the write; the storage snapshot is rebuilt with the response
+        if (ctx.config.fullTracerDeltaTrace)
+        {
+            if (full_trace.size() > 0)
+            {
+                full_trace[full_trace.size() - 1].storage_writes.push_back({storageAddress, key, value});
+            }
+#ifdef LOG_TIME_STATISTICS
+            tms.add("onUpdateStorage", TimeDiff(t));
+#endif
+            return ZKR_SUCCESS;
+        }
+
         // add key/value to deltaStorage, if undefined, create object
         if (deltaStorage.find(storageAddress) == deltaStorage.end())
         {
@@ -1505,6 +1528,13 @@ zkresult FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
 
     mpz_class auxScalar;
 
+    singleInfo.bDelta = ctx.config.fullTracerDeltaTrace;
+
+    // Delta trace baseline built by this opcode; it only replaces the previous one if this opcode is added to the trace
+    string deltaMemory;
+    vector<Fea> deltaMemoryWords;
+    vector<Fea> deltaStack;
+
 #ifdef LOG_TIME_STATISTICS
     gettimeofday(&top, NULL);
 #endif
@@ -1656,24 +1686,56 @@ zkresult FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
             lenMemValueFinal = ceil(double(auxScalar.get_ui()) / 32);
         }
 
-        for (uint64_t i = 0; i < lenMemValueFinal; i++)
+        string baMemory;
+        if (singleInfo.bDelta)
         {
-            it = ctx.mem.find(addrMem + i);
-            if (it == ctx.mem.end())
+            // Start from the memory built in the previous opcode, and only convert the words that changed since then
+            Fea zeroFea;
+            zeroFea.fe0 = zeroFea.fe1 = zeroFea.fe2 = zeroFea.fe3 = zeroFea.fe4 = zeroFea.fe5 = zeroFea.fe6 = zeroFea.fe7 = fr.zero();
+            uint64_t lastLength = min<uint64_t>(lastMemoryWords.size(), lenMemValueFinal);
+            baMemory = lastMemory;
+            baMemory.resize(lenMemValueFinal*32, 0);
+            deltaMemoryWords = lastMemoryWords;
+            deltaMemoryWords.resize(lenMemValueFinal, zeroFea);
+            for (uint64_t i = 0; i < lenMemValueFinal; i++)
             {
-                finalMemory += "0000000000000000000000000000000000000000000000000000000000000000";
-                continue;
+                it = ctx.mem.find(addrMem + i);
+                const Fea &memValue = (it == ctx.mem.end()) ? zeroFea : it->second;
+                if ((i < lastLength) && feaEqual(memValue, deltaMemoryWords[i]))
+                {
+                    continue;
+                }
+                if (!fea2scalar(ctx.fr, auxScalar, memValue.fe0, memValue.fe1, memValue.fe2, memValue.fe3, memValue.fe4, memValue.fe5, memValue.fe6, memValue.fe7))
+                {
+                    zklog.error("FullTracer::onOpcode() failed calling fea2scalar(memValue)");
+                    return ZKR_SM_MAIN_FEA2SCALAR;
+                }
+                Bytes32 word(auxScalar);
+                memcpy(&baMemory[i*32], word.bytes, 32);
+                deltaMemoryWords[i] = memValue;
             }
-            Fea memValue = it->second;
-            if (!fea2scalar(ctx.fr, auxScalar, memValue.fe0, memValue.fe1, memValue.fe2, memValue.fe3, memValue.fe4, memValue.fe5, memValue.fe6, memValue.fe7))
+            deltaMemory = baMemory;
+        }
+        else
+        {
+            for (uint64_t i = 0; i < lenMemValueFinal; i++)
             {
-                zklog.error("FullTracer::onOpcode() failed calling fea2scalar(memValue)");
-                return ZKR_SM_MAIN_FEA2SCALAR;
+                it = ctx.mem.find(addrMem + i);
+                if (it == ctx.mem.end())
+                {
+                    finalMemory += "0000000000000000000000000000000000000000000000000000000000000000";
+                    continue;
+                }
+                Fea memValue = it->second;
+                if (!fea2scalar(ctx.fr, auxScalar, memValue.fe0, memValue.fe1, memValue.fe2, memValue.fe3, memValue.fe4, memValue.fe5, memValue.fe6, memValue.fe7))
+                {
+                    zklog.error("FullTracer::onOpcode() failed calling fea2scalar(memValue)");
+                    return ZKR_SM_MAIN_FEA2SCALAR;
+                }
+                finalMemory += PrependZeros(auxScalar.get_str(16), 64);
             }
-            finalMemory += PrependZeros(auxScalar.get_str(16), 64);
+            baMemory = string2ba(finalMemory);
         }
-        
-        string baMemory = string2ba(finalMemory);
 
         if (numOpcodes == 0)
         {
@@ -1705,7 +1767,7 @@ zkresult FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
     
     if (ctx.proverRequest.input.traceConfig.bGenerateStack)
     {
-        vector<mpz_class> finalStack;
+        vector<Bytes32> finalStack;
 
         // Get context offset
         uint64_t offsetCtx = fr.toU64(ctx.pols.CTX[*ctx.pStep]) * 0x40000;
@@ -1715,23 +1777,44 @@ zkresult FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
 
         uint16_t sp = fr.toU64(ctx.pols.SP[*ctx.pStep]);
         unordered_map<uint64_t, Fea>::iterator it;
+
+        // Collect the stack words
+        deltaStack.reserve(sp);
         for (uint16_t i = 0; i < sp; i++)
         {
             it = ctx.mem.find(addr + i);
             if (it == ctx.mem.end())
                 continue;
-            Fea stack = it->second;
+            deltaStack.emplace_back(it->second);
+        }
+
+        // In delta trace mode, skip the words that match the previous opcode stack
+        uint64_t common = 0;
+        if (singleInfo.bDelta)
+        {
+            uint64_t maxCommon = min(previousStack.size(), deltaStack.size());
+            while ((common < maxCommon) && feaEqual(previousStack[common], deltaStack[common]))
+            {
+                common++;
+            }
+            singleInfo.stack_pops = previousStack.size() - common;
+        }
+
+        finalStack.reserve(deltaStack.size() - common);
+        for (uint64_t i = common; i < deltaStack.size(); i++)
+        {
+            const Fea &stack = deltaStack[i];
             mpz_class stackScalar;
             if (!fea2scalar(ctx.fr, stackScalar, stack.fe0, stack.fe1, stack.fe2, stack.fe3, stack.fe4, stack.fe5, stack.fe6, stack.fe7))
             {
                 zklog.error("FullTracer::onOpcode() failed calling fea2scalar(stackScalar)");
                 return ZKR_SM_MAIN_FEA2SCALAR;
             }
-            finalStack.push_back(stackScalar);
+            finalStack.emplace_back(stackScalar);
         }
 
         // save stack to opcode trace
-        singleInfo.stack = finalStack;
+        singleInfo.stack.swap(finalStack);
     }
 
 #ifdef LOG_TIME_STATISTICS
@@ -1764,7 +1847,7 @@ zkresult FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
             zklog.error("FullTracer::onOpcode() failed calling fea2scalar()");
             return ZKR_SM_MAIN_FEA2SCALAR;
         }
-        singleInfo.state_root = NormalizeTo0xNFormat(auxScalar.get_str(16), 64);
+        singleInfo.state_root.fromScalar(auxScalar);
 
         // Add contract info
         zkr = getVarFromCtx(ctx, false, ctx.rom.txDestAddrOffset, auxScalar);
@@ -1773,7 +1856,7 @@ zkresult FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
             zklog.error("FullTracer::onOpcode() failed calling getVarFromCtx(ctx.rom.txDestAddrOffset)");
             return zkr;
         }
-        singleInfo.contract.address = NormalizeToNFormat(auxScalar.get_str(16), 40);
+        singleInfo.contract.address.fromScalar(auxScalar);
 
         zkr = getVarFromCtx(ctx, false, ctx.rom.txSrcAddrOffset, auxScalar);
         if (zkr != ZKR_SUCCESS)
@@ -1781,7 +1864,7 @@ zkresult FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
             zklog.error("FullTracer::onOpcode() failed calling getVarFromCtx(ctx.rom.txSrcAddrOffset)");
             return zkr;
         }
-        singleInfo.contract.caller = NormalizeToNFormat(auxScalar.get_str(16), 40);
+        singleInfo.contract.caller.fromScalar(auxScalar);
 
         zkr = getVarFromCtx(ctx, false, ctx.rom.txValueOffset, auxScalar);
         if (zkr != ZKR_SUCCESS)
@@ -2117,7 +2200,7 @@ zkresult FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
             zklog.error("FullTracer::onOpcode() failed calling getVarFromCtx(ctx.rom.storageAddrOffset)");
             return zkr;
         }
-        singleInfo.contract.caller = NormalizeToNFormat(auxScalar.get_str(16), 40);
+        singleInfo.contract.caller.fromScalar(auxScalar);
     }
         
     // If is an ether transfer, don't add stop opcode to trace
@@ -2143,6 +2226,14 @@ zkresult FullTracer::onOpcode(Context &ctx, const RomCommand &cmd)
         {
             // Save output traces
             full_trace.emplace_back(singleInfo);
+
+            // The next opcode delta is computed against this one, which is the previous opcode in the trace
+            if (singleInfo.bDelta)
+            {
+                lastMemory.swap(deltaMemory);
+                lastMemoryWords.swap(deltaMemoryWords);
+                previousStack.swap(deltaStack);
+            }
         }
     }
 
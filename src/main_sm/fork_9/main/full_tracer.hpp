@@ -16,6 +16,7 @@ namespace fork_9
 {
 
 class Context;
+class Fea;
 
 class ContextData
 {
@@ -45,6 +46,9 @@ public:
     ReturnFromCreate returnFromCreate;
     unordered_map<uint64_t, ContextData> callData;
     string previousMemory;
+    string lastMemory; // Memory bytes built in the last opcode, in delta trace mode
+    vector<Fea> lastMemoryWords; // Memory words of lastMemory, to only convert the words that changed
+    vector<Fea> previousStack; // Stack of the previous opcode, in delta trace mode
     bool hasGaspriceOpcode;
     bool hasBalanceOpcode;
     uint64_t txIndex; // Transaction index in the current block
@@ -34,6 +34,8 @@
 #include "goldilocks_precomputed.hpp"
 #include "zklog.hpp"
 #include "ecrecover.hpp"
+#include "ecrecover_batch_precalc.hpp"
+#include "bytecode_hash_cache.hpp"
 #include "sha256.hpp"
 
 
@@ -112,10 +114,18 @@ MainExecutor::MainExecutor (Goldilocks &fr, PoseidonGoldilocks &poseidon, const
     outOfCountersMemalignLabel = rom.getLabel(string("outOfCountersMemalign"));
     outOfCountersPoseidonLabel = rom.getLabel(string("outOfCountersPoseidon"));
     outOfCountersPaddingLabel  = rom.getLabel(string("outOfCountersPadding"));
+    hashPoseidonLinearFromMemoryLabel = rom.getLabel(string("hashPoseidonLinearFromMemory"));
+    hashPoseidonReturnLabel    = rom.getLabel(string("hashPoseidonReturn"));
 
     // Init labels mutex
     pthread_mutex_init(&labelsMutex, NULL);
 
+    // Map the ROM lines to their labels
+    if (config.executorROMProfile)
+    {
+        romProfiler.init(rom);
+    }
+
     /* Get a HashDBInterface interface, according to the configuration */
     pHashDB = HashDBClientFactory::createHashDBClient(fr, config);
     if (pHashDB == NULL)
@@ -131,6 +141,12 @@ MainExecutor::~MainExecutor ()
 {
     TimerStart(MAIN_EXECUTOR_DESTRUCTOR_fork_9);
 
+    // Save the ROM profile accumulated since the last save
+    if (config.executorROMProfile)
+    {
+        romProfiler.save(config.outputPath + "/rom_profile_fork_9");
+    }
+
     HashDBClientFactory::freeHashDBClient(pHashDB);
 
     TimerStopAndLog(MAIN_EXECUTOR_DESTRUCTOR_fork_9);
@@ -172,6 +188,8 @@ void MainExecutor::execute (ProverRequest &proverRequest, MainCommitPols &pols,
     checkFirstTxTypeLabel     = rom.getLabel(string("checkFirstTxType"));
     writeBlockInfoRootLabel   = rom.getLabel(string("writeBlockInfoRoot"));
     verifyMerkleProofEndLabel = rom.getLabel(string("verifyMerkleProofEnd"));
+    hashPoseidonLinearFromMemoryLabel = rom.getLabel(string("hashPoseidonLinearFromMemory"));
+    hashPoseidonReturnLabel   = rom.getLabel(string("hashPoseidonReturn"));
     
 #endif
 
@@ -198,8 +216,45 @@ void MainExecutor::execute (ProverRequest &proverRequest, MainCommitPols &pols,
     remove("c.txt");
 #endif
 
+    // Read the input witness state from a binary witness database, instead of loading it into the hashdb, when it is
+    // local and reachable through the database read log, and the new state is not persisted into a shared database,
+    // which would then miss the witness nodes it refers to
+    bool bWitnessDB = false;
+    bool bWitnessDBReadable = config.witnessDB && (config.hashDBURL == "local") && !config.hashDB64 && (!proverRequest.input.bUpdateMerkleTree || (config.databaseURL == "local")) && (proverRequest.dbReadLog != NULL);
+    if (!proverRequest.input.witnessDBFile.empty())
+    {
+        zkresult zkr = proverRequest.witnessDB.open(proverRequest.input.witnessDBFile);
+        if (zkr != ZKR_SUCCESS)
+        {
+            proverRequest.result = zkr;
+            zklog.error("MainExecutor::execute() failed calling witnessDB.open() of file=" + proverRequest.input.witnessDBFile + " result=" + zkresult2string(zkr));
+            return;
+        }
+        if (!bWitnessDBReadable)
+        {
+            proverRequest.witnessDB.toMaps(proverRequest.input.db, proverRequest.input.contractsBytecode);
+            proverRequest.witnessDB.close();
+        }
+    }
+    else if (bWitnessDBReadable && ((proverRequest.input.db.size() > 0) || (proverRequest.input.contractsBytecode.size() > 0)))
+    {
+        zkresult zkr = proverRequest.witnessDB.build(proverRequest.input.db, proverRequest.input.contractsBytecode);
+        if (zkr != ZKR_SUCCESS)
+        {
+            zklog.warning("MainExecutor::execute() failed calling witnessDB.build() result=" + zkresult2string(zkr) + "; loading the witness into the hashdb");
+        }
+    }
+    if (proverRequest.witnessDB.isOpen())
+    {
+        proverRequest.dbReadLog->setWitnessDB(&proverRequest.witnessDB);
+        bWitnessDB = true;
+#ifdef LOG_TIME_STATISTICS_MAIN_EXECUTOR
+        zklog.info("MainExecutor::execute() using witness DB with nodes=" + to_string(proverRequest.witnessDB.getNodesSize()) + " programs=" + to_string(proverRequest.witnessDB.getProgramsSize()) + " size=" + to_string(proverRequest.witnessDB.getDataSize()) + "B");
+#endif
+    }
+
     // Copy input database content into context database
-    if (proverRequest.input.db.size() > 0)
+    if (!bWitnessDB && (proverRequest.input.db.size() > 0))
     {
         Goldilocks::Element stateRoot[4];
         scalar2fea(fr, proverRequest.input.publicInputsExtended.publicInputs.oldStateRoot, stateRoot);
@@ -213,7 +268,7 @@ void MainExecutor::execute (ProverRequest &proverRequest, MainCommitPols &pols,
     }
 
     // Copy input contracts database content into context database (dbProgram)
-    if (proverRequest.input.contractsBytecode.size() > 0)
+    if (!bWitnessDB && (proverRequest.input.contractsBytecode.size() > 0))
     {
         pHashDB->loadProgramDB(proverRequest.input.contractsBytecode, true);
         uint64_t flushId, lastSentFlushId;
@@ -224,6 +279,35 @@ void MainExecutor::execute (ProverRequest &proverRequest, MainCommitPols &pols,
         }
     }
 
+    // Precalculate the ECRecover of all the batch transactions in parallel, unless a previous execution already did it
+    ECRecoverBatchPrecalc ecRecoverBatchPrecalc;
+    if (config.ECRecoverPrecalc && config.ECRecoverBatchPrecalc && ((proverRequest.pBatchExecutionCacheEntry == NULL) || proverRequest.pBatchExecutionCacheEntry->bRecording))
+    {
+        TimerStart(ECRECOVER_BATCH_PRECALC);
+        uint64_t nTxs = ecRecoverBatchPrecalc.precalculate(proverRequest.input.publicInputsExtended.publicInputs.batchL2Data, config.ECRecoverPrecalcNThreads);
+        TimerStopAndLog(ECRECOVER_BATCH_PRECALC);
+#ifdef LOG_TIME_STATISTICS_MAIN_EXECUTOR
+        zklog.info("MainExecutor::execute() precalculated ECRecover of " + to_string(nTxs) + " txs");
+#else
+        (void)nTxs;
+#endif
+    }
+
+    // Hash the bytecodes of the state override in parallel, so that they are found in the bytecode hash cache
+    if (proverRequest.input.stateOverride.size() > 0)
+    {
+        vector<const vector<uint8_t> *> bytecodes;
+        unordered_map<string, OverrideEntry>::const_iterator it;
+        for (it = proverRequest.input.stateOverride.begin(); it != proverRequest.input.stateOverride.end(); it++)
+        {
+            if (it->second.code.size() > 0)
+            {
+                bytecodes.push_back(&it->second.code);
+            }
+        }
+        bytecodeLinearPoseidon(ctx, bytecodes);
+    }
+
     // opN are local, uncommitted polynomials
     Goldilocks::Element op0, op1, op2, op3, op4, op5, op6, op7;
 
@@ -294,6 +378,10 @@ void MainExecutor::execute (ProverRequest &proverRequest, MainCommitPols &pols,
         ctx.mem[rom.timestampOffset] = fea;
     }
 
+    // Profile of the steps and cycles spent in every ROM line
+    bool bRomProfile = config.executorROMProfile;
+    RomProfile romProfile(bRomProfile ? rom.size : 0);
+
     for (step=0; step<N_Max; step++)
     {
         if (bProcessBatch)
@@ -319,6 +407,11 @@ void MainExecutor::execute (ProverRequest &proverRequest, MainCommitPols &pols,
 
         zkPC = fr.toU64(pols.zkPC[i]); // This is the read line of ZK code
 
+        if (bRomProfile)
+        {
+            romProfile.step(zkPC);
+        }
+
         uint64_t incHashPos = 0;
         uint64_t incCounter = 0;
 
@@ -346,7 +439,26 @@ void MainExecutor::execute (ProverRequest &proverRequest, MainCommitPols &pols,
             fea2scalar(fr, r_, pols.B0[i], pols.B1[i], pols.B2[i], pols.B3[i], pols.B4[i], pols.B5[i], pols.B6[i], pols.B7[i]);
             fea2scalar(fr, s_, pols.C0[i], pols.C1[i], pols.C2[i], pols.C3[i], pols.C4[i], pols.C5[i], pols.C6[i], pols.C7[i]);
             fea2scalar(fr, v_, pols.D0[i], pols.D1[i], pols.D2[i], pols.D3[i], pols.D4[i], pols.D5[i], pols.D6[i], pols.D7[i]);
-            ctx.ecRecoverPrecalcBuffer.posUsed = ECRecoverPrecalc(signature_, r_, s_, v_, false, ctx.ecRecoverPrecalcBuffer.buffer, ctx.config.ECRecoverPrecalcNThreads);
+            // Reuse the points precalculated by the batch pre-pass or by a previous execution of this batch, if available
+            string ecRecoverKey;
+            if ((proverRequest.pBatchExecutionCacheEntry != NULL) || !ecRecoverBatchPrecalc.empty())
+            {
+                ecRecoverKey = BatchExecutionCacheEntry::getECRecoverKey(signature_, r_, s_, v_);
+            }
+            bool bFound = ecRecoverBatchPrecalc.get(ecRecoverKey, ctx.ecRecoverPrecalcBuffer.buffer, ctx.ecRecoverPrecalcBuffer.posUsed);
+            bool bFoundInCache = false;
+            if (!bFound && (proverRequest.pBatchExecutionCacheEntry != NULL))
+            {
+                bFound = bFoundInCache = proverRequest.pBatchExecutionCacheEntry->getECRecoverPrecalc(ecRecoverKey, ctx.ecRecoverPrecalcBuffer.buffer, ctx.ecRecoverPrecalcBuffer.posUsed);
+            }
+            if (!bFound)
+            {
+                ctx.ecRecoverPrecalcBuffer.posUsed = ECRecoverPrecalc(signature_, r_, s_, v_, false, ctx.ecRecoverPrecalcBuffer.buffer, ctx.config.ECRecoverPrecalcNThreads);
+            }
+            if (!bFoundInCache && (proverRequest.pBatchExecutionCacheEntry != NULL))
+            {
+                proverRequest.pBatchExecutionCacheEntry->setECRecoverPrecalc(ecRecoverKey, ctx.ecRecoverPrecalcBuffer.buffer, ctx.ecRecoverPrecalcBuffer.posUsed);
+            }
             ctx.ecRecoverPrecalcBuffer.pos = 0;
             if (ctx.ecRecoverPrecalcBuffer.posUsed > 0)
             {
@@ -1018,7 +1130,7 @@ void MainExecutor::execute (ProverRequest &proverRequest, MainCommitPols &pols,
                                 gettimeofday(&t, NULL);
 #endif
                                 Goldilocks::Element result[4];
-                                linearPoseidon(ctx, it->second.code, result);
+                                bytecodeLinearPoseidon(ctx, it->second.code, result);
 #ifdef LOG_TIME_STATISTICS_MAIN_EXECUTOR
                                 mainMetrics.add("Poseidon", TimeDiff(t));
 #endif
@@ -2840,7 +2952,15 @@ void MainExecutor::execute (ProverRequest &proverRequest, MainCommitPols &pols,
 #ifdef LOG_TIME_STATISTICS_MAIN_EXECUTOR
                 gettimeofday(&t, NULL);
 #endif
-                keccak256(hashKIterator->second.data.data(), hashKIterator->second.data.size(), hashKIterator->second.digest);
+                // Reuse the digest calculated by a previous execution of this batch, if available
+                if ((proverRequest.pBatchExecutionCacheEntry == NULL) || !proverRequest.pBatchExecutionCacheEntry->getKeccak(hashKIterator->second.data, hashKIterator->second.digest))
+                {
+                    keccak256(hashKIterator->second.data.data(), hashKIterator->second.data.size(), hashKIterator->second.digest);
+                    if (proverRequest.pBatchExecutionCacheEntry != NULL)
+                    {
+                        proverRequest.pBatchExecutionCacheEntry->setKeccak(hashKIterator->second.data, hashKIterator->second.digest);
+                    }
+                }
 #ifdef LOG_TIME_STATISTICS_MAIN_EXECUTOR
                 mainMetrics.add("Keccak", TimeDiff(t));
 #endif
@@ -3120,8 +3240,29 @@ void MainExecutor::execute (ProverRequest &proverRequest, MainCommitPols &pols,
                 gettimeofday(&t, NULL);
 #endif
                 Goldilocks::Element result[4];
-                linearPoseidon(ctx, hashPIterator->second.data, result);
-                fea2scalar(fr, hashPIterator->second.digest, result);
+                // Reuse the digest calculated by a previous execution of this batch, if available
+                if ((proverRequest.pBatchExecutionCacheEntry != NULL) && proverRequest.pBatchExecutionCacheEntry->getPoseidon(hashPIterator->second.data, hashPIterator->second.digest))
+                {
+                    scalar2fea(fr, hashPIterator->second.digest, result);
+                }
+                else
+                {
+                    // Only the deployed contract bytecodes, hashed by hashPoseidonLinearFromMemory, are worth caching
+                    // across batches; transaction and log data are hashed once
+                    if ((zkPC >= hashPoseidonLinearFromMemoryLabel) && (zkPC < hashPoseidonReturnLabel))
+                    {
+                        bytecodeLinearPoseidon(ctx, hashPIterator->second.data, result);
+                    }
+                    else
+                    {
+                        linearPoseidon(ctx, hashPIterator->second.data, result);
+                    }
+                    fea2scalar(fr, hashPIterator->second.digest, result);
+                    if (proverRequest.pBatchExecutionCacheEntry != NULL)
+                    {
+                        proverRequest.pBatchExecutionCacheEntry->setPoseidon(hashPIterator->second.data, hashPIterator->second.digest);
+                    }
+                }
 #ifdef LOG_TIME_STATISTICS_MAIN_EXECUTOR
                 mainMetrics.add("Poseidon", TimeDiff(t));
 #endif
@@ -5411,6 +5552,17 @@ void MainExecutor::execute (ProverRequest &proverRequest, MainCommitPols &pols,
 
     } // End of main executor loop, for all evaluations
 
+    // Accumulate and save the ROM profile
+    if (bRomProfile)
+    {
+        romProfile.stop();
+        romProfiler.add(romProfile);
+        if (romProfiler.isSaveDue(config.executorROMProfileSaveInterval))
+        {
+            romProfiler.save(config.outputPath + "/rom_profile_fork_9");
+        }
+    }
+
     // Copy the counters
     proverRequest.counters.arith = fr.toU64(pols.cntArith[0]);
     proverRequest.counters.binary = fr.toU64(pols.cntBinary[0]);
@@ -5683,6 +5835,10 @@ void MainExecutor::execute (ProverRequest &proverRequest, MainCommitPols &pols,
         mainMetrics.print("Main Executor calls");
         evalCommandMetrics.print("Main Executor eval command calls");
     }
+    if (proverRequest.pMainMetrics != NULL)
+    {
+        proverRequest.pMainMetrics->add(mainMetrics);
+    }
 #endif
 
     if (config.dbMetrics)
@@ -5691,6 +5847,11 @@ void MainExecutor::execute (ProverRequest &proverRequest, MainCommitPols &pols,
     }
 
     zklog.info("MainExecutor::execute() done lastStep=" + to_string(ctx.lastStep) + " (" + to_string((double(ctx.lastStep)*100)/N) + "%)", &proverRequest.tags);
+    if (bytecodeHashCache.enabled())
+    {
+        zklog.info("MainExecutor::execute() bytecode hashes hits=" + to_string(ctx.bytecodeHashHits) + " misses=" + to_string(ctx.bytecodeHashMisses) + " savedTime=" + to_string(ctx.bytecodeHashSavedTime) + " us", &proverRequest.tags);
+        bytecodeHashCache.print();
+    }
 
     TimerStopAndLog(MAIN_EXECUTOR_EXECUTE);
 }
@@ -5950,4 +6111,65 @@ void MainExecutor::linearPoseidon (Context &ctx, const vector<uint8_t> &data, Go
     poseidonLinearHash(data, result);
 }
 
+void MainExecutor::bytecodeLinearPoseidon (Context &ctx, const vector<uint8_t> &bytecode, Goldilocks::Element (&result)[4])
+{
+    // Reuse the hash of this bytecode calculated by a previous batch, if available
+    uint64_t time;
+    if (bytecodeHashCache.get(bytecode, result, time))
+    {
+        ctx.bytecodeHashHits++;
+        ctx.bytecodeHashSavedTime += time;
+        return;
+    }
+
+    struct timeval t;
+    gettimeofday(&t, NULL);
+    poseidonLinearHash(bytecode, result);
+    time = TimeDiff(t);
+    ctx.bytecodeHashMisses++;
+
+    if (bytecodeHashCache.enabled())
+    {
+        bytecodeHashCache.add(bytecode, result, time);
+    }
+}
+
+void MainExecutor::bytecodeLinearPoseidon (Context &ctx, const vector<const vector<uint8_t> *> &bytecodes)
+{
+    // Only the hashes stored in the cache can be reused later
+    if (!bytecodeHashCache.enabled())
+    {
+        return;
+    }
+
+    // Select the bytecodes not found in the cache
+    vector<const vector<uint8_t> *> missing;
+    Goldilocks::Element result[4];
+    uint64_t time;
+    for (uint64_t i=0; i<bytecodes.size(); i++)
+    {
+        if (bytecodeHashCache.get(*bytecodes[i], result, time))
+        {
+            ctx.bytecodeHashHits++;
+            ctx.bytecodeHashSavedTime += time;
+        }
+        else
+        {
+            missing.push_back(bytecodes[i]);
+        }
+    }
+
+    // Hash them in parallel, one bytecode per thread, and store them in the cache
+#pragma omp parallel for num_threads(config.bytecodeHashNThreads) schedule(dynamic)
+    for (uint64_t i=0; i<missing.size(); i++)
+    {
+        Goldilocks::Element hash[4];
+        struct timeval t;
+        gettimeofday(&t, NULL);
+        poseidonLinearHash(*missing[i], hash);
+        bytecodeHashCache.add(*missing[i], hash, TimeDiff(t));
+    }
+    ctx.bytecodeHashMisses += missing.size();
+}
+
 } // namespace
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <semaphore.h>
 #include "config.hpp"
 #include "main_sm/fork_9/main/rom.hpp"
+#include "main_sm/fork_9/main/rom_profiler.hpp"
 #include "main_sm/fork_9/main/context.hpp"
 #include "main_sm/fork_9/pols_generated/commit_pols.hpp"
 #include "main_sm/fork_9/main/main_exec_required.hpp"
@@ -71,10 +72,15 @@ public:
     uint64_t outOfCountersMemalignLabel;
     uint64_t outOfCountersPoseidonLabel;
     uint64_t outOfCountersPaddingLabel;
+    uint64_t hashPoseidonLinearFromMemoryLabel;
+    uint64_t hashPoseidonReturnLabel;
 
     // Labels lock
     pthread_mutex_t labelsMutex;    // Mutex to protect the labels vector
 
+    // ROM profile, accumulated over all executions if config.executorROMProfile
+    RomProfiler romProfiler;
+
     // HashDB
     HashDBInterface *pHashDB;
 
@@ -95,6 +101,8 @@ public:
     void assertOutputs(Context &ctx);
     void logError(Context &ctx, const string &message = "");
     void linearPoseidon(Context &ctx, const vector<uint8_t> &data, Goldilocks::Element (&result)[4]);
+    void bytecodeLinearPoseidon(Context &ctx, const vector<uint8_t> &bytecode, Goldilocks::Element (&result)[4]);
+    void bytecodeLinearPoseidon(Context &ctx, const vector<const vector<uint8_t> *> &bytecodes);
 
     // Labels lock / unlock
     void labelsLock(void) { pthread_mutex_lock(&labelsMutex); };
@@ -0,0 +1,174 @@
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+#include "main_sm/fork_9/main/rom_profiler.hpp"
+#include "zklog.hpp"
+
+namespace fork_9
+{
+
+// Flame graph frames cannot contain the frames separator nor the count separator
+string romProfilerFrame (const string &s)
+{
+    string frame = s;
+    replace(frame.begin(), frame.end(), ';', '_');
+    replace(frame.begin(), frame.end(), ' ', '_');
+    return frame;
+}
+
+RomProfiler::RomProfiler () : executions(0)
+{
+    pthread_mutex_init(&mutex, NULL);
+}
+
+RomProfiler::~RomProfiler ()
+{
+    pthread_mutex_destroy(&mutex);
+}
+
+void RomProfiler::init (const Rom &rom)
+{
+    Lock();
+
+    // Sort the labels by line; if several labels point to the same line, use the first one alphabetically
+    vector<pair<uint64_t, string>> sortedLabels;
+    unordered_map<string, uint64_t>::const_iterator it;
+    for (it = rom.labels.begin(); it != rom.labels.end(); it++)
+    {
+        sortedLabels.emplace_back(it->second, it->first);
+    }
+    sort(sortedLabels.begin(), sortedLabels.end());
+
+    // Every line belongs to the routine of the closest previous label
+    steps.assign(rom.size, 0);
+    cycles.assign(rom.size, 0);
+    lineStacks.resize(rom.size);
+    lineLabels.resize(rom.size);
+    uint64_t nextLabel = 0;
+    string label = "start";
+    for (uint64_t zkPC=0; zkPC<rom.size; zkPC++)
+    {
+        if ((nextLabel < sortedLabels.size()) && (sortedLabels[nextLabel].first <= zkPC))
+        {
+            label = sortedLabels[nextLabel].second;
+            while ((nextLabel < sortedLabels.size()) && (sortedLabels[nextLabel].first <= zkPC))
+            {
+                nextLabel++;
+            }
+        }
+        string fileName = romProfilerFrame(rom.line[zkPC].fileName);
+        lineLabels[zkPC] = romProfilerFrame(label);
+        lineStacks[zkPC] = "fork_9;" + fileName + ";" + lineLabels[zkPC] + ";" + fileName + ":" + to_string(rom.line[zkPC].line);
+    }
+    executions = 0;
+    gettimeofday(&lastSaveTime, NULL);
+
+    Unlock();
+}
+
+void RomProfiler::add (const RomProfile &profile)
+{
+    Lock();
+
+    // Ignore profiles of a different ROM
+    if (profile.steps.size() != steps.size())
+    {
+        Unlock();
+        zklog.warning("RomProfiler::add() got a profile of size=" + to_string(profile.steps.size()) + " different from the ROM size=" + to_string(steps.size()));
+        return;
+    }
+
+    for (uint64_t zkPC=0; zkPC<steps.size(); zkPC++)
+    {
+        steps[zkPC] += profile.steps[zkPC];
+        cycles[zkPC] += profile.cycles[zkPC];
+    }
+    executions++;
+
+    Unlock();
+}
+
+bool RomProfiler::isSaveDue (uint64_t interval)
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+
+    Lock();
+    bool bDue = (uint64_t(now.tv_sec - lastSaveTime.tv_sec) >= interval);
+    if (bDue)
+    {
+        lastSaveTime = now;
+    }
+    Unlock();
+
+    return bDue;
+}
+
+void RomProfiler::save (const string &fileName)
+{
+    // Copy the accumulated profile; the line stacks and labels do not change after init()
+    Lock();
+    vector<uint64_t> savedSteps = steps;
+    vector<uint64_t> savedCycles = cycles;
+    uint64_t savedExecutions = executions;
+    Unlock();
+
+    // Flame graph input, one folded stack per executed line
+    string folded;
+    uint64_t totalSteps = 0;
+    uint64_t totalCycles = 0;
+    unordered_map<string, pair<uint64_t, uint64_t>> labels; // steps and cycles, per ROM label
+    for (uint64_t zkPC=0; zkPC<savedSteps.size(); zkPC++)
+    {
+        if (savedSteps[zkPC] == 0)
+        {
+            continue;
+        }
+        folded += lineStacks[zkPC] + " " + to_string(savedCycles[zkPC]) + "\n";
+        totalSteps += savedSteps[zkPC];
+        totalCycles += savedCycles[zkPC];
+        pair<uint64_t, uint64_t> &label = labels[lineLabels[zkPC]];
+        label.first += savedSteps[zkPC];
+        label.second += savedCycles[zkPC];
+    }
+
+    // Summary per ROM label, sorted by cycles
+    vector<pair<uint64_t, string>> sortedLabels;
+    unordered_map<string, pair<uint64_t, uint64_t>>::const_iterator it;
+    for (it = labels.begin(); it != labels.end(); it++)
+    {
+        sortedLabels.emplace_back(it->second.second, it->first);
+    }
+    sort(sortedLabels.rbegin(), sortedLabels.rend());
+    string summary = "executions=" + to_string(savedExecutions) + " steps=" + to_string(totalSteps) + " cycles=" + to_string(totalCycles) + "\n";
+    summary += "label steps cycles cycles/step per_mille\n";
+    for (uint64_t i=0; i<sortedLabels.size(); i++)
+    {
+        const pair<uint64_t, uint64_t> &label = labels[sortedLabels[i].second];
+        summary += sortedLabels[i].second + " " + to_string(label.first) + " " + to_string(label.second) + " " + to_string(label.second/label.first) + " " + to_string((totalCycles == 0) ? 0 : label.second*1000/totalCycles) + "\n";
+    }
+
+    // Write into temporary files and rename them, so that readers never get a partial profile; the caller makes sure
+    // that only one thread saves at a time, e.g. calling isSaveDue()
+    const string extensions[2] = {".folded", ".txt"};
+    const string * contents[2] = {&folded, &summary};
+    for (uint64_t i=0; i<2; i++)
+    {
+        string tmpFileName = fileName + extensions[i] + ".tmp";
+        std::ofstream outfile(tmpFileName, std::ios::out | std::ios::trunc);
+        if (!outfile.good())
+        {
+            zklog.error("RomProfiler::save() failed opening file=" + tmpFileName);
+            return;
+        }
+        outfile << *contents[i];
+        outfile.close();
+        if (rename(tmpFileName.c_str(), (fileName + extensions[i]).c_str()) != 0)
+        {
+            zklog.error("RomProfiler::save() failed renaming file=" + tmpFileName);
+            return;
+        }
+    }
+}
+
+} // namespace
@@ -0,0 +1,92 @@
+#ifndef ROM_PROFILER_HPP_fork_9
+#define ROM_PROFILER_HPP_fork_9
+
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <sys/time.h>
+#include <x86intrin.h>
+#include "main_sm/fork_9/main/rom.hpp"
+
+using namespace std;
+
+namespace fork_9
+{
+
+// Steps and time stamp counter cycles spent in every ROM line during one execution; it is recorded by the executing
+// thread without locks, and the cycles of a step, including its commands and hashdb calls, are attributed to its line
+class RomProfile
+{
+public:
+    vector<uint64_t> steps; // Executed steps, per zkPC
+    vector<uint64_t> cycles; // Cycles spent, per zkPC
+    uint64_t lastZkPC; // Line of the step being measured
+    uint64_t lastCycles; // Time stamp counter when the step being measured started
+    bool bRunning;
+
+    RomProfile (uint64_t romSize) : steps(romSize, 0), cycles(romSize, 0), lastZkPC(0), lastCycles(0), bRunning(false) {};
+
+    // Called when a step starts; closes the measurement of the previous step
+    inline void step (uint64_t zkPC)
+    {
+        uint64_t now = __rdtsc();
+        if (bRunning)
+        {
+            steps[lastZkPC]++;
+            cycles[lastZkPC] += now - lastCycles;
+        }
+        bRunning = true;
+        lastZkPC = zkPC;
+        lastCycles = now;
+    }
+
+    // Called when the execution ends; closes the measurement of the last step
+    inline void stop (void)
+    {
+        if (bRunning)
+        {
+            steps[lastZkPC]++;
+            cycles[lastZkPC] += __rdtsc() - lastCycles;
+            bRunning = false;
+        }
+    }
+};
+
+// Accumulates the profiles of all the executions of a ROM, and saves them as a flame graph input file, with one
+// "fork_9;<zkasm file>;<ROM label>;<zkasm file>:<line> <cycles>" folded stack per executed line, and as a summary of
+// steps and cycles per ROM label
+class RomProfiler
+{
+private:
+    pthread_mutex_t mutex; // Mutex to protect the accumulated profile
+    void Lock(void) { pthread_mutex_lock(&mutex); };
+    void Unlock(void) { pthread_mutex_unlock(&mutex); };
+
+    vector<uint64_t> steps; // Accumulated steps, per zkPC
+    vector<uint64_t> cycles; // Accumulated cycles, per zkPC
+    vector<string> lineStacks; // Folded stack of every line, i.e. "fork_9;<zkasm file>;<ROM label>;<zkasm file>:<line>"
+    vector<string> lineLabels; // ROM label of the routine every line belongs to, i.e. the closest previous label
+    uint64_t executions;
+    struct timeval lastSaveTime; // Time of the last save, or of the init
+
+public:
+    RomProfiler ();
+    ~RomProfiler ();
+
+    // Maps every ROM line to its file and label
+    void init (const Rom &rom);
+
+    // Adds the profile of an execution of the same ROM
+    void add (const RomProfile &profile);
+
+    // Returns true, to only one of the calling threads, if the last save is older than interval seconds
+    bool isSaveDue (uint64_t interval);
+
+    // Writes the accumulated profile into <fileName>.folded (flame graph input) and <fileName>.txt (summary per label);
+    // the profile is copied under the lock, and the files are built and written without it
+    void save (const string &fileName);
+};
+
+} // namespace
+
+#endif
@@ -1,4 +1,7 @@
 #include "poseidon_opt.hpp"
+#ifdef __AVX512IFMA__
+#include <immintrin.h>
+#endif
 
 void Poseidon_opt::hash(vector<FrElement> &state, FrElement *result)
 {
@@ -98,3 +101,450 @@ void Poseidon_opt::mix(vector<FrElement> *new_state, vector<FrElement> state, co
 		}
 	}
 }
+
+/*
+ * Batched hash
+ *
+ * The permutation is written once, as a template over the lane arithmetic: Lanes::Vec holds the same state
+ * element of POSEIDON_OPT_LANES independent hashes, and Lanes::Const is the representation of the constants
+ */
+
+// Constants of a state size, in the representation of the lane arithmetic; matrices are flattened as m[j*t + i] = M[j][i]
+template <class Const>
+struct PoseidonOptTables
+{
+	vector<Const> c;
+	vector<Const> s;
+	vector<Const> m;
+	vector<Const> p;
+};
+
+template <class Lanes>
+static const PoseidonOptTables<typename Lanes::Const> &getPoseidonOptTables(const int t)
+{
+	// Converted once, the first time they are used
+	static const vector<PoseidonOptTables<typename Lanes::Const>> tables = []()
+	{
+		vector<PoseidonOptTables<typename Lanes::Const>> tables(Constants_opt::C.size());
+		for (uint64_t k = 0; k < tables.size(); k++)
+		{
+			for (uint64_t i = 0; i < Constants_opt::C[k].size(); i++)
+			{
+				tables[k].c.push_back(Lanes::toConst(Constants_opt::C[k][i]));
+			}
+			for (uint64_t i = 0; i < Constants_opt::S[k].size(); i++)
+			{
+				tables[k].s.push_back(Lanes::toConst(Constants_opt::S[k][i]));
+			}
+			for (uint64_t j = 0; j < Constants_opt::M[k].size(); j++)
+			{
+				for (uint64_t i = 0; i < Constants_opt::M[k][j].size(); i++)
+				{
+					tables[k].m.push_back(Lanes::toConst(Constants_opt::M[k][j][i]));
+				}
+			}
+			for (uint64_t j = 0; j < Constants_opt::P[k].size(); j++)
+			{
+				for (uint64_t i = 0; i < Constants_opt::P[k][j].size(); i++)
+				{
+					tables[k].p.push_back(Lanes::toConst(Constants_opt::P[k][j][i]));
+				}
+			}
+		}
+		return tables;
+	}();
+	return tables[t - 2];
+}
+
+template <class Lanes>
+static inline void exp5Lanes(typename Lanes::Vec &r)
+{
+	typename Lanes::Vec aux;
+	Lanes::square(aux, r);
+	Lanes::square(aux, aux);
+	Lanes::mul(r, aux, r);
+}
+
+template <class Lanes>
+static inline void sboxLanes(typename Lanes::Vec *state, const typename Lanes::Const *c, const int t)
+{
+	for (int i = 0; i < t; i++)
+	{
+		exp5Lanes<Lanes>(state[i]);
+		Lanes::addConst(state[i], state[i], c[i]);
+	}
+}
+
+template <class Lanes>
+static inline void mixLanes(typename Lanes::Vec *state, const typename Lanes::Const *m, const int t)
+{
+	typename Lanes::Vec newState[17];
+	typename Lanes::Vec aux;
+	for (int i = 0; i < t; i++)
+	{
+		Lanes::mulConst(newState[i], state[0], m[i]);
+		for (int j = 1; j < t; j++)
+		{
+			Lanes::mulConst(aux, state[j], m[j * t + i]);
+			Lanes::add(newState[i], newState[i], aux);
+		}
+	}
+	for (int i = 0; i < t; i++)
+	{
+		state[i] = newState[i];
+	}
+}
+
+template <class Lanes>
+static void hashLanes(const RawFr::Element *states, const uint64_t nLanes, const int t, const int nRoundsP, const int nRoundsF, RawFr::Element *results)
+{
+	const PoseidonOptTables<typename Lanes::Const> &tables = getPoseidonOptTables<Lanes>(t);
+	const typename Lanes::Const *c = tables.c.data();
+	const typename Lanes::Const *s = tables.s.data();
+
+	typename Lanes::Vec state[17];
+	for (int i = 0; i < t; i++)
+	{
+		Lanes::load(state[i], states, nLanes, t, i);
+		Lanes::addConst(state[i], state[i], c[i]);
+	}
+	for (int r = 0; r < nRoundsF / 2 - 1; r++)
+	{
+		sboxLanes<Lanes>(state, &c[(r + 1) * t], t);
+		mixLanes<Lanes>(state, tables.m.data(), t);
+	}
+	sboxLanes<Lanes>(state, &c[(nRoundsF / 2 - 1 + 1) * t], t);
+	mixLanes<Lanes>(state, tables.p.data(), t);
+	typename Lanes::Vec s0;
+	typename Lanes::Vec aux;
+	for (int r = 0; r < nRoundsP; r++)
+	{
+		exp5Lanes<Lanes>(state[0]);
+		Lanes::addConst(state[0], state[0], c[(nRoundsF / 2 + 1) * t + r]);
+
+		Lanes::mulConst(s0, state[0], s[(t * 2 - 1) * r]);
+		for (int j = 1; j < t; j++)
+		{
+			Lanes::mulConst(aux, state[j], s[(t * 2 - 1) * r + j]);
+			Lanes::add(s0, s0, aux);
+			Lanes::mulConst(aux, state[0], s[(t * 2 - 1) * r + t + j - 1]);
+			Lanes::add(state[j], state[j], aux);
+		}
+		state[0] = s0;
+	}
+	for (int r = 0; r < nRoundsF / 2 - 1; r++)
+	{
+		sboxLanes<Lanes>(state, &c[(nRoundsF / 2 + 1) * t + nRoundsP + r * t], t);
+		mixLanes<Lanes>(state, tables.m.data(), t);
+	}
+	for (int i = 0; i < t; i++)
+	{
+		exp5Lanes<Lanes>(state[i]);
+	}
+	mixLanes<Lanes>(state, tables.m.data(), t);
+
+	Lanes::store(results, nLanes, state[0]);
+}
+
+// Lanes computed one after the other with the ffiasm Montgomery arithmetic
+class PoseidonOptScalarLanes
+{
+public:
+	typedef RawFr::Element Const;
+	struct Vec
+	{
+		RawFr::Element e[POSEIDON_OPT_LANES];
+	};
+
+	static inline Const toConst(const RawFr::Element &a) { return a; }
+
+	static inline void load(Vec &r, const RawFr::Element *states, const uint64_t nLanes, const int t, const int i)
+	{
+		for (uint64_t l = 0; l < POSEIDON_OPT_LANES; l++)
+		{
+			r.e[l] = (l < nLanes) ? states[l * t + i] : RawFr::field.zero();
+		}
+	}
+	static inline void store(RawFr::Element *results, const uint64_t nLanes, const Vec &a)
+	{
+		for (uint64_t l = 0; l < nLanes; l++)
+		{
+			results[l] = a.e[l];
+		}
+	}
+	static inline void add(Vec &r, const Vec &a, const Vec &b)
+	{
+		for (uint64_t l = 0; l < POSEIDON_OPT_LANES; l++)
+		{
+			Fr_rawAdd(r.e[l].v, a.e[l].v, b.e[l].v);
+		}
+	}
+	static inline void addConst(Vec &r, const Vec &a, const Const &b)
+	{
+		for (uint64_t l = 0; l < POSEIDON_OPT_LANES; l++)
+		{
+			Fr_rawAdd(r.e[l].v, a.e[l].v, b.v);
+		}
+	}
+	static inline void mul(Vec &r, const Vec &a, const Vec &b)
+	{
+		for (uint64_t l = 0; l < POSEIDON_OPT_LANES; l++)
+		{
+			Fr_rawMMul(r.e[l].v, a.e[l].v, b.e[l].v);
+		}
+	}
+	static inline void mulConst(Vec &r, const Vec &a, const Const &b)
+	{
+		for (uint64_t l = 0; l < POSEIDON_OPT_LANES; l++)
+		{
+			Fr_rawMMul(r.e[l].v, a.e[l].v, b.v);
+		}
+	}
+	static inline void square(Vec &r, const Vec &a)
+	{
+		for (uint64_t l = 0; l < POSEIDON_OPT_LANES; l++)
+		{
+			Fr_rawMSquare(r.e[l].v, a.e[l].v);
+		}
+	}
+};
+
+#ifdef __AVX512IFMA__
+
+// One lane per 64-bit slot of a 512-bit register, with 52-bit limbs multiplied by the IFMA instructions.
+// Elements are kept in Montgomery form with R = 2^260 (five limbs) instead of the ffiasm R = 2^256, so they
+// are scaled by 2^4 when loaded and back when stored; results are canonical, so they match the ffiasm ones
+class PoseidonOptIfmaLanes
+{
+public:
+	struct Const
+	{
+		uint64_t l[5];
+	};
+	struct Vec
+	{
+		__m512i l[5];
+	};
+
+private:
+	static const uint64_t MASK52 = 0xFFFFFFFFFFFFF;
+
+	struct Field
+	{
+		__m512i q[5]; // Prime limbs
+		__m512i mu;	  // -q^-1 mod 2^52
+		__m512i r256[5]; // 2^256 mod q, used to go back from R = 2^260 to R = 2^256
+	};
+
+	static void toLimbs(uint64_t *l, const FrRawElement v)
+	{
+		l[0] = v[0] & MASK52;
+		l[1] = ((v[0] >> 52) | (v[1] << 12)) & MASK52;
+		l[2] = ((v[1] >> 40) | (v[2] << 24)) & MASK52;
+		l[3] = ((v[2] >> 28) | (v[3] << 36)) & MASK52;
+		l[4] = v[3] >> 16;
+	}
+
+	static void fromLimbs(FrRawElement v, const uint64_t *l)
+	{
+		v[0] = l[0] | (l[1] << 52);
+		v[1] = (l[1] >> 12) | (l[2] << 40);
+		v[2] = (l[2] >> 24) | (l[3] << 28);
+		v[3] = (l[3] >> 36) | (l[4] << 16);
+	}
+
+	static const Field &field()
+	{
+		static const Field f = []()
+		{
+			Field f;
+			uint64_t l[5];
+			toLimbs(l, Fr_rawq);
+			for (int j = 0; j < 5; j++)
+			{
+				f.q[j] = _mm512_set1_epi64(l[j]);
+			}
+			uint64_t inv = Fr_rawq[0]; // Newton iteration for q^-1 mod 2^64
+			for (int i = 0; i < 6; i++)
+			{
+				inv *= 2 - Fr_rawq[0] * inv;
+			}
+			f.mu = _mm512_set1_epi64((0 - inv) & MASK52);
+			toLimbs(l, RawFr::field.one().v);
+			for (int j = 0; j < 5; j++)
+			{
+				f.r256[j] = _mm512_set1_epi64(l[j]);
+			}
+			return f;
+		}();
+		return f;
+	}
+
+	// Reduces normalized limbs of a value lower than 2q to [0, q)
+	static inline void reduce(__m512i *r, const __m512i *t, const Field &f)
+	{
+		const __m512i mask = _mm512_set1_epi64(MASK52);
+		__m512i d[5];
+		__m512i carry = _mm512_setzero_si512();
+		for (int j = 0; j < 5; j++)
+		{
+			d[j] = _mm512_add_epi64(_mm512_sub_epi64(t[j], f.q[j]), carry);
+			carry = _mm512_srai_epi64(d[j], 52);
+			d[j] = _mm512_and_si512(d[j], mask);
+		}
+		__mmask8 negative = _mm512_cmplt_epi64_mask(carry, _mm512_setzero_si512());
+		for (int j = 0; j < 5; j++)
+		{
+			r[j] = _mm512_mask_blend_epi64(negative, d[j], t[j]);
+		}
+	}
+
+	// Montgomery multiplication, a*b/2^260 mod q, interleaving the product and the reduction per limb of b
+	static inline void mulMont(__m512i *r, const __m512i *a, const __m512i *b)
+	{
+		const Field &f = field();
+		const __m512i zero = _mm512_setzero_si512();
+		__m512i t[6] = {zero, zero, zero, zero, zero, zero};
+		for (int i = 0; i < 5; i++)
+		{
+			for (int j = 0; j < 5; j++)
+			{
+				t[j] = _mm512_madd52lo_epu64(t[j], a[j], b[i]);
+				t[j + 1] = _mm512_madd52hi_epu64(t[j + 1], a[j], b[i]);
+			}
+			__m512i m = _mm512_madd52lo_epu64(zero, t[0], f.mu);
+			for (int j = 0; j < 5; j++)
+			{
+				t[j] = _mm512_madd52lo_epu64(t[j], f.q[j], m);
+				t[j + 1] = _mm512_madd52hi_epu64(t[j + 1], f.q[j], m);
+			}
+			// The lower 52 bits of t[0] are now zero; shift one limb down
+			t[1] = _mm512_add_epi64(t[1], _mm512_srli_epi64(t[0], 52));
+			for (int j = 0; j < 5; j++)
+			{
+				t[j] = t[j + 1];
+			}
+			t[5] = zero;
+		}
+		const __m512i mask = _mm512_set1_epi64(MASK52);
+		for (int j = 0; j < 4; j++)
+		{
+			t[j + 1] = _mm512_add_epi64(t[j + 1], _mm512_srli_epi64(t[j], 52));
+			t[j] = _mm512_and_si512(t[j], mask);
+		}
+		reduce(r, t, f);
+	}
+
+	static inline void addMod(__m512i *r, const __m512i *a, const __m512i *b)
+	{
+		const __m512i mask = _mm512_set1_epi64(MASK52);
+		__m512i t[5];
+		for (int j = 0; j < 5; j++)
+		{
+			t[j] = _mm512_add_epi64(a[j], b[j]);
+		}
+		for (int j = 0; j < 4; j++)
+		{
+			t[j + 1] = _mm512_add_epi64(t[j + 1], _mm512_srli_epi64(t[j], 52));
+			t[j] = _mm512_and_si512(t[j], mask);
+		}
+		reduce(r, t, field());
+	}
+
+	static inline void broadcast(__m512i *r, const Const &a)
+	{
+		for (int j = 0; j < 5; j++)
+		{
+			r[j] = _mm512_set1_epi64(a.l[j]);
+		}
+	}
+
+public:
+	static Const toConst(const RawFr::Element &a)
+	{
+		RawFr::Element a16;
+		Fr_rawAdd(a16.v, a.v, a.v);
+		Fr_rawAdd(a16.v, a16.v, a16.v);
+		Fr_rawAdd(a16.v, a16.v, a16.v);
+		Fr_rawAdd(a16.v, a16.v, a16.v);
+		Const r;
+		toLimbs(r.l, a16.v);
+		return r;
+	}
+
+	static inline void load(Vec &r, const RawFr::Element *states, const uint64_t nLanes, const int t, const int i)
+	{
+		alignas(64) uint64_t l[5][POSEIDON_OPT_LANES];
+		for (uint64_t lane = 0; lane < POSEIDON_OPT_LANES; lane++)
+		{
+			uint64_t aux[5] = {0, 0, 0, 0, 0};
+			if (lane < nLanes)
+			{
+				toLimbs(aux, states[lane * t + i].v);
+			}
+			for (int j = 0; j < 5; j++)
+			{
+				l[j][lane] = aux[j];
+			}
+		}
+		for (int j = 0; j < 5; j++)
+		{
+			r.l[j] = _mm512_load_si512(l[j]);
+		}
+		// Scale by 2^4 to move from R = 2^256 to R = 2^260
+		for (int k = 0; k < 4; k++)
+		{
+			addMod(r.l, r.l, r.l);
+		}
+	}
+
+	static inline void store(RawFr::Element *results, const uint64_t nLanes, const Vec &a)
+	{
+		__m512i aux[5];
+		mulMont(aux, a.l, field().r256);
+		alignas(64) uint64_t l[5][POSEIDON_OPT_LANES];
+		for (int j = 0; j < 5; j++)
+		{
+			_mm512_store_si512(l[j], aux[j]);
+		}
+		for (uint64_t lane = 0; lane < nLanes; lane++)
+		{
+			uint64_t limbs[5] = {l[0][lane], l[1][lane], l[2][lane], l[3][lane], l[4][lane]};
+			fromLimbs(results[lane].v, limbs);
+		}
+	}
+
+	static inline void add(Vec &r, const Vec &a, const Vec &b) { addMod(r.l, a.l, b.l); }
+	static inline void addConst(Vec &r, const Vec &a, const Const &b)
+	{
+		__m512i aux[5];
+		broadcast(aux, b);
+		addMod(r.l, a.l, aux);
+	}
+	static inline void mul(Vec &r, const Vec &a, const Vec &b) { mulMont(r.l, a.l, b.l); }
+	static inline void mulConst(Vec &r, const Vec &a, const Const &b)
+	{
+		__m512i aux[5];
+		broadcast(aux, b);
+		mulMont(r.l, a.l, aux);
+	}
+	static inline void square(Vec &r, const Vec &a) { mulMont(r.l, a.l, a.l); }
+};
+
+#endif // __AVX512IFMA__
+
+void Poseidon_opt::hash(const FrElement *states, uint64_t nHashes, const int t, FrElement *results)
+{
+	assert((t >= 2) && (t < 18));
+	const int nRoundsP = N_ROUNDS_P[t - 2];
+
+	for (uint64_t i = 0; i < nHashes; i += POSEIDON_OPT_LANES)
+	{
+		uint64_t nLanes = (nHashes - i < POSEIDON_OPT_LANES) ? nHashes - i : POSEIDON_OPT_LANES;
+#ifdef __AVX512IFMA__
+		hashLanes<PoseidonOptIfmaLanes>(&states[i * t], nLanes, t, nRoundsP, N_ROUNDS_F, &results[i]);
+#else
+		hashLanes<PoseidonOptScalarLanes>(&states[i * t], nLanes, t, nRoundsP, N_ROUNDS_F, &results[i]);
+#endif
+	}
+}
@@ -8,6 +8,9 @@
 #include <cassert>
 using namespace std;
 
+// Number of independent states hashed together by the batched hash
+#define POSEIDON_OPT_LANES 8
+
 class Poseidon_opt
 {
   typedef RawFr::Element FrElement;
@@ -26,6 +29,11 @@ private:
 public:
   void hash(vector<FrElement> &state);
   void hash(vector<FrElement> &state, FrElement *result);
+
+  // Batched hash of nHashes independent states of size t, stored consecutively (state i starts at states[i*t]).
+  // POSEIDON_OPT_LANES states are permuted at a time, interleaving their field operations (using AVX-512 IFMA
+  // when available); results[i] gets the same value as hash(state_i, &results[i])
+  void hash(const FrElement *states, uint64_t nHashes, const int t, FrElement *results);
   void gmimc(vector<FrElement>, FrElement *result);
 };
 
@@ -5,7 +5,7 @@
 
 //#define LOG_DATA_STREAM
 
-uint8_t ParseU8 (const string &data, uint64_t &p)
+uint8_t ParseU8 (string_view data, uint64_t &p)
 {
     uint8_t result;
     result = data[p];
@@ -13,7 +13,7 @@ uint8_t ParseU8 (const string &data, uint64_t &p)
     return result;
 }
 
-uint16_t ParseBigEndianU16 (const string &data, uint64_t &p)
+uint16_t ParseBigEndianU16 (string_view data, uint64_t &p)
 {
     // Get the 2 bytes
     uint8_t d0 = data[p];
@@ -31,7 +31,7 @@ uint16_t ParseBigEndianU16 (const string &data, uint64_t &p)
     return result;
 }
 
-uint32_t ParseBigEndianU32 (const string &data, uint64_t &p)
+uint32_t ParseBigEndianU32 (string_view data, uint64_t &p)
 {
     // Get the 4 bytes
     uint8_t d0 = data[p];
@@ -55,7 +55,7 @@ uint32_t ParseBigEndianU32 (const string &data, uint64_t &p)
     return result;
 }
 
-uint64_t ParseBigEndianU64 (const string &data, uint64_t &p)
+uint64_t ParseBigEndianU64 (string_view data, uint64_t &p)
 {
     // Get the 8 bytes
     uint8_t d0 = data[p];
@@ -68,7 +68,7 @@ uint64_t ParseBigEndianU64 (const string &data, uint64_t &p)
     uint8_t d7 = data[p+7];
 
     // Build the result
-    uint32_t result;
+    uint64_t result;
     result = d0;
     result <<= 8;
     result += d1;
@@ -102,11 +102,9 @@ string EncodeBigEndianU32 (uint32_t value)
     return result;
 }
 
-zkresult dataStream2batch (const string &dataStream, DataStreamBatch &batch)
+zkresult DataStreamReader::next (DataStreamEntry &entry, bool &bEnd)
 {
-    // Initialize variables
-    uint64_t p = 0;
-    batch.reset();
+    bEnd = false;
 
     // While there is data to process
     while (p < dataStream.size())
@@ -120,51 +118,37 @@ zkresult dataStream2batch (const string &dataStream, DataStreamBatch &batch)
             u8[] data
         */
 
+        // Check that there is enough room for the entry header
+        if (p + 17 > dataStream.size())
+        {
+            zklog.error("DataStreamReader::next() parsing entry header, run out of data stream data p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
+            return ZKR_DATA_STREAM_INVALID_DATA;
+        }
+
         // Parse packet type
         uint8_t packetType = ParseU8(dataStream, p);
 
         // Parse length
-        if (p + 4 > dataStream.size())
-        {
-            zklog.error("dataStream2batch() parsing length, run out of data stream data p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
-            return ZKR_DATA_STREAM_INVALID_DATA;
-        }
         uint32_t length = ParseBigEndianU32(dataStream, p);
 
         // Check length range
         if (length < 17)
         {
-            zklog.error("dataStream2batch() checking length range, length=" + to_string(length) + "<17");
+            zklog.error("DataStreamReader::next() checking length range, length=" + to_string(length) + "<17");
             return ZKR_DATA_STREAM_INVALID_DATA;
         }
-        if (p + length - 1 /*packetType*/ - 4 /*length*/ - 1 > dataStream.size())
-        {
-            zklog.error("dataStream2batch() checking length, run out of data stream data p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
-            //return ZKR_DATA_STREAM_INVALID_DATA;
-        }
 
         // Parse type
-        if (p + 4 > dataStream.size())
-        {
-            zklog.error("dataStream2batch() parsing type, run out of data stream data p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
-            return ZKR_DATA_STREAM_INVALID_DATA;
-        }
         uint32_t entryType = ParseBigEndianU32(dataStream, p);
 
-        // Parse number
-        if (p + 8 > dataStream.size())
-        {
-            zklog.error("dataStream2batch() parsing number, run out of data stream data p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
-            return ZKR_DATA_STREAM_INVALID_DATA;
-        }
-        //uint64_t number = ParseBigEndianU64(dataStream, p);
+        // Skip number
         p += 8;
 
         // Check that there is enough room for data
         uint64_t dataLength = length - 17;
-        if (p + dataLength > dataStream.size())
+        if (dataLength > dataStream.size() - p)
         {
-            zklog.error("dataStream2batch() checking data length=" + to_string(dataLength) + ", run out of data stream data p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
+            zklog.error("DataStreamReader::next() checking data length=" + to_string(dataLength) + ", run out of data stream data p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
             return ZKR_DATA_STREAM_INVALID_DATA;
         }
 
@@ -178,18 +162,20 @@ zkresult dataStream2batch (const string &dataStream, DataStreamBatch &batch)
         // If packet type is not entry, then fail
         if (packetType != 2)
         {
-            zklog.error("dataStream2batch() unsupported packet type=" + to_string(p) + " data p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
+            zklog.error("DataStreamReader::next() unsupported packet type=" + to_string(packetType) + " data p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
             return ZKR_DATA_STREAM_INVALID_DATA;
         }
 
+        entry.type = entryType;
+
         // Check type
         switch (entryType)
         {
-            case 0xb0: // Bookmark type, skip
+            case DATA_STREAM_ENTRY_BOOKMARK: // Bookmark type, skip
             {
                 p += dataLength;
 #ifdef LOG_DATA_STREAM
-                zklog.info("dataStream2batch() BOOKMARK");
+                zklog.info("DataStreamReader::next() BOOKMARK");
 #endif
                 continue;
             }
@@ -209,73 +195,178 @@ zkresult dataStream2batch (const string &dataStream, DataStreamBatch &batch)
                     u16 forkID
                     u32 chainID
             */
-            case 1: // Start L2 block
+            case DATA_STREAM_ENTRY_START_L2_BLOCK:
             {
                 // Check data length range
                 if (dataLength != 122)
                 {
-                    zklog.error("dataStream2batch() start L2 block invalid dataLength=" + to_string(dataLength) + "!=122 p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
+                    zklog.error("DataStreamReader::next() start L2 block invalid dataLength=" + to_string(dataLength) + "!=122 p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
+                    return ZKR_DATA_STREAM_INVALID_DATA;
+                }
+
+                DataStreamBlock &block = entry.block;
+                entry.batchNumber = ParseBigEndianU64(dataStream, p);
+                block.blockNumber = ParseBigEndianU64(dataStream, p);
+                block.timestamp = ParseBigEndianU64(dataStream, p);
+                block.deltaTimestamp = ParseBigEndianU32(dataStream, p);
+                block.l1InfoTreeIndex = ParseBigEndianU32(dataStream, p);
+                ba2string(block.l1BlockHash, (const uint8_t *)dataStream.data() + p, 32);
+                p += 32;
+                ba2string(block.globalExitRoot, (const uint8_t *)dataStream.data() + p, 32);
+                p += 32;
+                ba2string(block.coinbase, (const uint8_t *)dataStream.data() + p, 20);
+                p += 20;
+                block.forkId = ParseBigEndianU16(dataStream, p);
+                block.chainId = ParseBigEndianU32(dataStream, p);
+                block.l2BlockHash.clear();
+                block.stateRoot.clear();
+                block.txs.clear();
+
+#ifdef LOG_DATA_STREAM
+                zklog.info("DataStreamReader::next() START L2 BLOCK " + block.toString());
+#endif
+                return ZKR_SUCCESS;
+            }
+
+            /*
+            L2 TX:
+                Entry type = 2
+                Entry data:
+                    u8 gasPricePercentage
+                    u8 isValid // Intrinsic
+                    u8[32] stateRoot
+                    u32 encodedTXLength
+                    u8[] encodedTX
+            */
+            case DATA_STREAM_ENTRY_L2_TX:
+            {
+                // Check data length range
+                if (dataLength < 38)
+                {
+                    zklog.error("DataStreamReader::next() L2 TX invalid dataLength=" + to_string(dataLength) + "<38 p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
                     return ZKR_DATA_STREAM_INVALID_DATA;
                 }
 
-                // Get batch number
-                uint64_t batchNumber;
-                batchNumber = ParseBigEndianU64(dataStream, p);
-                if (batchNumber == 0)
+                DataStreamTx &tx = entry.tx;
+                tx.gasPricePercentage = ParseU8(dataStream, p);
+                tx.isValid = ParseU8(dataStream, p);
+                tx.stateRoot = dataStream.substr(p, 32);
+                p += 32;
+                uint32_t encodedTxLength = ParseBigEndianU32(dataStream, p);
+                if (encodedTxLength > dataLength - 38)
                 {
-                    zklog.error("dataStream2batch() start L2 block, found batchNumber=0 p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
+                    zklog.error("DataStreamReader::next() L2 TX, run out of data encodedTxLength=" + to_string(encodedTxLength) + " dataLength=" + to_string(dataLength) + " p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
                     return ZKR_DATA_STREAM_INVALID_DATA;
                 }
+                tx.encodedTx = dataStream.substr(p, encodedTxLength);
+                p += dataLength - 38;
 
-                // Create a block and fill it with the entry data
-                DataStreamBlock block;
+#ifdef LOG_DATA_STREAM
+                zklog.info("DataStreamReader::next() L2 TX " + tx.toString());
+#endif
+                return ZKR_SUCCESS;
+            }
 
-                // Parse block number
-                block.blockNumber = ParseBigEndianU64(dataStream, p);
-                if (block.blockNumber == 0)
+            /*
+            End L2 Block:
+                Entry type = 3
+                Entry data:
+                    u64 blockL2Num
+                    u8[32] l2BlockHash
+                    u8[32] stateRoot
+            */
+            case DATA_STREAM_ENTRY_END_L2_BLOCK:
+            {
+                // Check data length range
+                if (dataLength != 72)
                 {
-                    zklog.error("dataStream2batch() end L2 block, found blockNumber=0 p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
+                    zklog.error("DataStreamReader::next() end L2 block invalid dataLength=" + to_string(dataLength) + "!=72 p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
                     return ZKR_DATA_STREAM_INVALID_DATA;
                 }
 
-                // Parse block timestamp
-                block.timestamp = ParseBigEndianU64(dataStream, p);
+                DataStreamBlock &block = entry.block;
+                block.blockNumber = ParseBigEndianU64(dataStream, p);
+                ba2string(block.l2BlockHash, (const uint8_t *)dataStream.data() + p, 32);
+                p += 32;
+                ba2string(block.stateRoot, (const uint8_t *)dataStream.data() + p, 32);
+                p += 32;
 
-                // Parse block delta timestamp
-                block.deltaTimestamp = ParseBigEndianU32(dataStream, p);
+#ifdef LOG_DATA_STREAM
+                zklog.info("DataStreamReader::next() END L2 BLOCK blockNumber=" + to_string(block.blockNumber));
+#endif
+                return ZKR_SUCCESS;
+            }
 
-                // Parse block L1 info tree index
-                block.l1InfoTreeIndex = ParseBigEndianU32(dataStream, p);
+            // Default: fail
+            default:
+            {
+                zklog.error("DataStreamReader::next() unsupported entry type=" + to_string(entryType) + " data p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
+                return ZKR_DATA_STREAM_INVALID_DATA;
+            }
+        }
+    }
 
-                // Parse L1 block hash
-                ba2string(block.l1BlockHash, (const uint8_t *)dataStream.c_str() + p, 32);
-                p += 32;
+    bEnd = true;
+    return ZKR_SUCCESS;
+}
 
-                // Parse block global exit root
-                ba2string(block.globalExitRoot, (const uint8_t *)dataStream.c_str() + p, 32);
-                p += 32;
+zkresult dataStream2batch (const string &dataStream, DataStreamBatch &batch)
+{
+    // Initialize variables
+    DataStreamReader reader(dataStream);
+    DataStreamEntry entry;
+    bool bEnd;
+    zkresult zkr;
+    batch.reset();
 
-                // Parse block coinbase (sequencer address)
-                ba2string(block.coinbase, (const uint8_t *)dataStream.c_str() + p, 20);
-                p += 20;
+    // While there are entries to process
+    while (true)
+    {
+        zkr = reader.next(entry, bEnd);
+        if (zkr != ZKR_SUCCESS)
+        {
+            zklog.error("dataStream2batch() failed calling DataStreamReader::next() result=" + zkresult2string(zkr));
+            return zkr;
+        }
+        if (bEnd)
+        {
+            break;
+        }
+        uint64_t p = reader.position();
 
-                // Parse block fork ID
-                block.forkId = ParseBigEndianU16(dataStream, p);
+        switch (entry.type)
+        {
+            case DATA_STREAM_ENTRY_START_L2_BLOCK:
+            {
+                DataStreamBlock &block = entry.block;
+
+                // Check batch number
+                if (entry.batchNumber == 0)
+                {
+                    zklog.error("dataStream2batch() start L2 block, found batchNumber=0 p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
+                    return ZKR_DATA_STREAM_INVALID_DATA;
+                }
+
+                // Check block number
+                if (block.blockNumber == 0)
+                {
+                    zklog.error("dataStream2batch() end L2 block, found blockNumber=0 p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
+                    return ZKR_DATA_STREAM_INVALID_DATA;
+                }
+
+                // Check block fork ID
                 if (block.forkId == 0)
                 {
                     zklog.error("dataStream2batch() start L2 block, found forkId=0 block number=" + to_string(block.blockNumber) + " p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
                     return ZKR_DATA_STREAM_INVALID_DATA;
                 }
 
-                // Parse chain ID
-                block.chainId = ParseBigEndianU32(dataStream, p);
-
                 // If batch is empty, initialize it
                 if (batch.blocks.empty())
                 {
                     // Store block in batch
                     batch.blocks.emplace_back(block);
-                    batch.batchNumber = batchNumber;
+                    batch.batchNumber = entry.batchNumber;
                     batch.forkId = block.forkId;
                     batch.chainId = block.chainId;
                 }
@@ -284,9 +375,9 @@ zkresult dataStream2batch (const string &dataStream, DataStreamBatch &batch)
                 else
                 {
                     // Check that the batch numbers match
-                    if (batch.batchNumber != batchNumber) // If they don't match, we are getting blocks from different batches, so fail
+                    if (batch.batchNumber != entry.batchNumber) // If they don't match, we are getting blocks from different batches, so fail
                     {
-                        zklog.error("dataStream2batch() start L2 block, batch number mismatch, batchNumber=" + to_string(batchNumber) + " batch.batchNumber=" + to_string(batch.batchNumber) + " p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
+                        zklog.error("dataStream2batch() start L2 block, batch number mismatch, batchNumber=" + to_string(entry.batchNumber) + " batch.batchNumber=" + to_string(batch.batchNumber) + " p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
                         return ZKR_DATA_STREAM_INVALID_DATA;
                     }
 
@@ -316,32 +407,11 @@ zkresult dataStream2batch (const string &dataStream, DataStreamBatch &batch)
                     batch.blocks.emplace_back(block);
                 }
 
-#ifdef LOG_DATA_STREAM
-                zklog.info("dataStream2batch() START L2 BLOCK " + block.toString());
-#endif
-
                 continue;
             }
 
-            /*
-            L2 TX:
-                Entry type = 2
-                Entry data:
-                    u8 gasPricePercentage
-                    u8 isValid // Intrinsic
-                    u8[32] stateRoot
-                    u32 encodedTXLength
-                    u8[] encodedTX
-            */
-            case 2: // L2 TX
+            case DATA_STREAM_ENTRY_L2_TX:
             {
-                // Check data length range
-                if (dataLength < 38)
-                {
-                    zklog.error("dataStream2batch() L2 TX invalid dataLength=" + to_string(dataLength) + "<38 p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
-                    return ZKR_DATA_STREAM_INVALID_DATA;
-                }
-
                 // Check that batch is in the proper state, i.e. with current block still open
                 if (batch.blocks.empty())
                 {
@@ -370,51 +440,14 @@ zkresult dataStream2batch (const string &dataStream, DataStreamBatch &batch)
                     return ZKR_DATA_STREAM_INVALID_DATA;
                 }
 
-                // Parse Tx
-                DataStreamTx tx;
-                tx.gasPricePercentage = ParseU8(dataStream, p);
-                tx.isValid = ParseU8(dataStream, p);
-                ba2string(tx.stateRoot, (const uint8_t *)dataStream.c_str() + p, 32);
-                p += 32;
-                uint32_t encodedTxLength = ParseBigEndianU32(dataStream, p);
-                if (p + encodedTxLength - 1 >= dataStream.size())
-                {
-                    zklog.error("dataStream2batch() L2 TX, run out of data latestBlock.blockNumber=" + to_string(latestBlock.blockNumber) + " p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
-                    return ZKR_DATA_STREAM_INVALID_DATA;
-                }
-                tx.encodedTx = dataStream.substr(p, encodedTxLength);
-                p += encodedTxLength;
-
                 // Add it to the current block
-                latestBlock.txs.emplace_back(tx);
-
-#ifdef LOG_DATA_STREAM
-                zklog.info("dataStream2batch() L2 TX " + tx.toString());
-#endif
+                latestBlock.txs.emplace_back(entry.tx);
 
                 continue;
             }
 
-            /*
-            End L2 Block:
-                Entry type = 3
-                Entry data:
-                    u64 blockL2Num
-                    u8[32] l2BlockHash
-                    u8[32] stateRoot
-            */
-            case 3: // End L2 Block
+            case DATA_STREAM_ENTRY_END_L2_BLOCK:
             {
-                // Check data length range
-                if (dataLength != 72)
-                {
-                    zklog.error("dataStream2batch() end L2 block invalid dataLength=" + to_string(dataLength) + "!=72 p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
-                    return ZKR_DATA_STREAM_INVALID_DATA;
-                }
-
-                // Get block number
-                uint64_t blockNumber = ParseBigEndianU64(dataStream, p);
-
                 // Check that batch is in the proper state, i.e. with current block still open
                 if (batch.blocks.empty())
                 {
@@ -442,30 +475,21 @@ zkresult dataStream2batch (const string &dataStream, DataStreamBatch &batch)
                     zklog.error("dataStream2batch() end L2 block, found current block with stateRoot not empty latestBlock=" + to_string(latestBlock.blockNumber) + " p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
                     return ZKR_DATA_STREAM_INVALID_DATA;
                 }
-                if (latestBlock.blockNumber != blockNumber)
+                if (latestBlock.blockNumber != entry.block.blockNumber)
                 {
-                    zklog.error("dataStream2batch() end L2 block, found blockNumber=" + to_string(blockNumber) + " but latestBlock.blockNumber=" + to_string(latestBlock.blockNumber) + " p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
+                    zklog.error("dataStream2batch() end L2 block, found blockNumber=" + to_string(entry.block.blockNumber) + " but latestBlock.blockNumber=" + to_string(latestBlock.blockNumber) + " p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
                     return ZKR_DATA_STREAM_INVALID_DATA;
                 }
 
                 // Get new block data
-                ba2string(latestBlock.l2BlockHash, (const uint8_t *)dataStream.c_str() + p, 32);
-                p += 32;
-                ba2string(latestBlock.stateRoot, (const uint8_t *)dataStream.c_str() + p, 32);
-                p += 32;
+                latestBlock.l2BlockHash = entry.block.l2BlockHash;
+                latestBlock.stateRoot = entry.block.stateRoot;
 
 #ifdef LOG_DATA_STREAM
                 zklog.info("dataStream2batch() END L2 BLOCK " + latestBlock.toString());
 #endif
                 continue;
             }
-
-            // Default: fail
-            default:
-            {
-                zklog.error("dataStream2batch() unsupported entry type=" + to_string(entryType) + " data p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
-                return ZKR_DATA_STREAM_INVALID_DATA;
-            }
         }
     }
 
@@ -474,23 +498,23 @@ zkresult dataStream2batch (const string &dataStream, DataStreamBatch &batch)
     {
         if (batch.batchNumber == 0)
         {
-            zklog.warning("dataStream2batch() final check, found batch.batchNumber=0 p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
+            zklog.warning("dataStream2batch() final check, found batch.batchNumber=0 dataStream.size=" + to_string(dataStream.size()));
             return ZKR_DATA_STREAM_INVALID_DATA;
         }
         if (batch.forkId == 0)
         {
-            zklog.error("dataStream2batch() final check, found batch.forkId=0 p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
+            zklog.error("dataStream2batch() final check, found batch.forkId=0 dataStream.size=" + to_string(dataStream.size()));
             return ZKR_DATA_STREAM_INVALID_DATA;
         }
         DataStreamBlock &latestBlock = batch.blocks[batch.blocks.size() - 1];
         if (latestBlock.l2BlockHash.empty())
         {
-            zklog.error("dataStream2batch() final check, found current block with l2BlockHash empty latestBlock.blockNumber=" + to_string(latestBlock.blockNumber) + " p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
+            zklog.error("dataStream2batch() final check, found current block with l2BlockHash empty latestBlock.blockNumber=" + to_string(latestBlock.blockNumber) + " dataStream.size=" + to_string(dataStream.size()));
             return ZKR_DATA_STREAM_INVALID_DATA;
         }
         if (latestBlock.stateRoot.empty())
         {
-            zklog.error("dataStream2batch() final check, found current block with stateRoot empty latestBlock.blockNumber=" + to_string(latestBlock.blockNumber) + " p=" + to_string(p) + " dataStream.size=" + to_string(dataStream.size()));
+            zklog.error("dataStream2batch() final check, found current block with stateRoot empty latestBlock.blockNumber=" + to_string(latestBlock.blockNumber) + " dataStream.size=" + to_string(dataStream.size()));
             return ZKR_DATA_STREAM_INVALID_DATA;
         }
     }
@@ -503,7 +527,7 @@ zkresult dataStream2batch (const string &dataStream, DataStreamBatch &batch)
         log += "  blocks[" + to_string(b) + "]= " + batch.blocks[b].toString() + "\n";
         for (uint64_t t=0; t<batch.blocks[b].txs.size(); t++)
         {
-            log += "    txs[" + to_string(t) + "]= " + batch.blocks[b].txs[t].toString() + " encodedTx=" + ba2string(batch.blocks[b].txs[t].encodedTx) + "\n";
+            log += "    txs[" + to_string(t) + "]= " + batch.blocks[b].txs[t].toString() + " encodedTx=" + ba2string((const uint8_t *)batch.blocks[b].txs[t].encodedTx.data(), batch.blocks[b].txs[t].encodedTx.size()) + "\n";
         }
     }
     cout << log << endl;
@@ -514,8 +538,18 @@ zkresult dataStream2batch (const string &dataStream, DataStreamBatch &batch)
 
 zkresult dataStreamBatch2batchL2Data (const DataStreamBatch &batch, string &batchL2Data)
 {
-    // Clear the result
+    // Clear the result, and reserve room for all the blocks and txs, to transcode them in place
     batchL2Data.clear();
+    uint64_t size = 0;
+    for (uint64_t b=0; b < batch.blocks.size(); b++)
+    {
+        size += 9;
+        for (uint64_t t = 0; t < batch.blocks[b].txs.size(); t++)
+        {
+            size += batch.blocks[b].txs[t].encodedTx.size() + 66;
+        }
+    }
+    batchL2Data.reserve(size);
 
     // For all blocks
     for (uint64_t b=0; b < batch.blocks.size(); b++)
@@ -536,14 +570,12 @@ zkresult dataStreamBatch2batchL2Data (const DataStreamBatch &batch, string &batc
         for (uint64_t t = 0; t < block.txs.size(); t++)
         {
             const DataStreamTx &tx = block.txs[t];
-            string transcodedTx;
-            zkresult zkr = transcodeTx(tx.encodedTx, batch.chainId, transcodedTx);
+            zkresult zkr = transcodeTx(tx.encodedTx, batch.chainId, batchL2Data);
             if (zkr != ZKR_SUCCESS)
             {
                 zklog.error("dataStreamBatch2batchL2Data() failed calling transcodeTx() result=" + zkresult2string(zkr));
                 return zkr;
             }
-            batchL2Data += transcodedTx;
             batchL2Data += tx.gasPricePercentage;
         }
     }
@@ -553,15 +585,25 @@ zkresult dataStreamBatch2batchL2Data (const DataStreamBatch &batch, string &batc
     return ZKR_SUCCESS;
 }
 
+// Returns the byte array without its leading zeros, i.e. the minimal big-endian representation of its scalar value
+static inline string_view stripLeadingZeros (string_view ba)
+{
+    uint64_t i = 0;
+    while ((i < ba.size()) && (ba[i] == 0))
+    {
+        i++;
+    }
+    return ba.substr(i);
+}
+
 // Decodes tx from Ethereum RLP format, and encodes it into ROM RLP format
 // From: RLP(fields, v, r, s) --> To: RLP(fields, chainId, 0, 0) | r | s | v
-zkresult transcodeTx (const string &tx, uint32_t batchChainId, string &transcodedTx)
+zkresult transcodeTx (string_view tx, uint32_t batchChainId, string &transcodedTx)
 {
-    // Decode the TX RLP list
-    bool bResult;
-    vector<string> fields;
-    bResult = rlp::decodeList(tx, fields);
-    if (!bResult)
+    // Decode the TX RLP list; fields point to the tx data
+    vector<string_view> fields;
+    fields.reserve(9);
+    if (!rlp::decodeList(tx, fields))
     {
         zklog.error("transcodeTx() failed calling decodeList()");
         return ZKR_DATA_STREAM_INVALID_DATA;
@@ -586,14 +628,17 @@ zkresult transcodeTx (const string &tx, uint32_t batchChainId, string &transcode
     }
 
     // Get TX v
-    mpz_class vScalar;
-    ba2scalar(vScalar, fields[6]);
-    if (vScalar > ScalarMask64)
+    string_view vBa = stripLeadingZeros(fields[6]);
+    if (vBa.size() > 8)
     {
-        zklog.error("transcodeTx() called decodeList() and got too big v=" + vScalar.get_str(16));
+        zklog.error("transcodeTx() called decodeList() and got too big v=" + ba2string((const uint8_t *)vBa.data(), vBa.size()));
         return ZKR_DATA_STREAM_INVALID_DATA;
     }
-    uint64_t txv = vScalar.get_ui();
+    uint64_t txv = 0;
+    for (uint64_t i = 0; i < vBa.size(); i++)
+    {
+        txv = (txv << 8) | (uint8_t)vBa[i];
+    }
 
     // Get chain ID
     uint64_t chainId = (txv - 35) / 2;
@@ -607,66 +652,59 @@ zkresult transcodeTx (const string &tx, uint32_t batchChainId, string &transcode
     uint64_t v = txv - chainId*2 - 35 + 27;
 
     // Get r
-    mpz_class r;
-    ba2scalar(r, fields[7]);
-    if (r > ScalarMask256)
+    string_view r = stripLeadingZeros(fields[7]);
+    if (r.size() > 32)
     {
-        zklog.error("transcodeTx() called decodeList() and got too big r=" + r.get_str(16));
+        zklog.error("transcodeTx() called decodeList() and got too big r=" + ba2string((const uint8_t *)r.data(), r.size()));
         return ZKR_DATA_STREAM_INVALID_DATA;
     }
 
     // Get s
-    mpz_class s;
-    ba2scalar(s, fields[8]);
-    if (s > ScalarMask256)
+    string_view s = stripLeadingZeros(fields[8]);
+    if (s.size() > 32)
     {
-        zklog.error("transcodeTx() called decodeList() and got too big r=" + r.get_str(16));
+        zklog.error("transcodeTx() called decodeList() and got too big s=" + ba2string((const uint8_t *)s.data(), s.size()));
         return ZKR_DATA_STREAM_INVALID_DATA;
     }
 
     // Set fields[6] = chain ID
-    fields[6].clear();
+    char chainIdBa[4];
+    uint64_t chainIdSize = 0;
     const uint8_t * pChainId = (const uint8_t *)&batchChainId;
-    bool writing = false;
     for (int64_t i = 3; i >= 0; i--)
     {
-        if (writing || (pChainId[i] != 0))
+        if ((chainIdSize > 0) || (pChainId[i] != 0))
         {
-            fields[6] += pChainId[i];
-            writing = true;
+            chainIdBa[chainIdSize] = pChainId[i];
+            chainIdSize++;
         }
     }
+    fields[6] = string_view(chainIdBa, chainIdSize);
 
     // Clear fields[7]
-    fields[7].clear();
+    fields[7] = string_view();
 
     // Clear fields[8]
-    fields[8].clear();
+    fields[8] = string_view();
 
     // Encode RLP list
-    bResult = rlp::encodeList(fields, transcodedTx);
-    if (!bResult)
+    if (!rlp::encodeList(fields, transcodedTx))
     {
         zklog.error("transcodeTx() failed calling encodeList()");
         return ZKR_DATA_STREAM_INVALID_DATA;
     }
 
-    // Format r and concatenate to tx
-    string rBa;
-    rBa = scalar2ba32(r);
-    transcodedTx += rBa;
-    //zklog.info("r=" + ba2string(rBa));
+    // Format r as 32 bytes and concatenate to tx
+    transcodedTx.append(32 - r.size(), 0);
+    transcodedTx += r;
 
-    // Format s and concatenate to tx
-    string sBa;
-    sBa = scalar2ba32(s);
-    transcodedTx += sBa;
-    //zklog.info("s=" + ba2string(sBa));
+    // Format s as 32 bytes and concatenate to tx
+    transcodedTx.append(32 - s.size(), 0);
+    transcodedTx += s;
 
     // Concatenat v to tx
     uint8_t d = v;
     transcodedTx += d;
-    //zklog.info("v=" + to_string(v));
 
     return ZKR_SUCCESS;
-}
\ No newline at end of file
+}
@@ -3,9 +3,11 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include "zkresult.hpp"
+#include "scalar.hpp"
 
 using namespace std;
 
@@ -14,15 +16,15 @@ class DataStreamTx
 public:
     uint8_t gasPricePercentage;
     bool isValid; // Intrinsic
-    string stateRoot; // 32 bytes = 64 characters
-    string encodedTx; // byte array
+    string_view stateRoot; // 32 bytes, span of the data stream
+    string_view encodedTx; // byte array, span of the data stream
     DataStreamTx() : gasPricePercentage(0), isValid(false) {};
     string toString (void)
     {
         return
             "gasPricePercentage=" + to_string(gasPricePercentage) +
             " isValid=" + to_string(isValid) +
-            " stateRoot=" + stateRoot +
+            " stateRoot=" + ba2string((const uint8_t *)stateRoot.data(), stateRoot.size()) +
             " encodedTx.size=" + to_string(encodedTx.size());
     }
 };
@@ -86,13 +88,45 @@ public:
     }
 };
 
-// Decodes a data stream and stores content in a DataStreamBatch
+// Data stream entry types
+#define DATA_STREAM_ENTRY_START_L2_BLOCK 1
+#define DATA_STREAM_ENTRY_L2_TX 2
+#define DATA_STREAM_ENTRY_END_L2_BLOCK 3
+#define DATA_STREAM_ENTRY_BOOKMARK 0xb0
+
+class DataStreamEntry
+{
+public:
+    uint32_t type; // DATA_STREAM_ENTRY_START_L2_BLOCK, DATA_STREAM_ENTRY_L2_TX or DATA_STREAM_ENTRY_END_L2_BLOCK
+    uint64_t batchNumber; // Start L2 block
+    DataStreamBlock block; // Start L2 block header fields, or end L2 block blockNumber, l2BlockHash and stateRoot
+    DataStreamTx tx; // L2 TX
+    DataStreamEntry() : type(0), batchNumber(0) {};
+};
+
+// Streaming parser of the block and TX entries of a data stream, skipping padding and bookmarks; the TX byte arrays
+// are spans of the data stream buffer, so it must outlive the parsed entries
+class DataStreamReader
+{
+private:
+    string_view dataStream;
+    uint64_t p; // Position of the next entry
+public:
+    DataStreamReader(string_view dataStream) : dataStream(dataStream), p(0) {};
+
+    // Parses the next entry; returns ZKR_SUCCESS with bEnd=true when there are no more entries
+    zkresult next (DataStreamEntry &entry, bool &bEnd);
+
+    uint64_t position (void) { return p; };
+};
+
+// Decodes a data stream and stores content in a DataStreamBatch, which points to the data stream TX byte arrays
 zkresult dataStream2batch (const string &dataStream, DataStreamBatch &batch);
 
 // Encodes a DataStreamBatch into a batch L2 data byte array
 zkresult dataStreamBatch2batchL2Data (const DataStreamBatch &batch, string &batchL2Data);
 
-// Decodes tx from Ethereum RLP format, and encodes it into ROM RLP format
-zkresult transcodeTx (const string &tx, uint32_t batchChainId, string &transcodedTx);
+// Decodes tx from Ethereum RLP format, and encodes it into ROM RLP format, appending it to transcodedTx
+zkresult transcodeTx (string_view tx, uint32_t batchChainId, string &transcodedTx);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,31 @@
+#include "full_trace_expander.hpp"
+#include "zkassert.hpp"
+
+void FullTraceExpander::next (const Opcode &step)
+{
+    if (!step.bDelta)
+    {
+        pStack = &step.stack;
+        pStorage = &step.storage;
+        return;
+    }
+
+    // Remove the popped entries and append the pushed ones
+    zkassert(step.stack_pops <= stack.size());
+    stack.resize(stack.size() - step.stack_pops);
+    stack.insert(stack.end(), step.stack.begin(), step.stack.end());
+    pStack = &stack;
+
+    // Apply the storage writes; the step reports the storage of the last written contract, as the full trace does
+    if (step.storage_writes.empty())
+    {
+        pStorage = &emptyStorage;
+        return;
+    }
+    for (uint64_t i=0; i<step.storage_writes.size(); i++)
+    {
+        const OpcodeStorageWrite &write = step.storage_writes[i];
+        storage[write.address][write.key] = write.value;
+    }
+    pStorage = &storage[step.storage_writes[step.storage_writes.size() - 1].address];
+}
@@ -0,0 +1,33 @@
+#ifndef FULL_TRACE_EXPANDER_HPP
+#define FULL_TRACE_EXPANDER_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "full_tracer_interface.hpp"
+
+using namespace std;
+
+// Rebuilds, step by step, the full stack and storage snapshots of a transaction trace recorded in delta mode, so
+// that they only exist while the response is being built; steps not recorded in delta mode are returned as they are.
+// Call next() for every step of the transaction trace, in order, and then read the snapshots of that step.
+class FullTraceExpander
+{
+private:
+    vector<Bytes32> stack; // Current stack
+    unordered_map<string, unordered_map<string, string>> storage; // Current storage, by contract address
+    const unordered_map<string, string> emptyStorage;
+    const vector<Bytes32> * pStack;
+    const unordered_map<string, string> * pStorage;
+public:
+    FullTraceExpander() : pStack(NULL), pStorage(&emptyStorage) {};
+
+    // Applies the step deltas, if any; the step must live until the next call
+    void next (const Opcode &step);
+
+    // Snapshots of the last step passed to next()
+    const vector<Bytes32> & getStack (void) const { return *pStack; };
+    const unordered_map<string, string> & getStorage (void) const { return *pStorage; };
+};
+
+#endif
@@ -2,11 +2,72 @@
 #define FULL_TRACER_INTERFACE_HPP
 
 #include <string>
+#include <cstring>
 #include <unordered_map>
+#include <gmpxx.h>
 #include "zkglobals.hpp"
 
 using namespace std;
 
+// Fixed-size big-endian binary value (state root, address, stack word) stored inline in the trace records, so that
+// every opcode step does not allocate and format hex strings; the response takes the bytes as they are, and only the
+// fields that the protobuf defines as strings are converted to hex when the response is built
+template <size_t N>
+class FixedBytes
+{
+public:
+    uint8_t bytes[N];
+
+    FixedBytes() { memset(bytes, 0, N); };
+    FixedBytes(const mpz_class &s) { fromScalar(s); };
+
+    // Stores the N least significant bytes of the scalar, zero-padded on the left
+    void fromScalar (const mpz_class &s)
+    {
+        memset(bytes, 0, N);
+        mpz_class aux = s;
+        if (mpz_sizeinbase(aux.get_mpz_t(), 2) > N*8)
+        {
+            aux &= (mpz_class(1) << (N*8)) - 1;
+        }
+        if (aux == 0)
+        {
+            return;
+        }
+        size_t size = (mpz_sizeinbase(aux.get_mpz_t(), 2) + 7) / 8;
+        mpz_export(bytes + N - size, NULL, 1, 1, 1, 0, aux.get_mpz_t());
+    };
+
+    // Returns the bytes as a byte array string, e.g. for protobuf bytes fields
+    string toBa (void) const { return string((const char *)bytes, N); };
+
+    // Returns the lowercase hex representation without 0x prefix, either with 2*N digits or without leading zeros
+    // (the latter matches mpz_class::get_str(16), i.e. "0" for a zero value)
+    string toHex (bool bPadded = true) const
+    {
+        static const char digits[] = "0123456789abcdef";
+        char aux[2*N];
+        for (size_t i=0; i<N; i++)
+        {
+            aux[2*i] = digits[bytes[i] >> 4];
+            aux[2*i + 1] = digits[bytes[i] & 0x0F];
+        }
+        if (bPadded)
+        {
+            return string(aux, 2*N);
+        }
+        size_t first = 0;
+        while ((first < 2*N - 1) && (aux[first] == '0'))
+        {
+            first++;
+        }
+        return string(aux + first, 2*N - first);
+    };
+};
+
+typedef FixedBytes<32> Bytes32;
+typedef FixedBytes<20> Bytes20;
+
 // Tracer service to output the logs of a batch of transactions. A complete log is created with all the transactions embedded
 // for each batch and also a log is created for each transaction separatedly. The events are triggered from the zkrom and handled
 // from the zkprover
@@ -14,8 +75,8 @@ using namespace std;
 class OpcodeContract
 {
 public:
-    string address;
-    string caller;
+    Bytes20 address;
+    Bytes20 caller;
     mpz_class value;
     string data;
     uint64_t gas;
@@ -23,12 +84,21 @@ public:
     OpcodeContract() : value(0), gas(0) {};
 };
 
+// Storage write done by an opcode, recorded instead of the full storage of the contract in delta traces
+class OpcodeStorageWrite
+{
+public:
+    string address;
+    string key;
+    string value;
+};
+
 class Opcode
 {
 public:
     uint64_t gas;
     int64_t gas_cost;
-    string state_root;
+    Bytes32 state_root;
     uint64_t depth;
     uint64_t pc;
     uint8_t op;
@@ -36,7 +106,7 @@ public:
     uint64_t gas_refund;
     string error;
     OpcodeContract contract;
-    vector<mpz_class> stack;
+    vector<Bytes32> stack;
     string memory;
     uint64_t memory_size;
     uint64_t memory_offset;
@@ -44,7 +114,14 @@ public:
     vector<string> return_data;
     struct timeval startTime;
     uint64_t duration;
-    Opcode() : gas(0), gas_cost(0), depth(0), pc(0), op(0), opcode(NULL), gas_refund(0), memory_size(0), memory_offset(0), startTime({0,0}), duration(0) {};
+
+    // Delta trace data: if bDelta is true, stack only contains the entries pushed after removing stack_pops entries
+    // from the previous step stack, and storage_writes replaces storage; use FullTraceExpander to rebuild them
+    bool bDelta;
+    uint64_t stack_pops;
+    vector<OpcodeStorageWrite> storage_writes;
+
+    Opcode() : gas(0), gas_cost(0), depth(0), pc(0), op(0), opcode(NULL), gas_refund(0), memory_size(0), memory_offset(0), startTime({0,0}), duration(0), bDelta(false), stack_pops(0) {};
 };
 
 class Log
@@ -722,6 +722,12 @@ void Input::loadDatabase (json &input)
         publicInputsExtended.publicInputs.witness = string2ba(witness);
     }
 
+    // Load binary witness database file name
+    if (input.contains("witnessDB") && input["witnessDB"].is_string())
+    {
+        witnessDBFile = input["witnessDB"];
+    }
+
     // Input JSON file must contain a db structure at the root level
     if ( !input.contains("db") ||
          !input["db"].is_structured() )
@@ -861,6 +867,10 @@ void Input::saveDatabase (json &input) const
 {
     db2json(input, db, "db");
     contractsBytecode2json(input, contractsBytecode, "contractsBytecode");
+    if (!witnessDBFile.empty())
+    {
+        input["witnessDB"] = witnessDBFile;
+    }
 }
 
 void Input::saveDatabase (json &input, DatabaseMap &dbReadLog) const
@@ -70,6 +70,7 @@ public:
     unordered_map<string, OverrideEntry> stateOverride;
     uint64_t stepsN;
     InputDebug debug;
+    string witnessDBFile; // Binary witness database file, which replaces db and contractsBytecode, if not empty
 
     // Constructor
     Input (Goldilocks &fr) :
@@ -31,6 +31,9 @@
 #include "recursive2Steps.hpp"
 #include "zklog.hpp"
 #include "exit_process.hpp"
+#include "zkmax.hpp"
+#include "bytecode_hash_cache.hpp"
+#include "metrics.hpp"
 
 
 Prover::Prover(Goldilocks &fr,
@@ -45,6 +48,13 @@ Prover::Prover(Goldilocks &fr,
     mpz_init(altBbn128r);
     mpz_set_str(altBbn128r, "21888242871839275222246405745257275088548364400416034343698204186575808495617", 10);
 
+    if (config.batchExecutionCache)
+    {
+        batchExecutionCache.init(config);
+    }
+
+    bytecodeHashCache.init(config);
+
     try
     {
         if (config.generateProof())
@@ -77,12 +87,23 @@ Prover::Prover(Goldilocks &fr,
                     zkey->getSectionData(8), // pointsC
                     zkey->getSectionData(9)  // pointsH1
                 );
+
+                if (config.multiexpFixedBasesMemory > 0)
+                {
+                    TimerStart(MULTIEXP_FIXED_BASES_PRECOMPUTATION);
+                    uint64_t memory = groth16Prover->precomputeFixedBases(config.multiexpFixedBasesMemory*1024*1024);
+                    TimerStopAndLog(MULTIEXP_FIXED_BASES_PRECOMPUTATION);
+                    zklog.info("Prover::Prover() precomputed groth16 fixed bases using " + to_string(memory/(1024*1024)) + " MB");
+                }
             }
 
             lastComputedRequestEndTime = 0;
 
             sem_init(&pendingRequestSem, 0, 0);
+            sem_init(&executedRequestSem, 0, 0);
             pthread_mutex_init(&mutex, NULL);
+            completedBatchProofs = 0;
+            firstBatchProofStartTime = 0;
             pCurrentRequest = NULL;
             pthread_create(&proverPthread, NULL, proverThread, this);
             pthread_create(&cleanerPthread, NULL, cleanerThread, this);
@@ -115,7 +136,15 @@ Prover::Prover(Goldilocks &fr,
             }
 
             prover = new Fflonk::FflonkProver<AltBn128::Engine>(AltBn128::Engine::engine, pAddress, polsSize);
-            prover->setZkey(zkey.get());
+            prover->setZkey(zkey.get(), config.fflonkZkeyInPlace);
+
+            if ((Zkey::GROTH16_PROTOCOL_ID != protocolId) && (config.multiexpFixedBasesMemory > 0))
+            {
+                TimerStart(MULTIEXP_FIXED_BASES_PRECOMPUTATION);
+                uint64_t memory = prover->precomputeFixedBases(config.multiexpFixedBasesMemory*1024*1024);
+                TimerStopAndLog(MULTIEXP_FIXED_BASES_PRECOMPUTATION);
+                zklog.info("Prover::Prover() precomputed fflonk fixed bases using " + to_string(memory/(1024*1024)) + " MB");
+            }
 
             StarkInfo _starkInfoRecursiveF(config, config.recursivefStarkInfo);
             pAddressStarksRecursiveF = (void *)malloc(_starkInfoRecursiveF.mapTotalN * sizeof(Goldilocks::Element));
@@ -126,6 +155,35 @@ Prover::Prover(Goldilocks &fr,
             starksRecursive1 = new Starks(config, {config.recursive1ConstPols, config.mapConstPolsFile, config.recursive1ConstantsTree, config.recursive1StarkInfo}, pAddress);
             starksRecursive2 = new Starks(config, {config.recursive2ConstPols, config.mapConstPolsFile, config.recursive2ConstantsTree, config.recursive2StarkInfo}, pAddress);
             starksRecursiveF = new StarkRecursiveF(config, pAddressStarksRecursiveF);
+
+            // Load the verifier circuits; every proof only creates its own witness calculator context
+            TimerStart(CIRCOM_LOAD_CIRCUITS);
+            circuitZkevm = Circom::loadCircuit(config.zkevmVerifier);
+            circuitRecursive1 = CircomRecursive1::loadCircuit(config.recursive1Verifier);
+            circuitRecursive2 = CircomRecursive2::loadCircuit(config.recursive2Verifier);
+            circuitRecursiveF = CircomRecursiveF::loadCircuit(config.recursivefVerifier);
+            circuitFinal = CircomFinal::loadCircuit(config.finalVerifier);
+            TimerStopAndLog(CIRCOM_LOAD_CIRCUITS);
+
+            // Allocate the executor stage buffers and start the executor thread, if the prover pipeline is enabled
+            if (config.proverPipeline)
+            {
+                uint64_t cmPolsSize = PROVER_FORK_NAMESPACE::CommitPols::pilSize();
+                for (uint64_t i = 0; i < config.proverPipelineBuffers; i++)
+                {
+                    void *pBuffer = calloc(cmPolsSize, 1);
+                    if (pBuffer == NULL)
+                    {
+                        zklog.error("Prover::Prover() failed calling calloc() of size " + to_string(cmPolsSize) + " for pipeline buffer " + to_string(i));
+                        exitProcess();
+                    }
+                    pipelineBuffers.push_back(pBuffer);
+                    freePipelineBuffers.push_back(pBuffer);
+                }
+                sem_init(&freePipelineBufferSem, 0, config.proverPipelineBuffers);
+                pthread_create(&executorPthread, NULL, executorThread, this);
+                zklog.info("Prover::Prover() started prover pipeline with " + to_string(config.proverPipelineBuffers) + " buffers of " + to_string(cmPolsSize) + " bytes");
+            }
         }
     }
     catch (std::exception &e)
@@ -176,6 +234,17 @@ Prover::~Prover()
         delete starksRecursive1;
         delete starksRecursive2;
         delete starksRecursiveF;
+
+        Circom::freeCircuit(circuitZkevm);
+        CircomRecursive1::freeCircuit(circuitRecursive1);
+        CircomRecursive2::freeCircuit(circuitRecursive2);
+        CircomRecursiveF::freeCircuit(circuitRecursiveF);
+        CircomFinal::freeCircuit(circuitFinal);
+
+        for (uint64_t i = 0; i < pipelineBuffers.size(); i++)
+        {
+            free(pipelineBuffers[i]);
+        }
     }
 }
 
@@ -186,19 +255,23 @@ void *proverThread(void *arg)
 
     zkassert(pProver->config.generateProof());
 
+    // In pipeline mode, requests are taken once the executor thread is done with them
+    vector<ProverRequest *> &requests = pProver->config.proverPipeline ? pProver->executedRequests : pProver->pendingRequests;
+    sem_t &requestsSem = pProver->config.proverPipeline ? pProver->executedRequestSem : pProver->pendingRequestSem;
+
     while (true)
     {
         pProver->lock();
 
         // Wait for the pending request queue semaphore to be released, if there are no more pending requests
-        if (pProver->pendingRequests.size() == 0)
+        if (requests.size() == 0)
         {
             pProver->unlock();
-            sem_wait(&pProver->pendingRequestSem);
+            sem_wait(&requestsSem);
         }
 
         // Check that the pending requests queue is not empty
-        if (pProver->pendingRequests.size() == 0)
+        if (requests.size() == 0)
         {
             pProver->unlock();
             zklog.info("proverThread() found pending requests queue empty, so ignoring");
@@ -206,9 +279,12 @@ void *proverThread(void *arg)
         }
 
         // Extract the first pending request (first in, first out)
-        pProver->pCurrentRequest = pProver->pendingRequests[0];
-        pProver->pCurrentRequest->startTime = time(NULL);
-        pProver->pendingRequests.erase(pProver->pendingRequests.begin());
+        pProver->pCurrentRequest = requests[0];
+        if (pProver->pCurrentRequest->startTime == 0)
+        {
+            pProver->pCurrentRequest->startTime = time(NULL);
+        }
+        requests.erase(requests.begin());
 
         zklog.info("proverThread() starting to process request with UUID: " + pProver->pCurrentRequest->uuid);
 
@@ -243,6 +319,20 @@ void *proverThread(void *arg)
 
         pProver->completedRequests.push_back(pProver->pCurrentRequest);
         pProver->pCurrentRequest = NULL;
+
+        // Report the batch proofs throughput
+        if (pProverRequest->type == prt_genBatchProof)
+        {
+            if (pProver->completedBatchProofs == 0)
+            {
+                pProver->firstBatchProofStartTime = pProverRequest->startTime;
+            }
+            pProver->completedBatchProofs++;
+            uint64_t elapsed = pProverRequest->endTime - pProver->firstBatchProofStartTime;
+            zklog.info("proverThread() completed batch proofs=" + to_string(pProver->completedBatchProofs) +
+                " in " + to_string(elapsed) + " s, throughput=" + to_string(elapsed == 0 ? 0 : double(pProver->completedBatchProofs) * 3600 / elapsed) + " proofs/hour" +
+                " pipeline=" + to_string(pProver->config.proverPipeline));
+        }
         pProver->unlock();
 
         zklog.info("proverThread() done processing request with UUID: " + pProverRequest->uuid);
@@ -254,6 +344,72 @@ void *proverThread(void *arg)
     return NULL;
 }
 
+void *executorThread(void *arg)
+{
+    Prover *pProver = (Prover *)arg;
+    zklog.info("executorThread() started");
+
+    zkassert(pProver->config.generateProof());
+    zkassert(pProver->config.proverPipeline);
+
+    while (true)
+    {
+        // Wait for a pending request
+        sem_wait(&pProver->pendingRequestSem);
+        pProver->lock();
+        if (pProver->pendingRequests.size() == 0)
+        {
+            pProver->unlock();
+            zklog.info("executorThread() found pending requests queue empty, so ignoring");
+            continue;
+        }
+
+        // Extract the first pending request (first in, first out)
+        ProverRequest *pProverRequest = pProver->pendingRequests[0];
+        pProver->pendingRequests.erase(pProver->pendingRequests.begin());
+        pProver->unlock();
+
+        // Execute batch proof requests into a free buffer; the rest of requests are passed to the prover thread as they are,
+        // keeping the order
+        if (pProverRequest->type == prt_genBatchProof)
+        {
+            pProverRequest->pCmPolsAddress = pProver->getPipelineBuffer();
+            pProverRequest->startTime = time(NULL);
+
+            zklog.info("executorThread() starting to execute request with UUID: " + pProverRequest->uuid);
+            pProver->executeBatchProof(pProverRequest, pProverRequest->pCmPolsAddress);
+            zklog.info("executorThread() done executing request with UUID: " + pProverRequest->uuid);
+        }
+
+        // Pass the request to the prover thread
+        pProver->lock();
+        pProver->executedRequests.push_back(pProverRequest);
+        sem_post(&pProver->executedRequestSem);
+        pProver->unlock();
+    }
+    zklog.info("executorThread() done");
+    return NULL;
+}
+
+void *Prover::getPipelineBuffer(void)
+{
+    sem_wait(&freePipelineBufferSem);
+    lock();
+    zkassert(freePipelineBuffers.size() > 0);
+    void *pBuffer = freePipelineBuffers.back();
+    freePipelineBuffers.pop_back();
+    unlock();
+    return pBuffer;
+}
+
+void Prover::releasePipelineBuffer(void *pBuffer)
+{
+    lock();
+    freePipelineBuffers.push_back(pBuffer);
+    unlock();
+    sem_post(&freePipelineBufferSem);
+}
+
 void *cleanerThread(void *arg)
 {
     Prover *pProver = (Prover *)arg;
@@ -375,8 +531,28 @@ void Prover::processBatch(ProverRequest *pProverRequest)
         zklog.info("Input=" + inputJson.dump());
     }
 
+    // Record the execution data to reuse it when generating the proof of this batch
+    if (config.batchExecutionCache)
+    {
+        zkassert(pProverRequest->pBatchExecutionCacheEntry == NULL);
+        pProverRequest->pBatchExecutionCacheEntry = new BatchExecutionCacheEntry(pProverRequest->input);
+    }
+
     // Execute the program, in the process batch way
+    struct timeval t;
+    gettimeofday(&t, NULL);
     executor.process_batch(*pProverRequest);
+    recordProcessBatchMetrics(pProverRequest, TimeDiff(t));
+
+    // Store the execution data in the batch execution cache, only if the execution succeeded
+    if (config.batchExecutionCache && (pProverRequest->result == ZKR_SUCCESS) && (pProverRequest->dbReadLog != NULL))
+    {
+        BatchExecutionCacheEntry *pEntry = pProverRequest->pBatchExecutionCacheEntry;
+        pProverRequest->pBatchExecutionCacheEntry = NULL;
+        pEntry->db = pProverRequest->dbReadLog->getMTDB();
+        pEntry->contractsBytecode = pProverRequest->dbReadLog->getProgramDB();
+        batchExecutionCache.add(BatchExecutionCache::getKey(pProverRequest->input), pEntry);
+    }
 
     // Save input to <timestamp>.input.json after execution including dbReadLog
     if (config.saveDbReadsToFile)
@@ -389,17 +565,47 @@ void Prover::processBatch(ProverRequest *pProverRequest)
     //TimerStopAndLog(PROVER_PROCESS_BATCH);
 }
 
-void Prover::genBatchProof(ProverRequest *pProverRequest)
+void Prover::recordProcessBatchMetrics(ProverRequest *pProverRequest, uint64_t time)
 {
-    zkassert(config.generateProof());
-    zkassert(pProverRequest != NULL);
-
-    TimerStart(PROVER_BATCH_PROOF);
-
-    printMemoryInfo(true);
-    printProcessInfo(true);
+    static uint64_t metricBatches = metrics.registerCounter("zkprover_executor_batches_total", "", "Executed process batch requests");
+    static uint64_t metricBatchErrors = metrics.registerCounter("zkprover_executor_batch_errors_total", "", "Executed process batch requests that failed");
+    static uint64_t metricBatchTime = metrics.registerHistogram("zkprover_executor_batch_us", "", "Time spent executing a process batch request, in us");
+    static uint64_t metricGas = metrics.registerCounter("zkprover_executor_gas_total", "", "Gas used by the executed batches");
+    static uint64_t metricArith = metrics.registerCounter("zkprover_executor_sm_counters_total", "sm=\"arith\"", "Counters of the executed batches, by state machine");
+    static uint64_t metricBinary = metrics.registerCounter("zkprover_executor_sm_counters_total", "sm=\"binary\"");
+    static uint64_t metricMemAlign = metrics.registerCounter("zkprover_executor_sm_counters_total", "sm=\"mem_align\"");
+    static uint64_t metricKeccakF = metrics.registerCounter("zkprover_executor_sm_counters_total", "sm=\"keccak_f\"");
+    static uint64_t metricPoseidonG = metrics.registerCounter("zkprover_executor_sm_counters_total", "sm=\"poseidon_g\"");
+    static uint64_t metricPaddingPG = metrics.registerCounter("zkprover_executor_sm_counters_total", "sm=\"padding_pg\"");
+    static uint64_t metricSHA256F = metrics.registerCounter("zkprover_executor_sm_counters_total", "sm=\"sha256_f\"");
+    static uint64_t metricSteps = metrics.registerCounter("zkprover_executor_sm_counters_total", "sm=\"main\"");
+
+    metrics.add(metricBatches);
+    metrics.observe(metricBatchTime, time);
+    if (pProverRequest->result != ZKR_SUCCESS)
+    {
+        metrics.add(metricBatchErrors);
+        return;
+    }
+    if (pProverRequest->pFullTracer != NULL)
+    {
+        metrics.add(metricGas, pProverRequest->pFullTracer->get_cumulative_gas_used());
+    }
+    metrics.add(metricArith, pProverRequest->counters.arith);
+    metrics.add(metricBinary, pProverRequest->counters.binary);
+    metrics.add(metricMemAlign, pProverRequest->counters.memAlign);
+    metrics.add(metricKeccakF, pProverRequest->counters.keccakF);
+    metrics.add(metricPoseidonG, pProverRequest->counters.poseidonG);
+    metrics.add(metricPaddingPG, pProverRequest->counters.paddingPG);
+    metrics.add(metricSHA256F, pProverRequest->counters.sha256F);
+    metrics.add(metricSteps, pProverRequest->counters.steps);
+}
 
+void Prover::executeBatchProof(ProverRequest *pProverRequest, void *pCmPolsAddress)
+{
+    zkassert(config.generateProof());
     zkassert(pProverRequest != NULL);
+    zkassert(pCmPolsAddress != NULL);
 
     zklog.info("Prover::genBatchProof() timestamp: " + pProverRequest->timestamp);
     zklog.info("Prover::genBatchProof() UUID: " + pProverRequest->uuid);
@@ -420,13 +626,25 @@ void Prover::genBatchProof(ProverRequest *pProverRequest)
     /************/
     TimerStart(EXECUTOR_EXECUTE_INITIALIZATION);
 
-    PROVER_FORK_NAMESPACE::CommitPols cmPols(pAddress, PROVER_FORK_NAMESPACE::CommitPols::pilDegree());
+    PROVER_FORK_NAMESPACE::CommitPols cmPols(pCmPolsAddress, PROVER_FORK_NAMESPACE::CommitPols::pilDegree());
     uint64_t num_threads = omp_get_max_threads();
     uint64_t bytes_per_thread = cmPols.size() / num_threads;
 #pragma omp parallel for num_threads(num_threads)
     for (uint64_t i = 0; i < cmPols.size(); i += bytes_per_thread) // Each iteration processes 64 bytes at a time
     {
-        memset((uint8_t *)pAddress + i, 0, bytes_per_thread);
+        memset((uint8_t *)pCmPolsAddress + i, 0, bytes_per_thread);
+    }
+
+    // Reuse the data of a previous process batch execution of this same batch, if any
+    if (config.batchExecutionCache)
+    {
+        zkassert(pProverRequest->pBatchExecutionCacheEntry == NULL);
+        pProverRequest->pBatchExecutionCacheEntry = batchExecutionCache.take(BatchExecutionCache::getKey(pProverRequest->input), pProverRequest->input);
+        if ((pProverRequest->pBatchExecutionCacheEntry != NULL) && pProverRequest->input.db.empty() && pProverRequest->input.contractsBytecode.empty())
+        {
+            pProverRequest->input.db = pProverRequest->pBatchExecutionCacheEntry->db;
+            pProverRequest->input.contractsBytecode = pProverRequest->pBatchExecutionCacheEntry->contractsBytecode;
+        }
     }
 
     TimerStopAndLog(EXECUTOR_EXECUTE_INITIALIZATION);
@@ -435,6 +653,16 @@ void Prover::genBatchProof(ProverRequest *pProverRequest)
     executor.execute(*pProverRequest, cmPols);
     TimerStopAndLog(EXECUTOR_EXECUTE_BATCH_PROOF);
 
+    if (pProverRequest->pBatchExecutionCacheEntry != NULL)
+    {
+        zklog.info("Prover::genBatchProof() reused process batch execution data: db=" + to_string(pProverRequest->pBatchExecutionCacheEntry->db.size()) +
+            " programs=" + to_string(pProverRequest->pBatchExecutionCacheEntry->contractsBytecode.size()) +
+            " hits=" + to_string(pProverRequest->pBatchExecutionCacheEntry->hits) +
+            " misses=" + to_string(pProverRequest->pBatchExecutionCacheEntry->misses));
+        batchExecutionCache.addStats(*pProverRequest->pBatchExecutionCacheEntry);
+        batchExecutionCache.print();
+    }
+
     uint64_t lastN = cmPols.pilDegree() - 1;
 
     zklog.info("Prover::genBatchProof() called executor.execute() oldStateRoot=" + pProverRequest->input.publicInputsExtended.publicInputs.oldStateRoot.get_str(16) +
@@ -455,6 +683,49 @@ void Prover::genBatchProof(ProverRequest *pProverRequest)
         memcpy(pointerCmPols, cmPols.address(), cmPols.size());
         unmapFile(pointerCmPols, cmPols.size());
     }
+}
+
+void Prover::genBatchProof(ProverRequest *pProverRequest)
+{
+    zkassert(config.generateProof());
+    zkassert(pProverRequest != NULL);
+
+    TimerStart(PROVER_BATCH_PROOF);
+
+    printMemoryInfo(true);
+    printProcessInfo(true);
+
+    /************/
+    /* Executor */
+    /************/
+    if (pProverRequest->pCmPolsAddress == NULL)
+    {
+        executeBatchProof(pProverRequest, pAddress);
+    }
+    else
+    {
+        // The executor stage of the prover pipeline has already computed the committed polynomials into its own buffer,
+        // so copy them to the STARK area and release the buffer for the next batch
+        TimerStart(PROVER_PIPELINE_COPY_CM_POLS);
+        uint64_t cmPolsSize = PROVER_FORK_NAMESPACE::CommitPols::pilSize();
+        uint64_t num_threads = omp_get_max_threads();
+        uint64_t bytes_per_thread = (cmPolsSize + num_threads - 1) / num_threads;
+#pragma omp parallel for num_threads(num_threads)
+        for (uint64_t t = 0; t < num_threads; t++)
+        {
+            uint64_t offset = t * bytes_per_thread;
+            if (offset < cmPolsSize)
+            {
+                memcpy((uint8_t *)pAddress + offset, (uint8_t *)pProverRequest->pCmPolsAddress + offset, zkmin(bytes_per_thread, cmPolsSize - offset));
+            }
+        }
+        releasePipelineBuffer(pProverRequest->pCmPolsAddress);
+        pProverRequest->pCmPolsAddress = NULL;
+        TimerStopAndLog(PROVER_PIPELINE_COPY_CM_POLS);
+    }
+
+    PROVER_FORK_NAMESPACE::CommitPols cmPols(pAddress, PROVER_FORK_NAMESPACE::CommitPols::pilDegree());
+    uint64_t lastN = cmPols.pilDegree() - 1;
 
     if (pProverRequest->result == ZKR_SUCCESS)
     {
@@ -578,19 +849,22 @@ void Prover::genBatchProof(ProverRequest *pProverRequest)
 
         TimerStopAndLog(STARK_PROOF_BATCH_PROOF);
         TimerStart(STARK_GEN_AND_CALC_WITNESS_C12A);
-        TimerStart(STARK_JSON_GENERATION_BATCH_PROOF);
+        TimerStart(STARK_ZKIN_GENERATION_BATCH_PROOF);
 
-        nlohmann::ordered_json jProof = fproof.proofs.proof2json();
-        nlohmann::json zkin = proof2zkinStark(jProof);
+        ZkinStark zkin;
+        proof2zkinStark(fproof, zkin);
         // Generate publics
-        jProof["publics"] = publicStarkJson;
-        zkin["publics"] = publicStarkJson;
+        std::vector<uint64_t> &zkinPublics = zkin.add("publics");
+        for (uint64_t i = 0; i < starkZkevm->starkInfo.nPublics; i++)
+        {
+            zkinPublics.push_back(Goldilocks::toU64(publics[i]));
+        }
 
-        TimerStopAndLog(STARK_JSON_GENERATION_BATCH_PROOF);
+        TimerStopAndLog(STARK_ZKIN_GENERATION_BATCH_PROOF);
 
         CommitPolsStarks cmPols12a(pAddress, (1 << starksC12a->starkInfo.starkStruct.nBits), starksC12a->starkInfo.nCm1);
 
-        Circom::getCommitedPols(&cmPols12a, config.zkevmVerifier, config.c12aExec, zkin, (1 << starksC12a->starkInfo.starkStruct.nBits), starksC12a->starkInfo.nCm1);
+        Circom::getCommitedPols(&cmPols12a, circuitZkevm, config.c12aExec, zkin, (1 << starksC12a->starkInfo.starkStruct.nBits), starksC12a->starkInfo.nCm1);
 
         // void *pointerCm12aPols = mapFile("config/c12a/c12a.commit", cmPols12a.size(), true);
         // memcpy(pointerCm12aPols, cmPols12a.address(), cmPols12a.size());
@@ -610,24 +884,27 @@ void Prover::genBatchProof(ProverRequest *pProverRequest)
         starksC12a->genProof(fproofC12a, publics, c12aVerkey, &c12aSteps);
 
         TimerStopAndLog(STARK_C12_A_PROOF_BATCH_PROOF);
-        TimerStart(STARK_JSON_GENERATION_BATCH_PROOF_C12A);
+        TimerStart(STARK_ZKIN_GENERATION_BATCH_PROOF_C12A);
 
-        // Save the proof & zkinproof
-        nlohmann::ordered_json jProofc12a = fproofC12a.proofs.proof2json();
-        nlohmann::json zkinC12a = proof2zkinStark(jProofc12a);
-
-        // Add the recursive2 verification key
-        json rootC;
-        rootC[0] = to_string(recursive2Verkey["constRoot"][0]);
-        rootC[1] = to_string(recursive2Verkey["constRoot"][1]);
-        rootC[2] = to_string(recursive2Verkey["constRoot"][2]);
-        rootC[3] = to_string(recursive2Verkey["constRoot"][3]);
-        zkinC12a["publics"] = publicStarkJson;
-        zkinC12a["rootC"] = rootC;
-        TimerStopAndLog(STARK_JSON_GENERATION_BATCH_PROOF_C12A);
+        // Generate the zkin of the c12a proof
+        ZkinStark zkinC12a;
+        proof2zkinStark(fproofC12a, zkinC12a);
+        std::vector<uint64_t> &zkinC12aPublics = zkinC12a.add("publics");
+        for (uint64_t i = 0; i < starkZkevm->starkInfo.nPublics; i++)
+        {
+            zkinC12aPublics.push_back(Goldilocks::toU64(publics[i]));
+        }
+
+        // Add the recursive2 verification key, stored in publics[44..47]
+        std::vector<uint64_t> &zkinC12aRootC = zkinC12a.add("rootC");
+        for (uint64_t i = 0; i < 4; i++)
+        {
+            zkinC12aRootC.push_back(Goldilocks::toU64(publics[starkZkevm->starkInfo.nPublics + i]));
+        }
+        TimerStopAndLog(STARK_ZKIN_GENERATION_BATCH_PROOF_C12A);
 
         CommitPolsStarks cmPolsRecursive1(pAddress, (1 << starksRecursive1->starkInfo.starkStruct.nBits), starksRecursive1->starkInfo.nCm1);
-        CircomRecursive1::getCommitedPols(&cmPolsRecursive1, config.recursive1Verifier, config.recursive1Exec, zkinC12a, (1 << starksRecursive1->starkInfo.starkStruct.nBits), starksRecursive1->starkInfo.nCm1);
+        CircomRecursive1::getCommitedPols(&cmPolsRecursive1, circuitRecursive1, config.recursive1Exec, zkinC12a, (1 << starksRecursive1->starkInfo.starkStruct.nBits), starksRecursive1->starkInfo.nCm1);
 
         // void *pointerCmRecursive1Pols = mapFile("config/recursive1/recursive1.commit", cmPolsRecursive1.size(), true);
         // memcpy(pointerCmRecursive1Pols, cmPolsRecursive1.address(), cmPolsRecursive1.size());
@@ -765,7 +1042,7 @@ void Prover::genAggregatedProof(ProverRequest *pProverRequest)
     }
 
     CommitPolsStarks cmPolsRecursive2(pAddress, (1 << starksRecursive2->starkInfo.starkStruct.nBits), starksRecursive2->starkInfo.nCm1);
-    CircomRecursive2::getCommitedPols(&cmPolsRecursive2, config.recursive2Verifier, config.recursive2Exec, zkinInputRecursive2, (1 << starksRecursive2->starkInfo.starkStruct.nBits), starksRecursive2->starkInfo.nCm1);
+    CircomRecursive2::getCommitedPols(&cmPolsRecursive2, circuitRecursive2, config.recursive2Exec, zkinInputRecursive2, (1 << starksRecursive2->starkInfo.starkStruct.nBits), starksRecursive2->starkInfo.nCm1);
 
     // void *pointerCmRecursive2Pols = mapFile("config/recursive2/recursive2.commit", cmPolsRecursive2.size(), true);
     // memcpy(pointerCmRecursive2Pols, cmPolsRecursive2.address(), cmPolsRecursive2.size());
@@ -855,7 +1132,7 @@ void Prover::genFinalProof(ProverRequest *pProverRequest)
     }
 
     CommitPolsStarks cmPolsRecursiveF(pAddressStarksRecursiveF, (1 << starksRecursiveF->starkInfo.starkStruct.nBits), starksRecursiveF->starkInfo.nCm1);
-    CircomRecursiveF::getCommitedPols(&cmPolsRecursiveF, config.recursivefVerifier, config.recursivefExec, zkinFinal, (1 << starksRecursiveF->starkInfo.starkStruct.nBits), starksRecursiveF->starkInfo.nCm1);
+    CircomRecursiveF::getCommitedPols(&cmPolsRecursiveF, circuitRecursiveF, config.recursivefExec, zkinFinal, (1 << starksRecursiveF->starkInfo.starkStruct.nBits), starksRecursiveF->starkInfo.nCm1);
 
     // void *pointercmPolsRecursiveF = mapFile("config/recursivef/recursivef.commit", cmPolsRecursiveF.size(), true);
     // memcpy(pointercmPolsRecursiveF, cmPolsRecursiveF.address(), cmPolsRecursiveF.size());
@@ -890,10 +1167,6 @@ void Prover::genFinalProof(ProverRequest *pProverRequest)
     //  Verifier final
     //  ----------------------------------------------
 
-    TimerStart(CIRCOM_LOAD_CIRCUIT_FINAL);
-    CircomFinal::Circom_Circuit *circuitFinal = CircomFinal::loadCircuit(config.finalVerifier);
-    TimerStopAndLog(CIRCOM_LOAD_CIRCUIT_FINAL);
-
     TimerStart(CIRCOM_FINAL_LOAD_JSON);
     CircomFinal::Circom_CalcWit *ctxFinal = new CircomFinal::Circom_CalcWit(circuitFinal);
 
@@ -909,7 +1182,6 @@ void Prover::genFinalProof(ProverRequest *pProverRequest)
     AltBn128::FrElement *pWitnessFinal = NULL;
     uint64_t witnessSizeFinal = 0;
     CircomFinal::getBinWitness(ctxFinal, pWitnessFinal, witnessSizeFinal);
-    CircomFinal::freeCircuit(circuitFinal);
     delete ctxFinal;
 
     TimerStopAndLog(CIRCOM_GET_BIN_WITNESS_FINAL);
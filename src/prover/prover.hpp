@@ -23,6 +23,13 @@
 #include "starks.hpp"
 #include "constant_pols_starks.hpp"
 #include "fflonk_prover.hpp"
+
+namespace Circom { struct Circom_Circuit; }
+namespace CircomRecursive1 { struct Circom_Circuit; }
+namespace CircomRecursive2 { struct Circom_Circuit; }
+namespace CircomRecursiveF { struct Circom_Circuit; }
+namespace CircomFinal { struct Circom_Circuit; }
+
 class Prover
 {
     Goldilocks &fr;
@@ -36,6 +43,13 @@ class Prover
     Starks *starksRecursive1;
     Starks *starksRecursive2;
 
+    // Verifier circuits, loaded once and shared read-only by all the proofs
+    Circom::Circom_Circuit *circuitZkevm;
+    CircomRecursive1::Circom_Circuit *circuitRecursive1;
+    CircomRecursive2::Circom_Circuit *circuitRecursive2;
+    CircomRecursiveF::Circom_Circuit *circuitRecursiveF;
+    CircomFinal::Circom_Circuit *circuitFinal;
+
     Fflonk::FflonkProver<AltBn128::Engine> *prover;
     std::unique_ptr<Groth16::Prover<AltBn128::Engine>> groth16Prover;
     std::unique_ptr<BinFileUtils::BinFile> zkey;
@@ -56,6 +70,19 @@ private:
     void *pAddress = NULL;
     void *pAddressStarksRecursiveF = NULL;
     int protocolId;
+
+    // Prover pipeline: the executor stage of the batch proofs runs in its own thread, into its own buffers
+    pthread_t executorPthread; // Executor stage thread
+    vector<void *> pipelineBuffers; // Executor stage buffers, to store the committed polynomials
+    vector<void *> freePipelineBuffers; // Executor stage buffers not in use
+    sem_t freePipelineBufferSem; // Semaphore to wakeup the executor thread when a buffer is released
+public:
+    vector<ProverRequest *> executedRequests; // Queue of requests whose executor stage is done, to be processed by the prover thread
+    sem_t executedRequestSem; // Semaphore to wakeup prover thread when an executed request is available
+
+    // Batch proofs throughput
+    uint64_t completedBatchProofs;
+    time_t firstBatchProofStartTime;
 public:
     const Config &config;
     sem_t pendingRequestSem; // Semaphore to wakeup prover thread when a new request is available
@@ -69,9 +96,11 @@ public:
     ~Prover();
 
     void genBatchProof(ProverRequest *pProverRequest);
+    void executeBatchProof(ProverRequest *pProverRequest, void *pCmPolsAddress); // Executor stage of genBatchProof()
     void genAggregatedProof(ProverRequest *pProverRequest);
     void genFinalProof(ProverRequest *pProverRequest);
     void processBatch(ProverRequest *pProverRequest);
+    void recordProcessBatchMetrics(ProverRequest *pProverRequest, uint64_t time); // Time in us
     void execute(ProverRequest *pProverRequest);
     
     string submitRequest(ProverRequest *pProverRequest);                                          // returns UUID for this request
@@ -79,9 +108,14 @@ public:
 
     void lock(void) { pthread_mutex_lock(&mutex); };
     void unlock(void) { pthread_mutex_unlock(&mutex); };
+
+    // Prover pipeline buffers management
+    void *getPipelineBuffer(void); // Blocks until a buffer is available
+    void releasePipelineBuffer(void *pBuffer);
 };
 
 void *proverThread(void *arg);
+void *executorThread(void *arg);
 void *cleanerThread(void *arg);
 
 #endif
\ No newline at end of file
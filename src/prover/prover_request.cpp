@@ -23,6 +23,9 @@ ProverRequest::ProverRequest (Goldilocks &fr, const Config &config, tProverReque
     lastSentFlushId(0),
     dbReadLog(NULL),
     pFullTracer(NULL),
+    pBatchExecutionCacheEntry(NULL),
+    pCmPolsAddress(NULL),
+    pMainMetrics(NULL),
     bCompleted(false),
     bCancelling(false),
     result(ZKR_UNSPECIFIED)
@@ -46,7 +49,8 @@ ProverRequest::ProverRequest (Goldilocks &fr, const Config &config, tProverReque
         filePrefix = config.outputPath + "/" + timestamp + "_" + uuid + ".";
     }
 
-    if (config.saveDbReadsToFile || config.dbMetrics)
+    // The binary witness database, if any, is read through the database read log
+    if (config.saveDbReadsToFile || config.dbMetrics || config.batchExecutionCache || config.witnessDB)
     {
         dbReadLog = new DatabaseMap();
         dbReadLog->setSaveKeys(false);
@@ -54,6 +58,12 @@ ProverRequest::ProverRequest (Goldilocks &fr, const Config &config, tProverReque
         if (config.saveDbReadsToFile){              
             dbReadLog->setSaveKeys(true);
         }
+
+        // The batch execution cache needs the read keys and values to reuse them in the batch proof generation
+        if (config.batchExecutionCache && (type == prt_processBatch))
+        {
+            dbReadLog->setSaveKeys(true);
+        }
         
         if (config.saveDbReadsToFileOnChange)
         {
@@ -286,6 +296,11 @@ ProverRequest::~ProverRequest()
         delete dbReadLog;
     }
 
+    if (pBatchExecutionCacheEntry != NULL)
+    {
+        delete pBatchExecutionCacheEntry;
+    }
+
     if (pFullTracer != NULL)
     {
         DestroyFullTracer();
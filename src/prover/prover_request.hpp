@@ -8,7 +8,10 @@
 #include "counters.hpp"
 #include "full_tracer_interface.hpp"
 #include "database_map.hpp"
+#include "witness_db.hpp"
 #include "prover_request_type.hpp"
+#include "batch_execution_cache.hpp"
+#include "utils/time_metric.hpp"
 
 using json = nlohmann::json;
 using ordered_json = nlohmann::ordered_json;
@@ -61,7 +64,11 @@ public:
     Counters counters; // Counters of the batch execution
     Counters counters_reserve; // Counters reserve of the batch execution
     DatabaseMap *dbReadLog; // Database reads logs done during the execution (if enabled)
+    WitnessDB witnessDB; // Witness state read by the execution, if loaded as a binary witness database
     FullTracerInterface * pFullTracer; // Execution traces interface
+    BatchExecutionCacheEntry * pBatchExecutionCacheEntry; // Process batch data being recorded, or reused to generate the batch proof (if enabled)
+    void * pCmPolsAddress; // Committed polynomials computed by the executor stage of the prover pipeline (if enabled)
+    TimeMetricStorage * pMainMetrics; // Main executor time metrics are accumulated here, if not NULL (if LOG_TIME_STATISTICS_MAIN_EXECUTOR)
 
     /* State */
     bool bCompleted;
@@ -4,10 +4,12 @@
 #include "zkey_fflonk.hpp"
 #include "wtns_utils.hpp"
 #include <sodium.h>
+#include <fstream>
 #include "thread_utils.hpp"
 #include "polynomial/cpolynomial.hpp"
 #include "zklog.hpp"
 #include "exit_process.hpp"
+#include "definitions.hpp"
 
 #define ELPP_NO_DEFAULT_LOG_FILE
 #include "logger.hpp"
@@ -19,6 +21,9 @@ namespace Fflonk
     void FflonkProver<Engine>::initialize(void* reservedMemoryPtr, uint64_t reservedMemorySize)
     {
         zkey = NULL;
+        fixedPTau = NULL;
+        zkeyInPlace = false;
+        lastPeakRss = 0;
         this->reservedMemoryPtr = (FrElement *)reservedMemoryPtr;
         this->reservedMemorySize = reservedMemorySize;
 
@@ -63,6 +68,9 @@ namespace Fflonk
 
         delete fft;
 
+        delete fixedPTau;
+        fixedPTau = NULL;
+
         mapBuffers.clear();
 
         for (auto const &x : roots) delete[] x.second;
@@ -90,7 +98,7 @@ namespace Fflonk
     }
 
     template<typename Engine>
-    void FflonkProver<Engine>::setZkey(BinFileUtils::BinFile *fdZkey) {
+    void FflonkProver<Engine>::setZkey(BinFileUtils::BinFile *fdZkey, bool zkeyInPlace) {
         try
         {
             if(NULL != zkey) {
@@ -127,143 +135,131 @@ namespace Fflonk
             ////////////////////////////////////////////////////
             // PRECOMPUTED BIG BUFFER
             ////////////////////////////////////////////////////
-            // Precomputed 1 > polynomials buffer
+            // When the zkey data is used in place, the precomputed polynomials, evaluations and PTau are not copied;
+            // only the lagrange evaluations are, since they are interleaved with their coefficients in the zkey
+            this->zkeyInPlace = zkeyInPlace;
+
             uint64_t lengthPrecomputedBigBuffer = 0;
-            lengthPrecomputedBigBuffer += zkey->domainSize * 1 * 8; // Polynomials QL, QR, QM, QO, QC, Sigma1, Sigma2 & Sigma3
-            lengthPrecomputedBigBuffer += zkey->domainSize * 8 * 1; // Polynomial  C0
-            // Precomputed 2 > evaluations buffer
-            lengthPrecomputedBigBuffer += zkey->domainSize * 4 * 8; // Evaluations QL, QR, QM, QO, QC, Sigma1, Sigma2, Sigma3
+            if(!zkeyInPlace) {
+                // Precomputed 1 > polynomials buffer
+                lengthPrecomputedBigBuffer += zkey->domainSize * 1 * 8; // Polynomials QL, QR, QM, QO, QC, Sigma1, Sigma2 & Sigma3
+                lengthPrecomputedBigBuffer += zkey->domainSize * 8 * 1; // Polynomial  C0
+                // Precomputed 2 > evaluations buffer
+                lengthPrecomputedBigBuffer += zkey->domainSize * 4 * 8; // Evaluations QL, QR, QM, QO, QC, Sigma1, Sigma2, Sigma3
+            }
             lengthPrecomputedBigBuffer += zkey->domainSize * 4 * zkey->nPublic; // Evaluations Lagrange1
-            // Precomputed 3 > ptau buffer
-            lengthPrecomputedBigBuffer += zkey->domainSize * 9 * sizeof(G1PointAffine) / sizeof(FrElement); // PTau buffer
+            if(!zkeyInPlace) {
+                // Precomputed 3 > ptau buffer
+                lengthPrecomputedBigBuffer += zkey->domainSize * 9 * sizeof(G1PointAffine) / sizeof(FrElement); // PTau buffer
+            }
 
             precomputedBigBuffer = new FrElement[lengthPrecomputedBigBuffer];
 
-            polPtr["Sigma1"] = &precomputedBigBuffer[0];
-            polPtr["Sigma2"] = polPtr["Sigma1"] + zkey->domainSize;
-            polPtr["Sigma3"] = polPtr["Sigma2"] + zkey->domainSize;
-            polPtr["QL"]     = polPtr["Sigma3"] + zkey->domainSize;
-            polPtr["QR"]     = polPtr["QL"] + zkey->domainSize;
-            polPtr["QM"]     = polPtr["QR"] + zkey->domainSize;
-            polPtr["QO"]     = polPtr["QM"] + zkey->domainSize;
-            polPtr["QC"]     = polPtr["QO"] + zkey->domainSize;
-            polPtr["C0"]     = polPtr["QC"] + zkey->domainSize;
-
-            evalPtr["Sigma1"] = polPtr["C0"] + zkey->domainSize * 8;
-            evalPtr["Sigma2"] = evalPtr["Sigma1"] + zkey->domainSize * 4;
-            evalPtr["Sigma3"] = evalPtr["Sigma2"] + zkey->domainSize * 4;
-            evalPtr["QL"]     = evalPtr["Sigma3"] + zkey->domainSize * 4;
-            evalPtr["QR"]     = evalPtr["QL"] + zkey->domainSize * 4;
-            evalPtr["QM"]     = evalPtr["QR"] + zkey->domainSize * 4;
-            evalPtr["QO"]     = evalPtr["QM"] + zkey->domainSize * 4;
-            evalPtr["QC"]     = evalPtr["QO"] + zkey->domainSize * 4;
-            evalPtr["lagrange"] = evalPtr["QC"] + zkey->domainSize * 4;
-
-            PTau = (G1PointAffine *)(evalPtr["lagrange"] + zkey->domainSize * 4 * zkey->nPublic);
-
-                        // Read Q selectors polynomials and evaluations
-            LOG_TRACE("... Loading QL, QR, QM, QO, & QC polynomial coefficients and evaluations");
-
-            // Reserve memory for Q's polynomials
-            polynomials["QL"] = new Polynomial<Engine>(E, polPtr["QL"], zkey->domainSize);
-            polynomials["QR"] = new Polynomial<Engine>(E, polPtr["QR"], zkey->domainSize);
-            polynomials["QM"] = new Polynomial<Engine>(E, polPtr["QM"], zkey->domainSize);
-            polynomials["QO"] = new Polynomial<Engine>(E, polPtr["QO"], zkey->domainSize);
-            polynomials["QC"] = new Polynomial<Engine>(E, polPtr["QC"], zkey->domainSize);
+            if(zkeyInPlace) {
+                polPtr["Sigma1"] = (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_SIGMA1_SECTION);
+                polPtr["Sigma2"] = (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_SIGMA2_SECTION);
+                polPtr["Sigma3"] = (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_SIGMA3_SECTION);
+                polPtr["QL"]     = (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_QL_SECTION);
+                polPtr["QR"]     = (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_QR_SECTION);
+                polPtr["QM"]     = (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_QM_SECTION);
+                polPtr["QO"]     = (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_QO_SECTION);
+                polPtr["QC"]     = (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_QC_SECTION);
+                polPtr["C0"]     = (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_C0_SECTION);
+
+                // Each section stores the coefficients followed by the evaluations
+                evalPtr["Sigma1"] = polPtr["Sigma1"] + zkey->domainSize;
+                evalPtr["Sigma2"] = polPtr["Sigma2"] + zkey->domainSize;
+                evalPtr["Sigma3"] = polPtr["Sigma3"] + zkey->domainSize;
+                evalPtr["QL"]     = polPtr["QL"] + zkey->domainSize;
+                evalPtr["QR"]     = polPtr["QR"] + zkey->domainSize;
+                evalPtr["QM"]     = polPtr["QM"] + zkey->domainSize;
+                evalPtr["QO"]     = polPtr["QO"] + zkey->domainSize;
+                evalPtr["QC"]     = polPtr["QC"] + zkey->domainSize;
+                evalPtr["lagrange"] = &precomputedBigBuffer[0];
+
+                PTau = (G1PointAffine *)fdZkey->getSectionData(Zkey::ZKEY_FF_PTAU_SECTION);
+            } else {
+                polPtr["Sigma1"] = &precomputedBigBuffer[0];
+                polPtr["Sigma2"] = polPtr["Sigma1"] + zkey->domainSize;
+                polPtr["Sigma3"] = polPtr["Sigma2"] + zkey->domainSize;
+                polPtr["QL"]     = polPtr["Sigma3"] + zkey->domainSize;
+                polPtr["QR"]     = polPtr["QL"] + zkey->domainSize;
+                polPtr["QM"]     = polPtr["QR"] + zkey->domainSize;
+                polPtr["QO"]     = polPtr["QM"] + zkey->domainSize;
+                polPtr["QC"]     = polPtr["QO"] + zkey->domainSize;
+                polPtr["C0"]     = polPtr["QC"] + zkey->domainSize;
+
+                evalPtr["Sigma1"] = polPtr["C0"] + zkey->domainSize * 8;
+                evalPtr["Sigma2"] = evalPtr["Sigma1"] + zkey->domainSize * 4;
+                evalPtr["Sigma3"] = evalPtr["Sigma2"] + zkey->domainSize * 4;
+                evalPtr["QL"]     = evalPtr["Sigma3"] + zkey->domainSize * 4;
+                evalPtr["QR"]     = evalPtr["QL"] + zkey->domainSize * 4;
+                evalPtr["QM"]     = evalPtr["QR"] + zkey->domainSize * 4;
+                evalPtr["QO"]     = evalPtr["QM"] + zkey->domainSize * 4;
+                evalPtr["QC"]     = evalPtr["QO"] + zkey->domainSize * 4;
+                evalPtr["lagrange"] = evalPtr["QC"] + zkey->domainSize * 4;
+
+                PTau = (G1PointAffine *)(evalPtr["lagrange"] + zkey->domainSize * 4 * zkey->nPublic);
+            }
 
             int nThreads = omp_get_max_threads() / 2;
 
-            // Read Q's polynomial coefficients from zkey file
-            ThreadUtils::parcpy(polynomials["QL"]->coef,
-                                (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_QL_SECTION),
-                                sDomain, nThreads);
-            ThreadUtils::parcpy(polynomials["QR"]->coef,
-                                (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_QR_SECTION),
-                                sDomain, nThreads);
-            ThreadUtils::parcpy(polynomials["QM"]->coef,
-                                (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_QM_SECTION),
-                                sDomain, nThreads);
-            ThreadUtils::parcpy(polynomials["QO"]->coef,
-                                (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_QO_SECTION),
-                                sDomain, nThreads);
-            ThreadUtils::parcpy(polynomials["QC"]->coef,
-                                (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_QC_SECTION),
-                                sDomain, nThreads);
-
-            polynomials["QL"]->fixDegree();
-            polynomials["QR"]->fixDegree();
-            polynomials["QM"]->fixDegree();
-            polynomials["QO"]->fixDegree();
-            polynomials["QC"]->fixDegree();
+            // Creates a precomputed polynomial over its zkey section, copying it unless used in place
+            auto loadPolynomial = [&](const std::string &name, int section, u_int64_t length) {
+                if(zkeyInPlace) {
+                    polynomials[name] = Polynomial<Engine>::fromCoefficients(E, polPtr[name], length);
+                    return;
+                }
+                polynomials[name] = new Polynomial<Engine>(E, polPtr[name], length);
+                ThreadUtils::parcpy(polynomials[name]->coef,
+                                    (FrElement *)fdZkey->getSectionData(section),
+                                    length * sizeof(FrElement), nThreads);
+                polynomials[name]->fixDegree();
+            };
+
+            // Creates precomputed evaluations over its zkey section, copying them unless used in place
+            auto loadEvaluations = [&](const std::string &name, int section) {
+                if(zkeyInPlace) {
+                    evaluations[name] = Evaluations<Engine>::fromEvaluations(E, evalPtr[name], zkey->domainSize * 4);
+                    return;
+                }
+                evaluations[name] = new Evaluations<Engine>(E, evalPtr[name], zkey->domainSize * 4);
+                ThreadUtils::parcpy(evaluations[name]->eval,
+                                    (FrElement *)fdZkey->getSectionData(section) + zkey->domainSize,
+                                    sDomain * 4, nThreads);
+            };
+
+            // Read Q selectors polynomials and evaluations
+            LOG_TRACE("... Loading QL, QR, QM, QO, & QC polynomial coefficients and evaluations");
+
+            loadPolynomial("QL", Zkey::ZKEY_FF_QL_SECTION, zkey->domainSize);
+            loadPolynomial("QR", Zkey::ZKEY_FF_QR_SECTION, zkey->domainSize);
+            loadPolynomial("QM", Zkey::ZKEY_FF_QM_SECTION, zkey->domainSize);
+            loadPolynomial("QO", Zkey::ZKEY_FF_QO_SECTION, zkey->domainSize);
+            loadPolynomial("QC", Zkey::ZKEY_FF_QC_SECTION, zkey->domainSize);
 
             std::ostringstream ss;
             ss << "... Reading Q selector evaluations ";
 
-            // Reserve memory for Q's evaluations
-            evaluations["QL"] = new Evaluations<Engine>(E, evalPtr["QL"], zkey->domainSize * 4);
-            evaluations["QR"] = new Evaluations<Engine>(E, evalPtr["QR"], zkey->domainSize * 4);
-            evaluations["QM"] = new Evaluations<Engine>(E, evalPtr["QM"], zkey->domainSize * 4);
-            evaluations["QO"] = new Evaluations<Engine>(E, evalPtr["QO"], zkey->domainSize * 4);
-            evaluations["QC"] = new Evaluations<Engine>(E, evalPtr["QC"], zkey->domainSize * 4);
-
-            // Read Q's evaluations from zkey file
-            ThreadUtils::parcpy(evaluations["QL"]->eval,
-                                (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_QL_SECTION) + zkey->domainSize,
-                                sDomain * 4, nThreads);
-            ThreadUtils::parcpy(evaluations["QR"]->eval,
-                                (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_QR_SECTION) + zkey->domainSize,
-                                sDomain * 4, nThreads);
-            ThreadUtils::parcpy(evaluations["QM"]->eval,
-                                (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_QM_SECTION) + zkey->domainSize,
-                                sDomain * 4, nThreads);
-            ThreadUtils::parcpy(evaluations["QO"]->eval,
-                                (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_QO_SECTION) + zkey->domainSize,
-                                sDomain * 4, nThreads);
-            ThreadUtils::parcpy(evaluations["QC"]->eval,
-                                (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_QC_SECTION) + zkey->domainSize,
-                                sDomain * 4, nThreads);
+            loadEvaluations("QL", Zkey::ZKEY_FF_QL_SECTION);
+            loadEvaluations("QR", Zkey::ZKEY_FF_QR_SECTION);
+            loadEvaluations("QM", Zkey::ZKEY_FF_QM_SECTION);
+            loadEvaluations("QO", Zkey::ZKEY_FF_QO_SECTION);
+            loadEvaluations("QC", Zkey::ZKEY_FF_QC_SECTION);
 
             // Read Sigma polynomial coefficients and evaluations from zkey file
             LOG_TRACE("... Loading Sigma1, Sigma2 & Sigma3 polynomial coefficients and evaluations");
 
-            polynomials["Sigma1"] = new Polynomial<Engine>(E, polPtr["Sigma1"], zkey->domainSize);
-            polynomials["Sigma2"] = new Polynomial<Engine>(E, polPtr["Sigma2"], zkey->domainSize);
-            polynomials["Sigma3"] = new Polynomial<Engine>(E, polPtr["Sigma3"], zkey->domainSize);
-
-            ThreadUtils::parcpy(polynomials["Sigma1"]->coef,
-                                (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_SIGMA1_SECTION),
-                                sDomain, nThreads);
-            ThreadUtils::parcpy(polynomials["Sigma2"]->coef,
-                                (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_SIGMA2_SECTION),
-                                sDomain, nThreads);
-            ThreadUtils::parcpy(polynomials["Sigma3"]->coef,
-                                (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_SIGMA3_SECTION),
-                                sDomain, nThreads);
-
-            polynomials["Sigma1"]->fixDegree();
-            polynomials["Sigma2"]->fixDegree();
-            polynomials["Sigma3"]->fixDegree();
-
-            evaluations["Sigma1"] = new Evaluations<Engine>(E, evalPtr["Sigma1"], zkey->domainSize * 4);
-            evaluations["Sigma2"] = new Evaluations<Engine>(E, evalPtr["Sigma2"], zkey->domainSize * 4);
-            evaluations["Sigma3"] = new Evaluations<Engine>(E, evalPtr["Sigma3"], zkey->domainSize * 4);
-
-            ThreadUtils::parcpy(evaluations["Sigma1"]->eval,
-                                (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_SIGMA1_SECTION) + zkey->domainSize,
-                                sDomain * 4, nThreads);
-            ThreadUtils::parcpy(evaluations["Sigma2"]->eval,
-                                (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_SIGMA2_SECTION) + zkey->domainSize,
-                                sDomain * 4, nThreads);
-            ThreadUtils::parcpy(evaluations["Sigma3"]->eval,
-                                (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_SIGMA3_SECTION) + zkey->domainSize,
-                                sDomain * 4, nThreads);
+            loadPolynomial("Sigma1", Zkey::ZKEY_FF_SIGMA1_SECTION, zkey->domainSize);
+            loadPolynomial("Sigma2", Zkey::ZKEY_FF_SIGMA2_SECTION, zkey->domainSize);
+            loadPolynomial("Sigma3", Zkey::ZKEY_FF_SIGMA3_SECTION, zkey->domainSize);
+
+            loadEvaluations("Sigma1", Zkey::ZKEY_FF_SIGMA1_SECTION);
+            loadEvaluations("Sigma2", Zkey::ZKEY_FF_SIGMA2_SECTION);
+            loadEvaluations("Sigma3", Zkey::ZKEY_FF_SIGMA3_SECTION);
 
             LOG_TRACE("... Loading C0 polynomial coefficients");
-            polynomials["C0"] = new Polynomial<Engine>(E, polPtr["C0"], zkey->domainSize * 8);
-            ThreadUtils::parcpy(polynomials["C0"]->coef,
-                                (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_C0_SECTION),
-                                sDomain * 8, nThreads);
-            polynomials["C0"]->fixDegree();
+            loadPolynomial("C0", Zkey::ZKEY_FF_C0_SECTION, zkey->domainSize * 8);
 
             // Read Lagrange polynomials & evaluations from zkey file
             LOG_TRACE("... Loading Lagrange evaluations");
@@ -273,15 +269,18 @@ namespace Fflonk
                                     (FrElement *)fdZkey->getSectionData(Zkey::ZKEY_FF_LAGRANGE_SECTION) + zkey->domainSize + zkey->domainSize * 5 * i,
                                     sDomain * 4, nThreads);
             }
-            LOG_TRACE("... Loading Powers of Tau evaluations");
-
-            ThreadUtils::parset(PTau, 0, sizeof(G1PointAffine) * zkey->domainSize * 9, nThreads);
 
             // domainSize * 9 = SRS length in the zkey saved in setup process.
             // it corresponds to the maximum SRS length needed, specifically to commit C2
-            ThreadUtils::parcpy(this->PTau,
-                                (G1PointAffine *)fdZkey->getSectionData(Zkey::ZKEY_FF_PTAU_SECTION),
-                                (zkey->domainSize * 9) * sizeof(G1PointAffine), nThreads);
+            if(!zkeyInPlace) {
+                LOG_TRACE("... Loading Powers of Tau evaluations");
+
+                ThreadUtils::parset(PTau, 0, sizeof(G1PointAffine) * zkey->domainSize * 9, nThreads);
+
+                ThreadUtils::parcpy(this->PTau,
+                                    (G1PointAffine *)fdZkey->getSectionData(Zkey::ZKEY_FF_PTAU_SECTION),
+                                    (zkey->domainSize * 9) * sizeof(G1PointAffine), nThreads);
+            }
 
             // Load A, B & C map buffers
             LOG_TRACE("... Loading A, B & C map buffers");
@@ -344,12 +343,10 @@ namespace Fflonk
             lengthNonPrecomputedBigBuffer += zkey->domainSize * 16 * 1; // Polynomial C2
             lengthNonPrecomputedBigBuffer += zkey->domainSize * 16 * 1; // Polynomial F
             lengthNonPrecomputedBigBuffer += zkey->domainSize * 16 * 1; // Polynomial tmp (Z, T0, T1, T1z, T2 & T2z will (re)use this buffer)
-            // Non-precomputed 2 > evaluations buffer
-            lengthNonPrecomputedBigBuffer += zkey->domainSize * 4  * 3; // Evaluations A, B & C
-            lengthNonPrecomputedBigBuffer += zkey->domainSize * 4  * 1; // Evaluations Z
+            // Non-precomputed 2 > evaluations A, B, C & Z reuse the polynomial F buffer, which is computed after them
             // Non-precomputed 3 > buffers buffer
             buffersLength = 0;
-            buffersLength   += zkey->domainSize * 4  * 3; // Evaluations A, B & C
+            buffersLength   += zkey->domainSize * 1  * 3; // Buffers A, B & C
             buffersLength   += zkey->domainSize * 16 * 1; // Evaluations tmp (Z, numArr, denArr, T0, T1, T1z, T2 & T2z will (re)use this buffer)
             lengthNonPrecomputedBigBuffer += buffersLength;
 
@@ -365,6 +362,12 @@ namespace Fflonk
 
                 nonPrecomputedBigBuffer = this->reservedMemoryPtr + lengthBatchInversesBuffer;
             }
+
+            ss.str("");
+            ss << "... Precomputed buffer: " << lengthPrecomputedBigBuffer * sizeof(FrElement) / (1024 * 1024) << " MB"
+               << (zkeyInPlace ? " (zkey data used in place)" : "")
+               << ", non-precomputed buffer: " << lengthNonPrecomputedBigBuffer * sizeof(FrElement) / (1024 * 1024) << " MB";
+            LOG_TRACE(ss);
             
             polPtr["L"] = &nonPrecomputedBigBuffer[0];
             polPtr["C1"]  = polPtr["L"]  + zkey->domainSize * 16;
@@ -409,6 +412,45 @@ namespace Fflonk
         }
     }
 
+    template<typename Engine>
+    void FflonkProver<Engine>::logMemoryUsage(const std::string &stage) {
+#ifdef LOG_FFLONK_MEMORY_USAGE
+        u_int64_t rss = 0, peakRss = 0;
+
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.rfind("VmRSS:", 0) == 0) {
+                rss = std::stoull(line.substr(6));
+            } else if (line.rfind("VmHWM:", 0) == 0) {
+                peakRss = std::stoull(line.substr(6));
+            }
+        }
+
+        // The peak is process-wide and never reset, so the growth of the peak is the part of it reached in this stage
+        u_int64_t peakRssIncrease = (lastPeakRss != 0) && (peakRss > lastPeakRss) ? peakRss - lastPeakRss : 0;
+        lastPeakRss = peakRss;
+
+        std::ostringstream ss;
+        ss << "... Memory after " << stage << ": RSS " << rss / 1024 << " MB, peak RSS " << peakRss / 1024 << " MB (+" << peakRssIncrease / 1024 << " MB)";
+        LOG_TRACE(ss);
+#endif
+    }
+
+    template<typename Engine>
+    u_int64_t FflonkProver<Engine>::precomputeFixedBases(u_int64_t maxMemory) {
+        if(NULL == zkey) {
+            zklog.error("Fflonk::precomputeFixedBases() called before setZkey()");
+            exitProcess();
+        }
+
+        LOG_TRACE("Precomputing PTau fixed bases");
+        delete fixedPTau;
+        fixedPTau = new MultiexpFixedBases<typename Engine::G1>(E.g1, PTau, zkey->domainSize * 9, sizeof(FrElement), maxMemory);
+
+        return fixedPTau->memory();
+    }
+
     template<typename Engine>
     std::tuple <json, json> FflonkProver<Engine>::prove(BinFileUtils::BinFile *fdZkey, BinFileUtils::BinFile *fdWtns) {
 
@@ -526,28 +568,34 @@ namespace Fflonk
             ThreadUtils::parset(buffers["A"], 0, buffersLength * sizeof(FrElement), nThreads);
 
             calculateAdditions();
+            logMemoryUsage("additions");
 
             // START FFLONK PROVER PROTOCOL
 
             // ROUND 1. Compute C1(X) polynomial
             LOG_TRACE("> ROUND 1");
             round1();
+            logMemoryUsage("round 1");
 
             // ROUND 2. Compute C2(X) polynomial
             LOG_TRACE("> ROUND 2");
             round2();
+            logMemoryUsage("round 2");
 
             // ROUND 3. Compute opening evaluations
             LOG_TRACE("> ROUND 3");
             round3();
+            logMemoryUsage("round 3");
 
             // ROUND 4. Compute W(X) polynomial
             LOG_TRACE("> ROUND 4");
             round4();
+            logMemoryUsage("round 4");
 
             // ROUND 5. Compute W'(X) polynomial
             LOG_TRACE("> ROUND 5");
             round5();
+            logMemoryUsage("round 5");
 
             proof->addEvaluationCommitment("inv", getMontgomeryBatchedInverse());
 
@@ -1697,7 +1745,11 @@ namespace Fflonk
         G1Point value;
         FrElement *pol = this->polynomialFromMontgomery(polynomial);
 
-        E.g1.multiMulByScalar(value, PTau, (uint8_t *)pol, sizeof(pol[0]), polynomial->getDegree() + 1);
+        if (fixedPTau != NULL) {
+            E.g1.multiMulByScalar(value, *fixedPTau, (uint8_t *)pol, sizeof(pol[0]), polynomial->getDegree() + 1);
+        } else {
+            E.g1.multiMulByScalar(value, PTau, (uint8_t *)pol, sizeof(pol[0]), polynomial->getDegree() + 1);
+        }
 
         return value;
     }
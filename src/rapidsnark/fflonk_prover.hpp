@@ -7,6 +7,7 @@
 #include "binfile_utils.hpp"
 #include <gmp.h>
 #include "fft.hpp"
+#include "multiexp.hpp"
 #include "zkey_fflonk.hpp"
 #include "polynomial/polynomial.hpp"
 #include "polynomial/evaluations.hpp"
@@ -41,6 +42,9 @@ namespace Fflonk {
 
         FrElement *precomputedBigBuffer;
         G1PointAffine *PTau;
+        MultiexpFixedBases<typename Engine::G1> *fixedPTau; // Precomputed multiples of PTau, if enabled
+        bool zkeyInPlace; // True if the precomputed polynomials, evaluations and PTau point into the zkey file data
+        u_int64_t lastPeakRss; // Peak resident memory of the process in the last logMemoryUsage() call, in kB
 
         u_int64_t lengthNonPrecomputedBigBuffer;
         FrElement *nonPrecomputedBigBuffer;
@@ -81,7 +85,13 @@ namespace Fflonk {
 
         ~FflonkProver();
 
-        void setZkey(BinFileUtils::BinFile *fdZkey);
+        // If zkeyInPlace, the precomputed polynomials, evaluations and PTau are used directly from the zkey file data
+        // instead of being copied, so fdZkey must be kept alive while proving
+        void setZkey(BinFileUtils::BinFile *fdZkey, bool zkeyInPlace = false);
+
+        // Precomputes multiples of the PTau points to speed up the commitments multiexps, using up to maxMemory bytes;
+        // returns the memory used
+        u_int64_t precomputeFixedBases(u_int64_t maxMemory);
 
         std::tuple <json, json> prove(BinFileUtils::BinFile *fdZkey, BinFileUtils::BinFile *fdWtns);
         std::tuple <json, json> prove(BinFileUtils::BinFile *fdZkey, FrElement *wtns, WtnsUtils::Header* wtnsHeader = NULL);
@@ -94,6 +104,10 @@ namespace Fflonk {
 
         void removePrecomputedData();
 
+        // If LOG_FFLONK_MEMORY_USAGE is defined, logs the current and peak resident memory of the process, and how much
+        // the peak grew since the previous call, i.e. during this stage
+        void logMemoryUsage(const std::string &stage);
+
         void calculateAdditions();
 
         FrElement getWitness(u_int64_t idx);
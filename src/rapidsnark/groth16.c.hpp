@@ -46,48 +46,103 @@ std::unique_ptr<Prover<Engine>> makeProver(
 }
 
 template <typename Engine>
-std::unique_ptr<Proof<Engine>> Prover<Engine>::prove(typename Engine::FrElement *wtns) {
+void Prover<Engine>::partitionCoefs() {
+    u_int64_t nRows = 2*(u_int64_t)domainSize;
+    rowOffsets.assign(nRows + 1, 0);
 
-    LOG_TRACE("Start Initializing a b c A");
-    auto a = new typename Engine::FrElement[domainSize];
-    auto b = new typename Engine::FrElement[domainSize];
-    auto c = new typename Engine::FrElement[domainSize];
-
-    #pragma omp parallel for
-    for (u_int32_t i=0; i<domainSize; i++) {
-        E.fr.copy(a[i], E.fr.zero());
-        E.fr.copy(b[i], E.fr.zero());
+    // Count the coefficients of every row, and check if they are already sorted by row
+    bool sorted = true;
+    u_int64_t lastRow = 0;
+    for (u_int64_t i=0; i<nCoefs; i++) {
+        u_int64_t row = (coefs[i].m == 0 ? 0 : domainSize) + coefs[i].c;
+        rowOffsets[row + 1]++;
+        if (row < lastRow) sorted = false;
+        lastRow = row;
+    }
+    for (u_int64_t row=0; row<nRows; row++) {
+        rowOffsets[row + 1] += rowOffsets[row];
+    }
+    if (sorted) {
+        return;
     }
 
-    LOG_TRACE("Processing coefs");
-    #define NLOCKS 1024
-    omp_lock_t locks[NLOCKS];
-    for (int i=0; i<NLOCKS; i++) omp_init_lock(&locks[i]);
-    #pragma omp parallel for 
+    // Counting sort of the coefficient indices by row
+    LOG_TRACE("Sorting coefs by row");
+    coefsOrder.resize(nCoefs);
+    std::vector<u_int64_t> next(rowOffsets.begin(), rowOffsets.end() - 1);
     for (u_int64_t i=0; i<nCoefs; i++) {
-        typename Engine::FrElement *ab = (coefs[i].m == 0) ? a : b;
-        typename Engine::FrElement aux;
-
-        E.fr.mul(
-            aux,
-            wtns[coefs[i].s],
-            coefs[i].coef
-        );
+        u_int64_t row = (coefs[i].m == 0 ? 0 : domainSize) + coefs[i].c;
+        coefsOrder[next[row]++] = i;
+    }
+}
 
-        omp_set_lock(&locks[coefs[i].c % NLOCKS]);
-        E.fr.add(
-            ab[coefs[i].c],
-            ab[coefs[i].c],
-            aux
-        );
-        omp_unset_lock(&locks[coefs[i].c % NLOCKS]);
+template <typename Engine>
+u_int64_t Prover<Engine>::precomputeFixedBases(u_int64_t maxMemory) {
+    // Share the memory in proportion to the size of every set of points
+    u_int64_t sizeG1 = sizeof(typename Engine::G1PointAffine);
+    u_int64_t sizeG2 = sizeof(typename Engine::G2PointAffine);
+    u_int64_t nC = nVars - nPublic - 1;
+    u_int64_t total = nVars*(2*sizeG1 + sizeG2) + nC*sizeG1 + domainSize*sizeG1;
+    uint32_t sW = sizeof(typename Engine::FrElement);
+
+    // Budget of every set, multiplying before dividing in 128 bits, so that budgets lower than total are not
+    // truncated to 0, and higher ones are not truncated to a multiple of total
+    auto budget = [&](u_int64_t n, u_int64_t size) {
+        return (u_int64_t)((unsigned __int128)maxMemory*n*size/total);
+    };
+
+    LOG_TRACE("Precomputing fixed bases");
+    fixedPointsA.reset(new MultiexpFixedBases<typename Engine::G1>(E.g1, pointsA, nVars, sW, budget(nVars, sizeG1)));
+    fixedPointsB1.reset(new MultiexpFixedBases<typename Engine::G1>(E.g1, pointsB1, nVars, sW, budget(nVars, sizeG1)));
+    fixedPointsB2.reset(new MultiexpFixedBases<typename Engine::G2>(E.g2, pointsB2, nVars, sW, budget(nVars, sizeG2)));
+    fixedPointsC.reset(new MultiexpFixedBases<typename Engine::G1>(E.g1, pointsC, nC, sW, budget(nC, sizeG1)));
+    fixedPointsH.reset(new MultiexpFixedBases<typename Engine::G1>(E.g1, pointsH, domainSize, sW, budget(domainSize, sizeG1)));
+
+    // A set gets no table if its budget is lower than one copy of its points
+    const char *names[5] = {"A", "B1", "B2", "C", "H"};
+    u_int64_t nTables[5] = {fixedPointsA->nTables, fixedPointsB1->nTables, fixedPointsB2->nTables, fixedPointsC->nTables, fixedPointsH->nTables};
+    for (u_int64_t i=0; i<5; i++) {
+        if (nTables[i] == 1) {
+            std::ostringstream ss;
+            ss << "Groth16::precomputeFixedBases() got no fixed base table for points " << names[i] << " with maxMemory=" << maxMemory;
+            LOG_INFO(ss);
+        }
     }
-    for (int i=0; i<NLOCKS; i++) omp_destroy_lock(&locks[i]);
 
+    return fixedPointsA->memory() + fixedPointsB1->memory() + fixedPointsB2->memory() + fixedPointsC->memory() + fixedPointsH->memory();
+}
 
-    LOG_TRACE("Calculating c");
-    #pragma omp parallel for
+template <typename Engine>
+std::unique_ptr<Proof<Engine>> Prover<Engine>::prove(typename Engine::FrElement *wtns) {
+
+    LOG_TRACE("Start Initializing a b c A");
+    auto a = new typename Engine::FrElement[domainSize];
+    auto b = new typename Engine::FrElement[domainSize];
+    auto c = new typename Engine::FrElement[domainSize];
+
+    // Every row is accumulated by a single thread, so no locks are needed
+    LOG_TRACE("Processing coefs and calculating c");
+    #pragma omp parallel for schedule(dynamic, 1024)
     for (u_int32_t i=0; i<domainSize; i++) {
+        typename Engine::FrElement aux;
+        for (u_int32_t m=0; m<2; m++) {
+            typename Engine::FrElement &ab = (m == 0) ? a[i] : b[i];
+            E.fr.copy(ab, E.fr.zero());
+            u_int64_t row = m*domainSize + i;
+            for (u_int64_t k=rowOffsets[row]; k<rowOffsets[row+1]; k++) {
+                Coef<Engine> &coef = coefs[coefsOrder.empty() ? k : coefsOrder[k]];
+                E.fr.mul(
+                    aux,
+                    wtns[coef.s],
+                    coef.coef
+                );
+                E.fr.add(
+                    ab,
+                    ab,
+                    aux
+                );
+            }
+        }
         E.fr.mul(
             c[i],
             a[i],
@@ -95,64 +150,20 @@ std::unique_ptr<Proof<Engine>> Prover<Engine>::prove(typename Engine::FrElement
         );
     }
 
-    LOG_TRACE("Initializing fft");
-    u_int32_t domainPower = fft->log2(domainSize);
-
-    LOG_TRACE("Start iFFT A");
-    fft->ifft(a, domainSize);
-    LOG_TRACE("a After ifft:");
-    LOG_DEBUG(E.fr.toString(a[0]).c_str());
-    LOG_DEBUG(E.fr.toString(a[1]).c_str());
-    LOG_TRACE("Start Shift A");
-    #pragma omp parallel for
-    for (u_int64_t i=0; i<domainSize; i++) {
-        E.fr.mul(a[i], a[i], fft->root(domainPower+1, i));
-    }
-    LOG_TRACE("a After shift:");
-    LOG_DEBUG(E.fr.toString(a[0]).c_str());
-    LOG_DEBUG(E.fr.toString(a[1]).c_str());
-    LOG_TRACE("Start FFT A");
-    fft->fft(a, domainSize);
-    LOG_TRACE("a After fft:");
+    // a, b and c are transformed together, to their evaluations over the domain shifted by the 2*domainSize root of unity
+    typename Engine::FrElement *pols[3] = {a, b, c};
+    LOG_TRACE("Start iFFT and shift A B C");
+    fft->ifftShift(pols, 3, domainSize);
+    LOG_TRACE("a b c After ifft and shift:");
     LOG_DEBUG(E.fr.toString(a[0]).c_str());
-    LOG_DEBUG(E.fr.toString(a[1]).c_str());
-    LOG_TRACE("Start iFFT B");
-    fft->ifft(b, domainSize);
-    LOG_TRACE("b After ifft:");
-    LOG_DEBUG(E.fr.toString(b[0]).c_str());
-    LOG_DEBUG(E.fr.toString(b[1]).c_str());
-    LOG_TRACE("Start Shift B");
-    #pragma omp parallel for
-    for (u_int64_t i=0; i<domainSize; i++) {
-        E.fr.mul(b[i], b[i], fft->root(domainPower+1, i));
-    }
-    LOG_TRACE("b After shift:");
-    LOG_DEBUG(E.fr.toString(b[0]).c_str());
-    LOG_DEBUG(E.fr.toString(b[1]).c_str());
-    LOG_TRACE("Start FFT B");
-    fft->fft(b, domainSize);
-    LOG_TRACE("b After fft:");
     LOG_DEBUG(E.fr.toString(b[0]).c_str());
-    LOG_DEBUG(E.fr.toString(b[1]).c_str());
-
-    LOG_TRACE("Start iFFT C");
-    fft->ifft(c, domainSize);
-    LOG_TRACE("c After ifft:");
-    LOG_DEBUG(E.fr.toString(c[0]).c_str());
-    LOG_DEBUG(E.fr.toString(c[1]).c_str());
-    LOG_TRACE("Start Shift C");
-    #pragma omp parallel for
-    for (u_int64_t i=0; i<domainSize; i++) {
-        E.fr.mul(c[i], c[i], fft->root(domainPower+1, i));
-    }
-    LOG_TRACE("c After shift:");
     LOG_DEBUG(E.fr.toString(c[0]).c_str());
-    LOG_DEBUG(E.fr.toString(c[1]).c_str());
-    LOG_TRACE("Start FFT C");
-    fft->fft(c, domainSize);
-    LOG_TRACE("c After fft:");
+    LOG_TRACE("Start FFT A B C");
+    fft->fft(pols, 3, domainSize);
+    LOG_TRACE("a b c After fft:");
+    LOG_DEBUG(E.fr.toString(a[0]).c_str());
+    LOG_DEBUG(E.fr.toString(b[0]).c_str());
     LOG_DEBUG(E.fr.toString(c[0]).c_str());
-    LOG_DEBUG(E.fr.toString(c[1]).c_str());
 
     LOG_TRACE("Start ABC");
     #pragma omp parallel for
@@ -170,7 +181,11 @@ std::unique_ptr<Proof<Engine>> Prover<Engine>::prove(typename Engine::FrElement
 
     LOG_TRACE("Start Multiexp H");
     typename Engine::G1Point pih;
-    E.g1.multiMulByScalar(pih, pointsH, (uint8_t *)a, sizeof(a[0]), domainSize);
+    if (fixedPointsH) {
+        E.g1.multiMulByScalar(pih, *fixedPointsH, (uint8_t *)a, sizeof(a[0]), domainSize);
+    } else {
+        E.g1.multiMulByScalar(pih, pointsH, (uint8_t *)a, sizeof(a[0]), domainSize);
+    }
     std::ostringstream ss1;
     ss1 << "pih: " << E.g1.toString(pih);
     LOG_DEBUG(ss1);
@@ -180,28 +195,44 @@ std::unique_ptr<Proof<Engine>> Prover<Engine>::prove(typename Engine::FrElement
     LOG_TRACE("Start Multiexp A");
     uint32_t sW = sizeof(wtns[0]);
     typename Engine::G1Point pi_a;
-    E.g1.multiMulByScalar(pi_a, pointsA, (uint8_t *)wtns, sW, nVars);
+    if (fixedPointsA) {
+        E.g1.multiMulByScalar(pi_a, *fixedPointsA, (uint8_t *)wtns, sW, nVars);
+    } else {
+        E.g1.multiMulByScalar(pi_a, pointsA, (uint8_t *)wtns, sW, nVars);
+    }
     std::ostringstream ss2;
     ss2 << "pi_a: " << E.g1.toString(pi_a);
     LOG_DEBUG(ss2);
 
     LOG_TRACE("Start Multiexp B1");
     typename Engine::G1Point pib1;
-    E.g1.multiMulByScalar(pib1, pointsB1, (uint8_t *)wtns, sW, nVars);
+    if (fixedPointsB1) {
+        E.g1.multiMulByScalar(pib1, *fixedPointsB1, (uint8_t *)wtns, sW, nVars);
+    } else {
+        E.g1.multiMulByScalar(pib1, pointsB1, (uint8_t *)wtns, sW, nVars);
+    }
     std::ostringstream ss3;
     ss3 << "pib1: " << E.g1.toString(pib1);
     LOG_DEBUG(ss3);
 
     LOG_TRACE("Start Multiexp B2");
     typename Engine::G2Point pi_b;
-    E.g2.multiMulByScalar(pi_b, pointsB2, (uint8_t *)wtns, sW, nVars);
+    if (fixedPointsB2) {
+        E.g2.multiMulByScalar(pi_b, *fixedPointsB2, (uint8_t *)wtns, sW, nVars);
+    } else {
+        E.g2.multiMulByScalar(pi_b, pointsB2, (uint8_t *)wtns, sW, nVars);
+    }
     std::ostringstream ss4;
     ss4 << "pi_b: " << E.g2.toString(pi_b);
     LOG_DEBUG(ss4);
 
     LOG_TRACE("Start Multiexp C");
     typename Engine::G1Point pi_c;
-    E.g1.multiMulByScalar(pi_c, pointsC, (uint8_t *)((uint64_t)wtns + (nPublic +1)*sW), sW, nVars-nPublic-1);
+    if (fixedPointsC) {
+        E.g1.multiMulByScalar(pi_c, *fixedPointsC, (uint8_t *)((uint64_t)wtns + (nPublic +1)*sW), sW, nVars-nPublic-1);
+    } else {
+        E.g1.multiMulByScalar(pi_c, pointsC, (uint8_t *)((uint64_t)wtns + (nPublic +1)*sW), sW, nVars-nPublic-1);
+    }
     std::ostringstream ss5;
     ss5 << "pi_c: " << E.g1.toString(pi_c);
     LOG_DEBUG(ss5);
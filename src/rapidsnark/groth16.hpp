@@ -2,11 +2,14 @@
 #define GROTH16_HPP
 
 #include <string>
+#include <vector>
+#include <memory>
 #include <nlohmann/json.hpp>
 using json = nlohmann::json;
 
 #include "binfile_utils.hpp"
 #include "fft.hpp"
+#include "multiexp.hpp"
 
 namespace Groth16 {
 
@@ -55,6 +58,21 @@ namespace Groth16 {
         typename Engine::G1PointAffine *pointsH;
 
         FFT<typename Engine::Fr> *fft;
+
+        // Coefficients partitioned by matrix (A, then B) and constraint row: the coefficients of row c of matrix m
+        // are coefsOrder[rowOffsets[m*domainSize + c] .. rowOffsets[m*domainSize + c + 1]), or the coefs themselves,
+        // without indirection, if coefsOrder is empty because the zkey stores them already sorted
+        std::vector<u_int64_t> rowOffsets;
+        std::vector<u_int64_t> coefsOrder;
+
+        // Precomputed multiples of the zkey points, if enabled
+        std::unique_ptr<MultiexpFixedBases<typename Engine::G1>> fixedPointsA;
+        std::unique_ptr<MultiexpFixedBases<typename Engine::G1>> fixedPointsB1;
+        std::unique_ptr<MultiexpFixedBases<typename Engine::G2>> fixedPointsB2;
+        std::unique_ptr<MultiexpFixedBases<typename Engine::G1>> fixedPointsC;
+        std::unique_ptr<MultiexpFixedBases<typename Engine::G1>> fixedPointsH;
+
+        void partitionCoefs();
     public:
         Prover(
             Engine &_E, 
@@ -92,12 +110,17 @@ namespace Groth16 {
             pointsH(_pointsH)
         { 
             fft = new FFT<typename Engine::Fr>(domainSize*2);
+            partitionCoefs();
         };
 
         ~Prover() {
             delete fft;
         }
 
+        // Precomputes multiples of the zkey points to speed up the proof multiexps, using up to maxMemory bytes;
+        // returns the memory used
+        u_int64_t precomputeFixedBases(u_int64_t maxMemory);
+
         std::unique_ptr<Proof<Engine>> prove(typename Engine::FrElement *wtns);
     };
 
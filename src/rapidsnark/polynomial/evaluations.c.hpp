@@ -3,13 +3,15 @@
 
 
 template<typename Engine>
-void Evaluations<Engine>::initialize(u_int64_t length, bool createBuffer) {
+void Evaluations<Engine>::initialize(u_int64_t length, bool createBuffer, bool clearBuffer) {
     this->createBuffer = createBuffer;
     if(createBuffer) {
         eval = new FrElement[length];
     }
     int nThreads = omp_get_max_threads() / 2;
-    ThreadUtils::parset(eval, 0, length * sizeof(FrElement), nThreads);
+    if(clearBuffer) {
+        ThreadUtils::parset(eval, 0, length * sizeof(FrElement), nThreads);
+    }
     //memset(eval, 0, length * sizeof(FrElement));
     this->length = length;
 }
@@ -25,6 +27,17 @@ Evaluations<Engine>::Evaluations(Engine &_E, FrElement *reservedBuffer, u_int64_
     this->initialize(length, false);
 }
 
+template<typename Engine>
+Evaluations<Engine>::Evaluations(Engine &_E, FrElement *reservedBuffer, u_int64_t length, bool clearBuffer) : E(_E) {
+    this->eval = reservedBuffer;
+    this->initialize(length, false, clearBuffer);
+}
+
+template<typename Engine>
+Evaluations<Engine> *Evaluations<Engine>::fromEvaluations(Engine &_E, FrElement *evaluations, u_int64_t length) {
+    return new Evaluations<Engine>(_E, evaluations, length, false);
+}
+
 //template<typename Engine>
 //Evaluations<Engine>::fromEvaluations(Engine &_E, FrElement *evaluations, u_int64_t length) : E(_E) {
 //    initialize(length);
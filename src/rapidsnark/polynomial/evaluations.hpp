@@ -16,7 +16,9 @@ class Evaluations {
 
     Engine &E;
 
-    void initialize(u_int64_t length, bool createBuffer = true);
+    void initialize(u_int64_t length, bool createBuffer = true, bool clearBuffer = true);
+
+    Evaluations(Engine &_E, FrElement *reservedBuffer, u_int64_t length, bool clearBuffer);
 
 public:
     FrElement *eval;
@@ -29,6 +31,9 @@ public:
 
     Evaluations(Engine &_E, FFT<typename Engine::Fr> *fft, FrElement *reservedBuffer, Polynomial<Engine> &polynomial, u_int32_t extensionLength);
 
+    // Uses the evaluations buffer in place, without copying nor clearing it
+    static Evaluations<Engine>* fromEvaluations(Engine &_E, FrElement *evaluations, u_int64_t length);
+
     ~Evaluations();
 
     FrElement getEvaluation(u_int64_t index) const;
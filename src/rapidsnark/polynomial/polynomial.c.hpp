@@ -7,7 +7,7 @@
 using namespace CPlusPlusLogging;
 
 template<typename Engine>
-void Polynomial<Engine>::initialize(u_int64_t length, u_int64_t blindLength, bool createBuffer) {
+void Polynomial<Engine>::initialize(u_int64_t length, u_int64_t blindLength, bool createBuffer, bool clearBuffer) {
     this->createBuffer = createBuffer;
     u_int64_t totalLength = length + blindLength;
     if(createBuffer) {
@@ -15,7 +15,9 @@ void Polynomial<Engine>::initialize(u_int64_t length, u_int64_t blindLength, boo
     }
 
     int nThreads = omp_get_max_threads() / 2;
-    ThreadUtils::parset(coef, 0, totalLength * sizeof(FrElement), nThreads);
+    if(clearBuffer) {
+        ThreadUtils::parset(coef, 0, totalLength * sizeof(FrElement), nThreads);
+    }
     //memset(coef, 0, totalLength * sizeof(FrElement));
     this->length = totalLength;
     degree = 0;
@@ -32,6 +34,21 @@ Polynomial<Engine>::Polynomial(Engine &_E, FrElement *reservedBuffer, u_int64_t
     this->initialize(length, blindLength, false);
 }
 
+template<typename Engine>
+Polynomial<Engine>::Polynomial(Engine &_E, FrElement *reservedBuffer, u_int64_t length, u_int64_t blindLength, bool clearBuffer) : E(_E) {
+    this->coef = reservedBuffer;
+    this->initialize(length, blindLength, false, clearBuffer);
+}
+
+template<typename Engine>
+Polynomial<Engine> *
+Polynomial<Engine>::fromCoefficients(Engine &_E, FrElement *coefficients, u_int64_t length) {
+    Polynomial<Engine> *pol = new Polynomial<Engine>(_E, coefficients, length, 0, false);
+    pol->fixDegree();
+
+    return pol;
+}
+
 template<typename Engine>
 Polynomial<Engine> *
 Polynomial<Engine>::fromPolynomial(Engine &_E, Polynomial<Engine> &polynomial, u_int64_t blindLength) {
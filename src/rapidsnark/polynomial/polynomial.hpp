@@ -18,7 +18,9 @@ class Polynomial {
 
     Engine &E;
 
-    void initialize(u_int64_t length, u_int64_t blindLength = 0, bool createBuffer = true);
+    void initialize(u_int64_t length, u_int64_t blindLength = 0, bool createBuffer = true, bool clearBuffer = true);
+
+    Polynomial(Engine &_E, FrElement *reservedBuffer, u_int64_t length, u_int64_t blindLength, bool clearBuffer);
 
     static Polynomial<Engine>* computeLagrangePolynomial(u_int64_t i, FrElement xArr[], FrElement yArr[], u_int32_t length);
 public:
@@ -33,6 +35,9 @@ public:
 
     static Polynomial<Engine>* fromPolynomial(Engine &_E, Polynomial<Engine> &polynomial, FrElement *reservedBuffer, u_int64_t blindLength = 0);
 
+    // Uses the coefficients buffer in place, without copying nor clearing it
+    static Polynomial<Engine>* fromCoefficients(Engine &_E, FrElement *coefficients, u_int64_t length);
+
     // From evaluations
     static Polynomial<Engine>* fromEvaluations(Engine &_E, FFT<typename Engine::Fr> *fft, FrElement *evaluations, u_int64_t length, u_int64_t blindLength = 0);
 
@@ -0,0 +1,144 @@
+#include "executor_queue.hpp"
+#include "timer.hpp"
+#include "metrics.hpp"
+
+ExecutorQueue::ExecutorQueue (uint64_t maxSize, uint64_t agingTime) :
+    maxSize(maxSize),
+    agingTime(agingTime),
+    sequence(0),
+    bStopped(false),
+    admitted(0),
+    rejected(0),
+    maxDepth(0),
+    totalWaitTime(0),
+    maxWaitTime(0),
+    popped(0),
+    aged(0)
+{
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&cond, NULL);
+}
+
+ExecutorQueue::~ExecutorQueue ()
+{
+    pthread_cond_destroy(&cond);
+    pthread_mutex_destroy(&mutex);
+}
+
+bool ExecutorQueue::push (ExecutorCall * pCall, uint64_t size)
+{
+    Lock();
+
+    // Reject the call if the queue is full
+    if (bStopped || (entries.size() >= maxSize))
+    {
+        rejected++;
+        Unlock();
+        return false;
+    }
+
+    // Add the call
+    Entry &entry = entries[sequence];
+    entry.pCall = pCall;
+    entry.size = size;
+    gettimeofday(&entry.enqueueTime, NULL);
+    bySize.insert(pair<uint64_t, uint64_t>(size, sequence));
+    sequence++;
+
+    admitted++;
+    if (entries.size() > maxDepth)
+    {
+        maxDepth = entries.size();
+    }
+
+    pthread_cond_signal(&cond);
+    Unlock();
+    return true;
+}
+
+ExecutorCall * ExecutorQueue::pop (uint64_t &waitTime)
+{
+    Lock();
+
+    // Wait for a call
+    while (entries.empty() && !bStopped)
+    {
+        pthread_cond_wait(&cond, &mutex);
+    }
+    if (bStopped)
+    {
+        Unlock();
+        return NULL;
+    }
+
+    // Serve the oldest call if it has been waiting for too long, otherwise the shortest one
+    map<uint64_t, Entry>::iterator it = entries.begin();
+    waitTime = TimeDiff(it->second.enqueueTime);
+    if (waitTime >= agingTime)
+    {
+        aged++;
+    }
+    else
+    {
+        it = entries.find(bySize.begin()->second);
+        waitTime = TimeDiff(it->second.enqueueTime);
+    }
+    ExecutorCall * pCall = it->second.pCall;
+    bySize.erase(pair<uint64_t, uint64_t>(it->second.size, it->first));
+    entries.erase(it);
+
+    popped++;
+    totalWaitTime += waitTime;
+    if (waitTime > maxWaitTime)
+    {
+        maxWaitTime = waitTime;
+    }
+
+    Unlock();
+
+    static uint64_t metricWaitTime = metrics.registerHistogram("zkprover_executor_queue_wait_us", "", "Time spent by the executor calls waiting for a worker, in us");
+    metrics.observe(metricWaitTime, waitTime);
+
+    return pCall;
+}
+
+void ExecutorQueue::stop (void)
+{
+    Lock();
+    bStopped = true;
+    pthread_cond_broadcast(&cond);
+    Unlock();
+}
+
+string ExecutorQueue::getMetrics (void)
+{
+    Lock();
+    string metrics =
+        "depth=" + to_string(entries.size()) +
+        " maxDepth=" + to_string(maxDepth) +
+        " admitted=" + to_string(admitted) +
+        " rejected=" + to_string(rejected) +
+        " aged=" + to_string(aged) +
+        " avgWait=" + to_string(popped == 0 ? 0 : double(totalWaitTime)/popped/1000) + "ms" +
+        " maxWait=" + to_string(double(maxWaitTime)/1000) + "ms";
+    Unlock();
+    return metrics;
+}
+
+void ExecutorQueue::collectMetrics (void * pArg)
+{
+    static uint64_t metricDepth = metrics.registerGauge("zkprover_executor_queue_depth", "", "Executor calls waiting for a worker");
+    static uint64_t metricMaxDepth = metrics.registerGauge("zkprover_executor_queue_max_depth", "", "Maximum number of executor calls waiting for a worker");
+    static uint64_t metricAdmitted = metrics.registerGauge("zkprover_executor_queue_admitted", "", "Executor calls admitted into the queue");
+    static uint64_t metricRejected = metrics.registerGauge("zkprover_executor_queue_rejected", "", "Executor calls rejected because the queue was full");
+    static uint64_t metricAged = metrics.registerGauge("zkprover_executor_queue_aged", "", "Executor calls served before shorter ones because of their wait time");
+
+    ExecutorQueue * pQueue = (ExecutorQueue *)pArg;
+    pQueue->Lock();
+    metrics.set(metricDepth, pQueue->entries.size());
+    metrics.set(metricMaxDepth, pQueue->maxDepth);
+    metrics.set(metricAdmitted, pQueue->admitted);
+    metrics.set(metricRejected, pQueue->rejected);
+    metrics.set(metricAged, pQueue->aged);
+    pQueue->Unlock();
+}
@@ -0,0 +1,81 @@
+#ifndef EXECUTOR_QUEUE_HPP
+#define EXECUTOR_QUEUE_HPP
+
+#include <map>
+#include <set>
+#include <string>
+#include <pthread.h>
+#include <sys/time.h>
+
+using namespace std;
+
+// Executor call received by the asynchronous executor server, waiting to be executed by a worker
+class ExecutorCall
+{
+public:
+    virtual ~ExecutorCall() {};
+
+    // Called by the completion queue thread when an operation of this call has completed
+    virtual void proceed (bool ok) = 0;
+
+    // Called by a worker thread to execute the call
+    virtual void execute (void) = 0;
+};
+
+// Bounded priority queue of executor calls, which serves the shortest batches first, unless the oldest call has been
+// waiting for longer than the aging time, so that long batches are not starved
+class ExecutorQueue
+{
+private:
+    class Entry
+    {
+    public:
+        ExecutorCall * pCall;
+        uint64_t size; // Batch size, in bytes
+        struct timeval enqueueTime;
+    };
+
+    uint64_t maxSize; // Maximum number of calls waiting; new calls are rejected when full
+    uint64_t agingTime; // Time after which the oldest call is served first, in us
+    uint64_t sequence; // Arrival order of the next call
+    map<uint64_t, Entry> entries; // Waiting calls, by arrival order
+    set<pair<uint64_t, uint64_t>> bySize; // Waiting calls, by (size, arrival order)
+    bool bStopped;
+
+    pthread_mutex_t mutex; // Mutex to protect the queue
+    pthread_cond_t cond; // Signals workers when a call is pushed, or when the queue is stopped
+
+    // Metrics
+    uint64_t admitted; // Calls pushed
+    uint64_t rejected; // Calls rejected because the queue was full
+    uint64_t maxDepth; // Maximum number of calls waiting
+    uint64_t totalWaitTime; // Sum of the wait time of all popped calls, in us
+    uint64_t maxWaitTime; // Maximum wait time of a popped call, in us
+    uint64_t popped; // Calls popped
+    uint64_t aged; // Calls popped because of their wait time, before shorter ones
+
+public:
+    ExecutorQueue (uint64_t maxSize, uint64_t agingTime);
+    ~ExecutorQueue ();
+
+    // Adds a call; returns false if the queue is full, so that the call must be rejected
+    bool push (ExecutorCall * pCall, uint64_t size);
+
+    // Waits for a call and removes it from the queue; returns NULL if the queue has been stopped
+    ExecutorCall * pop (uint64_t &waitTime);
+
+    // Wakes up all the waiting workers, which will get NULL
+    void stop (void);
+
+    // Returns the queue metrics as a log string
+    string getMetrics (void);
+
+    // Metrics collector of the queue statistics; pArg is the queue
+    static void collectMetrics (void * pArg);
+
+private:
+    void Lock(void) { pthread_mutex_lock(&mutex); };
+    void Unlock(void) { pthread_mutex_unlock(&mutex); };
+};
+
+#endif
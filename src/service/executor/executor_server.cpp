@@ -7,14 +7,99 @@
 #include "executor_server.hpp"
 #include "executor_service.hpp"
 #include "zklog.hpp"
+#include "zkmax.hpp"
+#include "metrics.hpp"
 
 using grpc::Server;
 using grpc::ServerBuilder;
 using grpc::ServerContext;
 using grpc::Status;
+using executor::v1::ExecutorService;
+
+// Unary call of the asynchronous executor service: it requests a call of its method to the completion queue, which is
+// queued when received, executed by a worker, and deleted when its response has been sent
+template <class Request, class Response>
+class ExecutorUnaryCall : public ExecutorCall
+{
+public:
+    typedef void (ExecutorService::AsyncService::*RequestMethod)(ServerContext *, Request *, grpc::ServerAsyncResponseWriter<Response> *, grpc::CompletionQueue *, grpc::ServerCompletionQueue *, void *);
+    typedef Status (ExecutorServiceImpl::*ExecuteMethod)(ServerContext *, const Request *, Response *);
+    typedef uint64_t (*SizeFunction)(const Request &request);
+
+private:
+    ExecutorServer &server;
+    grpc::ServerCompletionQueue * pCompletionQueue;
+    RequestMethod requestMethod;
+    ExecuteMethod executeMethod;
+    SizeFunction sizeFunction; // Returns the batch size, used as priority; if NULL, the call is executed without queueing
+    ServerContext context;
+    Request request;
+    Response response;
+    grpc::ServerAsyncResponseWriter<Response> responder;
+    bool bFinished;
+
+public:
+    ExecutorUnaryCall (ExecutorServer &server, grpc::ServerCompletionQueue * pCompletionQueue, RequestMethod requestMethod, ExecuteMethod executeMethod, SizeFunction sizeFunction) :
+        server(server),
+        pCompletionQueue(pCompletionQueue),
+        requestMethod(requestMethod),
+        executeMethod(executeMethod),
+        sizeFunction(sizeFunction),
+        responder(&context),
+        bFinished(false)
+    {
+        (server.getAsyncService().*requestMethod)(&context, &request, &responder, pCompletionQueue, pCompletionQueue, this);
+    }
+
+    void proceed (bool ok) override
+    {
+        // The response has been sent, or the server is shutting down
+        if (bFinished || !ok)
+        {
+            delete this;
+            return;
+        }
+
+        // A call has been received; request the next call of this method
+        new ExecutorUnaryCall<Request, Response>(server, pCompletionQueue, requestMethod, executeMethod, sizeFunction);
+
+        // Execute it in this thread, if it is cheap
+        if (sizeFunction == NULL)
+        {
+            execute();
+            return;
+        }
+
+        // Queue it for the workers, or reject it if the queue is full
+        if (!server.getQueue().push(this, sizeFunction(request)))
+        {
+            zklog.error("ExecutorUnaryCall::proceed() rejected call since the executor queue is full " + server.getQueue().getMetrics());
+            bFinished = true;
+            responder.FinishWithError(Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "executor queue is full"), this);
+        }
+    }
+
+    void execute (void) override
+    {
+        Status status = (server.getService().*executeMethod)(&context, &request, &response);
+        bFinished = true;
+        responder.Finish(response, status, this);
+    }
+};
+
+// Batch sizes, used as priority of the queued calls
+static uint64_t processBatchSize (const executor::v1::ProcessBatchRequest &request) { return request.batch_l2_data().size(); }
+static uint64_t processBatchV2Size (const executor::v1::ProcessBatchRequestV2 &request) { return request.batch_l2_data().size(); }
+static uint64_t processStatelessBatchV2Size (const executor::v1::ProcessStatelessBatchRequestV2 &request) { return request.data_stream().size(); }
 
 void ExecutorServer::run (void)
 {
+    if (config.executorServerAsync)
+    {
+        runAsync();
+        return;
+    }
+
     ServerBuilder builder;
     
     // Limit the maximum number of threads to avoid memory starvation
@@ -46,6 +131,128 @@ void ExecutorServer::run (void)
     server->Wait();
 }
 
+class ExecutorServerIOThreadArgs
+{
+public:
+    ExecutorServer * pServer;
+    grpc::ServerCompletionQueue * pCompletionQueue;
+};
+
+void* executorServerIOThread (void* arg)
+{
+    ExecutorServerIOThreadArgs *pArgs = (ExecutorServerIOThreadArgs *)arg;
+    pArgs->pServer->ioThread(pArgs->pCompletionQueue);
+    return NULL;
+}
+
+void* executorServerWorkerThread (void* arg)
+{
+    ExecutorServer *pExecutorServer = (ExecutorServer *)arg;
+    pExecutorServer->workerThread();
+    return NULL;
+}
+
+void ExecutorServer::runAsync (void)
+{
+    ServerBuilder builder;
+
+    pService = new ExecutorServiceImpl(fr, config, prover);
+    pAsyncService = new ExecutorService::AsyncService();
+    pQueue = new ExecutorQueue(config.executorServerQueueSize, config.executorServerQueueAgingTime*1000);
+    metrics.addCollector(ExecutorQueue::collectMetrics, pQueue);
+
+    std::string server_address("0.0.0.0:" + to_string(config.executorServerPort));
+
+    grpc::EnableDefaultHealthCheckService(true);
+    grpc::reflection::InitProtoReflectionServerBuilderPlugin();
+
+    // Listen on the given address without any authentication mechanism.
+    builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
+
+    // Register the asynchronous service, and a completion queue per I/O thread
+    builder.RegisterService(pAsyncService);
+    uint64_t nIOThreads = zkmax(config.executorServerIOThreads, 1);
+    for (uint64_t i = 0; i < nIOThreads; i++)
+    {
+        completionQueues.emplace_back(builder.AddCompletionQueue());
+    }
+
+    // Finally assemble the server.
+    std::unique_ptr<Server> server(builder.BuildAndStart());
+
+    // Request the first call of every method in every completion queue
+    for (uint64_t i = 0; i < nIOThreads; i++)
+    {
+        grpc::ServerCompletionQueue * pCompletionQueue = completionQueues[i].get();
+        new ExecutorUnaryCall<executor::v1::ProcessBatchRequest, executor::v1::ProcessBatchResponse>(*this, pCompletionQueue, &ExecutorService::AsyncService::RequestProcessBatch, &ExecutorServiceImpl::ProcessBatch, processBatchSize);
+        new ExecutorUnaryCall<executor::v1::ProcessBatchRequestV2, executor::v1::ProcessBatchResponseV2>(*this, pCompletionQueue, &ExecutorService::AsyncService::RequestProcessBatchV2, &ExecutorServiceImpl::ProcessBatchV2, processBatchV2Size);
+        new ExecutorUnaryCall<executor::v1::ProcessStatelessBatchRequestV2, executor::v1::ProcessBatchResponseV2>(*this, pCompletionQueue, &ExecutorService::AsyncService::RequestProcessStatelessBatchV2, &ExecutorServiceImpl::ProcessStatelessBatchV2, processStatelessBatchV2Size);
+        new ExecutorUnaryCall<google::protobuf::Empty, executor::v1::GetFlushStatusResponse>(*this, pCompletionQueue, &ExecutorService::AsyncService::RequestGetFlushStatus, &ExecutorServiceImpl::GetFlushStatus, NULL);
+    }
+
+    // Start the workers
+    workerThreads.resize(zkmax(config.maxExecutorThreads, 1));
+    for (uint64_t i = 0; i < workerThreads.size(); i++)
+    {
+        pthread_create(&workerThreads[i], NULL, executorServerWorkerThread, this);
+    }
+
+    // Start the I/O threads
+    vector<ExecutorServerIOThreadArgs> ioThreadArgs(nIOThreads);
+    ioThreads.resize(nIOThreads);
+    for (uint64_t i = 0; i < nIOThreads; i++)
+    {
+        ioThreadArgs[i].pServer = this;
+        ioThreadArgs[i].pCompletionQueue = completionQueues[i].get();
+        pthread_create(&ioThreads[i], NULL, executorServerIOThread, &ioThreadArgs[i]);
+    }
+
+    zklog.info("Executor server listening on " + server_address + " asynchronously with ioThreads=" + to_string(nIOThreads) + " workers=" + to_string(workerThreads.size()) + " queueSize=" + to_string(config.executorServerQueueSize));
+
+    // Wait for the I/O threads, which run until the completion queues are shut down, and then for the workers
+    for (uint64_t i = 0; i < ioThreads.size(); i++)
+    {
+        pthread_join(ioThreads[i], NULL);
+    }
+    pQueue->stop();
+    for (uint64_t i = 0; i < workerThreads.size(); i++)
+    {
+        pthread_join(workerThreads[i], NULL);
+    }
+
+    metrics.removeCollector(ExecutorQueue::collectMetrics, pQueue);
+    delete pQueue;
+    delete pAsyncService;
+    delete pService;
+}
+
+void ExecutorServer::ioThread (grpc::ServerCompletionQueue * pCompletionQueue)
+{
+    void * tag;
+    bool ok;
+    while (pCompletionQueue->Next(&tag, &ok))
+    {
+        ((ExecutorCall *)tag)->proceed(ok);
+    }
+}
+
+void ExecutorServer::workerThread (void)
+{
+    while (true)
+    {
+        uint64_t waitTime;
+        ExecutorCall * pCall = pQueue->pop(waitTime);
+        if (pCall == NULL)
+        {
+            break;
+        }
+        pCall->execute();
+#ifdef LOG_SERVICE
+        zklog.info("ExecutorServer::workerThread() executed call after waitTime=" + to_string(double(waitTime)/1000) + "ms queue " + pQueue->getMetrics());
+#endif
+    }
+}
+
 void ExecutorServer::runThread (void)
 {
     pthread_create(&t, NULL, executorServerThread, this);
@@ -1,9 +1,13 @@
 #ifndef EXECUTOR_SERVER_HPP
 #define EXECUTOR_SERVER_HPP
 
+#include <vector>
+#include <grpcpp/grpcpp.h>
 #include "goldilocks_base_field.hpp"
 #include "prover.hpp"
 #include "config.hpp"
+#include "executor_service.hpp"
+#include "executor_queue.hpp"
 
 class ExecutorServer
 {
@@ -11,13 +15,39 @@ class ExecutorServer
     Prover &prover;
     Config &config;
     pthread_t t;
+
+    // Asynchronous server attributes
+    executor::v1::ExecutorService::AsyncService * pAsyncService; // Receives the calls through the completion queues
+    ExecutorServiceImpl * pService; // Executes the calls
+    ExecutorQueue * pQueue; // Calls waiting for a worker
+    vector<std::unique_ptr<grpc::ServerCompletionQueue>> completionQueues; // One per I/O thread
+    vector<pthread_t> ioThreads;
+    vector<pthread_t> workerThreads;
+
+    void runAsync (void);
+
 public:
-    ExecutorServer(Goldilocks &fr, Prover &prover, Config &config) : fr(fr), prover(prover), config(config) {};
+    ExecutorServer(Goldilocks &fr, Prover &prover, Config &config) :
+        fr(fr),
+        prover(prover),
+        config(config),
+        pAsyncService(NULL),
+        pService(NULL),
+        pQueue(NULL) {};
     void run (void);
     void runThread (void);
     void waitForThread (void);
+
+    // Asynchronous server threads
+    void ioThread (grpc::ServerCompletionQueue * pCompletionQueue);
+    void workerThread (void);
+
+    // Asynchronous calls
+    executor::v1::ExecutorService::AsyncService & getAsyncService (void) { return *pAsyncService; };
+    ExecutorServiceImpl & getService (void) { return *pService; };
+    ExecutorQueue & getQueue (void) { return *pQueue; };
 };
 
 void* executorServerThread(void* arg);
 
-#endif
\ No newline at end of file
+#endif
@@ -8,6 +8,7 @@
 #include "utils.hpp"
 #include "witness.hpp"
 #include "data_stream.hpp"
+#include "full_trace_expander.hpp"
 
 using grpc::Server;
 using grpc::ServerBuilder;
@@ -570,18 +571,20 @@ using grpc::Status;
             pTransactionContext->set_gas_used(responses[tx].full_trace.context.gas_used); // Total gas used as result of execution
             pTransactionContext->set_execution_time(responses[tx].full_trace.context.execution_time);
             pTransactionContext->set_old_state_root(string2ba(responses[tx].full_trace.context.old_state_root)); // Starting state root
+            FullTraceExpander expander; // Rebuilds the stack and storage of delta trace steps
             for (uint64_t step=0; step<responses[tx].full_trace.steps.size(); step++)
             {
+                expander.next(responses[tx].full_trace.steps[step]);
                 executor::v1::TransactionStep * pTransactionStep = pFullTrace->add_steps();
-                pTransactionStep->set_state_root(string2ba(responses[tx].full_trace.steps[step].state_root));
+                pTransactionStep->set_state_root(responses[tx].full_trace.steps[step].state_root.toBa());
                 pTransactionStep->set_depth(responses[tx].full_trace.steps[step].depth); // Call depth
                 pTransactionStep->set_pc(responses[tx].full_trace.steps[step].pc); // Program counter
                 pTransactionStep->set_gas(responses[tx].full_trace.steps[step].gas); // Remaining gas
                 pTransactionStep->set_gas_cost(responses[tx].full_trace.steps[step].gas_cost); // Gas cost of the operation
                 pTransactionStep->set_gas_refund(responses[tx].full_trace.steps[step].gas_refund); // Gas refunded during the operation
                 pTransactionStep->set_op(responses[tx].full_trace.steps[step].op); // Opcode
-                for (uint64_t stack=0; stack<responses[tx].full_trace.steps[step].stack.size() ; stack++)
-                    pTransactionStep->add_stack(responses[tx].full_trace.steps[step].stack[stack].get_str(16)); // Content of the stack
+                for (uint64_t stack=0; stack<expander.getStack().size() ; stack++)
+                    pTransactionStep->add_stack(expander.getStack()[stack].toHex(false)); // Content of the stack
                 pTransactionStep->set_memory_size(responses[tx].full_trace.steps[step].memory_size);
                 pTransactionStep->set_memory_offset(responses[tx].full_trace.steps[step].memory_offset);
                 pTransactionStep->set_memory(responses[tx].full_trace.steps[step].memory);
@@ -590,8 +593,8 @@ using grpc::Status;
                     dataConcatenated += responses[tx].full_trace.steps[step].return_data[data];
                 pTransactionStep->set_return_data(string2ba(dataConcatenated));
                 executor::v1::Contract * pContract = pTransactionStep->mutable_contract(); // Contract information
-                pContract->set_address(responses[tx].full_trace.steps[step].contract.address);
-                pContract->set_caller(responses[tx].full_trace.steps[step].contract.caller);
+                pContract->set_address(responses[tx].full_trace.steps[step].contract.address.toHex());
+                pContract->set_caller(responses[tx].full_trace.steps[step].contract.caller.toHex());
                 pContract->set_value(Add0xIfMissing(responses[tx].full_trace.steps[step].contract.value.get_str(16)));
                 pContract->set_data(string2ba(responses[tx].full_trace.steps[step].contract.data));
                 pContract->set_gas(responses[tx].full_trace.steps[step].contract.gas);
@@ -599,8 +602,8 @@ using grpc::Status;
                 pTransactionStep->set_error(string2error(responses[tx].full_trace.steps[step].error));
 
                 google::protobuf::Map<std::string, std::string> * pStorage = pTransactionStep->mutable_storage();
-                unordered_map<string,string>::iterator it;
-                for (it=responses[tx].full_trace.steps[step].storage.begin(); it!=responses[tx].full_trace.steps[step].storage.end(); it++)
+                unordered_map<string,string>::const_iterator it;
+                for (it=expander.getStorage().begin(); it!=expander.getStorage().end(); it++)
                     (*pStorage)[it->first] = it->second; // Content of the storage
             }
             pProcessTransactionResponse->set_allocated_full_trace(pFullTrace);
@@ -1491,18 +1494,20 @@ using grpc::Status;
                 pTransactionContext->set_old_state_root(string2ba(responses[tx].full_trace.context.old_state_root)); // Starting state root
                 pTransactionContext->set_chain_id(responses[tx].full_trace.context.chainId);
                 pTransactionContext->set_tx_index(responses[tx].full_trace.context.txIndex);
+                FullTraceExpander expander; // Rebuilds the stack and storage of delta trace steps
                 for (uint64_t step=0; step<responses[tx].full_trace.steps.size(); step++)
                 {
+                    expander.next(responses[tx].full_trace.steps[step]);
                     executor::v1::TransactionStepV2 * pTransactionStep = pFullTrace->add_steps();
-                    pTransactionStep->set_state_root(string2ba(responses[tx].full_trace.steps[step].state_root));
+                    pTransactionStep->set_state_root(responses[tx].full_trace.steps[step].state_root.toBa());
                     pTransactionStep->set_depth(responses[tx].full_trace.steps[step].depth); // Call depth
                     pTransactionStep->set_pc(responses[tx].full_trace.steps[step].pc); // Program counter
                     pTransactionStep->set_gas(responses[tx].full_trace.steps[step].gas); // Remaining gas
                     pTransactionStep->set_gas_cost(responses[tx].full_trace.steps[step].gas_cost); // Gas cost of the operation
                     pTransactionStep->set_gas_refund(responses[tx].full_trace.steps[step].gas_refund); // Gas refunded during the operation
                     pTransactionStep->set_op(responses[tx].full_trace.steps[step].op); // Opcode
-                    for (uint64_t stack=0; stack<responses[tx].full_trace.steps[step].stack.size() ; stack++)
-                        pTransactionStep->add_stack(responses[tx].full_trace.steps[step].stack[stack].get_str(16)); // Content of the stack
+                    for (uint64_t stack=0; stack<expander.getStack().size() ; stack++)
+                        pTransactionStep->add_stack(expander.getStack()[stack].toHex(false)); // Content of the stack
                     pTransactionStep->set_memory_size(responses[tx].full_trace.steps[step].memory_size);
                     pTransactionStep->set_memory_offset(responses[tx].full_trace.steps[step].memory_offset);
                     pTransactionStep->set_memory(responses[tx].full_trace.steps[step].memory);
@@ -1511,8 +1516,8 @@ using grpc::Status;
                         dataConcatenated += responses[tx].full_trace.steps[step].return_data[data];
                     pTransactionStep->set_return_data(string2ba(dataConcatenated));
                     executor::v1::ContractV2 * pContract = pTransactionStep->mutable_contract(); // Contract information
-                    pContract->set_address(responses[tx].full_trace.steps[step].contract.address);
-                    pContract->set_caller(responses[tx].full_trace.steps[step].contract.caller);
+                    pContract->set_address(responses[tx].full_trace.steps[step].contract.address.toHex());
+                    pContract->set_caller(responses[tx].full_trace.steps[step].contract.caller.toHex());
                     pContract->set_value(Add0xIfMissing(responses[tx].full_trace.steps[step].contract.value.get_str(16)));
                     pContract->set_data(string2ba(responses[tx].full_trace.steps[step].contract.data));
                     pContract->set_gas(responses[tx].full_trace.steps[step].contract.gas);
@@ -1520,8 +1525,8 @@ using grpc::Status;
                     pTransactionStep->set_error(string2error(responses[tx].full_trace.steps[step].error));
 
                     google::protobuf::Map<std::string, std::string> * pStorage = pTransactionStep->mutable_storage();
-                    unordered_map<string,string>::iterator it;
-                    for (it=responses[tx].full_trace.steps[step].storage.begin(); it!=responses[tx].full_trace.steps[step].storage.end(); it++)
+                    unordered_map<string,string>::const_iterator it;
+                    for (it=expander.getStorage().begin(); it!=expander.getStorage().end(); it++)
                         (*pStorage)[it->first] = it->second; // Content of the storage
                 }
                 pProcessTransactionResponse->set_allocated_full_trace(pFullTrace);
@@ -2184,18 +2189,20 @@ using grpc::Status;
                 pTransactionContext->set_old_state_root(string2ba(responses[tx].full_trace.context.old_state_root)); // Starting state root
                 pTransactionContext->set_chain_id(responses[tx].full_trace.context.chainId);
                 pTransactionContext->set_tx_index(responses[tx].full_trace.context.txIndex);
+                FullTraceExpander expander; // Rebuilds the stack and storage of delta trace steps
                 for (uint64_t step=0; step<responses[tx].full_trace.steps.size(); step++)
                 {
+                    expander.next(responses[tx].full_trace.steps[step]);
                     executor::v1::TransactionStepV2 * pTransactionStep = pFullTrace->add_steps();
-                    pTransactionStep->set_state_root(string2ba(responses[tx].full_trace.steps[step].state_root));
+                    pTransactionStep->set_state_root(responses[tx].full_trace.steps[step].state_root.toBa());
                     pTransactionStep->set_depth(responses[tx].full_trace.steps[step].depth); // Call depth
                     pTransactionStep->set_pc(responses[tx].full_trace.steps[step].pc); // Program counter
                     pTransactionStep->set_gas(responses[tx].full_trace.steps[step].gas); // Remaining gas
                     pTransactionStep->set_gas_cost(responses[tx].full_trace.steps[step].gas_cost); // Gas cost of the operation
                     pTransactionStep->set_gas_refund(responses[tx].full_trace.steps[step].gas_refund); // Gas refunded during the operation
                     pTransactionStep->set_op(responses[tx].full_trace.steps[step].op); // Opcode
-                    for (uint64_t stack=0; stack<responses[tx].full_trace.steps[step].stack.size() ; stack++)
-                        pTransactionStep->add_stack(responses[tx].full_trace.steps[step].stack[stack].get_str(16)); // Content of the stack
+                    for (uint64_t stack=0; stack<expander.getStack().size() ; stack++)
+                        pTransactionStep->add_stack(expander.getStack()[stack].toHex(false)); // Content of the stack
                     pTransactionStep->set_memory_size(responses[tx].full_trace.steps[step].memory_size);
                     pTransactionStep->set_memory_offset(responses[tx].full_trace.steps[step].memory_offset);
                     pTransactionStep->set_memory(responses[tx].full_trace.steps[step].memory);
@@ -2204,8 +2211,8 @@ using grpc::Status;
                         dataConcatenated += responses[tx].full_trace.steps[step].return_data[data];
                     pTransactionStep->set_return_data(string2ba(dataConcatenated));
                     executor::v1::ContractV2 * pContract = pTransactionStep->mutable_contract(); // Contract information
-                    pContract->set_address(responses[tx].full_trace.steps[step].contract.address);
-                    pContract->set_caller(responses[tx].full_trace.steps[step].contract.caller);
+                    pContract->set_address(responses[tx].full_trace.steps[step].contract.address.toHex());
+                    pContract->set_caller(responses[tx].full_trace.steps[step].contract.caller.toHex());
                     pContract->set_value(Add0xIfMissing(responses[tx].full_trace.steps[step].contract.value.get_str(16)));
                     pContract->set_data(string2ba(responses[tx].full_trace.steps[step].contract.data));
                     pContract->set_gas(responses[tx].full_trace.steps[step].contract.gas);
@@ -2213,8 +2220,8 @@ using grpc::Status;
                     pTransactionStep->set_error(string2error(responses[tx].full_trace.steps[step].error));
 
                     google::protobuf::Map<std::string, std::string> * pStorage = pTransactionStep->mutable_storage();
-                    unordered_map<string,string>::iterator it;
-                    for (it=responses[tx].full_trace.steps[step].storage.begin(); it!=responses[tx].full_trace.steps[step].storage.end(); it++)
+                    unordered_map<string,string>::const_iterator it;
+                    for (it=expander.getStorage().begin(); it!=expander.getStorage().end(); it++)
                         (*pStorage)[it->first] = it->second; // Content of the storage
                 }
                 pProcessTransactionResponse->set_allocated_full_trace(pFullTrace);
@@ -0,0 +1,123 @@
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <string.h>
+#include "metrics_server.hpp"
+#include "metrics.hpp"
+#include "zklog.hpp"
+#include "exit_process.hpp"
+
+#define METRICS_SERVER_MAX_REQUEST_SIZE 8192
+
+// Writes the whole buffer into the socket; returns false if the connection failed
+bool metricsServerSend (int socket, const string &data)
+{
+    uint64_t sent = 0;
+    while (sent < data.size())
+    {
+        ssize_t result = send(socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (result <= 0)
+        {
+            return false;
+        }
+        sent += result;
+    }
+    return true;
+}
+
+void MetricsServer::run (void)
+{
+    // Listen on all interfaces
+    int serverSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (serverSocket < 0)
+    {
+        zklog.error("MetricsServer::run() failed calling socket() errno=" + to_string(errno) + "=" + strerror(errno));
+        exitProcess();
+    }
+    int reuse = 1;
+    setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(config.metricsServerPort);
+    if (bind(serverSocket, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        zklog.error("MetricsServer::run() failed calling bind() port=" + to_string(config.metricsServerPort) + " errno=" + to_string(errno) + "=" + strerror(errno));
+        exitProcess();
+    }
+    if (listen(serverSocket, 16) != 0)
+    {
+        zklog.error("MetricsServer::run() failed calling listen() errno=" + to_string(errno) + "=" + strerror(errno));
+        exitProcess();
+    }
+
+    zklog.info("Metrics server listening on 0.0.0.0:" + to_string(config.metricsServerPort));
+
+    // Serve the scrapes one by one, since they are infrequent
+    string output;
+    char buffer[METRICS_SERVER_MAX_REQUEST_SIZE];
+    while (true)
+    {
+        int clientSocket = accept(serverSocket, NULL, NULL);
+        if (clientSocket < 0)
+        {
+            zklog.warning("MetricsServer::run() failed calling accept() errno=" + to_string(errno) + "=" + strerror(errno));
+            continue;
+        }
+
+        // Read the request headers
+        struct timeval timeout;
+        timeout.tv_sec = 5;
+        timeout.tv_usec = 0;
+        setsockopt(clientSocket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        string request;
+        while (request.find("\r\n\r\n") == string::npos)
+        {
+            ssize_t received = recv(clientSocket, buffer, sizeof(buffer), 0);
+            if (received <= 0)
+            {
+                break;
+            }
+            request.append(buffer, received);
+            if (request.size() > METRICS_SERVER_MAX_REQUEST_SIZE)
+            {
+                break;
+            }
+        }
+
+        // Reply with the metrics, or with an error
+        string response;
+        if ((request.compare(0, 13, "GET /metrics ") == 0) || (request.compare(0, 13, "GET /metrics?") == 0))
+        {
+            metrics.scrape(output);
+            response = "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " + to_string(output.size()) + "\r\nConnection: close\r\n\r\n" + output;
+        }
+        else
+        {
+            response = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        }
+        if (!metricsServerSend(clientSocket, response))
+        {
+            zklog.warning("MetricsServer::run() failed sending the response errno=" + to_string(errno) + "=" + strerror(errno));
+        }
+        close(clientSocket);
+    }
+}
+
+void MetricsServer::runThread (void)
+{
+    pthread_create(&t, NULL, metricsServerThread, this);
+}
+
+void MetricsServer::waitForThread (void)
+{
+    pthread_join(t, NULL);
+}
+
+void* metricsServerThread (void* arg)
+{
+    MetricsServer *pServer = (MetricsServer *)arg;
+    pServer->run();
+    return NULL;
+}
@@ -0,0 +1,23 @@
+#ifndef METRICS_SERVER_HPP
+#define METRICS_SERVER_HPP
+
+#include <pthread.h>
+#include "config.hpp"
+
+// Minimal HTTP server that exposes the metrics registry in Prometheus text format at GET /metrics
+class MetricsServer
+{
+private:
+    Config &config;
+    pthread_t t;
+
+public:
+    MetricsServer (Config &config) : config(config) {};
+    void run (void);
+    void runThread (void);
+    void waitForThread (void);
+};
+
+void* metricsServerThread(void* arg);
+
+#endif
@@ -3,6 +3,7 @@
 #include "exit_process.hpp"
 #include "zkassert.hpp"
 #include "zklog.hpp"
+#include <immintrin.h>
 
 void KeccakFExecutor::loadScript(json j)
 {
@@ -128,7 +129,6 @@ void KeccakFExecutor::loadScript(json j)
 void KeccakFExecutor::execute(const vector<vector<Goldilocks::Element>> &input, KeccakFCommitPols &pols)
 {
     zkassertpermanent(bLoaded);
-    const uint64_t keccakMask = 0xFFFFFFFFFFF;
 
     // Check input size
     if (input.size() != numberOfSlots)
@@ -155,78 +155,115 @@ void KeccakFExecutor::execute(const vector<vector<Goldilocks::Element>> &input,
         pols.c[i][KeccakGateConfig.zeroRef] = fr.fromU64(fr.toU64(pols.a[i][KeccakGateConfig.zeroRef]) ^ fr.toU64(pols.b[i][KeccakGateConfig.zeroRef]));
     }
 
-    // Set Sin values
-    for (uint64_t slot = 0; slot < numberOfSlots; slot++)
+    // Execute the program, evaluating KECCAK_F_EXECUTOR_LANES slots per instruction stream
+    uint64_t numberOfGroups = (numberOfSlots + KECCAK_F_EXECUTOR_LANES - 1) / KECCAK_F_EXECUTOR_LANES;
+#pragma omp parallel for schedule(dynamic, 1)
+    for (uint64_t group = 0; group < numberOfGroups; group++)
+    {
+        executeSlots(input, pols, group * KECCAK_F_EXECUTOR_LANES);
+    }
+
+    zklog.info("KeccakFExecutor successfully processed " + to_string(numberOfSlots) + " Keccak-F actions (" + to_string((double(input.size()) * KeccakGateConfig.slotSize * 100) / N) + "%)");
+}
+
+void KeccakFExecutor::executeSlots(const vector<vector<Goldilocks::Element>> &input, KeccakFCommitPols &pols, uint64_t firstSlot)
+{
+    const uint64_t keccakMask = 0xFFFFFFFFFFF;
+    const uint64_t L = KECCAK_F_EXECUTOR_LANES;
+    const uint64_t slotSize = KeccakGateConfig.slotSize;
+    const uint64_t nSlots = zkmin(L, numberOfSlots - firstSlot);
+
+    // Gate values of the slots being processed, stored as [ref][lane], so that the values of the
+    // same reference in all the lanes are contiguous and can be loaded into one SIMD register
+    vector<uint64_t> aBuffer(slotSize * L, 0);
+    vector<uint64_t> bBuffer(slotSize * L, 0);
+    vector<uint64_t> cBuffer(slotSize * L, 0);
+    uint64_t *pins[3];
+    pins[pin_a] = aBuffer.data();
+    pins[pin_b] = bBuffer.data();
+    pins[pin_r] = cBuffer.data();
+
+    // Set KeccakGateConfig.zeroRef values, as they are set in the pols
+    for (uint64_t lane = 0; lane < L; lane++)
+    {
+        pins[pin_a][KeccakGateConfig.zeroRef * L + lane] = 0;
+        pins[pin_b][KeccakGateConfig.zeroRef * L + lane] = keccakMask;
+        pins[pin_r][KeccakGateConfig.zeroRef * L + lane] = keccakMask;
+    }
+
+    // Set Sin values; unused lanes are left to zero
+    for (uint64_t lane = 0; lane < nSlots; lane++)
     {
         for (uint64_t i = 0; i < 1600; i++)
         {
-            setPol(pols.a, KeccakGateConfig.relRef2AbsRef(KeccakGateConfig.sinRef0 + i * 44, slot), fr.toU64(input[slot][i]));
+            pins[pin_a][(KeccakGateConfig.sinRef0 + i * 44) * L + lane] = fr.toU64(input[firstSlot + lane][i]);
         }
     }
 
-    // Execute the program
-#pragma omp parallel for
-    for (uint64_t slot = 0; slot < numberOfSlots; slot++)
+    // Execute the program for all lanes at once
+#if defined(__AVX512__)
+    const __m512i mask = _mm512_set1_epi64(keccakMask);
+#else
+    const __m256i mask = _mm256_set1_epi64x(keccakMask);
+#endif
+    for (uint64_t i = 0; i < program.size(); i++)
     {
-        for (uint64_t i = 0; i < program.size(); i++)
-        {
-            uint64_t absRefa = KeccakGateConfig.relRef2AbsRef(program[i].refa, slot);
-            uint64_t absRefb = KeccakGateConfig.relRef2AbsRef(program[i].refb, slot);
-            uint64_t absRefr = KeccakGateConfig.relRef2AbsRef(program[i].refr, slot);
-
-            switch (program[i].pina)
-            {
-            case pin_a:
-                setPol(pols.a, absRefr, getPol(pols.a, absRefa));
-                break;
-            case pin_b:
-                setPol(pols.a, absRefr, getPol(pols.b, absRefa));
-                break;
-            case pin_r:
-                setPol(pols.a, absRefr, getPol(pols.c, absRefa));
-                break;
-            default:
-                zklog.error("KeccakFExecutor() found invalid program[i].pina=" + to_string(program[i].pina));
-                exitProcess();
-            }
-            switch (program[i].pinb)
-            {
-            case pin_a:
-                setPol(pols.b, absRefr, getPol(pols.a, absRefb));
-                break;
-            case pin_b:
-                setPol(pols.b, absRefr, getPol(pols.b, absRefb));
-                break;
-            case pin_r:
-                setPol(pols.b, absRefr, getPol(pols.c, absRefb));
-                break;
-            default:
-                zklog.error("KeccakFExecutor() found invalid program[i].pinb=" + to_string(program[i].pinb));
-                exitProcess();
-            }
-
-            switch (program[i].op)
-            {
-            case gop_xor:
-            {
-                setPol(pols.c, absRefr, (getPol(pols.a, absRefr) ^ getPol(pols.b, absRefr)) & keccakMask);
-                break;
-            }
-            case gop_andp:
-            {
-                setPol(pols.c, absRefr, ((~getPol(pols.a, absRefr)) & getPol(pols.b, absRefr)) & keccakMask);
-                break;
-            }
-            default:
-            {
-                zklog.error("KeccakFExecutor::execute() found invalid op: " + to_string(program[i].op) + " in evaluation: " + to_string(i));
-                exitProcess();
-            }
-            }
+        const KeccakInstruction &instruction = program[i];
+        const uint64_t *pa = pins[instruction.pina] + instruction.refa * L;
+        const uint64_t *pb = pins[instruction.pinb] + instruction.refb * L;
+        uint64_t *ra = pins[pin_a] + instruction.refr * L;
+        uint64_t *rb = pins[pin_b] + instruction.refr * L;
+        uint64_t *rc = pins[pin_r] + instruction.refr * L;
+
+#if defined(__AVX512__)
+        __m512i a = _mm512_loadu_si512((const void *)pa);
+        __m512i b = _mm512_loadu_si512((const void *)pb);
+        _mm512_storeu_si512((void *)ra, a);
+        _mm512_storeu_si512((void *)rb, b);
+        switch (instruction.op)
+        {
+        case gop_xor:
+            _mm512_storeu_si512((void *)rc, _mm512_and_si512(_mm512_xor_si512(a, b), mask));
+            break;
+        case gop_andp:
+            _mm512_storeu_si512((void *)rc, _mm512_and_si512(_mm512_andnot_si512(a, b), mask));
+            break;
+#else
+        __m256i a = _mm256_loadu_si256((const __m256i *)pa);
+        __m256i b = _mm256_loadu_si256((const __m256i *)pb);
+        _mm256_storeu_si256((__m256i *)ra, a);
+        _mm256_storeu_si256((__m256i *)rb, b);
+        switch (instruction.op)
+        {
+        case gop_xor:
+            _mm256_storeu_si256((__m256i *)rc, _mm256_and_si256(_mm256_xor_si256(a, b), mask));
+            break;
+        case gop_andp:
+            _mm256_storeu_si256((__m256i *)rc, _mm256_and_si256(_mm256_andnot_si256(a, b), mask));
+            break;
+#endif
+        default:
+        {
+            zklog.error("KeccakFExecutor::executeSlots() found invalid op: " + to_string(instruction.op) + " in evaluation: " + to_string(i));
+            exitProcess();
+        }
         }
     }
 
-    zklog.info("KeccakFExecutor successfully processed " + to_string(numberOfSlots) + " Keccak-F actions (" + to_string((double(input.size()) * KeccakGateConfig.slotSize * 100) / N) + "%)");
+    // Copy the gate values of the used lanes into the pols; reference zeroRef is shared by all
+    // slots and it is set only once, by the caller
+    for (uint64_t lane = 0; lane < nSlots; lane++)
+    {
+        uint64_t slot = firstSlot + lane;
+        for (uint64_t ref = 0; ref < slotSize; ref++)
+        {
+            if (ref == KeccakGateConfig.zeroRef) continue;
+            uint64_t absRef = KeccakGateConfig.relRef2AbsRef(ref, slot);
+            setPol(pols.a, absRef, pins[pin_a][ref * L + lane]);
+            setPol(pols.b, absRef, pins[pin_b][ref * L + lane]);
+            setPol(pols.c, absRef, pins[pin_r][ref * L + lane]);
+        }
+    }
 }
 
 void KeccakFExecutor::setPol(CommitPol (&pol)[4], uint64_t index, uint64_t value)
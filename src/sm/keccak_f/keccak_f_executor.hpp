@@ -13,6 +13,13 @@
 
 USING_PROVER_FORK_NAMESPACE;
 
+// Number of slots whose gate programs are evaluated together, one slot per SIMD lane
+#ifdef __AVX512__
+    #define KECCAK_F_EXECUTOR_LANES 8
+#else
+    #define KECCAK_F_EXECUTOR_LANES 4
+#endif
+
 using namespace std;
 
 /*class KeccakFExecuteInput
@@ -69,6 +76,9 @@ public:
     /* Input is a vector of numberOfSlots*1600 fe, output is KeccakPols */
     void execute (const vector<vector<Goldilocks::Element>> &input, PROVER_FORK_NAMESPACE::KeccakFCommitPols &pols);
 
+    /* Executes the program over KECCAK_F_EXECUTOR_LANES consecutive slots, starting at firstSlot, and stores the result in pols */
+    void executeSlots (const vector<vector<Goldilocks::Element>> &input, PROVER_FORK_NAMESPACE::KeccakFCommitPols &pols, uint64_t firstSlot);
+
     void setPol (PROVER_FORK_NAMESPACE::CommitPol (&pol)[4], uint64_t index, uint64_t value);
     uint64_t getPol (PROVER_FORK_NAMESPACE::CommitPol (&pol)[4], uint64_t index);
 
@@ -12,11 +12,6 @@ uint64_t FACTORV (uint8_t index, uint64_t i) {
     return (V_BYTE(i) >> 2) == index ? f[V_BYTE(i) % 4] : 0; 
 }
 
-uint8_t getByte (mpz_class value, uint8_t index) {
-    mpz_class r = (value >> (8 * index)) & 0xFF;
-    return r.get_ui();
-}
-
 
 void MemAlignExecutor::execute (vector<MemAlignAction> &input, MemAlignCommitPols &pols)
 {
@@ -28,16 +23,22 @@ void MemAlignExecutor::execute (vector<MemAlignAction> &input, MemAlignCommitPol
     }
 
     uint64_t factors[4] = {1, 1<<8, 1<<16, 1<<24};
+
+    // Every action fills its own range of 32 evaluations, plus the first evaluation of the next range,
+    // where it never writes the same polynomial as the next action, so actions can be processed in parallel
+#pragma omp parallel for schedule(static)
     for (uint64_t i=0; i<input.size(); i++) 
     {
-        mpz_class m0v = input[i].m0;
-        mpz_class m1v = input[i].m1;
-        mpz_class v = input[i].v;
+        uint8_t m0Bytes[32];
+        uint8_t m1Bytes[32];
+        uint8_t vBytes[32];
+        scalar2bytes(input[i].m0, m0Bytes);
+        scalar2bytes(input[i].m1, m1Bytes);
+        scalar2bytes(input[i].v, vBytes);
         uint8_t offset = input[i].offset;
         uint8_t wr8 = input[i].wr8;
         uint8_t wr256 = input[i].wr256;
         uint64_t polIndex = i * 32;
-        mpz_class vv = v;
         
         // setting index when result was ready
         uint64_t polResultIndex = ((i+1) * 32)%N;
@@ -48,9 +49,9 @@ void MemAlignExecutor::execute (vector<MemAlignAction> &input, MemAlignCommitPol
         for (uint8_t j=0; j<32; j++)
         {
             uint8_t vByte = ((31 + (offset + wr8) - j) % 32);
-            uint8_t inM0 = getByte(m0v, 31-j);
-            uint8_t inM1 = getByte(m1v, 31-j);
-            uint8_t inV = getByte(vv, vByte);
+            uint8_t inM0 = m0Bytes[31-j];
+            uint8_t inM1 = m1Bytes[31-j];
+            uint8_t inV = vBytes[vByte];
             uint8_t selM1 = (wr8 ? (j == offset) :(offset > j)) ? 1:0;
 
             pols.wr8[polIndex + j + 1] = fr.fromU64(wr8);
@@ -91,6 +92,7 @@ void MemAlignExecutor::execute (vector<MemAlignAction> &input, MemAlignCommitPol
             }
         }
     }
+#pragma omp parallel for schedule(static)
     for (uint64_t i = (input.size() * 32); i < N; i++) {
         for (uint8_t index = 0; index < 8; index++) {
             pols.factorV[index][i] = fr.fromU64(FACTORV(index, i % 32));
@@ -1,4 +1,5 @@
 #include <nlohmann/json.hpp>
+#include <parallel/algorithm>
 #include "memory_executor.hpp"
 #include "utils.hpp"
 #include "scalar.hpp"
@@ -9,12 +10,8 @@ using json = nlohmann::json;
 
 void MemoryExecutor::execute (vector<MemoryAccess> &input, MemCommitPols &pols)
 {
-    // Get input size
-    uint64_t inputSize = input.size();
-    uint64_t inputSizeMinusOne = inputSize - 1;
-
     // Check input size does not exceed the number of evaluations
-    if (inputSize > N)
+    if (input.size() > N)
     {
         zklog.error("MemoryExecutor::execute() Too many entries input.size()=" + to_string(input.size()) + " > N=" + to_string(N));
         exitProcess();
@@ -26,17 +23,14 @@ void MemoryExecutor::execute (vector<MemoryAccess> &input, MemCommitPols &pols)
     reorder(input, access);
     TimerStopAndLog(MEMORY_EXECUTOR_REORDER);
 
-    // We use variables to store the previous values of addr and step
-    // We need this to complete the "empty" evaluations of the polynomials addr and step
-    // We cannot do it with i-1 because we have to "protect" the case that the access list is empty
-    Goldilocks::Element lastAddr = fr.zero();
-    uint64_t prevStep = 0;
-
-    // Counter of the current polynomial evaluation
-    uint64_t i=0;
+    // Get access list size, after reordering
+    uint64_t inputSize = access.size();
+    uint64_t inputSizeMinusOne = inputSize - 1;
 
-    // For every input we consume one evaluation
-    for (; i<inputSize; i++)
+    // For every input we consume one evaluation; every evaluation only depends on its own access
+    // and on the next one, so they can be written in parallel chunks
+#pragma omp parallel for schedule(static)
+    for (uint64_t i=0; i<inputSize; i++)
     {
         pols.addr[i] = fr.fromU64(access[i].address);
         pols.step[i] = fr.fromU64(access[i].pc);
@@ -83,21 +77,27 @@ void MemoryExecutor::execute (vector<MemoryAccess> &input, MemCommitPols &pols)
 #endif
     }
 
-    // If the input list was not empty, get the values from the previous evaluation before breaking the loop
-    if (i > 0)
+    // We use variables to store the previous values of addr and step
+    // We need this to complete the "empty" evaluations of the polynomials addr and step
+    // We cannot do it with i-1 because we have to "protect" the case that the access list is empty
+    Goldilocks::Element lastAddr = fr.zero();
+    uint64_t prevStep = 0;
+
+    // If the input list was not empty, get the values from the last access
+    if (inputSize > 0)
     {
-        lastAddr = fr.add(pols.addr[i-1], fr.one());
-        prevStep = fr.toU64(pols.step[i-1]);
+        lastAddr = fr.add(fr.fromU64(access[inputSizeMinusOne].address), fr.one());
+        prevStep = access[inputSizeMinusOne].pc;
     }
 
     // After all inputs have been processed, consume the rest of evaluations
-    for (; i<N; i++)
+    // To validate the pil correctly keep last addr incremented +1 and increment the step respect to the previous value,
+    // i.e. the step of evaluation i is prevStep + (i - inputSize + 1), which does not depend on the previous evaluation
+#pragma omp parallel for schedule(static)
+    for (uint64_t i=inputSize; i<N; i++)
     {
-        // We complete the remaining polynomial evaluations
-        // To validate the pil correctly keep last addr incremented +1 and increment the step respect to the previous value
         pols.addr[i] = lastAddr;
-        prevStep++;
-        pols.step[i] = fr.fromU64(prevStep);
+        pols.step[i] = fr.fromU64(prevStep + i - inputSizeMinusOne);
     }
     
     // pols.lastAccess = 1 in the last evaluation to ensure ciclical validation
@@ -116,24 +116,23 @@ public:
     }
 };
 
-void MemoryExecutor::reorder (const vector<MemoryAccess> &input, vector<MemoryAccess> &output)
+class MemoryAccessEqual
 {
-    // Clear output vector
-    output.clear();
-
-    // Map input MemoryAccess entries using the MemoryAccessCompare class to order them
-    map<MemoryAccess, uint64_t, MemoryAccessCompare> auxMap;
-    for (uint64_t i=0; i<input.size(); i++)
+public:
+    bool operator()(const MemoryAccess &a, const MemoryAccess &b) const
     {
-        auxMap[input[i]] = i;
+        return (a.address == b.address) && (a.pc == b.pc);
     }
+};
 
-    // Copy data from the map to the output vector, in the map order
-    map<MemoryAccess, uint64_t, MemoryAccessCompare>::const_iterator auxMapIterator;
-    for (auxMapIterator = auxMap.begin(); auxMapIterator != auxMap.end(); auxMapIterator++)
-    {
-        output.push_back(auxMapIterator->first);
-    }
+void MemoryExecutor::reorder (const vector<MemoryAccess> &input, vector<MemoryAccess> &output)
+{
+    // Copy input MemoryAccess entries and sort them in parallel, using the MemoryAccessCompare class to order them
+    output = input;
+    __gnu_parallel::stable_sort(output.begin(), output.end(), MemoryAccessCompare());
+
+    // Keep only the first access of every address and pc pair, in input order
+    output.erase(unique(output.begin(), output.end(), MemoryAccessEqual()), output.end());
 }
 
 void MemoryExecutor::print (const vector<MemoryAccess> &access, Goldilocks &fr)
@@ -32,10 +32,23 @@ uint64_t PaddingKKExecutor::prepareInput (vector<PaddingKKExecutorInput> &input)
             }
         }
 
-        keccak256(input[i].dataBytes, input[i].hash);
-
         input[i].realLen = input[i].dataBytes.size();
+    }
+
+    // Calculate all the digests in one call, several of them in parallel
+    vector<const uint8_t *> inputs(input.size());
+    vector<uint64_t> inputSizes(input.size());
+    vector<mpz_class *> hashes(input.size());
+    for (uint64_t i=0; i<input.size(); i++)
+    {
+        inputs[i] = input[i].dataBytes.data();
+        inputSizes[i] = input[i].dataBytes.size();
+        hashes[i] = &input[i].hash;
+    }
+    keccak256(input.size(), inputs.data(), inputSizes.data(), hashes.data());
 
+    for (uint64_t i=0; i<input.size(); i++)
+    {
         // Add padding
         input[i].dataBytes.push_back(0x1);
         while (input[i].dataBytes.size() % bytesPerBlock) input[i].dataBytes.push_back(0);
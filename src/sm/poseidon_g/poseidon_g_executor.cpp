@@ -104,6 +104,78 @@ Goldilocks::Element C[] = {
     0, 0, 0, 0
 };
 
+/* Reduces a 128 bits value modulo the Goldilocks prime p = 2^64 - 2^32 + 1 */
+inline uint64_t reduce128 (unsigned __int128 x)
+{
+    const uint64_t EPSILON = 0xFFFFFFFF; // 2^64 mod p
+    uint64_t lo = (uint64_t)x;
+    uint64_t hi = (uint64_t)(x >> 64);
+    uint64_t hiHi = hi >> 32;
+    uint64_t hiLo = hi & EPSILON;
+
+    // 2^96 = -1 mod p
+    uint64_t t0 = lo - hiHi;
+    if (lo < hiHi) t0 -= EPSILON;
+
+    // 2^64 = 2^32 - 1 mod p
+    uint64_t t1 = hiLo * EPSILON;
+    uint64_t r = t0 + t1;
+    if (r < t1) r += EPSILON;
+
+    if (r >= GOLDILOCKS_PRIME) r -= GOLDILOCKS_PRIME;
+    return r;
+}
+
+void PoseidonGExecutor::permutation (const Goldilocks::Element (&input)[12], Goldilocks::Element (&trace)[31][12])
+{
+    uint64_t state[12];
+    for (uint64_t s=0; s<12; s++)
+    {
+        state[s] = fr.toU64(input[s]);
+        trace[0][s] = input[s];
+    }
+
+    for (uint64_t r=0; r < nRoundsF + nRoundsP; r++)
+    {
+        Goldilocks::Element e[12];
+        if ( (r < (nRoundsF/2)) || (r >= ((nRoundsF/2) + nRoundsP)) )
+        {
+            for (uint64_t s=0; s<12; s++)
+            {
+                e[s] = pow7(fr.add(fr.fromU64(state[s]), C[r*t + s]));
+                state[s] = fr.toU64(e[s]);
+            }
+        }
+        else
+        {
+            e[0] = pow7(fr.add(fr.fromU64(state[0]), C[r*t]));
+            state[0] = fr.toU64(e[0]);
+            for (uint64_t s=1; s<12; s++)
+            {
+                state[s] = fr.toU64(fr.add(fr.fromU64(state[s]), C[r*t + s]));
+            }
+        }
+
+        // M is a circulant matrix of small coefficients, so the dot products can be accumulated
+        // in 128 bits and reduced only once per output element
+        uint64_t acc[12];
+        for (uint64_t x=0; x<12; x++)
+        {
+            unsigned __int128 sum = 0;
+            for (uint64_t y=0; y<12; y++)
+            {
+                sum += (unsigned __int128)state[y] * MU64[x][y];
+            }
+            acc[x] = reduce128(sum);
+        }
+        for (uint64_t x=0; x<12; x++)
+        {
+            state[x] = acc[x];
+            trace[r+1][x] = fr.fromU64(acc[x]);
+        }
+    }
+}
+
 void PoseidonGExecutor::execute (   vector<array<Goldilocks::Element, 17>> &inputMain,
                                     vector<array<Goldilocks::Element, 17>> &inputPadding, 
                                     vector<array<Goldilocks::Element, 17>> &inputStorage, 
@@ -113,6 +185,7 @@ void PoseidonGExecutor::execute (   vector<array<Goldilocks::Element, 17>> &inpu
     uint64_t sizePadding = inputPadding.size();
     uint64_t sizeStorage = inputStorage.size();
     uint64_t size = sizeMain + sizePadding + sizeStorage;
+    const uint64_t rowsPerHash = nRoundsF + nRoundsP + 1;
 
     // Check input size
     if (size > maxHashes)
@@ -121,212 +194,117 @@ void PoseidonGExecutor::execute (   vector<array<Goldilocks::Element, 17>> &inpu
         exitProcess();
     }
 
-    uint64_t p = 0;
-    uint64_t pDone = 0;
-
-    vector<array<Goldilocks::Element, 17>> * input = NULL;
-    uint64_t sizeIn=0;
-
-    for(int k=0; k<3; k++){
-        
-        //Select input
-        if(k==0){
-            input = &inputMain;
-            sizeIn = sizeMain;
-        } else if(k==1){
-            input = &inputPadding;
-            sizeIn = sizePadding;
-        } else if(k==2){
-            input = &inputStorage;
-            sizeIn = sizeStorage;
-        }
-        
-        //Execute
-        for (uint64_t i=0; i<sizeIn; i++)
+    // Check the permutation ids before spawning the threads
+    vector<array<Goldilocks::Element, 17>> * inputs[3] = { &inputMain, &inputPadding, &inputStorage };
+    for (uint64_t k=0; k<3; k++)
+    {
+        for (uint64_t i=0; i<inputs[k]->size(); i++)
         {
-            
-            pols.in0[p] = (*input)[i][0];
-            pols.in1[p] = (*input)[i][1];
-            pols.in2[p] = (*input)[i][2];
-            pols.in3[p] = (*input)[i][3];
-            pols.in4[p] = (*input)[i][4];
-            pols.in5[p] = (*input)[i][5];
-            pols.in6[p] = (*input)[i][6];
-            pols.in7[p] = (*input)[i][7];
-            pols.hashType[p] = (*input)[i][8];
-            pols.cap1[p] = (*input)[i][9];
-            pols.cap2[p] = (*input)[i][10];
-            pols.cap3[p] = (*input)[i][11];
-            pols.hash0[p] = (*input)[i][12];
-            pols.hash1[p] = (*input)[i][13];
-            pols.hash2[p] = (*input)[i][14];
-            pols.hash3[p] = (*input)[i][15];
-            uint64_t permutation = fr.toU64((*input)[i][16]);
-            switch (permutation)
-            {
-                case POSEIDONG_PERMUTATION1_ID:
-                    pols.result1[p] = fr.one();
-                    break;
-                case POSEIDONG_PERMUTATION2_ID:
-                    pols.result2[p] = fr.one();
-                    break;
-                case POSEIDONG_PERMUTATION3_ID:
-                    pols.result3[p] = fr.one();
-                    break;
-                case POSEIDONG_PERMUTATION4_ID:
-                    // pols.result4[p] = fr.one();
-                    break;
-                default:
-                    zklog.error("PoseidonGExecutor::execute() got an invalid permutation=" + to_string(permutation) + " at input k=" + to_string(k) + " i=" + to_string(i));
-                    exitProcess();
-                    break;
-            }
-
-            p += 1;
-            
-            array<Goldilocks::Element,12> state= {
-                pols.in0[p-1], 
-                pols.in1[p-1], 
-                pols.in2[p-1], 
-                pols.in3[p-1], 
-                pols.in4[p-1], 
-                pols.in5[p-1], 
-                pols.in6[p-1], 
-                pols.in7[p-1], 
-                pols.hashType[p-1], 
-                pols.cap1[p-1], 
-                pols.cap2[p-1], 
-                pols.cap3[p-1] };
-
-            for (uint64_t r=0; r < nRoundsF + nRoundsP; r++)
+            uint64_t permutation = fr.toU64((*inputs[k])[i][16]);
+            if ((permutation < POSEIDONG_PERMUTATION1_ID) || (permutation > POSEIDONG_PERMUTATION4_ID))
             {
-                for (uint64_t s=0; s<12; s++)
-                {
-                    state[s] = fr.add(state[s], C[r*t + s]);
-                }
-
-                if ( (r < (nRoundsF/2)) || (r >= ((nRoundsF/2) + nRoundsP)) )
-                {
-                    for (uint64_t s=0; s<12; s++)
-                    {
-                        state[s] = pow7(state[s]);
-                    }
-                }
-                else
-                {
-                    state[0] = pow7(state[0]);
-                }
-
-                Goldilocks::Element acc[12];
-                for (uint64_t x=0; x<state.size(); x++)
-                {
-                    acc[x] = fr.zero();
-                    for (uint64_t y=0; y<state.size(); y++)
-                    {
-                        acc[x] = fr.add(acc[x], fr.mul(state[y], M[x][y]));
-                    }
-                }
-                for (uint64_t x=0; x<state.size(); x++)
-                {
-                    state[x] = acc[x];
-                }
-
-                pols.in0[p] = state[0];
-                pols.in1[p] = state[1];
-                pols.in2[p] = state[2];
-                pols.in3[p] = state[3];
-                pols.in4[p] = state[4];
-                pols.in5[p] = state[5];
-                pols.in6[p] = state[6];
-                pols.in7[p] = state[7];
-                pols.hashType[p] = state[8];
-                pols.cap1[p] = state[9];
-                pols.cap2[p] = state[10];
-                pols.cap3[p] = state[11];
-                pols.hash0[p] = (*input)[i][12];
-                pols.hash1[p] = (*input)[i][13];
-                pols.hash2[p] = (*input)[i][14];
-                pols.hash3[p] = (*input)[i][15];
-                p+=1;
+                zklog.error("PoseidonGExecutor::execute() got an invalid permutation=" + to_string(permutation) + " at input k=" + to_string(k) + " i=" + to_string(i));
+                exitProcess();
             }
         }
     }
 
-    vector<array<Goldilocks::Element,12>> st0;
-
-    array<Goldilocks::Element, 12> aux;
-    for (uint64_t i=0; i<12; i++)
+    // Every hash fills its own range of rowsPerHash rows, so they can be computed in parallel
+#pragma omp parallel for schedule(static)
+    for (uint64_t h=0; h<size; h++)
     {
-        aux[i] = fr.zero();
-    };
-    st0.push_back(aux);
+        // Select input
+        const array<Goldilocks::Element, 17> &input =
+            (h < sizeMain) ? inputMain[h] :
+            (h < sizeMain + sizePadding) ? inputPadding[h - sizeMain] :
+            inputStorage[h - sizeMain - sizePadding];
+        uint64_t p = h*rowsPerHash;
 
-    for (uint64_t r=0; r<nRoundsF + nRoundsP; r++)
-    {
-        for (uint64_t s=0; s<12; s++)
+        switch (fr.toU64(input[16]))
         {
-            aux[s] = fr.add(st0[r][s], C[r*t + s]);
+            case POSEIDONG_PERMUTATION1_ID:
+                pols.result1[p] = fr.one();
+                break;
+            case POSEIDONG_PERMUTATION2_ID:
+                pols.result2[p] = fr.one();
+                break;
+            case POSEIDONG_PERMUTATION3_ID:
+                pols.result3[p] = fr.one();
+                break;
+            default: // POSEIDONG_PERMUTATION4_ID
+                // pols.result4[p] = fr.one();
+                break;
         }
-        st0.push_back(aux);
 
-        if ( (r < (nRoundsF/2)) || (r >= ((nRoundsF/2) + nRoundsP)) )
-        {
-            for (uint64_t s=0; s<12; s++)
-            {
-                st0[r+1][s] = pow7(st0[r+1][s]);
-            }
-        }
-        else
+        // Execute
+        Goldilocks::Element in[12];
+        for (uint64_t s=0; s<12; s++)
         {
-            st0[r+1][0] = pow7(st0[r+1][0]);
+            in[s] = input[s];
         }
+        Goldilocks::Element trace[31][12];
+        permutation(in, trace);
 
-        Goldilocks::Element acc[12];
-        for (uint64_t x=0; x<st0[r+1].size(); x++)
-        {
-            acc[x] = fr.zero();
-            for (uint64_t y=0; y<st0[r+1].size(); y++)
-            {
-                acc[x] = fr.add(acc[x], fr.mul(st0[r+1][y], M[x][y]));
-            }
-        }
-        for (uint64_t x=0; x<st0[r+1].size(); x++)
+        for (uint64_t r=0; r<rowsPerHash; r++, p++)
         {
-            st0[r+1][x] = acc[x];
+            pols.in0[p] = trace[r][0];
+            pols.in1[p] = trace[r][1];
+            pols.in2[p] = trace[r][2];
+            pols.in3[p] = trace[r][3];
+            pols.in4[p] = trace[r][4];
+            pols.in5[p] = trace[r][5];
+            pols.in6[p] = trace[r][6];
+            pols.in7[p] = trace[r][7];
+            pols.hashType[p] = trace[r][8];
+            pols.cap1[p] = trace[r][9];
+            pols.cap2[p] = trace[r][10];
+            pols.cap3[p] = trace[r][11];
+            pols.hash0[p] = input[12];
+            pols.hash1[p] = input[13];
+            pols.hash2[p] = input[14];
+            pols.hash3[p] = input[15];
         }
     }
 
-    pDone = p;
+    // Fill the remaining rows with the permutation of a zero state
+    Goldilocks::Element zeroInput[12];
+    for (uint64_t i=0; i<12; i++)
+    {
+        zeroInput[i] = fr.zero();
+    }
+    Goldilocks::Element st0[31][12];
+    permutation(zeroInput, st0);
+
+    uint64_t pDone = size*rowsPerHash;
 
-    while ( p < N ) // TODO: Can we skip this final part?
+#pragma omp parallel for schedule(static)
+    for (uint64_t p = pDone; p < N; p++) // TODO: Can we skip this final part?
     {
-        pols.in0[p] = st0[p%(nRoundsP + nRoundsF + 1)][0];
-        pols.in1[p] = st0[p%(nRoundsP + nRoundsF + 1)][1];
-        pols.in2[p] = st0[p%(nRoundsP + nRoundsF + 1)][2];
-        pols.in3[p] = st0[p%(nRoundsP + nRoundsF + 1)][3];
-        pols.in4[p] = st0[p%(nRoundsP + nRoundsF + 1)][4];
-        pols.in5[p] = st0[p%(nRoundsP + nRoundsF + 1)][5];
-        pols.in6[p] = st0[p%(nRoundsP + nRoundsF + 1)][6];
-        pols.in7[p] = st0[p%(nRoundsP + nRoundsF + 1)][7];
-        pols.hashType[p] = st0[p%(nRoundsP + nRoundsF + 1)][8];
-        pols.cap1[p] = st0[p%(nRoundsP + nRoundsF + 1)][9];
-        pols.cap2[p] = st0[p%(nRoundsP + nRoundsF + 1)][10];
-        pols.cap3[p] = st0[p%(nRoundsP + nRoundsF + 1)][11];
+        pols.in0[p] = st0[p%rowsPerHash][0];
+        pols.in1[p] = st0[p%rowsPerHash][1];
+        pols.in2[p] = st0[p%rowsPerHash][2];
+        pols.in3[p] = st0[p%rowsPerHash][3];
+        pols.in4[p] = st0[p%rowsPerHash][4];
+        pols.in5[p] = st0[p%rowsPerHash][5];
+        pols.in6[p] = st0[p%rowsPerHash][6];
+        pols.in7[p] = st0[p%rowsPerHash][7];
+        pols.hashType[p] = st0[p%rowsPerHash][8];
+        pols.cap1[p] = st0[p%rowsPerHash][9];
+        pols.cap2[p] = st0[p%rowsPerHash][10];
+        pols.cap3[p] = st0[p%rowsPerHash][11];
         pols.hash0[p] = st0[nRoundsP + nRoundsF][0];
         pols.hash1[p] = st0[nRoundsP + nRoundsF][1];
         pols.hash2[p] = st0[nRoundsP + nRoundsF][2];
         pols.hash3[p] = st0[nRoundsP + nRoundsF][3];
-        p+=1;
     }
 
-    zklog.info("PoseidonGExecutor successfully processed " + to_string(size) + " Poseidon hashes p=" + to_string(p) + " pDone=" + to_string(pDone) + " (" + to_string((double(pDone)*100)/N) + "%)");
+    zklog.info("PoseidonGExecutor successfully processed " + to_string(size) + " Poseidon hashes p=" + to_string(N) + " pDone=" + to_string(pDone) + " (" + to_string((double(pDone)*100)/N) + "%)");
 }
 
-Goldilocks::Element PoseidonGExecutor::pow7 (Goldilocks::Element &a)
+Goldilocks::Element PoseidonGExecutor::pow7 (const Goldilocks::Element &a)
 {
     Goldilocks::Element a2 = fr.square(a);
     Goldilocks::Element a4 = fr.square(a2);
     Goldilocks::Element a3 = fr.mul(a, a2);
     return fr.mul(a3, a4);
 }
-
@@ -25,6 +25,7 @@ private:
     const array<Goldilocks::Element,12> MCIRC;
     const array<Goldilocks::Element,12> MDIAG;
     array<array<Goldilocks::Element,12>,12> M;
+    uint64_t MU64[12][12]; // Same as M, as plain integers
 public:
     PoseidonGExecutor(Goldilocks &fr, PoseidonGoldilocks &poseidon) :
         fr(fr),
@@ -46,6 +47,7 @@ public:
                 {
                     M[i][j] = fr.add(M[i][j], MDIAG[i]);
                 }
+                MU64[i][j] = fr.toU64(M[i][j]);
             }
         }
     };
@@ -53,7 +55,11 @@ public:
                     vector<array<Goldilocks::Element, 17>> &inputPadding, 
                     vector<array<Goldilocks::Element, 17>> &inputStorage, 
                     PoseidonGCommitPols &pols);
-    Goldilocks::Element pow7(Goldilocks::Element &a);
+
+    /* Computes the permutation of input, returning the state after every round, i.e. the 31 rows of a hash */
+    void permutation (const Goldilocks::Element (&input)[12], Goldilocks::Element (&trace)[31][12]);
+
+    Goldilocks::Element pow7(const Goldilocks::Element &a);
 };
 
 #endif
\ No newline at end of file
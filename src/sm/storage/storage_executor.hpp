@@ -15,6 +15,43 @@
 
 USING_PROVER_FORK_NAMESPACE;
 
+// Storage SM registers, i.e. the state that is carried from one evaluation to the next one
+class StorageRegisters
+{
+public:
+    uint64_t pc;
+    uint64_t incCounter;
+    Goldilocks::Element oldRoot[4];
+    Goldilocks::Element newRoot[4];
+    Goldilocks::Element valueLow[4];
+    Goldilocks::Element valueHigh[4];
+    Goldilocks::Element siblingValueHash[4];
+    Goldilocks::Element rkey[4];
+    Goldilocks::Element siblingRkey[4];
+    Goldilocks::Element hashLeft[4];
+    Goldilocks::Element hashRight[4];
+    Goldilocks::Element rkeyBit;
+    Goldilocks::Element level;
+
+    StorageRegisters () : pc(0), incCounter(0)
+    {
+        for (uint64_t j=0; j<4; j++)
+        {
+            oldRoot[j] = Goldilocks::zero();
+            newRoot[j] = Goldilocks::zero();
+            valueLow[j] = Goldilocks::zero();
+            valueHigh[j] = Goldilocks::zero();
+            siblingValueHash[j] = Goldilocks::zero();
+            rkey[j] = Goldilocks::zero();
+            siblingRkey[j] = Goldilocks::zero();
+            hashLeft[j] = Goldilocks::zero();
+            hashRight[j] = Goldilocks::zero();
+        }
+        rkeyBit = Goldilocks::zero();
+        level = Goldilocks::zero();
+    }
+};
+
 class StorageExecutor
 {
     Goldilocks &fr;
@@ -23,6 +60,12 @@ class StorageExecutor
     const uint64_t N;
     StorageRom rom;
 
+    // Executes the ROM lines of action pAction starting at evaluation i with registers regs, until its latch,
+    // or until evaluation iEnd if pAction is NULL (final padding); returns the next evaluation.
+    // If pPols is NULL no trace is written; if pPoseidonComputed is not NULL the hashes are taken from it
+    // instead of being calculated; poseidon and climb key requests are stored only if the vectors are provided
+    uint64_t executeAction (const SmtAction * pAction, uint64_t a, uint64_t i, uint64_t iEnd, StorageRegisters &regs, PROVER_FORK_NAMESPACE::StorageCommitPols * pPols, vector<array<Goldilocks::Element, 17>> * pPoseidonRequired, const vector<array<Goldilocks::Element, 17>> * pPoseidonComputed, vector<ClimbKeyAction> * pClimbKeyRequired, uint64_t &lastStep);
+
 public:
     StorageExecutor (Goldilocks &fr, PoseidonGoldilocks &poseidon, const Config &config) :
         fr(fr),
@@ -73,9 +73,11 @@ void StorageRom::load(json &j)
         if (romLine.inFREE)
         {
             romLine.op = l["freeInTag"]["op"];
-            if (romLine.op=="functionCall")
+            romLine.opCode = string2StorageOp(romLine.op);
+            if (romLine.opCode == sop_functionCall)
             {
                 romLine.funcName = l["freeInTag"]["funcName"];
+                romLine.function = string2StorageFunction(romLine.funcName);
                 const uint64_t paramCount = l["freeInTag"]["params"].size();
                 json params = l["freeInTag"]["params"];
                 for (uint64_t iParam = 0; iParam < paramCount; iParam++)
@@ -88,9 +90,34 @@ void StorageRom::load(json &j)
         // Constant
         if (l["CONST"].is_number())
         {
-            romLine.CONST = to_string(l["CONST"].get<int64_t>());
+            romLine.constValue = l["CONST"].get<int64_t>();
+            romLine.CONST = to_string(romLine.constValue);
+            romLine.bConst = true;
         }
 
         line.push_back(romLine);
     }
+
+    // Every SMT action starts at line 0; if this line resets all registers to a constant value and all
+    // latches jump back to it, the execution of an action does not depend on the previous ones
+    bIndependentActions = (line.size() > 0);
+    if (bIndependentActions)
+    {
+        const StorageRomLine &first = line[0];
+        bIndependentActions =
+            !first.inFREE && !first.hash && !first.climbRkey && !first.climbSiblingRkey &&
+            !first.inOLD_ROOT && !first.inNEW_ROOT && !first.inRKEY_BIT && !first.inVALUE_LOW &&
+            !first.inVALUE_HIGH && !first.inRKEY && (first.inSIBLING_RKEY == 0) && !first.inSIBLING_VALUE_HASH &&
+            !first.inROTL_VH && !first.inLEVEL &&
+            first.setRKEY && first.setRKEY_BIT && first.setVALUE_LOW && first.setVALUE_HIGH && first.setLEVEL &&
+            first.setOLD_ROOT && first.setNEW_ROOT && first.setHASH_LEFT && first.setHASH_RIGHT &&
+            first.setSIBLING_RKEY && first.setSIBLING_VALUE_HASH;
+    }
+    for (uint64_t i=0; bIndependentActions && (i<line.size()); i++)
+    {
+        if ((line[i].latchGet || line[i].latchSet) && (!line[i].jmp || (line[i].jmpAddress != 0)))
+        {
+            bIndependentActions = false;
+        }
+    }
 }
\ No newline at end of file
@@ -12,6 +12,8 @@ class StorageRom
 {
 public:
     vector<StorageRomLine> line;
+    bool bIndependentActions; // True if every action starts from a clean register state
+    StorageRom () : bIndependentActions(false) {};
     void load (json &j);
 };
 
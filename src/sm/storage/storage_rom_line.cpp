@@ -1,6 +1,7 @@
 #include <iostream>
 #include "storage_rom_line.hpp"
 #include "zklog.hpp"
+#include "exit_process.hpp"
 
 void StorageRomLine::print (uint64_t l)
 {
@@ -64,4 +65,46 @@ void StorageRomLine::print (uint64_t l)
     if (setSIBLING_VALUE_HASH) s += "setSIBLING_VALUE_HASH ";
 
     zklog.info(s);
-}
\ No newline at end of file
+}
+
+tStorageOp string2StorageOp (const string &s)
+{
+    if (s == "")                                    return sop_empty;
+    else if (s == "functionCall")                   return sop_functionCall;
+    zklog.error("string2StorageOp() invalid string=" + s);
+    exitProcess();
+    return sop_empty;
+}
+
+tStorageFunction string2StorageFunction (const string &s)
+{
+    if (s == "isSetUpdate")                         return sf_isSetUpdate;
+    else if (s == "isSetInsertFound")               return sf_isSetInsertFound;
+    else if (s == "isSetInsertNotFound")            return sf_isSetInsertNotFound;
+    else if (s == "isSetDeleteLast")                return sf_isSetDeleteLast;
+    else if (s == "isSetDeleteFound")               return sf_isSetDeleteFound;
+    else if (s == "isSetDeleteNotFound")            return sf_isSetDeleteNotFound;
+    else if (s == "isSetZeroToZero")                return sf_isSetZeroToZero;
+    else if (s == "GetIsOld0")                      return sf_GetIsOld0;
+    else if (s == "isGet")                          return sf_isGet;
+    else if (s == "GetRkey")                        return sf_GetRkey;
+    else if (s == "GetSiblingRkey")                 return sf_GetSiblingRkey;
+    else if (s == "GetSiblingHash")                 return sf_GetSiblingHash;
+    else if (s == "GetSiblingLeftChildHash")        return sf_GetSiblingLeftChildHash;
+    else if (s == "GetSiblingRightChildHash")       return sf_GetSiblingRightChildHash;
+    else if (s == "isValueZero")                    return sf_isValueZero;
+    else if (s == "GetValueLow")                    return sf_GetValueLow;
+    else if (s == "GetValueHigh")                   return sf_GetValueHigh;
+    else if (s == "GetSiblingValueLow")             return sf_GetSiblingValueLow;
+    else if (s == "GetSiblingValueHigh")            return sf_GetSiblingValueHigh;
+    else if (s == "GetOldValueLow")                 return sf_GetOldValueLow;
+    else if (s == "GetOldValueHigh")                return sf_GetOldValueHigh;
+    else if (s == "GetLevel")                       return sf_GetLevel;
+    else if (s == "GetTopTree")                     return sf_GetTopTree;
+    else if (s == "GetTopOfBranch")                 return sf_GetTopOfBranch;
+    else if (s == "GetNextKeyBit")                  return sf_GetNextKeyBit;
+    else if (s == "isAlmostEndPolynomial")          return sf_isAlmostEndPolynomial;
+    zklog.error("string2StorageFunction() invalid string=" + s);
+    exitProcess();
+    return sf_empty;
+}
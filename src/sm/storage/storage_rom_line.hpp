@@ -7,6 +7,46 @@
 
 using namespace std;
 
+// Storage ROM inFREE operations
+typedef enum : int {
+    sop_empty = 0,
+    sop_functionCall
+} tStorageOp;
+
+// Storage ROM inFREE functions
+typedef enum : int {
+    sf_empty = 0,
+    sf_isSetUpdate,
+    sf_isSetInsertFound,
+    sf_isSetInsertNotFound,
+    sf_isSetDeleteLast,
+    sf_isSetDeleteFound,
+    sf_isSetDeleteNotFound,
+    sf_isSetZeroToZero,
+    sf_GetIsOld0,
+    sf_isGet,
+    sf_GetRkey,
+    sf_GetSiblingRkey,
+    sf_GetSiblingHash,
+    sf_GetSiblingLeftChildHash,
+    sf_GetSiblingRightChildHash,
+    sf_isValueZero,
+    sf_GetValueLow,
+    sf_GetValueHigh,
+    sf_GetSiblingValueLow,
+    sf_GetSiblingValueHigh,
+    sf_GetOldValueLow,
+    sf_GetOldValueHigh,
+    sf_GetLevel,
+    sf_GetTopTree,
+    sf_GetTopOfBranch,
+    sf_GetNextKeyBit,
+    sf_isAlmostEndPolynomial
+} tStorageFunction;
+
+tStorageOp string2StorageOp (const string &s);
+tStorageFunction string2StorageFunction (const string &s);
+
 class StorageRomLine
 {
 public:
@@ -65,6 +105,12 @@ public:
     // Constant
     string CONST;
 
+    // Decoded op, funcName and CONST, used by the executor to avoid string processing at every evaluation
+    tStorageOp opCode;
+    tStorageFunction function;
+    bool bConst;
+    int64_t constValue;
+
     StorageRomLine ()
     {
         line = 0;
@@ -102,6 +148,10 @@ public:
         setSIBLING_RKEY = false;
         setSIBLING_VALUE_HASH = false;
         jmpAddress = 0;
+        opCode = sop_empty;
+        function = sf_empty;
+        bConst = false;
+        constValue = 0;
     }
     void print (uint64_t l);
 };
@@ -81,6 +81,79 @@ ordered_json proof2zkinStark(ordered_json &proof)
     return zkinOut;
 };
 
+static void elements2zkin(const std::vector<Goldilocks::Element> &elements, std::vector<uint64_t> &values)
+{
+    for (uint64_t i = 0; i < elements.size(); i++)
+    {
+        values.push_back(Goldilocks::toU64(elements[i]));
+    }
+}
+
+static void elements2zkin(const std::vector<std::vector<Goldilocks::Element>> &elements, std::vector<uint64_t> &values)
+{
+    for (uint64_t i = 0; i < elements.size(); i++)
+    {
+        elements2zkin(elements[i], values);
+    }
+}
+
+void proof2zkinStark(FRIProof &fproof, ZkinStark &zkin)
+{
+    Proofs &proofs = fproof.proofs;
+    std::vector<ProofTree> &trees = proofs.fri.trees;
+
+    elements2zkin(proofs.root1, zkin.add("root1"));
+    elements2zkin(proofs.root2, zkin.add("root2"));
+    elements2zkin(proofs.root3, zkin.add("root3"));
+    elements2zkin(proofs.root4, zkin.add("root4"));
+    elements2zkin(proofs.evals, zkin.add("evals"));
+
+    uint64_t nQueries = trees[0].polQueries.size();
+    for (uint64_t i = 1; i < trees.size(); i++)
+    {
+        elements2zkin(trees[i].root, zkin.add("s" + std::to_string(i) + "_root"));
+        std::vector<uint64_t> &vals = zkin.add("s" + std::to_string(i) + "_vals");
+        for (uint64_t q = 0; q < nQueries; q++)
+        {
+            elements2zkin(trees[i].polQueries[q][0].v, vals);
+        }
+        std::vector<uint64_t> &siblings = zkin.add("s" + std::to_string(i) + "_siblings");
+        for (uint64_t q = 0; q < nQueries; q++)
+        {
+            elements2zkin(trees[i].polQueries[q][0].mp, siblings);
+        }
+    }
+
+    // Step 0 queries contain one merkle proof per tree: cm1, cm2, cm3, cm4 and constants; cm2 and cm3 can be empty
+    static const char *treeNames[5] = {"1", "2", "3", "4", "C"};
+    for (uint64_t t = 0; t < 5; t++)
+    {
+        if (trees[0].polQueries[0][t].v.size() == 0 && (t == 1 || t == 2))
+        {
+            continue;
+        }
+        std::vector<uint64_t> &vals = zkin.add("s0_vals" + std::string(treeNames[t]));
+        for (uint64_t q = 0; q < nQueries; q++)
+        {
+            elements2zkin(trees[0].polQueries[q][t].v, vals);
+        }
+    }
+    for (uint64_t t = 0; t < 5; t++)
+    {
+        if (trees[0].polQueries[0][t].v.size() == 0 && (t == 1 || t == 2))
+        {
+            continue;
+        }
+        std::vector<uint64_t> &siblings = zkin.add("s0_siblings" + std::string(treeNames[t]));
+        for (uint64_t q = 0; q < nQueries; q++)
+        {
+            elements2zkin(trees[0].polQueries[q][t].mp, siblings);
+        }
+    }
+
+    elements2zkin(proofs.fri.pol, zkin.add("finalPol"));
+}
+
 ordered_json joinzkin(ordered_json &zkin1, ordered_json &zkin2, ordered_json &verKey, uint64_t steps)
 {
     ordered_json zkinOut = ordered_json::object();
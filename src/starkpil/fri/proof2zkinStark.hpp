@@ -3,10 +3,14 @@
 
 #include <nlohmann/json.hpp>
 #include "friProof.hpp"
+#include "zkinStark.hpp"
 
 using ordered_json = nlohmann::ordered_json;
 
 ordered_json proof2zkinStark(ordered_json &fproof);
+
+// Same signals and values as proof2zkinStark(fproof.proofs.proof2json()), without the JSON conversion
+void proof2zkinStark(FRIProof &fproof, ZkinStark &zkin);
 ordered_json joinzkin(ordered_json &zkin1, ordered_json &zkin2, ordered_json &verKey, uint64_t steps);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef ZKIN_STARK_HPP
+#define ZKIN_STARK_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstdint>
+
+// Circom input signal, with its values flattened in the same order as the JSON arrays
+class ZkinSignal
+{
+public:
+    std::string name;
+    std::vector<uint64_t> values;
+};
+
+// Binary circom input, used to pass a stark proof to the next recursion circuit without a JSON round trip
+class ZkinStark
+{
+public:
+    std::deque<ZkinSignal> signals; // A deque keeps the references returned by add() valid while adding more signals
+
+    // Adds a new signal and returns its values vector, to be filled by the caller
+    std::vector<uint64_t> &add(const std::string &name)
+    {
+        signals.emplace_back();
+        signals.back().name = name;
+        return signals.back().values;
+    }
+
+    // Adds a new signal with the provided values
+    void add(const std::string &name, const std::vector<uint64_t> &values)
+    {
+        add(name) = values;
+    }
+};
+
+#endif
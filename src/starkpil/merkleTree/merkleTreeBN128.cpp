@@ -110,30 +110,26 @@ void MerkleTreeBN128::linearHash()
             }
         }
 
+        // Rows are hashed POSEIDON_OPT_LANES at a time; all of them have the same width, so every chunk
+        // of 16 elements is absorbed by the same state size in all of them
 #pragma omp parallel for
-        for (uint64_t i = 0; i < height; i++)
+        for (uint64_t i = 0; i < height; i += POSEIDON_OPT_LANES)
         {
-            uint pending = width;
             Poseidon_opt p;
-            std::vector<RawFr::Element> elements(17);
+            uint64_t nRows = std::min((uint64_t)POSEIDON_OPT_LANES, height - i);
+            RawFr::Element states[POSEIDON_OPT_LANES * 17];
+            uint64_t pending = width;
             while (pending > 0)
             {
-                std::memset(&elements[0], 0, 17 * sizeof(RawFr::Element));
-                if (pending >= 16)
-                {
-                    std::memcpy(&elements[1], &buff[i * width + width - pending], 16 * sizeof(RawFr::Element));
-                    std::memcpy(&elements[0], &nodes[i], sizeof(RawFr::Element));
-                    p.hash(elements, &nodes[i]);
-                    pending = pending - 16;
-                }
-                else
+                uint64_t batch = std::min(pending, (uint64_t)16);
+                uint64_t t = batch + 1;
+                for (uint64_t r = 0; r < nRows; r++)
                 {
-                    std::vector<RawFr::Element> elements_last(pending + 1);
-                    std::memcpy(&elements_last[1], &buff[i * width + width - pending], pending * sizeof(RawFr::Element));
-                    std::memcpy(&elements_last[0], &nodes[i], sizeof(RawFr::Element));
-                    p.hash(elements_last, &nodes[i]);
-                    pending = 0;
+                    std::memcpy(&states[r * t], &nodes[i + r], sizeof(RawFr::Element));
+                    std::memcpy(&states[r * t + 1], &buff[(i + r) * width + width - pending], batch * sizeof(RawFr::Element));
                 }
+                p.hash(states, nRows, t, &nodes[i]);
+                pending = pending - batch;
             }
         }
         free(buff);
@@ -165,15 +161,19 @@ void MerkleTreeBN128::merkelize()
     {
         uint64_t batches = ceil((double)n256 / 16);
 #pragma omp parallel for
-        for (uint64_t i = 0; i < batches; i++)
+        for (uint64_t i = 0; i < batches; i += POSEIDON_OPT_LANES)
         {
             Poseidon_opt p;
-            vector<RawFr::Element> elements(17);
-            std::memset(&elements[0], 0, 17 * sizeof(RawFr::Element));
+            uint64_t nHashes = std::min((uint64_t)POSEIDON_OPT_LANES, batches - i);
+            RawFr::Element states[POSEIDON_OPT_LANES * 17];
+            std::memset(states, 0, sizeof(states));
             uint numHashes = 16;
             (batches == 1) ? numHashes = n256 : numHashes = 16;
-            std::memcpy(&elements[1], &cursor[i * 16], numHashes * sizeof(RawFr::Element));
-            p.hash(elements, &cursorNext[i]);
+            for (uint64_t j = 0; j < nHashes; j++)
+            {
+                std::memcpy(&states[j * 17 + 1], &cursor[(i + j) * 16], numHashes * sizeof(RawFr::Element));
+            }
+            p.hash(states, nHashes, 17, &cursorNext[i]);
         }
 
         n256 = nextN256;
@@ -316,14 +316,11 @@ namespace CircomRecursive2
     inStream.close();
     loadJsonImpl(ctx, j);
   }
-  void getCommitedPols(CommitPolsStarks *commitPols, const std::string zkevmVerifier, const std::string execFile, nlohmann::json &zkin, uint64_t N, uint64_t nCols)
+  void getCommitedPols(CommitPolsStarks *commitPols, Circom_Circuit *circuit, const std::string execFile, nlohmann::json &zkin, uint64_t N, uint64_t nCols)
   {
     //-------------------------------------------
     // Verifier stark proof
     //-------------------------------------------
-    TimerStart(CIRCOM_LOAD_CIRCUIT_BATCH_PROOF_RECURSIVE2);
-    Circom_Circuit *circuit = loadCircuit(zkevmVerifier);
-    TimerStopAndLog(CIRCOM_LOAD_CIRCUIT_BATCH_PROOF_RECURSIVE2);
     TimerStart(CIRCOM_LOAD_JSON_BATCH_PROOF);
     Circom_CalcWit *ctx = new Circom_CalcWit(circuit);
 
@@ -392,7 +389,6 @@ namespace CircomRecursive2
       }
     }
     delete[] tmp;
-    freeCircuit(circuit);
     TimerStopAndLog(STARK_WITNESS_AND_COMMITED_POLS_BATCH_PROOF);
   }
 }
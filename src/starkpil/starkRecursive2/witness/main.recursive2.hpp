@@ -22,7 +22,7 @@ namespace CircomRecursive2
     void loadJsonImpl(Circom_CalcWit *ctx, json &j);
     void writeBinWitness(Circom_CalcWit *ctx, std::string wtnsFileName);
     void getBinWitness(Circom_CalcWit *ctx, FrGElement *&pWitness, uint64_t &witnessSize);
-    void getCommitedPols(CommitPolsStarks *commitPols, const std::string zkevmVerifier, const std::string execFile, nlohmann::json &zkin, uint64_t N, uint64_t nCols);
+    void getCommitedPols(CommitPolsStarks *commitPols, Circom_Circuit *circuit, const std::string execFile, nlohmann::json &zkin, uint64_t N, uint64_t nCols);
     bool check_valid_number(std::string &s, uint base);
 
 }
@@ -19,6 +19,7 @@ using json = nlohmann::json;
 #include "timer.hpp"
 #include "execFile.hpp"
 #include "commit_pols_starks.hpp"
+#include "zkinStark.hpp"
 #include "zklog.hpp"
 #include "exit_process.hpp"
 
@@ -257,6 +258,69 @@ namespace Circom
     }
   }
 
+  // Builds the same element that FrG_str2element() builds from the decimal string of this value
+  void u642FrGElement(uint64_t value, FrGElement &v)
+  {
+    if (value >= FrG_rawq[0])
+    {
+      value -= FrG_rawq[0];
+    }
+    if (value <= INT32_MAX)
+    {
+      v.type = FrG_SHORT;
+      v.shortVal = value;
+      v.longVal[0] = 0;
+    }
+    else
+    {
+      v.type = FrG_LONG;
+      v.shortVal = 0;
+      v.longVal[0] = value;
+    }
+  }
+
+  void loadZkinImpl(Circom_CalcWit *ctx, ZkinStark &zkin)
+  {
+    if (zkin.signals.size() == 0)
+    {
+      ctx->tryRunCircuit();
+    }
+    for (uint64_t s = 0; s < zkin.signals.size(); s++)
+    {
+      ZkinSignal &signal = zkin.signals[s];
+      u64 h = fnv1a(signal.name);
+      uint signalSize = ctx->getInputSignalSize(h);
+      if (signal.values.size() < signalSize)
+      {
+        std::ostringstream errStrStream;
+        errStrStream << "Error loading signal " << signal.name << ": Not enough values\n";
+        throw std::runtime_error(errStrStream.str());
+      }
+      if (signal.values.size() > signalSize)
+      {
+        std::ostringstream errStrStream;
+        errStrStream << "Error loading signal " << signal.name << ": Too many values\n";
+        throw std::runtime_error(errStrStream.str());
+      }
+      for (uint i = 0; i < signal.values.size(); i++)
+      {
+        FrGElement v;
+        u642FrGElement(signal.values[i], v);
+        try
+        {
+          ctx->setInputSignal(h, i, v);
+        }
+        catch (std::runtime_error &e)
+        {
+          std::ostringstream errStrStream;
+          errStrStream << "Error setting signal: " << signal.name << "\n"
+                       << e.what();
+          throw std::runtime_error(errStrStream.str());
+        }
+      }
+    }
+  }
+
   void writeBinWitness(Circom_CalcWit *ctx, std::string wtnsFileName)
   {
     FILE *write_ptr;
@@ -316,24 +380,15 @@ namespace Circom
     loadJsonImpl(ctx, j);
   }
   
-  void getCommitedPols(CommitPolsStarks *commitPols, const std::string zkevmVerifier, const std::string execFile, nlohmann::json &zkin, uint64_t N, uint64_t nCols)
+  // Computes the commited pols from the witness of a circuit whose inputs have been set
+  static void calculateCommitedPols(CommitPolsStarks *commitPols, Circom_CalcWit *ctx, const std::string execFile, uint64_t N, uint64_t nCols)
   {
-    //-------------------------------------------
-    // Verifier stark proof
-    //-------------------------------------------
-    TimerStart(CIRCOM_LOAD_CIRCUIT_BATCH_PROOF_ZKEVM);
-    Circom_Circuit *circuit = loadCircuit(zkevmVerifier);
-    TimerStopAndLog(CIRCOM_LOAD_CIRCUIT_BATCH_PROOF_ZKEVM);
-    TimerStart(CIRCOM_LOAD_JSON_BATCH_PROOF);
-    Circom_CalcWit *ctx = new Circom_CalcWit(circuit);
-
-    loadJsonImpl(ctx, zkin);
     if (ctx->getRemaingInputsToBeSet() != 0)
     {
       zklog.error("Prover::genBatchProof() Not all inputs have been set. Only " + to_string(get_main_input_signal_no() - ctx->getRemaingInputsToBeSet()) + " out of " + to_string(get_main_input_signal_no()));
       exitProcess();
     }
-    TimerStopAndLog(CIRCOM_LOAD_JSON_BATCH_PROOF);
+
     //-------------------------------------------
     // Compute witness and commited pols
     //-------------------------------------------
@@ -392,8 +447,33 @@ namespace Circom
       }
     }
     delete[] tmp;
-    freeCircuit(circuit);
     TimerStopAndLog(STARK_WITNESS_AND_COMMITED_POLS_BATCH_PROOF);
   }
 
+  void getCommitedPols(CommitPolsStarks *commitPols, Circom_Circuit *circuit, const std::string execFile, nlohmann::json &zkin, uint64_t N, uint64_t nCols)
+  {
+    //-------------------------------------------
+    // Verifier stark proof
+    //-------------------------------------------
+    TimerStart(CIRCOM_LOAD_JSON_BATCH_PROOF);
+    Circom_CalcWit *ctx = new Circom_CalcWit(circuit);
+    loadJsonImpl(ctx, zkin);
+    TimerStopAndLog(CIRCOM_LOAD_JSON_BATCH_PROOF);
+
+    calculateCommitedPols(commitPols, ctx, execFile, N, nCols);
+  }
+
+  void getCommitedPols(CommitPolsStarks *commitPols, Circom_Circuit *circuit, const std::string execFile, ZkinStark &zkin, uint64_t N, uint64_t nCols)
+  {
+    //-------------------------------------------
+    // Verifier stark proof
+    //-------------------------------------------
+    TimerStart(CIRCOM_LOAD_ZKIN_BATCH_PROOF);
+    Circom_CalcWit *ctx = new Circom_CalcWit(circuit);
+    loadZkinImpl(ctx, zkin);
+    TimerStopAndLog(CIRCOM_LOAD_ZKIN_BATCH_PROOF);
+
+    calculateCommitedPols(commitPols, ctx, execFile, N, nCols);
+  }
+
 }
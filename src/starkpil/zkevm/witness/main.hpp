@@ -11,6 +11,7 @@
 #include <iostream>
 #include <unistd.h>
 #include "commit_pols_starks.hpp"
+#include "zkinStark.hpp"
 using namespace std;
 
 namespace Circom
@@ -19,9 +20,11 @@ namespace Circom
     void freeCircuit(Circom_Circuit *circuit);
     void loadJson(Circom_CalcWit *ctx, std::string filename);
     void loadJsonImpl(Circom_CalcWit *ctx, json &j);
+    void loadZkinImpl(Circom_CalcWit *ctx, ZkinStark &zkin);
     void writeBinWitness(Circom_CalcWit *ctx, std::string wtnsFileName);
     void getBinWitness(Circom_CalcWit *ctx, FrGElement *&pWitness, uint64_t &witnessSize);
-    void getCommitedPols(CommitPolsStarks *commitPols, const std::string zkevmVerifier, const std::string execFile, nlohmann::json &zkin, uint64_t N, uint64_t nCols);
+    void getCommitedPols(CommitPolsStarks *commitPols, Circom_Circuit *circuit, const std::string execFile, nlohmann::json &zkin, uint64_t N, uint64_t nCols);
+    void getCommitedPols(CommitPolsStarks *commitPols, Circom_Circuit *circuit, const std::string execFile, ZkinStark &zkin, uint64_t N, uint64_t nCols);
     bool check_valid_number(std::string &s, uint base);
 
 }
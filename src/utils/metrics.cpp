@@ -0,0 +1,325 @@
+#include <cmath>
+#include "metrics.hpp"
+#include "zklog.hpp"
+#include "exit_process.hpp"
+
+Metrics metrics;
+
+thread_local MetricsShard * pMetricsShard = NULL;
+
+// Releases the shard of the current thread when it finishes
+class MetricsShardReleaser
+{
+public:
+    MetricsShard * pShard;
+    MetricsShardReleaser () : pShard(NULL) {};
+    ~MetricsShardReleaser ()
+    {
+        if (pShard != NULL)
+        {
+            pMetricsShard = NULL;
+            metrics.releaseShard(pShard);
+        }
+    }
+};
+
+thread_local MetricsShardReleaser metricsShardReleaser;
+
+MetricsHistogram::MetricsHistogram () : count(0), sum(0), max(0)
+{
+    for (uint64_t i=0; i<METRICS_HISTOGRAM_BUCKETS; i++)
+    {
+        buckets[i] = 0;
+    }
+}
+
+uint64_t MetricsHistogram::getBucketLowestValue (uint64_t bucket)
+{
+    if (bucket < 2*METRICS_HISTOGRAM_SUB_BUCKETS)
+    {
+        return bucket;
+    }
+    uint64_t shift = bucket/METRICS_HISTOGRAM_SUB_BUCKETS - 1;
+    return (bucket - shift*METRICS_HISTOGRAM_SUB_BUCKETS) << shift;
+}
+
+MetricsShard::MetricsShard ()
+{
+    for (uint64_t i=0; i<METRICS_MAX_COUNTERS; i++)
+    {
+        counters[i] = 0;
+    }
+    for (uint64_t i=0; i<METRICS_MAX_HISTOGRAMS; i++)
+    {
+        histograms[i] = NULL;
+    }
+}
+
+Metrics::Metrics () : nCounters(0), nGauges(0), nHistograms(0)
+{
+    pthread_mutex_init(&mutex, NULL);
+    for (uint64_t i=0; i<METRICS_MAX_GAUGES; i++)
+    {
+        gauges[i] = 0;
+    }
+}
+
+uint64_t Metrics::registerMetric (MetricType type, const string &name, const string &labels, const string &help)
+{
+    Lock();
+
+    // Return the already registered metric, if any
+    string key = to_string(type) + ":" + name + "{" + labels + "}";
+    unordered_map<string, uint64_t>::const_iterator it = descriptorsMap.find(key);
+    if (it != descriptorsMap.end())
+    {
+        uint64_t id = descriptors[it->second].id;
+        Unlock();
+        return id;
+    }
+
+    // Get the next id of this type
+    MetricDescriptor descriptor;
+    descriptor.type = type;
+    descriptor.name = name;
+    descriptor.labels = labels;
+    descriptor.help = help;
+    switch (type)
+    {
+        case metricCounter:
+            descriptor.id = nCounters++;
+            if (nCounters > METRICS_MAX_COUNTERS)
+            {
+                zklog.error("Metrics::registerMetric() reached METRICS_MAX_COUNTERS=" + to_string(METRICS_MAX_COUNTERS) + " name=" + name);
+                exitProcess();
+            }
+            break;
+        case metricGauge:
+            descriptor.id = nGauges++;
+            if (nGauges > METRICS_MAX_GAUGES)
+            {
+                zklog.error("Metrics::registerMetric() reached METRICS_MAX_GAUGES=" + to_string(METRICS_MAX_GAUGES) + " name=" + name);
+                exitProcess();
+            }
+            break;
+        case metricHistogram:
+            descriptor.id = nHistograms++;
+            if (nHistograms > METRICS_MAX_HISTOGRAMS)
+            {
+                zklog.error("Metrics::registerMetric() reached METRICS_MAX_HISTOGRAMS=" + to_string(METRICS_MAX_HISTOGRAMS) + " name=" + name);
+                exitProcess();
+            }
+            break;
+        default:
+            zklog.error("Metrics::registerMetric() got invalid type=" + to_string(type) + " name=" + name);
+            exitProcess();
+    }
+    descriptorsMap[key] = descriptors.size();
+    descriptors.emplace_back(descriptor);
+
+    Unlock();
+    return descriptor.id;
+}
+
+MetricsShard * Metrics::allocateShard (void)
+{
+    Lock();
+
+    // Reuse the shard of a finished thread, keeping its values, or create a new one
+    MetricsShard * pShard;
+    if (!freeShards.empty())
+    {
+        pShard = freeShards.back();
+        freeShards.pop_back();
+    }
+    else
+    {
+        pShard = new MetricsShard();
+        shards.emplace_back(pShard);
+    }
+
+    Unlock();
+
+    pMetricsShard = pShard;
+    metricsShardReleaser.pShard = pShard;
+    return pShard;
+}
+
+MetricsHistogram * Metrics::allocateHistogram (uint64_t id)
+{
+    MetricsHistogram * pHistogram = new MetricsHistogram();
+    pMetricsShard->histograms[id].store(pHistogram, memory_order_release);
+    return pHistogram;
+}
+
+void Metrics::releaseShard (MetricsShard * pShard)
+{
+    Lock();
+    freeShards.emplace_back(pShard);
+    Unlock();
+}
+
+void Metrics::addCollector (MetricsCollector collector, void * pArg)
+{
+    Lock();
+    for (uint64_t i=0; i<collectors.size(); i++)
+    {
+        if ((collectors[i].collector == collector) && (collectors[i].pArg == pArg))
+        {
+            Unlock();
+            return;
+        }
+    }
+    CollectorEntry entry;
+    entry.collector = collector;
+    entry.pArg = pArg;
+    collectors.emplace_back(entry);
+    Unlock();
+}
+
+void Metrics::removeCollector (MetricsCollector collector, void * pArg)
+{
+    Lock();
+    for (uint64_t i=0; i<collectors.size(); i++)
+    {
+        if ((collectors[i].collector == collector) && (collectors[i].pArg == pArg))
+        {
+            collectors.erase(collectors.begin() + i);
+            break;
+        }
+    }
+    Unlock();
+}
+
+uint64_t Metrics::getCounter (uint64_t counter)
+{
+    uint64_t value = 0;
+    Lock();
+    for (uint64_t i=0; i<shards.size(); i++)
+    {
+        value += shards[i]->counters[counter].load(memory_order_relaxed);
+    }
+    Unlock();
+    return value;
+}
+
+void Metrics::getHistogram (uint64_t histogram, vector<uint64_t> &buckets, uint64_t &count, uint64_t &sum, uint64_t &max)
+{
+    buckets.assign(METRICS_HISTOGRAM_BUCKETS, 0);
+    count = 0;
+    sum = 0;
+    max = 0;
+    Lock();
+    for (uint64_t i=0; i<shards.size(); i++)
+    {
+        MetricsHistogram * pHistogram = shards[i]->histograms[histogram].load(memory_order_acquire);
+        if (pHistogram == NULL)
+        {
+            continue;
+        }
+        for (uint64_t b=0; b<METRICS_HISTOGRAM_BUCKETS; b++)
+        {
+            buckets[b] += pHistogram->buckets[b].load(memory_order_relaxed);
+        }
+        count += pHistogram->count.load(memory_order_relaxed);
+        sum += pHistogram->sum.load(memory_order_relaxed);
+        uint64_t shardMax = pHistogram->max.load(memory_order_relaxed);
+        if (shardMax > max)
+        {
+            max = shardMax;
+        }
+    }
+    Unlock();
+}
+
+uint64_t Metrics::getQuantile (const vector<uint64_t> &buckets, uint64_t count, uint64_t max, double quantile)
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    // Find the bucket of the nearest-rank value
+    uint64_t rank = ceil(quantile*count);
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+    uint64_t accumulated = 0;
+    for (uint64_t b=0; b<buckets.size(); b++)
+    {
+        accumulated += buckets[b];
+        if (accumulated >= rank)
+        {
+            uint64_t highestValue = (b + 1 < METRICS_HISTOGRAM_BUCKETS) ? MetricsHistogram::getBucketLowestValue(b + 1) - 1 : UINT64_MAX;
+            return (highestValue < max) ? highestValue : max;
+        }
+    }
+    return max;
+}
+
+void Metrics::scrape (string &output)
+{
+    // Call the collectors, so that they update their gauges
+    Lock();
+    vector<CollectorEntry> collectorsCopy = collectors;
+    vector<MetricDescriptor> descriptorsCopy = descriptors;
+    Unlock();
+    for (uint64_t i=0; i<collectorsCopy.size(); i++)
+    {
+        collectorsCopy[i].collector(collectorsCopy[i].pArg);
+    }
+
+    // Export the metrics, grouping the ones with the same name under the same type line
+    output.clear();
+    unordered_map<string, bool> exportedNames;
+    vector<uint64_t> buckets;
+    for (uint64_t i=0; i<descriptorsCopy.size(); i++)
+    {
+        const MetricDescriptor &descriptor = descriptorsCopy[i];
+        if (exportedNames.find(descriptor.name) != exportedNames.end())
+        {
+            continue;
+        }
+        exportedNames[descriptor.name] = true;
+
+        if (!descriptor.help.empty())
+        {
+            output += "# HELP " + descriptor.name + " " + descriptor.help + "\n";
+        }
+        output += "# TYPE " + descriptor.name + " " + string((descriptor.type == metricCounter) ? "counter" : (descriptor.type == metricGauge) ? "gauge" : "summary") + "\n";
+
+        for (uint64_t j=i; j<descriptorsCopy.size(); j++)
+        {
+            const MetricDescriptor &d = descriptorsCopy[j];
+            if (d.name != descriptor.name)
+            {
+                continue;
+            }
+            string labels = d.labels.empty() ? "" : "{" + d.labels + "}";
+            switch (d.type)
+            {
+                case metricCounter:
+                    output += d.name + labels + " " + to_string(getCounter(d.id)) + "\n";
+                    break;
+                case metricGauge:
+                    output += d.name + labels + " " + to_string(getGauge(d.id)) + "\n";
+                    break;
+                case metricHistogram:
+                {
+                    uint64_t count, sum, max;
+                    getHistogram(d.id, buckets, count, sum, max);
+                    const double quantiles[] = {0.5, 0.9, 0.99, 0.999, 1};
+                    const char * quantileLabels[] = {"0.5", "0.9", "0.99", "0.999", "1"};
+                    for (uint64_t q=0; q<5; q++)
+                    {
+                        output += d.name + "{" + d.labels + (d.labels.empty() ? "" : ",") + "quantile=\"" + quantileLabels[q] + "\"} " + to_string(getQuantile(buckets, count, max, quantiles[q])) + "\n";
+                    }
+                    output += d.name + "_sum" + labels + " " + to_string(sum) + "\n";
+                    output += d.name + "_count" + labels + " " + to_string(count) + "\n";
+                    break;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,174 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <unordered_map>
+#include <pthread.h>
+
+using namespace std;
+
+/*
+    Registry of performance metrics, exported in Prometheus text format:
+    - counters and histograms are recorded by every thread into its own shard, without locks nor shared cache lines,
+      and merged when scraped
+    - gauges are global atomic values, set by the code or by the collectors called before every scrape
+    - histograms use log-linear buckets (HDR-like), with METRICS_HISTOGRAM_SUB_BUCKET_BITS bits of precision, i.e. a
+      relative error below 1/2^METRICS_HISTOGRAM_SUB_BUCKET_BITS, and are exported as summaries with quantiles
+    Metrics are registered once by name and labels, and then recorded by id
+*/
+
+#define METRICS_MAX_COUNTERS 256
+#define METRICS_MAX_GAUGES 256
+#define METRICS_MAX_HISTOGRAMS 512
+#define METRICS_HISTOGRAM_SUB_BUCKET_BITS 4
+#define METRICS_HISTOGRAM_SUB_BUCKETS (1 << METRICS_HISTOGRAM_SUB_BUCKET_BITS)
+#define METRICS_HISTOGRAM_BUCKETS ((64 - METRICS_HISTOGRAM_SUB_BUCKET_BITS + 1)*METRICS_HISTOGRAM_SUB_BUCKETS)
+
+class MetricsHistogram
+{
+public:
+    atomic<uint64_t> buckets[METRICS_HISTOGRAM_BUCKETS];
+    atomic<uint64_t> count;
+    atomic<uint64_t> sum;
+    atomic<uint64_t> max;
+    MetricsHistogram ();
+
+    // Returns the bucket of a value, and the lowest value of a bucket
+    static inline uint64_t getBucket (uint64_t value)
+    {
+        if (value < 2*METRICS_HISTOGRAM_SUB_BUCKETS)
+        {
+            return value;
+        }
+        uint64_t msb = 63 - __builtin_clzll(value);
+        uint64_t shift = msb - METRICS_HISTOGRAM_SUB_BUCKET_BITS;
+        return (shift + 1)*METRICS_HISTOGRAM_SUB_BUCKETS + (value >> shift) - METRICS_HISTOGRAM_SUB_BUCKETS;
+    }
+    static uint64_t getBucketLowestValue (uint64_t bucket);
+};
+
+// Metrics recorded by one thread; only the owner thread writes them, so increments do not need atomic operations
+class MetricsShard
+{
+public:
+    atomic<uint64_t> counters[METRICS_MAX_COUNTERS];
+    atomic<MetricsHistogram *> histograms[METRICS_MAX_HISTOGRAMS]; // Allocated the first time they are recorded
+    MetricsShard ();
+};
+
+// Shard of the current thread, or NULL if it did not record anything yet
+extern thread_local MetricsShard * pMetricsShard;
+
+// Collector called before every scrape, typically to set gauges from the state of an object
+typedef void (*MetricsCollector)(void * pArg);
+
+class Metrics
+{
+public:
+    enum MetricType
+    {
+        metricCounter = 0,
+        metricGauge = 1,
+        metricHistogram = 2
+    };
+
+private:
+    class MetricDescriptor
+    {
+    public:
+        MetricType type;
+        string name;
+        string labels; // e.g. sm="arith",fork="9"
+        string help;
+        uint64_t id; // Index in the counters, gauges or histograms arrays
+    };
+    class CollectorEntry
+    {
+    public:
+        MetricsCollector collector;
+        void * pArg;
+    };
+
+    pthread_mutex_t mutex; // Mutex to protect the registry, the shards list and the collectors
+    void Lock(void) { pthread_mutex_lock(&mutex); };
+    void Unlock(void) { pthread_mutex_unlock(&mutex); };
+
+    vector<MetricDescriptor> descriptors; // In registration order
+    unordered_map<string, uint64_t> descriptorsMap; // Index in descriptors, by type, name and labels
+    uint64_t nCounters;
+    uint64_t nGauges;
+    uint64_t nHistograms;
+    atomic<int64_t> gauges[METRICS_MAX_GAUGES];
+    vector<MetricsShard *> shards; // All the shards, ever allocated
+    vector<MetricsShard *> freeShards; // Shards of finished threads, to be reused by new threads
+    vector<CollectorEntry> collectors;
+
+    uint64_t registerMetric (MetricType type, const string &name, const string &labels, const string &help);
+    MetricsShard * allocateShard (void);
+    MetricsHistogram * allocateHistogram (uint64_t id);
+
+public:
+    Metrics (); // Shards are never freed, since threads can record metrics until the process exits
+
+    // Registers a metric, or returns the id of an already registered one with the same name and labels
+    uint64_t registerCounter (const string &name, const string &labels = "", const string &help = "") { return registerMetric(metricCounter, name, labels, help); };
+    uint64_t registerGauge (const string &name, const string &labels = "", const string &help = "") { return registerMetric(metricGauge, name, labels, help); };
+    uint64_t registerHistogram (const string &name, const string &labels = "", const string &help = "") { return registerMetric(metricHistogram, name, labels, help); };
+
+    // Records a metric value, by id
+    inline void add (uint64_t counter, uint64_t value = 1)
+    {
+        MetricsShard * pShard = (pMetricsShard != NULL) ? pMetricsShard : allocateShard();
+        pShard->counters[counter].store(pShard->counters[counter].load(memory_order_relaxed) + value, memory_order_relaxed);
+    }
+    inline void set (uint64_t gauge, int64_t value)
+    {
+        gauges[gauge].store(value, memory_order_relaxed);
+    }
+    inline void addGauge (uint64_t gauge, int64_t value)
+    {
+        gauges[gauge].fetch_add(value, memory_order_relaxed);
+    }
+    inline void observe (uint64_t histogram, uint64_t value)
+    {
+        MetricsShard * pShard = (pMetricsShard != NULL) ? pMetricsShard : allocateShard();
+        MetricsHistogram * pHistogram = pShard->histograms[histogram].load(memory_order_relaxed);
+        if (pHistogram == NULL)
+        {
+            pHistogram = allocateHistogram(histogram);
+        }
+        atomic<uint64_t> &bucket = pHistogram->buckets[MetricsHistogram::getBucket(value)];
+        bucket.store(bucket.load(memory_order_relaxed) + 1, memory_order_relaxed);
+        pHistogram->count.store(pHistogram->count.load(memory_order_relaxed) + 1, memory_order_relaxed);
+        pHistogram->sum.store(pHistogram->sum.load(memory_order_relaxed) + value, memory_order_relaxed);
+        if (value > pHistogram->max.load(memory_order_relaxed))
+        {
+            pHistogram->max.store(value, memory_order_relaxed);
+        }
+    }
+
+    // Collectors are called before every scrape; adding the same collector and argument twice has no effect
+    void addCollector (MetricsCollector collector, void * pArg);
+    void removeCollector (MetricsCollector collector, void * pArg);
+
+    // Merges the values of all threads
+    uint64_t getCounter (uint64_t counter);
+    int64_t getGauge (uint64_t gauge) { return gauges[gauge].load(memory_order_relaxed); };
+    void getHistogram (uint64_t histogram, vector<uint64_t> &buckets, uint64_t &count, uint64_t &sum, uint64_t &max);
+
+    // Returns the value of a quantile (0 to 1) of a merged histogram, as the highest value of its bucket
+    static uint64_t getQuantile (const vector<uint64_t> &buckets, uint64_t count, uint64_t max, double quantile);
+
+    // Calls the collectors, and returns all the metrics in Prometheus text format
+    void scrape (string &output);
+
+    // Called when a thread finishes, to make its shard available to new threads
+    void releaseShard (MetricsShard * pShard);
+};
+
+extern Metrics metrics;
+
+#endif
@@ -6,180 +6,43 @@ using namespace std;
 
 bool rlp::decodeLength (const string &input, uint64_t &p, uint64_t &length, bool &list)
 {
-    // Read the first byte, prefix
-    if (p > input.size())
+    if (!rlp::decodeLength(string_view(input), p, length, list))
     {
-        zklog.error("rlp::decodeLength() run out of data");
+        zklog.error("rlp::decodeLength() failed p=" + to_string(p) + " input.size=" + to_string(input.size()));
         return false;
     }
-    uint8_t prefix = input[p];
-
-    // The first byte is the data itself
-    if (prefix <= 0x7f)
-    {
-        length = 1;
-        list = false;
-        return true;
-    }
-
-    // Take length from first byte
-    if (prefix <= 0xb7)
-    {
-        length = prefix - 0x80;
-        p++;
-        if ((p + length) > input.size())
-        {
-            zklog.error("rlp::decodeLength() run out of data");
-            return false;
-        }
-        list = false;
-        return true;
-    }
-
-    // Take the length of the length from first byte
-    if (prefix <= 0xbf)
-    {
-        uint64_t lengthOfLength = prefix - 0xb7;
-        p++;
-        if (lengthOfLength > 8)
-        {
-            zklog.error("rlp::decodeLength() invalid length of length=" + to_string(lengthOfLength));
-            return false;
-        }
-        if (p + lengthOfLength > input.size())
-        {
-            zklog.error("rlp::decodeLength() run out of data");
-            return false;
-        }
-        length = 0;
-        for (uint64_t i = 0; i < lengthOfLength; i++)
-        {
-            uint8_t d = input[p];
-            p++;
-            length <<= 8;
-            length += d;
-        }
-        list = false;
-        return true;
-    }
-
-    // Take list length from first byte
-    if (prefix <= 0xf7)
-    {
-        length = prefix - 0xc0;
-        p++;
-        if ((p + length) > input.size())
-        {
-            zklog.error("rlp::decodeLength() run out of data");
-            return false;
-        }
-        list = true;
-        return true;
-    }
-
-    // Take the length of the length from first byte (list)
-    {
-        uint64_t lengthOfLength = prefix - 0xf7;
-        p++;
-        if (lengthOfLength > 8)
-        {
-            zklog.error("rlp::decodeLength() invalid length of length=" + to_string(lengthOfLength));
-            return false;
-        }
-        if (p + lengthOfLength > input.size())
-        {
-            zklog.error("rlp::decodeLength() run out of data");
-            return false;
-        }
-        length = 0;
-        for (uint64_t i = 0; i < lengthOfLength; i++)
-        {
-            uint8_t d = input[p];
-            p++;
-            length <<= 8;
-            length += d;
-        }
-        list = true;
-        return true;
-    }
+    return true;
 }
 
 bool rlp::decodeBa (const string &input, uint64_t &p, string &output, bool &list)
 {
-    // Check the counter
-    if (p > input.size())
-    {
-        zklog.error("rlp::decodeBa() run out of data");
-        return false;
-    }
-
     // Clear the output
     output.clear();
 
-    // Decode the length
-    uint64_t length;
-    bool bResult;
-    bResult = rlp::decodeLength(input, p, length, list);
-    if (!bResult)
+    // Decode the byte array, and copy it
+    string_view ba;
+    if (!rlp::decodeBa(string_view(input), p, ba, list))
     {
-        zklog.error("rlp::decodeBa() failed calling rlp::decodeLength() p=" + to_string(p));
-        return false;        
+        zklog.error("rlp::decodeBa() failed p=" + to_string(p) + " input.size=" + to_string(input.size()));
+        return false;
     }
-
-    // Copy the byte array
-    output = input.substr(p, length);
-    p += length;
+    output = ba;
 
     return true;
 }
 
 bool rlp::decodeList (const string &input, std::vector<string> &output)
 {
-    // Decode the list length
-    bool bResult;
-    bool list;
-    uint64_t p=0;
-    uint64_t length;
-    bResult = decodeLength(input, p, length, list);
-    if (!bResult)
+    // Decode the list, and copy its byte arrays
+    std::vector<string_view> list;
+    if (!rlp::decodeList(string_view(input), list))
     {
-        zklog.error("rlp::decodeList() failed calling rlp::decodeLength() p=" + to_string(p));
+        zklog.error("rlp::decodeList() failed input.size=" + to_string(input.size()));
         return false;
     }
-    if (!list)
+    for (uint64_t i=0; i<list.size(); i++)
     {
-        zklog.error("rlp::decodeList() called rlp::decodeLength() but list=false p=" + to_string(p));
-        return false;
-    }
-    if ((p + length) != input.size())
-    {
-        zklog.error("rlp::decodeList() called rlp::decodeLength() but length=" + to_string(length) + " input.size=" + to_string(input.size()) + " p=" + to_string(p) + " and p + length != input.size");
-        return false;
-    }
-
-    // Decode the list raw data content searching for byte arrays
-    while (p < input.size())
-    {
-        string ba;
-        bResult = decodeBa(input, p, ba, list);
-        if (!bResult)
-        {
-            zklog.error("rlp::decodeList() failed calling rlp::decodeBa() p=" + to_string(p));
-            return false;
-        }
-        if (list)
-        {
-            zklog.error("rlp::decodeList() called rlp::decodeBa() but list=false p=" + to_string(p));
-            return false;
-        }
-        output.push_back(ba);
-    }
-
-    // Check the counter
-    if (p != input.size())
-    {
-        zklog.error("rlp::decodeList() finished with input.size=" + to_string(input.size()) + " p=" + to_string(p) + " and p != input.size");
-        return false;
+        output.emplace_back(list[i]);
     }
 
     return true;
@@ -305,4 +168,139 @@ bool rlp::encodeList (const std::vector<string> &input, string &output)
     output += list;
     
     return true;
-}
\ No newline at end of file
+}
+bool rlp::decodeLength (string_view input, uint64_t &p, uint64_t &length, bool &list)
+{
+    // Read the first byte, prefix
+    if (p >= input.size())
+    {
+        return false;
+    }
+    uint8_t prefix = input[p];
+
+    // The first byte is the data itself
+    if (prefix <= 0x7f)
+    {
+        length = 1;
+        list = false;
+        return true;
+    }
+    p++;
+
+    // Take length from first byte
+    if ((prefix <= 0xb7) || ((prefix >= 0xc0) && (prefix <= 0xf7)))
+    {
+        list = (prefix >= 0xc0);
+        length = prefix - (list ? 0xc0 : 0x80);
+    }
+
+    // Take the length of the length from first byte
+    else
+    {
+        list = (prefix >= 0xc0);
+        uint64_t lengthOfLength = prefix - (list ? 0xf7 : 0xb7);
+        if ((lengthOfLength > 8) || (lengthOfLength > input.size() - p))
+        {
+            return false;
+        }
+        length = 0;
+        for (uint64_t i = 0; i < lengthOfLength; i++)
+        {
+            length <<= 8;
+            length += (uint8_t)input[p];
+            p++;
+        }
+    }
+
+    // Check that the data is available
+    if (length > input.size() - p)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool rlp::decodeBa (string_view input, uint64_t &p, string_view &output, bool &list)
+{
+    // Decode the length
+    uint64_t length;
+    if (!rlp::decodeLength(input, p, length, list))
+    {
+        return false;
+    }
+
+    // Point to the byte array
+    output = input.substr(p, length);
+    p += length;
+
+    return true;
+}
+
+bool rlp::decodeList (string_view input, std::vector<string_view> &output)
+{
+    // Decode the list length
+    bool list;
+    uint64_t p=0;
+    uint64_t length;
+    if (!decodeLength(input, p, length, list) || !list || (length != input.size() - p))
+    {
+        return false;
+    }
+
+    // Decode the list raw data content searching for byte arrays
+    output.clear();
+    while (p < input.size())
+    {
+        string_view ba;
+        if (!decodeBa(input, p, ba, list) || list)
+        {
+            return false;
+        }
+        output.push_back(ba);
+    }
+
+    return true;
+}
+
+bool rlp::encodeList (const std::vector<string_view> &input, string &output)
+{
+    // Calculate the length of the list raw data, to encode it before the byte arrays without an intermediate copy
+    uint64_t listLength = 0;
+    for (uint64_t i=0; i<input.size(); i++)
+    {
+        if ((input[i].size() == 1) && ((uint8_t)input[i][0] < 0x80))
+        {
+            listLength += 1;
+            continue;
+        }
+        string header;
+        if (!encodeLength(input[i].size(), false, header))
+        {
+            zklog.error("rlp::encodeList() failed calling encodeLength()");
+            return false;
+        }
+        listLength += header.size() + input[i].size();
+    }
+
+    // Encode the length of the list raw data
+    if (!encodeLength(listLength, true, output))
+    {
+        zklog.error("rlp::encodeList() failed calling encodeLength()");
+        return false;
+    }
+
+    // Encode and concatenate all byte arrays
+    for (uint64_t i=0; i<input.size(); i++)
+    {
+        if ((input[i].size() == 1) && ((uint8_t)input[i][0] < 0x80))
+        {
+            output += input[i];
+            continue;
+        }
+        encodeLength(input[i].size(), false, output);
+        output += input[i];
+    }
+
+    return true;
+}
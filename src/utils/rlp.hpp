@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <gmp.h>
 #include <gmpxx.h>
@@ -153,5 +154,12 @@ bool encodeLength (uint64_t length, bool list, string &output);
 bool encodeBa     (const string &input, string &output);
 bool encodeList   (const std::vector<string> &input, string &output);
 
+// Zero-copy versions, used by the ones above: the decoded byte arrays are spans of the input buffer, so the input
+// must outlive them; they do not log errors, since they parse untrusted request data, and their callers report it
+bool decodeLength (string_view input, uint64_t &p, uint64_t &length, bool &list);
+bool decodeBa     (string_view input, uint64_t &p, string_view &output, bool &list);
+bool decodeList   (string_view input, std::vector<string_view> &output);
+bool encodeList   (const std::vector<string_view> &input, string &output); // Appends the encoded list to output
+
 }
 #endif
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include "scalar.hpp"
 #include "XKCP/Keccak-more-compact.hpp"
+#include "XKCP/Keccak-multi.hpp"
 #include "config.hpp"
 #include "utils.hpp"
 #include "zklog.hpp"
@@ -336,13 +337,17 @@ string keccak256 (const uint8_t *pInputData, uint64_t inputDataSize)
 
 void keccak256 (const vector<uint8_t> &input, mpz_class &hash)
 {
-    string baString;
-    uint64_t inputSize = input.size();
-    for (uint64_t i=0; i<inputSize; i++)
+    keccak256(input.data(), input.size(), hash);
+}
+
+void keccak256 (uint64_t n, const uint8_t * const * pInputs, const uint64_t * pInputSizes, mpz_class * const * pHashes)
+{
+    vector<uint8_t> hashes(n*32);
+    Keccak256Multi(n, pInputs, pInputSizes, (uint8_t (*)[32])hashes.data());
+    for (uint64_t i=0; i<n; i++)
     {
-        baString.push_back(input[i]);
+        ba2scalar(hashes.data() + i*32, 32, *pHashes[i]);
     }
-    keccak256((uint8_t *)baString.c_str(), baString.size(), hash);
 }
 
 /* Byte to/from char conversion */
@@ -375,6 +375,9 @@ void   keccak256 (const uint8_t *pInputData, uint64_t inputDataSize, mpz_class &
 string keccak256 (const uint8_t *pInputData, uint64_t inputDataSize);
 void   keccak256 (const vector<uint8_t> &input, mpz_class &hash);
 
+// Computes the keccak digests of n independent inputs in one call, hashing several of them in parallel with SIMD
+void   keccak256 (uint64_t n, const uint8_t * const * pInputs, const uint64_t * pInputSizes, mpz_class * const * pHashes);
+
 /* Byte to/from char conversion */
 uint8_t char2byte (char c);
 char    byte2char (uint8_t b);
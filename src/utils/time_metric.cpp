@@ -25,6 +25,27 @@ void TimeMetricStorage::add(string &key, uint64_t time, uint64_t times)
 
     unlock();
 }
+
+void TimeMetricStorage::add(TimeMetricStorage &other)
+{
+    // Copy the other metrics first, so that both locks are never held at the same time
+    other.lock();
+    unordered_map<string, TimeMetric> otherMap = other.map;
+    other.unlock();
+
+    lock();
+
+    unordered_map<string, TimeMetric>::iterator it;
+    for (it = otherMap.begin(); it != otherMap.end(); it++)
+    {
+        TimeMetric &tm = map[it->first];
+        tm.time  += it->second.time;
+        tm.times += it->second.times;
+    }
+
+    unlock();
+}
+
 void TimeMetricStorage::print(const char * pTitle, uint64_t padding)
 {
     lock();
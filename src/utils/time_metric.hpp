@@ -45,6 +45,7 @@ public:
     }
     
     void add   (string &key, uint64_t time, uint64_t times=1);
+    void add   (TimeMetricStorage &other); // Accumulates all the metrics of another storage
     void print (const char * pTitle, uint64_t padding = 32);
     void clear (void);
 };
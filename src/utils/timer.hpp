@@ -6,6 +6,7 @@
 #include <string>
 #include "definitions.hpp"
 #include "zklog.hpp"
+#include "metrics.hpp"
 
 // Returns the time difference in us
 uint64_t TimeDiff(const struct timeval &startTime, const struct timeval &endTime);
@@ -18,7 +19,8 @@ std::string DateAndTime(struct timeval &tv);
 #define TimerStart(name) struct timeval name##_start; gettimeofday(&name##_start,NULL); zklog.info("--> " + string(#name) + " starting...")
 #define TimerStop(name) struct timeval name##_stop; gettimeofday(&name##_stop,NULL); zklog.info("<-- " + string(#name) + " done")
 #define TimerLog(name) zklog.info(string(#name) + ": " _ to_string(double(TimeDiff(name##_start, name##_stop))/1000000) + " s")
-#define TimerStopAndLog(name) struct timeval name##_stop; gettimeofday(&name##_stop,NULL); zklog.info("<-- " + string(#name) + " done: " + to_string(double(TimeDiff(name##_start, name##_stop))/1000000) + " s")
+// TimerStopAndLog also records the time into the zkprover_timer_us metric histogram, labeled with the timer name
+#define TimerStopAndLog(name) struct timeval name##_stop; gettimeofday(&name##_stop,NULL); zklog.info("<-- " + string(#name) + " done: " + to_string(double(TimeDiff(name##_start, name##_stop))/1000000) + " s"); static uint64_t name##_metric = metrics.registerHistogram("zkprover_timer_us", "name=\"" #name "\"", "Time spent in the timed code sections, in us"); metrics.observe(name##_metric, TimeDiff(name##_start, name##_stop))
 #else
 #define TimerStart(name)
 #define TimerStop(name)
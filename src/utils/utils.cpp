@@ -674,18 +674,14 @@ void getStringIncrement(const string &oldString, const string &newString, uint64
 
 string emptyString;
 
-void poseidonLinearHash (const vector<uint8_t> &_data, Goldilocks::Element (&result)[4])
+void poseidonLinearHash (const vector<uint8_t> &data, Goldilocks::Element (&result)[4])
 {
-    // Get a local copy of the bytes vector
-    vector<uint8_t> data = _data;
-
-    // Add padding = 0b1000...00001  up to a length of 56xN (7x8xN)
-    data.push_back(0x01);
-    while((data.size() % 56) != 0) data.push_back(0);
-    data[data.size()-1] |= 0x80;
+    // The data is padded with 0b1000...00001 up to a length of 56xN (7x8xN) bytes
+    uint64_t dataSize = data.size();
+    uint64_t paddedSize = ((dataSize + 1 + 55) / 56) * 56;
 
     // Create a FE buffer to store the transformed bytes into fe
-    uint64_t bufferSize = data.size()/7;
+    uint64_t bufferSize = paddedSize/7;
     Goldilocks::Element * pBuffer = new Goldilocks::Element[bufferSize];
     if (pBuffer == NULL)
     {
@@ -693,15 +689,28 @@ void poseidonLinearHash (const vector<uint8_t> &_data, Goldilocks::Element (&res
         exitProcess();
     }
 
-    // Init to zero
-    for (uint64_t j=0; j<bufferSize; j++) pBuffer[j] = fr.zero();
-
-    // Copy the bytes into the fe lower 7 sections
-    for (uint64_t j=0; j<data.size(); j++)
+    // Copy the bytes into the fe lower 7 sections, little endian, adding the padding without copying the data
+    uint64_t fullElements = dataSize/7;
+    for (uint64_t j=0; j<fullElements; j++)
+    {
+        uint64_t value = 0;
+        memcpy(&value, data.data() + j*7, 7);
+        pBuffer[j] = fr.fromU64(value);
+    }
+    for (uint64_t j=fullElements; j<bufferSize; j++)
     {
-        uint64_t fePos = j/7;
-        uint64_t shifted = uint64_t(data[j]) << ((j%7)*8);
-        pBuffer[fePos] = fr.add(pBuffer[fePos], fr.fromU64(shifted));
+        uint64_t value = 0;
+        for (uint64_t k=0; k<7; k++)
+        {
+            uint64_t position = j*7 + k;
+            uint64_t byte = (position < dataSize) ? data[position] : ((position == dataSize) ? 0x01 : 0);
+            if (position == paddedSize - 1)
+            {
+                byte |= 0x80;
+            }
+            value |= byte << (k*8);
+        }
+        pBuffer[j] = fr.fromU64(value);
     }
 
     // Call poseidon linear hash
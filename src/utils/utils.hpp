@@ -103,6 +103,6 @@ void getStringIncrement (const string &oldString, const string &newString, uint6
 extern string emptyString;
 
 // Calculates the Poseidon linear hash of a buffer
-void poseidonLinearHash (const vector<uint8_t> &_data, Goldilocks::Element (&result)[4]);
+void poseidonLinearHash (const vector<uint8_t> &data, Goldilocks::Element (&result)[4]);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "batch_execution_cache_test.hpp"
+#include "batch_execution_cache.hpp"
+#include "input.hpp"
+#include "zklog.hpp"
+
+// Fills the input of the same batch, as received by any executor or prover request
+void batchExecutionCacheTestInput (Input &input)
+{
+    PublicInputs &publicInputs = input.publicInputsExtended.publicInputs;
+    publicInputs.forkID = 9;
+    publicInputs.oldStateRoot.set_str("1d4a2a8bc0b0e3dd8c67a1ea9d7e4db81d5cb1c2a7fb0e5ed0f8a1e3d2c4b5a6", 16);
+    publicInputs.chainID = 1000;
+    publicInputs.batchL2Data = string("\x0b\x00\x00\x00\x7b\x00\x00\x00\x01\xee\x80\x84\x3b\x9a\xca\x00", 16);
+    publicInputs.l1InfoRoot.set_str("090bcaf734c4f06c93954a827b45a6e8c67b8e0fd1e0a35a1c5982d6961828f9", 16);
+    publicInputs.timestampLimit = 1944498031;
+    publicInputs.sequencerAddr.set_str("617b3a3528F9cDd6630fd3301B9c8911F7Bf063D", 16);
+    input.l1InfoTreeData[1].globalExitRoot.set_str("16994edfddddb9480667b64174fc00d3b6da7290d37b8db3a16571b4ddf0789f", 16);
+    input.l1InfoTreeData[1].minTimestamp = 1700000000;
+}
+
+uint64_t BatchExecutionCacheTest (Goldilocks &fr, const Config &config)
+{
+    uint64_t numberOfErrors = 0;
+
+    Config testConfig = config;
+    testConfig.batchExecutionCacheSize = 4;
+    BatchExecutionCache cache;
+    cache.init(testConfig);
+
+    vector<uint8_t> data = {0x01, 0x02, 0x03};
+    mpz_class digest("123456789abcdef", 16);
+    mpz_class cachedDigest;
+
+    // ProcessBatchV2 updates the merkle tree and provides neither the old accumulated input hash nor the batch number
+    Input processBatchInput(fr);
+    batchExecutionCacheTestInput(processBatchInput);
+    processBatchInput.bUpdateMerkleTree = true;
+    BatchExecutionCacheEntry *pEntry = new BatchExecutionCacheEntry(processBatchInput);
+    pEntry->setKeccak(data, digest);
+    pEntry->setPoseidon(data, digest);
+    cache.add(BatchExecutionCache::getKey(processBatchInput), pEntry);
+
+    // GenBatchProof of the same batch does not update the merkle tree, and provides the accumulated input hash
+    Input genBatchProofInput(fr);
+    batchExecutionCacheTestInput(genBatchProofInput);
+    genBatchProofInput.publicInputsExtended.publicInputs.oldAccInputHash.set_str("2b9484b83c6b8a7a4c1b6a7d2ad4bd26b2d6b5b6a2f1d8f7c3d6e2b1a4c3d2e1", 16);
+    genBatchProofInput.publicInputsExtended.publicInputs.oldBatchNum = 122;
+    if (BatchExecutionCache::getKey(genBatchProofInput) != BatchExecutionCache::getKey(processBatchInput))
+    {
+        zklog.error("BatchExecutionCacheTest() got different keys for the process batch and the batch proof requests");
+        numberOfErrors++;
+    }
+
+    // A request that runs without counters cannot reuse an execution that was limited by them, but the entry is kept
+    Input noCountersInput(fr);
+    batchExecutionCacheTestInput(noCountersInput);
+    noCountersInput.bNoCounters = true;
+    if (cache.take(BatchExecutionCache::getKey(noCountersInput), noCountersInput) != NULL)
+    {
+        zklog.error("BatchExecutionCacheTest() took an entry recorded with counters for a request without counters");
+        numberOfErrors++;
+    }
+
+    // A request with a different state override must not find the entry
+    Input stateOverrideInput(fr);
+    batchExecutionCacheTestInput(stateOverrideInput);
+    stateOverrideInput.stateOverride["617b3a3528F9cDd6630fd3301B9c8911F7Bf063D"].nonce = 7;
+    if (cache.take(BatchExecutionCache::getKey(stateOverrideInput), stateOverrideInput) != NULL)
+    {
+        zklog.error("BatchExecutionCacheTest() took an entry recorded without state override for a request with it");
+        numberOfErrors++;
+    }
+
+    // The batch proof request takes the entry, and reuses its results
+    pEntry = cache.take(BatchExecutionCache::getKey(genBatchProofInput), genBatchProofInput);
+    if (pEntry == NULL)
+    {
+        zklog.error("BatchExecutionCacheTest() did not find the entry of the process batch request for the batch proof request");
+        numberOfErrors++;
+    }
+    else
+    {
+        if (pEntry->bRecording || !pEntry->getKeccak(data, cachedDigest) || (cachedDigest != digest) || !pEntry->getPoseidon(data, cachedDigest) || (cachedDigest != digest))
+        {
+            zklog.error("BatchExecutionCacheTest() did not reuse the results of the process batch request");
+            numberOfErrors++;
+        }
+        delete pEntry;
+    }
+
+    // Once taken, the entry is not found again
+    if (cache.take(BatchExecutionCache::getKey(genBatchProofInput), genBatchProofInput) != NULL)
+    {
+        zklog.error("BatchExecutionCacheTest() took the same entry twice");
+        numberOfErrors++;
+    }
+
+    // ProcessStatelessBatchV2 skips the L1 info root verification, while GenStatelessBatchProof does not; an execution
+    // that skipped the block info root write cannot serve a request that writes it
+    Input statelessInput(fr);
+    batchExecutionCacheTestInput(statelessInput);
+    statelessInput.bUpdateMerkleTree = true;
+    statelessInput.bSkipVerifyL1InfoRoot = true;
+    statelessInput.bSkipWriteBlockInfoRoot = true;
+    cache.add(BatchExecutionCache::getKey(statelessInput), new BatchExecutionCacheEntry(statelessInput));
+    if (cache.take(BatchExecutionCache::getKey(genBatchProofInput), genBatchProofInput) != NULL)
+    {
+        zklog.error("BatchExecutionCacheTest() took an entry that skipped the block info root write for a request that writes it");
+        numberOfErrors++;
+    }
+    statelessInput.bSkipWriteBlockInfoRoot = false;
+    cache.add(BatchExecutionCache::getKey(statelessInput), new BatchExecutionCacheEntry(statelessInput));
+    pEntry = cache.take(BatchExecutionCache::getKey(genBatchProofInput), genBatchProofInput);
+    if (pEntry == NULL)
+    {
+        zklog.error("BatchExecutionCacheTest() did not find the entry of the stateless process batch request for the batch proof request");
+        numberOfErrors++;
+    }
+    delete pEntry;
+
+    zklog.info("BatchExecutionCacheTest() done with errors=" + to_string(numberOfErrors));
+
+    return numberOfErrors;
+}
@@ -0,0 +1,13 @@
+#ifndef BATCH_EXECUTION_CACHE_TEST_HPP
+#define BATCH_EXECUTION_CACHE_TEST_HPP
+
+#include <stdint.h>
+#include "goldilocks_base_field.hpp"
+#include "config.hpp"
+
+// Checks that the execution recorded by a process batch request is reused by the proof request of the same batch,
+// despite their different execution flags, and that it is not reused when it cannot serve the request; returns the
+// number of errors
+uint64_t BatchExecutionCacheTest (Goldilocks &fr, const Config &config);
+
+#endif
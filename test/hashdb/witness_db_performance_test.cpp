@@ -0,0 +1,226 @@
+#include <random>
+#include <sys/time.h>
+#include "witness_db_performance_test.hpp"
+#include "witness_db.hpp"
+#include "hashdb_singleton.hpp"
+#include "input.hpp"
+#include "scalar.hpp"
+#include "utils.hpp"
+#include "timer.hpp"
+#include "zklog.hpp"
+
+#define WITNESS_DB_PERFORMANCE_TEST_FOLDER "testvectors/collection/fork_9/"
+#define WITNESS_DB_PERFORMANCE_TEST_RANDOM_NODES 100000
+#define WITNESS_DB_PERFORMANCE_TEST_RANDOM_PROGRAMS 1000
+
+uint64_t WitnessDBPerformanceTestWitness (Goldilocks &fr, const Config &config, const string &name, const DatabaseMap::MTMap &db, const DatabaseMap::ProgramMap &programs, const Goldilocks::Element (&stateRoot)[4])
+{
+    uint64_t numberOfErrors = 0;
+    struct timeval t;
+    zkresult zkr;
+
+    // Build the binary witness database in memory
+    WitnessDB witnessDB;
+    gettimeofday(&t, NULL);
+    zkr = witnessDB.build(db, programs);
+    uint64_t buildTime = TimeDiff(t);
+    if (zkr != ZKR_SUCCESS)
+    {
+        zklog.error("WitnessDBPerformanceTestWitness() failed calling witnessDB.build() name=" + name + " zkr=" + zkresult2string(zkr));
+        return 1;
+    }
+
+    // Save it into a file, and map it back
+    ensureDirectoryExists(config.outputPath);
+    string witnessDBFile = config.outputPath + "/witness_db_performance_test.witnessdb";
+    zkr = witnessDB.save(witnessDBFile);
+    if (zkr != ZKR_SUCCESS)
+    {
+        zklog.error("WitnessDBPerformanceTestWitness() failed calling witnessDB.save() name=" + name + " zkr=" + zkresult2string(zkr));
+        return 1;
+    }
+    WitnessDB mappedWitnessDB;
+    gettimeofday(&t, NULL);
+    zkr = mappedWitnessDB.open(witnessDBFile);
+    uint64_t openTime = TimeDiff(t);
+    if (zkr != ZKR_SUCCESS)
+    {
+        zklog.error("WitnessDBPerformanceTestWitness() failed calling witnessDB.open() name=" + name + " zkr=" + zkresult2string(zkr));
+        return 1;
+    }
+
+    // Read all the nodes and programs from the mapped witness database, and check them
+    vector<Goldilocks::Element> value;
+    vector<uint8_t> data;
+    gettimeofday(&t, NULL);
+    for (DatabaseMap::MTMap::const_iterator it = db.begin(); it != db.end(); it++)
+    {
+        Goldilocks::Element key[4];
+        string2fea(fr, it->first, key);
+        if (!mappedWitnessDB.read(key, value))
+        {
+            zklog.error("WitnessDBPerformanceTestWitness() failed calling witnessDB.read() name=" + name + " key=" + it->first);
+            numberOfErrors++;
+            continue;
+        }
+        if (value.size() != it->second.size())
+        {
+            zklog.error("WitnessDBPerformanceTestWitness() got a different value size name=" + name + " key=" + it->first + " size=" + to_string(value.size()) + " expected=" + to_string(it->second.size()));
+            numberOfErrors++;
+            continue;
+        }
+        for (uint64_t i=0; i<value.size(); i++)
+        {
+            if (!fr.equal(value[i], it->second[i]))
+            {
+                zklog.error("WitnessDBPerformanceTestWitness() got a different value name=" + name + " key=" + it->first + " i=" + to_string(i));
+                numberOfErrors++;
+                break;
+            }
+        }
+    }
+    for (DatabaseMap::ProgramMap::const_iterator it = programs.begin(); it != programs.end(); it++)
+    {
+        if (!mappedWitnessDB.getProgram(it->first, data) || (data != it->second))
+        {
+            zklog.error("WitnessDBPerformanceTestWitness() failed calling witnessDB.getProgram() name=" + name + " key=" + it->first);
+            numberOfErrors++;
+        }
+    }
+    uint64_t readTime = TimeDiff(t);
+
+    // Check that the database reads find the nodes through a read log that carries the witness database
+    HashDB * pHashDB = hashDBSingleton.get();
+    if (!config.hashDB64 && (pHashDB != NULL))
+    {
+        DatabaseMap dbReadLog;
+        dbReadLog.setWitnessDB(&mappedWitnessDB);
+        for (DatabaseMap::MTMap::const_iterator it = db.begin(); it != db.end(); it++)
+        {
+            Goldilocks::Element key[4];
+            string2fea(fr, it->first, key);
+            if (pHashDB->db.read(it->first, key, value, &dbReadLog) != ZKR_SUCCESS)
+            {
+                zklog.error("WitnessDBPerformanceTestWitness() failed calling db.read() with the witness database name=" + name + " key=" + it->first);
+                numberOfErrors++;
+            }
+        }
+    }
+
+    // Load the witness into the hashdb, as the executor does without a witness database
+    uint64_t loadTime = 0;
+    if (!config.hashDB64 && (pHashDB != NULL))
+    {
+        gettimeofday(&t, NULL);
+        pHashDB->loadDB(db, true, stateRoot);
+        pHashDB->loadProgramDB(programs, true);
+        uint64_t flushId, storedFlushId;
+        zkr = pHashDB->flush(emptyString, emptyString, PERSISTENCE_CACHE, flushId, storedFlushId);
+        loadTime = TimeDiff(t);
+        if (zkr != ZKR_SUCCESS)
+        {
+            zklog.error("WitnessDBPerformanceTestWitness() failed calling pHashDB->flush() name=" + name + " zkr=" + zkresult2string(zkr));
+            numberOfErrors++;
+        }
+    }
+
+    zklog.info("WitnessDBPerformanceTestWitness() name=" + name +
+        " nodes=" + to_string(db.size()) +
+        " programs=" + to_string(programs.size()) +
+        " size=" + to_string(witnessDB.getDataSize()) + "B" +
+        " loadDB+flush=" + to_string(loadTime) + "us" +
+        " build=" + to_string(buildTime) + "us" +
+        " open=" + to_string(openTime) + "us" +
+        " read=" + to_string(readTime) + "us" +
+        " errors=" + to_string(numberOfErrors));
+
+    remove(witnessDBFile.c_str());
+
+    return numberOfErrors;
+}
+
+uint64_t WitnessDBPerformanceTest (Goldilocks &fr, const Config &config)
+{
+    TimerStart(WITNESS_DB_PERFORMANCE_TEST);
+
+    uint64_t numberOfErrors = 0;
+
+    // Get the input files
+    vector<string> inputFiles;
+    string inputFile = config.inputFile.empty() ? string(WITNESS_DB_PERFORMANCE_TEST_FOLDER) : config.inputFile;
+    if (inputFile.back() == '/')
+    {
+        vector<string> files = getFolderFiles(inputFile, true);
+        for (uint64_t i=0; i<files.size(); i++)
+        {
+            inputFiles.emplace_back(inputFile + files[i]);
+        }
+    }
+    else
+    {
+        inputFiles.emplace_back(inputFile);
+    }
+
+    // Test the witness state of every input file
+    for (uint64_t i=0; i<inputFiles.size(); i++)
+    {
+        json inputJson;
+        file2json(inputFiles[i], inputJson);
+        Input input(fr);
+        zkresult zkr = input.load(inputJson);
+        if (zkr != ZKR_SUCCESS)
+        {
+            zklog.error("WitnessDBPerformanceTest() failed calling input.load() inputFile=" + inputFiles[i] + " zkr=" + zkresult2string(zkr));
+            numberOfErrors++;
+            continue;
+        }
+        if (input.db.empty() && input.contractsBytecode.empty())
+        {
+            continue;
+        }
+        Goldilocks::Element stateRoot[4];
+        scalar2fea(fr, input.publicInputsExtended.publicInputs.oldStateRoot, stateRoot);
+        numberOfErrors += WitnessDBPerformanceTestWitness(fr, config, inputFiles[i], input.db, input.contractsBytecode, stateRoot);
+    }
+
+    // Test a big random witness state, with node values of any length, as the input database accepts
+    mt19937_64 randomEngine(0);
+    DatabaseMap::MTMap db;
+    DatabaseMap::ProgramMap programs;
+    for (uint64_t i=0; i<WITNESS_DB_PERFORMANCE_TEST_RANDOM_NODES; i++)
+    {
+        Goldilocks::Element key[4];
+        vector<Goldilocks::Element> value(randomEngine() % 16);
+        for (uint64_t j=0; j<4; j++)
+        {
+            key[j] = fr.fromU64(randomEngine() % GOLDILOCKS_PRIME);
+        }
+        for (uint64_t j=0; j<value.size(); j++)
+        {
+            value[j] = fr.fromU64(randomEngine() % GOLDILOCKS_PRIME);
+        }
+        db[fea2string(fr, key)] = value;
+    }
+    for (uint64_t i=0; i<WITNESS_DB_PERFORMANCE_TEST_RANDOM_PROGRAMS; i++)
+    {
+        Goldilocks::Element key[4];
+        for (uint64_t j=0; j<4; j++)
+        {
+            key[j] = fr.fromU64(randomEngine() % GOLDILOCKS_PRIME);
+        }
+        vector<uint8_t> &bytecode = programs[fea2string(fr, key)];
+        bytecode.resize(randomEngine() % 24576);
+        for (uint64_t j=0; j<bytecode.size(); j++)
+        {
+            bytecode[j] = randomEngine();
+        }
+    }
+    Goldilocks::Element stateRoot[4] = {fr.zero(), fr.zero(), fr.zero(), fr.zero()};
+    numberOfErrors += WitnessDBPerformanceTestWitness(fr, config, "random", db, programs, stateRoot);
+
+    TimerStopAndLog(WITNESS_DB_PERFORMANCE_TEST);
+
+    zklog.info("WitnessDBPerformanceTest() done with errors=" + to_string(numberOfErrors));
+
+    return numberOfErrors;
+}
@@ -0,0 +1,13 @@
+#ifndef WITNESS_DB_PERFORMANCE_TEST_HPP
+#define WITNESS_DB_PERFORMANCE_TEST_HPP
+
+#include <cstdint>
+#include "goldilocks_base_field.hpp"
+#include "config.hpp"
+
+// Loads the witness state of the inputFile file or folder (or of the fork 9 testvectors), and of a big random witness,
+// into the hashdb and into a binary witness database, logs both times, and checks the witness database reads; returns
+// the number of errors
+uint64_t WitnessDBPerformanceTest (Goldilocks &fr, const Config &config);
+
+#endif
@@ -0,0 +1,256 @@
+#include <atomic>
+#include <algorithm>
+#include <sys/time.h>
+#include "batch_replay_test.hpp"
+#include "prover_request.hpp"
+#include "counters.hpp"
+#include "utils/time_metric.hpp"
+#include "utils.hpp"
+#include "timer.hpp"
+#include "zklog.hpp"
+
+class BatchReplayResult
+{
+public:
+    zkresult result;
+    uint64_t latency; // Time spent in process batch, in us
+    uint64_t gas;
+    string newStateRoot;
+    Counters counters;
+    BatchReplayResult() : result(ZKR_UNSPECIFIED), latency(0), gas(0) {};
+};
+
+class BatchReplayContext
+{
+public:
+    Goldilocks &fr;
+    Prover &prover;
+    Config &config;
+    vector<string> inputFiles;
+    vector<json> inputJsons;
+    vector<BatchReplayResult> results; // Results of the current round, in input files order
+    atomic<uint64_t> nextInput; // Index of the next input file to replay, shared by all threads
+    TimeMetricStorage mainMetrics;
+    BatchReplayContext(Goldilocks &fr, Prover &prover, Config &config) : fr(fr), prover(prover), config(config), nextInput(0) {};
+};
+
+void * BatchReplayThread (void * arg)
+{
+    BatchReplayContext &ctx = *(BatchReplayContext *)arg;
+
+    while (true)
+    {
+        // Get the next input file; they are started in the same sorted order in every round
+        uint64_t i = ctx.nextInput.fetch_add(1);
+        if (i >= ctx.inputJsons.size())
+        {
+            break;
+        }
+        BatchReplayResult &result = ctx.results[i];
+
+        // Create the prover request
+        ProverRequest proverRequest(ctx.fr, ctx.config, prt_processBatch);
+        json inputJson = ctx.inputJsons[i];
+        result.result = proverRequest.input.load(inputJson);
+        if (result.result != ZKR_SUCCESS)
+        {
+            continue;
+        }
+        proverRequest.CreateFullTracer();
+        if (proverRequest.result != ZKR_SUCCESS)
+        {
+            result.result = proverRequest.result;
+            continue;
+        }
+        proverRequest.pMainMetrics = &ctx.mainMetrics;
+
+        // Process the batch
+        struct timeval t;
+        gettimeofday(&t, NULL);
+        ctx.prover.processBatch(&proverRequest);
+        result.latency = TimeDiff(t);
+
+        result.result = proverRequest.result;
+        result.gas = proverRequest.pFullTracer->get_cumulative_gas_used();
+        result.newStateRoot = proverRequest.pFullTracer->get_new_state_root();
+        result.counters = proverRequest.counters;
+    }
+
+    return NULL;
+}
+
+// Returns the nearest-rank percentile of a sorted vector
+uint64_t BatchReplayPercentile (const vector<uint64_t> &sorted, uint64_t percentile)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    uint64_t rank = (sorted.size()*percentile + 99)/100;
+    return sorted[(rank == 0) ? 0 : rank - 1];
+}
+
+string BatchReplayRate (uint64_t value, uint64_t time)
+{
+    return to_string(double(value)*1000000/zkmax(time, (uint64_t)1)) + "/s";
+}
+
+uint64_t BatchReplayTest (Goldilocks &fr, Prover &prover, Config &config)
+{
+    TimerStart(BATCH_REPLAY_TEST);
+
+    uint64_t numberOfErrors = 0;
+    BatchReplayContext ctx(fr, prover, config);
+
+    // Get the input files, sorted alphabetically, skipping the json files that are not batch inputs
+    const string &inputFile = config.inputFile;
+    vector<string> files;
+    if (!inputFile.empty() && (inputFile.back() == '/'))
+    {
+        files = getFolderFiles(inputFile, true);
+        for (uint64_t i=0; i<files.size(); i++)
+        {
+            files[i] = inputFile + files[i];
+        }
+    }
+    else if (fileExists(inputFile))
+    {
+        files.emplace_back(inputFile);
+    }
+    for (uint64_t i=0; i<files.size(); i++)
+    {
+        if ((files[i].size() < 5) || (files[i].substr(files[i].size() - 5) != ".json"))
+        {
+            continue;
+        }
+        json inputJson;
+        file2json(files[i], inputJson);
+        if (!inputJson.is_object() || !inputJson.contains("batchL2Data"))
+        {
+            zklog.warning("BatchReplayTest() skipping file without batchL2Data file=" + files[i]);
+            continue;
+        }
+        ctx.inputFiles.emplace_back(files[i]);
+        ctx.inputJsons.emplace_back(inputJson);
+    }
+    if (ctx.inputJsons.empty())
+    {
+        zklog.error("BatchReplayTest() found no input files in inputFile=" + inputFile);
+        return 1;
+    }
+
+    uint64_t nThreads = zkmax(config.batchReplayThreads, (uint64_t)1);
+    uint64_t nRounds = zkmax(config.batchReplayRounds, (uint64_t)1);
+    zklog.info("BatchReplayTest() replaying " + to_string(ctx.inputJsons.size()) + " batches with " + to_string(nThreads) + " threads " + to_string(nRounds) + " rounds");
+
+    // Replay all the batches in every round; the first one warms up the hashdb cache, if there are more rounds
+    vector<string> newStateRoots(ctx.inputJsons.size());
+    vector<uint64_t> latencies;
+    uint64_t totalTime = 0;
+    uint64_t totalGas = 0;
+    Counters totalCounters;
+    vector<pthread_t> threads(nThreads);
+    for (uint64_t round=0; round<nRounds; round++)
+    {
+        bool bWarmUp = (nRounds > 1) && (round == 0);
+        ctx.results.clear();
+        ctx.results.resize(ctx.inputJsons.size());
+        ctx.nextInput = 0;
+        ctx.mainMetrics.clear();
+
+        struct timeval t;
+        gettimeofday(&t, NULL);
+        for (uint64_t i=0; i<nThreads; i++)
+        {
+            pthread_create(&threads[i], NULL, BatchReplayThread, &ctx);
+        }
+        for (uint64_t i=0; i<nThreads; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+        uint64_t roundTime = TimeDiff(t);
+
+        // Check the results, and accumulate them
+        for (uint64_t i=0; i<ctx.results.size(); i++)
+        {
+            BatchReplayResult &result = ctx.results[i];
+            if (result.result != ZKR_SUCCESS)
+            {
+                zklog.error("BatchReplayTest() failed round=" + to_string(round) + " file=" + ctx.inputFiles[i] + " result=" + zkresult2string(result.result));
+                numberOfErrors++;
+                continue;
+            }
+            if (round == 0)
+            {
+                newStateRoots[i] = result.newStateRoot;
+            }
+            else if (result.newStateRoot != newStateRoots[i])
+            {
+                zklog.error("BatchReplayTest() got a different new state root round=" + to_string(round) + " file=" + ctx.inputFiles[i] + " newStateRoot=" + result.newStateRoot + " expected=" + newStateRoots[i]);
+                numberOfErrors++;
+            }
+            if (bWarmUp)
+            {
+                continue;
+            }
+            zklog.info("BatchReplayTest() round=" + to_string(round) + " file=" + ctx.inputFiles[i] +
+                " latency=" + to_string(result.latency) + "us" +
+                " gas=" + to_string(result.gas) +
+                " steps=" + to_string(result.counters.steps));
+            latencies.emplace_back(result.latency);
+            totalGas += result.gas;
+            totalCounters.arith += result.counters.arith;
+            totalCounters.binary += result.counters.binary;
+            totalCounters.memAlign += result.counters.memAlign;
+            totalCounters.keccakF += result.counters.keccakF;
+            totalCounters.poseidonG += result.counters.poseidonG;
+            totalCounters.paddingPG += result.counters.paddingPG;
+            totalCounters.sha256F += result.counters.sha256F;
+            totalCounters.steps += result.counters.steps;
+        }
+        zklog.info("BatchReplayTest() round=" + to_string(round) + (bWarmUp ? " (warm up)" : "") + " time=" + to_string(roundTime) + "us");
+        if (!bWarmUp)
+        {
+            totalTime += roundTime;
+        }
+    }
+
+    // Report the latency percentiles, the throughput, and the counters of every state machine
+    sort(latencies.begin(), latencies.end());
+    uint64_t totalLatency = 0;
+    for (uint64_t i=0; i<latencies.size(); i++)
+    {
+        totalLatency += latencies[i];
+    }
+    zklog.info(string("BatchReplayTest() latency:") +
+        " batches=" + to_string(latencies.size()) +
+        " avg=" + to_string(totalLatency/zkmax(latencies.size(), (size_t)1)) + "us" +
+        " p50=" + to_string(BatchReplayPercentile(latencies, 50)) + "us" +
+        " p90=" + to_string(BatchReplayPercentile(latencies, 90)) + "us" +
+        " p99=" + to_string(BatchReplayPercentile(latencies, 99)) + "us" +
+        " max=" + to_string(latencies.empty() ? 0 : latencies.back()) + "us");
+    zklog.info(string("BatchReplayTest() throughput:") +
+        " time=" + to_string(totalTime) + "us" +
+        " batches=" + BatchReplayRate(latencies.size(), totalTime) +
+        " gas=" + BatchReplayRate(totalGas, totalTime) +
+        " steps=" + BatchReplayRate(totalCounters.steps, totalTime));
+    zklog.info(string("BatchReplayTest() counters:") +
+        " arith=" + to_string(totalCounters.arith) + "=" + BatchReplayRate(totalCounters.arith, totalTime) +
+        " binary=" + to_string(totalCounters.binary) + "=" + BatchReplayRate(totalCounters.binary, totalTime) +
+        " memAlign=" + to_string(totalCounters.memAlign) + "=" + BatchReplayRate(totalCounters.memAlign, totalTime) +
+        " keccakF=" + to_string(totalCounters.keccakF) + "=" + BatchReplayRate(totalCounters.keccakF, totalTime) +
+        " poseidonG=" + to_string(totalCounters.poseidonG) + "=" + BatchReplayRate(totalCounters.poseidonG, totalTime) +
+        " paddingPG=" + to_string(totalCounters.paddingPG) + "=" + BatchReplayRate(totalCounters.paddingPG, totalTime) +
+        " sha256F=" + to_string(totalCounters.sha256F) + "=" + BatchReplayRate(totalCounters.sha256F, totalTime) +
+        " steps=" + to_string(totalCounters.steps) + "=" + BatchReplayRate(totalCounters.steps, totalTime));
+#ifdef LOG_TIME_STATISTICS_MAIN_EXECUTOR
+    // Main executor time breakdown of the last round
+    ctx.mainMetrics.print("BatchReplayTest() main executor calls of the last round");
+#endif
+
+    TimerStopAndLog(BATCH_REPLAY_TEST);
+
+    zklog.info("BatchReplayTest() done with errors=" + to_string(numberOfErrors));
+
+    return numberOfErrors;
+}
@@ -0,0 +1,15 @@
+#ifndef BATCH_REPLAY_TEST_HPP
+#define BATCH_REPLAY_TEST_HPP
+
+#include <cstdint>
+#include "goldilocks_base_field.hpp"
+#include "prover.hpp"
+#include "config.hpp"
+
+// Replays the config.inputFile file, or the input files of the config.inputFile folder, through Executor::process_batch,
+// with config.batchReplayThreads threads sharing the same prover and hashdb, config.batchReplayRounds times; logs the
+// batch latency percentiles, the gas and steps per second, and the counters of every state machine, and checks that
+// all rounds get the same new state roots; returns the number of errors
+uint64_t BatchReplayTest (Goldilocks &fr, Prover &prover, Config &config);
+
+#endif
@@ -0,0 +1,127 @@
+#include <vector>
+#include <gmpxx.h>
+#include "multiexp_batch_affine_performance_test.hpp"
+#include "alt_bn128.hpp"
+#include "timer.hpp"
+#include "zklog.hpp"
+
+using namespace std;
+
+// Number of different bases; bigger multiexps repeat them, since computing millions of affine points would take
+// longer than the multiexps themselves
+#define DIFFERENT_BASES (1 << 16)
+
+// Stores a scalar as the little-endian 64-bit words read by the multiexp
+static void setScalar (AltBn128::FrElement &element, const mpz_class &scalar)
+{
+    mpz_class aux = scalar;
+    for (uint64_t k = 0; k < 4; k++)
+    {
+        mpz_class word = aux & mpz_class("ffffffffffffffff", 16);
+        element.v[k] = word.get_ui();
+        aux >>= 64;
+    }
+}
+
+template <typename Curve>
+static uint64_t testCurve (Curve &g, const string &curveName, uint64_t minBits, uint64_t maxBits)
+{
+    uint64_t numberOfErrors = 0;
+    uint64_t maxN = 1ULL << maxBits;
+
+    vector<typename Curve::PointAffine> bases(maxN);
+    typename Curve::Point p;
+    g.copy(p, g.one());
+    for (uint64_t i = 0; i < DIFFERENT_BASES; i++)
+    {
+        g.dbl(p, p);
+        g.add(p, p, g.one());
+        g.copy(bases[i], p);
+    }
+    for (uint64_t i = DIFFERENT_BASES; i < maxN; i++)
+    {
+        bases[i] = bases[i % DIFFERENT_BASES];
+    }
+
+    // Random 256-bit values reduced modulo the scalar field order, so that every bit below it is used
+    mpz_class r("21888242871839275222246405745257275088548364400416034343698204186575808495617");
+    vector<AltBn128::FrElement> scalars(maxN);
+    uint64_t seed = 1;
+    mpz_class scalar;
+    for (uint64_t i = 0; i < maxN; i++)
+    {
+        scalar = 0;
+        for (uint64_t k = 0; k < 4; k++)
+        {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            scalar = (scalar << 64) + seed;
+        }
+        scalar %= r;
+        setScalar(scalars[i], scalar);
+    }
+
+    // Edge scalars near the field order and with all the bits of the top chunk set, in all the multiexps
+    mpz_class one = 1;
+    const mpz_class edges[] = {0, 1, r - 1, r - 2, (r - 1)/2, (one << 253) - 1, (one << 254) - 1};
+    for (uint64_t i = 0; i < sizeof(edges)/sizeof(edges[0]); i++)
+    {
+        setScalar(scalars[i], edges[i]);
+    }
+
+    // Scalars with the highest bit set, which require the extra carry chunk of the signed chunks recoding, only in
+    // the multiexps bigger than the first one, so that the first one checks the path without the carry chunk
+    const mpz_class carryEdges[] = {one << 255, (one << 256) - 1, (one << 255) + r - 1};
+    for (uint64_t i = 0; i < sizeof(carryEdges)/sizeof(carryEdges[0]); i++)
+    {
+        setScalar(scalars[(1ULL << (minBits + 1)) - 1 - i], carryEdges[i]);
+    }
+
+    ParallelMultiexp<Curve> classic(g, false);
+    ParallelMultiexp<Curve> batchAffine(g, true);
+
+    for (uint64_t nBits = minBits; nBits <= maxBits; nBits++)
+    {
+        uint64_t n = 1ULL << nBits;
+        struct timeval t;
+
+        typename Curve::Point reference;
+        gettimeofday(&t, NULL);
+        classic.multiexp(reference, bases.data(), (uint8_t *)scalars.data(), sizeof(scalars[0]), n);
+        uint64_t classicTime = TimeDiff(t);
+
+        typename Curve::Point result;
+        gettimeofday(&t, NULL);
+        batchAffine.multiexp(result, bases.data(), (uint8_t *)scalars.data(), sizeof(scalars[0]), n);
+        uint64_t batchAffineTime = TimeDiff(t);
+
+        zklog.info("MultiexpBatchAffinePerformanceTest() curve=" + curveName + " n=2^" + to_string(nBits) +
+            " classic=" + to_string(double(classicTime)/1000) + " ms" +
+            " batchAffine=" + to_string(double(batchAffineTime)/1000) + " ms" +
+            " speedup=" + to_string(batchAffineTime == 0 ? 0 : double(classicTime)/batchAffineTime));
+
+        if (!g.eq(result, reference))
+        {
+            zklog.error("MultiexpBatchAffinePerformanceTest() curve=" + curveName + " n=2^" + to_string(nBits) + " got a different result than the classic multiexp");
+            numberOfErrors++;
+        }
+    }
+
+    return numberOfErrors;
+}
+
+uint64_t MultiexpBatchAffinePerformanceTest (const Config &config)
+{
+    uint64_t numberOfErrors = 0;
+    AltBn128::Engine &E = AltBn128::Engine::engine;
+
+    TimerStart(MULTIEXP_BATCH_AFFINE_PERFORMANCE_TEST);
+
+    numberOfErrors += testCurve<AltBn128::Engine::G1>(E.g1, "G1", 20, 24);
+    numberOfErrors += testCurve<AltBn128::Engine::G2>(E.g2, "G2", 20, 22);
+
+    TimerStopAndLog(MULTIEXP_BATCH_AFFINE_PERFORMANCE_TEST);
+
+    zklog.info("MultiexpBatchAffinePerformanceTest() done, errors=" + to_string(numberOfErrors));
+
+    return numberOfErrors;
+}
@@ -0,0 +1,12 @@
+#ifndef MULTIEXP_BATCH_AFFINE_PERFORMANCE_TEST_HPP
+#define MULTIEXP_BATCH_AFFINE_PERFORMANCE_TEST_HPP
+
+#include <cstdint>
+#include "config.hpp"
+
+// Runs G1 multiexps of 2^20..2^24 points and G2 multiexps of 2^20..2^22 points accumulating the buckets in batch
+// affine mode and in the classic projective mode, logs both times and checks that the results match; returns the
+// number of errors
+uint64_t MultiexpBatchAffinePerformanceTest (const Config &config);
+
+#endif
@@ -0,0 +1,103 @@
+#include <vector>
+#include "multiexp_fixed_bases_performance_test.hpp"
+#include "alt_bn128.hpp"
+#include "timer.hpp"
+#include "zklog.hpp"
+
+using namespace std;
+
+// Memory budgets to test, in MB; 0 means no precomputed tables, i.e. only the bases
+static const vector<uint64_t> budgets = {0, 16, 64, 256, 1024};
+
+template <typename Curve>
+static uint64_t testCurve (Curve &g, const string &curveName, uint64_t n)
+{
+    uint64_t numberOfErrors = 0;
+
+    // Generate different bases, including the point at infinity, and pseudo-random scalars
+    vector<typename Curve::PointAffine> bases(n);
+    typename Curve::Point p;
+    g.copy(p, g.one());
+    for (uint64_t i = 0; i < n; i++)
+    {
+        g.dbl(p, p);
+        g.add(p, p, g.one());
+        g.copy(bases[i], p);
+    }
+    g.copy(bases[n/2], g.zeroAffine());
+
+    vector<AltBn128::FrElement> scalars(n);
+    uint64_t seed = 1;
+    for (uint64_t i = 0; i < n; i++)
+    {
+        for (uint64_t k = 0; k < 4; k++)
+        {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            scalars[i].v[k] = seed;
+        }
+        scalars[i].v[3] &= 0x0fffffffffffffffULL; // Keep it below the field order
+    }
+
+    struct timeval t;
+    typename Curve::Point reference;
+    gettimeofday(&t, NULL);
+    g.multiMulByScalar(reference, bases.data(), (uint8_t *)scalars.data(), sizeof(scalars[0]), n);
+    uint64_t plainTime = TimeDiff(t);
+    zklog.info("MultiexpFixedBasesPerformanceTest() curve=" + curveName + " n=" + to_string(n) + " plain multiexp=" + to_string(double(plainTime)/1000) + " ms");
+
+    for (uint64_t b = 0; b < budgets.size(); b++)
+    {
+        gettimeofday(&t, NULL);
+        MultiexpFixedBases<Curve> fixedBases(g, bases.data(), n, sizeof(scalars[0]), budgets[b]*1024*1024);
+        uint64_t precomputationTime = TimeDiff(t);
+
+        typename Curve::Point result;
+        gettimeofday(&t, NULL);
+        g.multiMulByScalar(result, fixedBases, (uint8_t *)scalars.data(), sizeof(scalars[0]), n);
+        uint64_t fixedTime = TimeDiff(t);
+
+        zklog.info("MultiexpFixedBasesPerformanceTest() curve=" + curveName + " n=" + to_string(n) +
+            " budget=" + to_string(budgets[b]) + "MB" +
+            " tables=" + to_string(fixedBases.nTables) +
+            " rounds=" + to_string(fixedBases.nRounds) +
+            " memory=" + to_string(double(fixedBases.memory())/(1024*1024)) + "MB" +
+            " precomputation=" + to_string(double(precomputationTime)/1000) + " ms" +
+            " multiexp=" + to_string(double(fixedTime)/1000) + " ms" +
+            " speedup=" + to_string(fixedTime == 0 ? 0 : double(plainTime)/fixedTime));
+
+        if (!g.eq(result, reference))
+        {
+            zklog.error("MultiexpFixedBasesPerformanceTest() curve=" + curveName + " budget=" + to_string(budgets[b]) + "MB got a different result than the plain multiexp");
+            numberOfErrors++;
+        }
+
+        // Multiexps of a prefix of the bases, as fflonk commitments do, must also match
+        typename Curve::Point prefixResult, prefixReference;
+        g.multiMulByScalar(prefixResult, fixedBases, (uint8_t *)scalars.data(), sizeof(scalars[0]), n/3);
+        g.multiMulByScalar(prefixReference, bases.data(), (uint8_t *)scalars.data(), sizeof(scalars[0]), n/3);
+        if (!g.eq(prefixResult, prefixReference))
+        {
+            zklog.error("MultiexpFixedBasesPerformanceTest() curve=" + curveName + " budget=" + to_string(budgets[b]) + "MB got a different prefix result than the plain multiexp");
+            numberOfErrors++;
+        }
+    }
+
+    return numberOfErrors;
+}
+
+uint64_t MultiexpFixedBasesPerformanceTest (const Config &config)
+{
+    uint64_t numberOfErrors = 0;
+    AltBn128::Engine &E = AltBn128::Engine::engine;
+
+    TimerStart(MULTIEXP_FIXED_BASES_PERFORMANCE_TEST);
+
+    numberOfErrors += testCurve<AltBn128::Engine::G1>(E.g1, "G1", 1 << 16);
+    numberOfErrors += testCurve<AltBn128::Engine::G2>(E.g2, "G2", 1 << 14);
+
+    TimerStopAndLog(MULTIEXP_FIXED_BASES_PERFORMANCE_TEST);
+
+    zklog.info("MultiexpFixedBasesPerformanceTest() done, errors=" + to_string(numberOfErrors));
+
+    return numberOfErrors;
+}
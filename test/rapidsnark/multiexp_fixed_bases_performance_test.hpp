@@ -0,0 +1,12 @@
+#ifndef MULTIEXP_FIXED_BASES_PERFORMANCE_TEST_HPP
+#define MULTIEXP_FIXED_BASES_PERFORMANCE_TEST_HPP
+
+#include <cstdint>
+#include "config.hpp"
+
+// Runs G1 and G2 multiexps with fixed bases precomputed under several memory budgets, logs the memory, the
+// precomputation time and the multiexp time against the plain multiexp, and checks that the results match;
+// returns the number of errors
+uint64_t MultiexpFixedBasesPerformanceTest (const Config &config);
+
+#endif
@@ -0,0 +1,158 @@
+#include <unistd.h>
+#include <atomic>
+#include <pthread.h>
+#include "executor_queue_test.hpp"
+#include "executor_queue.hpp"
+#include "zklog.hpp"
+#include "exit_process.hpp"
+
+#define EXECUTOR_QUEUE_TEST_WORKERS 4
+
+class ExecutorQueueTestCall : public ExecutorCall
+{
+public:
+    uint64_t id;
+    ExecutorQueueTestCall (uint64_t id) : id(id) {};
+    void proceed (bool ok) {};
+    void execute (void) {};
+};
+
+class ExecutorQueueTestWorkerArgs
+{
+public:
+    ExecutorQueue * pQueue;
+    atomic<uint64_t> returned; // Workers that returned from pop()
+    atomic<uint64_t> calls; // Workers that got a call instead of NULL
+};
+
+void * executorQueueTestWorker (void * arg)
+{
+    ExecutorQueueTestWorkerArgs * pArgs = (ExecutorQueueTestWorkerArgs *)arg;
+    uint64_t waitTime;
+    if (pArgs->pQueue->pop(waitTime) != NULL)
+    {
+        pArgs->calls++;
+    }
+    pArgs->returned++;
+    return NULL;
+}
+
+// Pops a call and checks that it is the expected one
+uint64_t executorQueueTestPop (ExecutorQueue &queue, uint64_t expectedId, const string &testName)
+{
+    uint64_t waitTime;
+    ExecutorQueueTestCall * pCall = (ExecutorQueueTestCall *)queue.pop(waitTime);
+    if ((pCall == NULL) || (pCall->id != expectedId))
+    {
+        zklog.error("ExecutorQueueTest() " + testName + " got call=" + (pCall == NULL ? string("NULL") : to_string(pCall->id)) + " expected=" + to_string(expectedId));
+        return 1;
+    }
+    return 0;
+}
+
+uint64_t ExecutorQueueTest (void)
+{
+    uint64_t numberOfErrors = 0;
+    ExecutorQueueTestCall call0(0), call1(1), call2(2), call3(3);
+
+    // Without aging, the shortest calls are served first, and calls of the same size in arrival order
+    {
+        ExecutorQueue queue(10, 1000000000);
+        queue.push(&call0, 300);
+        queue.push(&call1, 100);
+        queue.push(&call2, 200);
+        queue.push(&call3, 100);
+        numberOfErrors += executorQueueTestPop(queue, 1, "shortest first");
+        numberOfErrors += executorQueueTestPop(queue, 3, "shortest first");
+        numberOfErrors += executorQueueTestPop(queue, 2, "shortest first");
+        numberOfErrors += executorQueueTestPop(queue, 0, "shortest first");
+    }
+
+    // Once the oldest call has waited for the aging time, it is served before shorter ones
+    {
+        ExecutorQueue queue(10, 20000);
+        queue.push(&call0, 300);
+        usleep(30000);
+        queue.push(&call1, 100);
+        queue.push(&call2, 200);
+        numberOfErrors += executorQueueTestPop(queue, 0, "aging");
+        numberOfErrors += executorQueueTestPop(queue, 1, "aging");
+        numberOfErrors += executorQueueTestPop(queue, 2, "aging");
+        if (queue.getMetrics().find(" aged=1 ") == string::npos)
+        {
+            zklog.error("ExecutorQueueTest() aging got metrics=" + queue.getMetrics());
+            numberOfErrors++;
+        }
+    }
+
+    // When the queue is full, new calls are rejected until a call is popped
+    {
+        ExecutorQueue queue(2, 1000000000);
+        if (!queue.push(&call0, 100) || !queue.push(&call1, 100))
+        {
+            zklog.error("ExecutorQueueTest() rejection failed pushing into a non-full queue");
+            numberOfErrors++;
+        }
+        if (queue.push(&call2, 100))
+        {
+            zklog.error("ExecutorQueueTest() rejection pushed into a full queue");
+            numberOfErrors++;
+        }
+        numberOfErrors += executorQueueTestPop(queue, 0, "rejection");
+        if (!queue.push(&call2, 100))
+        {
+            zklog.error("ExecutorQueueTest() rejection failed pushing after a pop");
+            numberOfErrors++;
+        }
+        if (queue.getMetrics().find(" admitted=3 rejected=1 ") == string::npos)
+        {
+            zklog.error("ExecutorQueueTest() rejection got metrics=" + queue.getMetrics());
+            numberOfErrors++;
+        }
+    }
+
+    // Stopping the queue wakes up all the waiting workers, which get NULL, and rejects new calls
+    {
+        ExecutorQueue queue(10, 1000000000);
+        ExecutorQueueTestWorkerArgs args;
+        args.pQueue = &queue;
+        args.returned = 0;
+        args.calls = 0;
+        pthread_t threads[EXECUTOR_QUEUE_TEST_WORKERS];
+        for (uint64_t i=0; i<EXECUTOR_QUEUE_TEST_WORKERS; i++)
+        {
+            pthread_create(&threads[i], NULL, executorQueueTestWorker, &args);
+        }
+        usleep(50000);
+        if (args.returned != 0)
+        {
+            zklog.error("ExecutorQueueTest() stop got workers=" + to_string(args.returned) + " returning from an empty queue");
+            numberOfErrors++;
+        }
+        queue.stop();
+
+        // Give the workers up to 1 second to return, so that a missed wake up fails instead of hanging the test
+        for (uint64_t i=0; (i<100) && (args.returned < EXECUTOR_QUEUE_TEST_WORKERS); i++)
+        {
+            usleep(10000);
+        }
+        if ((args.returned != EXECUTOR_QUEUE_TEST_WORKERS) || (args.calls != 0))
+        {
+            zklog.error("ExecutorQueueTest() stop got returned=" + to_string(args.returned) + " calls=" + to_string(args.calls) + " expected returned=" + to_string(EXECUTOR_QUEUE_TEST_WORKERS) + " calls=0");
+            exitProcess(); // The workers still wait on this queue, which cannot be destroyed
+        }
+        for (uint64_t i=0; i<EXECUTOR_QUEUE_TEST_WORKERS; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+        if (queue.push(&call0, 100))
+        {
+            zklog.error("ExecutorQueueTest() stop pushed into a stopped queue");
+            numberOfErrors++;
+        }
+    }
+
+    zklog.info("ExecutorQueueTest() done with errors=" + to_string(numberOfErrors));
+
+    return numberOfErrors;
+}
@@ -0,0 +1,10 @@
+#ifndef EXECUTOR_QUEUE_TEST_HPP
+#define EXECUTOR_QUEUE_TEST_HPP
+
+#include <stdint.h>
+
+// Checks that the executor queue serves the shortest calls first, serves the oldest call once it has aged, rejects
+// calls when it is full, and wakes up the waiting workers when it is stopped; returns the number of errors
+uint64_t ExecutorQueueTest (void);
+
+#endif
@@ -0,0 +1,148 @@
+#include <sys/time.h>
+#include "memory_test.hpp"
+#include "memory_executor.hpp"
+#include "mem_align_executor.hpp"
+#include "main_sm/fork_9/main/main_executor.hpp"
+#include "prover_request.hpp"
+#include "utils.hpp"
+#include "timer.hpp"
+#include "zklog.hpp"
+#include "exit_process.hpp"
+
+using namespace std;
+
+uint64_t MemorySMTest (Goldilocks &fr, PoseidonGoldilocks &poseidon, const Config &config)
+{
+    uint64_t numberOfErrors = 0;
+
+    zklog.info("MemorySMTest starting...");
+
+    if (config.inputFile.empty())
+    {
+        zklog.error("MemorySMTest() found config.inputFile empty");
+        return 1;
+    }
+
+    // Get the list of input files
+    vector<string> files;
+    if (config.inputFile.back() == '/')
+    {
+        files = getFolderFiles(config.inputFile, true);
+        for (uint64_t i = 0; i < files.size(); i++)
+        {
+            files[i] = config.inputFile + files[i];
+        }
+    }
+    else
+    {
+        files.push_back(config.inputFile);
+    }
+
+    void * pAddress = calloc(CommitPols::pilSize(), 1);
+    if (pAddress == NULL)
+    {
+        zklog.error("MemorySMTest() failed calling calloc() of size=" + to_string(CommitPols::pilSize()));
+        exitProcess();
+    }
+    CommitPols cmPols(pAddress, CommitPols::pilDegree());
+
+    // Execute the main state machine over every input file, and collect the memory and memory align actions
+    fork_9::MainExecutor mainExecutor(fr, poseidon, config);
+    vector<MemoryAccess> memorySeed;
+    vector<MemAlignAction> memAlignSeed;
+    for (uint64_t f = 0; f < files.size(); f++)
+    {
+        ProverRequest proverRequest(fr, config, prt_execute);
+        json inputJson;
+        file2json(files[f], inputJson);
+        zkresult zkResult = proverRequest.input.load(inputJson);
+        if ((zkResult != ZKR_SUCCESS) || (proverRequest.input.publicInputsExtended.publicInputs.forkID != PROVER_FORK_ID))
+        {
+            zklog.warning("MemorySMTest() skipping file=" + files[f]);
+            continue;
+        }
+        proverRequest.CreateFullTracer();
+        if (proverRequest.result != ZKR_SUCCESS)
+        {
+            zklog.warning("MemorySMTest() skipping file=" + files[f] + " after failing calling CreateFullTracer()");
+            continue;
+        }
+        fork_9::MainExecRequired required;
+        mainExecutor.execute(proverRequest, cmPols.Main, required);
+        if (proverRequest.result != ZKR_SUCCESS)
+        {
+            zklog.warning("MemorySMTest() skipping file=" + files[f] + " after failing calling mainExecutor.execute()");
+            continue;
+        }
+        memorySeed.insert(memorySeed.end(), required.Memory.begin(), required.Memory.end());
+        memAlignSeed.insert(memAlignSeed.end(), required.MemAlign.begin(), required.MemAlign.end());
+    }
+    if (memorySeed.empty() || memAlignSeed.empty())
+    {
+        zklog.error("MemorySMTest() got no memory or memory align actions from the input files");
+        free(pAddress);
+        return 1;
+    }
+
+    // Replicate the memory accesses in disjoint address ranges, until the state machine is almost full
+    uint64_t maxAddress = 0;
+    for (uint64_t i = 0; i < memorySeed.size(); i++)
+    {
+        maxAddress = zkmax(maxAddress, memorySeed[i].address);
+    }
+    vector<MemoryAccess> memory;
+    for (uint64_t copy = 0; memory.size() + memorySeed.size() < MemCommitPols::pilDegree(); copy++)
+    {
+        for (uint64_t i = 0; i < memorySeed.size(); i++)
+        {
+            MemoryAccess access = memorySeed[i];
+            access.address += copy * (maxAddress + 1);
+            memory.push_back(access);
+        }
+    }
+
+    // Replicate the memory align actions, until the state machine is almost full
+    vector<MemAlignAction> memAlign;
+    while ((memAlign.size() + memAlignSeed.size()) * 32 < MemAlignCommitPols::pilDegree())
+    {
+        memAlign.insert(memAlign.end(), memAlignSeed.begin(), memAlignSeed.end());
+    }
+
+    // Execute the memory state machine
+    MemoryExecutor memoryExecutor(fr, config);
+    struct timeval t;
+    gettimeofday(&t, NULL);
+    memoryExecutor.execute(memory, cmPols.Mem);
+    uint64_t memoryTime = TimeDiff(t);
+
+    // Check that accesses are sorted by address, then by step, and that lastAccess is set at every address change
+    for (uint64_t i = 0; i + 1 < memory.size(); i++)
+    {
+        uint64_t addr = fr.toU64(cmPols.Mem.addr[i]);
+        uint64_t nextAddr = fr.toU64(cmPols.Mem.addr[i + 1]);
+        bool bLastAccess = !fr.isZero(cmPols.Mem.lastAccess[i]);
+        if ( (addr > nextAddr) ||
+             ((addr == nextAddr) && (fr.toU64(cmPols.Mem.step[i]) >= fr.toU64(cmPols.Mem.step[i + 1]))) ||
+             (bLastAccess != (addr != nextAddr)) )
+        {
+            zklog.error("MemorySMTest() found invalid memory evaluation i=" + to_string(i));
+            numberOfErrors++;
+            break;
+        }
+    }
+
+    // Execute the memory align state machine
+    MemAlignExecutor memAlignExecutor(fr, config);
+    gettimeofday(&t, NULL);
+    memAlignExecutor.execute(memAlign, cmPols.MemAlign);
+    uint64_t memAlignTime = TimeDiff(t);
+
+    free(pAddress);
+
+    zklog.info("MemorySMTest done with errors=" + to_string(numberOfErrors) +
+        " files=" + to_string(files.size()) +
+        " memoryAccesses=" + to_string(memory.size()) + " memoryTime=" + to_string(double(memoryTime)/1000) + "ms" +
+        " memAlignActions=" + to_string(memAlign.size()) + " memAlignTime=" + to_string(double(memAlignTime)/1000) + "ms");
+
+    return numberOfErrors;
+}
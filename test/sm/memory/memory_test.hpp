@@ -0,0 +1,12 @@
+#ifndef MEMORY_TEST_HPP
+#define MEMORY_TEST_HPP
+
+#include "config.hpp"
+#include "goldilocks_base_field.hpp"
+#include "poseidon_goldilocks.hpp"
+
+/* Executes the input files found in config.inputFile (a file, or a folder ending in '/'), replicates their
+   memory and memory align actions until the state machines are full, and measures their executors */
+uint64_t MemorySMTest (Goldilocks &fr, PoseidonGoldilocks &poseidon, const Config &config);
+
+#endif
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <sys/time.h>
+#include "poseidon_g_test.hpp"
+#include "poseidon_g_executor.hpp"
+#include "poseidon_g_permutation.hpp"
+#include "timer.hpp"
+#include "zklog.hpp"
+#include "exit_process.hpp"
+
+using namespace std;
+
+uint64_t PoseidonGSMTest (Goldilocks &fr, PoseidonGoldilocks &poseidon, const Config &config)
+{
+    uint64_t numberOfErrors = 0;
+
+    zklog.info("PoseidonGSMTest starting...");
+
+    void * pAddress = calloc(CommitPols::pilSize(), 1);
+    if (pAddress == NULL)
+    {
+        zklog.error("PoseidonGSMTest() failed calling calloc() of size=" + to_string(CommitPols::pilSize()));
+        exitProcess();
+    }
+    CommitPols cmPols(pAddress, CommitPols::pilDegree());
+
+    PoseidonGExecutor executor(fr, poseidon);
+
+    // Fill all the available slots, spread across the three inputs
+    const uint64_t rowsPerHash = 31;
+    const uint64_t maxHashes = PoseidonGCommitPols::pilDegree() / rowsPerHash;
+    vector<array<Goldilocks::Element, 17>> inputs[3];
+    for (uint64_t h = 0; h < maxHashes; h++)
+    {
+        array<Goldilocks::Element, 17> input;
+        Goldilocks::Element state[12];
+        for (uint64_t i = 0; i < 12; i++)
+        {
+            state[i] = fr.fromU64((h + 1) * 0x9E3779B97F4A7C15ULL + i);
+            input[i] = state[i];
+        }
+        Goldilocks::Element result[12];
+        poseidon.hash_full_result(result, state);
+        for (uint64_t i = 0; i < 4; i++)
+        {
+            input[12 + i] = result[i];
+        }
+        input[16] = fr.fromU64(POSEIDONG_PERMUTATION1_ID + (h % 4));
+        inputs[h % 3].push_back(input);
+    }
+
+    struct timeval t;
+    gettimeofday(&t, NULL);
+    executor.execute(inputs[0], inputs[1], inputs[2], cmPols.PoseidonG);
+    uint64_t duration = TimeDiff(t);
+
+    // Check that the last row of every hash contains the expected result
+    uint64_t h = 0;
+    for (uint64_t k = 0; k < 3; k++)
+    {
+        for (uint64_t i = 0; i < inputs[k].size(); i++, h++)
+        {
+            uint64_t p = h*rowsPerHash + rowsPerHash - 1;
+            if (!fr.equal(cmPols.PoseidonG.in0[p], inputs[k][i][12]) ||
+                !fr.equal(cmPols.PoseidonG.in1[p], inputs[k][i][13]) ||
+                !fr.equal(cmPols.PoseidonG.in2[p], inputs[k][i][14]) ||
+                !fr.equal(cmPols.PoseidonG.in3[p], inputs[k][i][15]))
+            {
+                zklog.error("PoseidonGSMTest() found invalid result at k=" + to_string(k) + " i=" + to_string(i));
+                numberOfErrors++;
+            }
+        }
+    }
+
+    free(pAddress);
+
+    zklog.info("PoseidonGSMTest done with errors=" + to_string(numberOfErrors) + " hashes=" + to_string(maxHashes) +
+        " time=" + to_string(double(duration)/1000) + "ms hashes/s=" + to_string(duration == 0 ? 0 : (maxHashes*1000000)/duration));
+
+    return numberOfErrors;
+}
@@ -0,0 +1,10 @@
+#ifndef POSEIDON_G_TEST_HPP
+#define POSEIDON_G_TEST_HPP
+
+#include "config.hpp"
+#include "goldilocks_base_field.hpp"
+#include "poseidon_goldilocks.hpp"
+
+uint64_t PoseidonGSMTest (Goldilocks &fr, PoseidonGoldilocks &poseidon, const Config &config);
+
+#endif
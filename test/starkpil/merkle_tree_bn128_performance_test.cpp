@@ -0,0 +1,152 @@
+#include <vector>
+#include <cstring>
+#include "merkle_tree_bn128_performance_test.hpp"
+#include "merkleTreeBN128.hpp"
+#include "poseidon_opt.hpp"
+#include "utils.hpp"
+#include "timer.hpp"
+#include "zklog.hpp"
+#include "zkmax.hpp"
+#include "exit_process.hpp"
+
+using namespace std;
+using json = nlohmann::json;
+
+// Root of the tree, computed hashing one node per Poseidon_opt call, as MerkleTreeBN128 did before the batched hash
+static void getReferenceRoot (Goldilocks::Element *source, uint64_t height, uint64_t sourceWidth, RawFr::Element &root)
+{
+    uint64_t width = (sourceWidth + GOLDILOCKS_ELEMENTS - 1) / GOLDILOCKS_ELEMENTS;
+    vector<RawFr::Element> level(height);
+
+#pragma omp parallel for
+    for (uint64_t i = 0; i < height; i++)
+    {
+        Poseidon_opt p;
+        memset(&level[i], 0, sizeof(RawFr::Element));
+        if (sourceWidth <= 4)
+        {
+            for (uint64_t k = 0; k < sourceWidth; k++)
+            {
+                level[i].v[k] = Goldilocks::toU64(source[i * sourceWidth + k]);
+            }
+            RawFr::field.toMontgomery(level[i], level[i]);
+            continue;
+        }
+        vector<RawFr::Element> row(width);
+        for (uint64_t j = 0; j < width; j++)
+        {
+            memset(&row[j], 0, sizeof(RawFr::Element));
+            for (uint64_t k = 0; (k < GOLDILOCKS_ELEMENTS) && (j * GOLDILOCKS_ELEMENTS + k < sourceWidth); k++)
+            {
+                row[j].v[k] = Goldilocks::toU64(source[i * sourceWidth + j * GOLDILOCKS_ELEMENTS + k]);
+            }
+            RawFr::field.toMontgomery(row[j], row[j]);
+        }
+        for (uint64_t j = 0; j < width; j += 16)
+        {
+            uint64_t batch = zkmin(width - j, (uint64_t)16);
+            vector<RawFr::Element> elements(batch + 1);
+            elements[0] = level[i];
+            memcpy(&elements[1], &row[j], batch * sizeof(RawFr::Element));
+            p.hash(elements, &level[i]);
+        }
+    }
+
+    while (level.size() > 1)
+    {
+        uint64_t nextSize = (level.size() + 15) / 16;
+        vector<RawFr::Element> next(nextSize);
+#pragma omp parallel for
+        for (uint64_t i = 0; i < nextSize; i++)
+        {
+            Poseidon_opt p;
+            vector<RawFr::Element> elements(17);
+            memset(&elements[0], 0, 17 * sizeof(RawFr::Element));
+            for (uint64_t j = 0; (j < 16) && (i * 16 + j < level.size()); j++)
+            {
+                elements[j + 1] = level[i * 16 + j];
+            }
+            p.hash(elements, &next[i]);
+        }
+        level.swap(next);
+    }
+    root = level[0];
+}
+
+uint64_t MerkleTreeBN128PerformanceTest (const Config &config)
+{
+    uint64_t numberOfErrors = 0;
+
+    // Get the recursiveF tree sizes from its stark info, or use similar ones if it is not available
+    uint64_t nBitsExt = 16;
+    vector<uint64_t> widths = {12, 12, 12, 9};
+    if (fileExists(config.recursivefStarkInfo))
+    {
+        json starkInfoJson;
+        file2json(config.recursivefStarkInfo, starkInfoJson);
+        nBitsExt = starkInfoJson["starkStruct"]["nBitsExt"];
+        widths[0] = starkInfoJson["mapSectionsN"]["cm1_n"];
+        widths[1] = starkInfoJson["mapSectionsN"]["cm2_n"];
+        widths[2] = starkInfoJson["mapSectionsN"]["cm3_n"];
+        widths[3] = starkInfoJson["mapSectionsN"]["cm4_2ns"];
+    }
+    else
+    {
+        zklog.warning("MerkleTreeBN128PerformanceTest() could not find recursiveF stark info file=" + config.recursivefStarkInfo + "; using default sizes");
+    }
+    uint64_t height = 1ULL << nBitsExt;
+
+    uint64_t seed = 1;
+    for (uint64_t w = 0; w < widths.size(); w++)
+    {
+        uint64_t width = widths[w];
+        if (width == 0)
+        {
+            continue;
+        }
+        zklog.info("MerkleTreeBN128PerformanceTest() tree=" + to_string(w) + " height=" + to_string(height) + " width=" + to_string(width));
+
+        Goldilocks::Element *source = (Goldilocks::Element *)malloc(height * width * sizeof(Goldilocks::Element));
+        if (source == NULL)
+        {
+            zklog.error("MerkleTreeBN128PerformanceTest() failed calling malloc() of size=" + to_string(height * width * sizeof(Goldilocks::Element)));
+            exitProcess();
+        }
+        for (uint64_t i = 0; i < height * width; i++)
+        {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            source[i] = Goldilocks::fromU64(seed);
+        }
+
+        TimerStart(MERKLE_TREE_BN128_BATCHED);
+        MerkleTreeBN128 tree(height, width, source);
+        tree.merkelize();
+        TimerStopAndLog(MERKLE_TREE_BN128_BATCHED);
+
+        TimerStart(MERKLE_TREE_BN128_PER_NODE);
+        RawFr::Element referenceRoot;
+        getReferenceRoot(source, height, width, referenceRoot);
+        TimerStopAndLog(MERKLE_TREE_BN128_PER_NODE);
+
+        RawFr::Element root;
+        tree.getRoot(&root);
+        if (memcmp(&root, &referenceRoot, sizeof(RawFr::Element)) != 0)
+        {
+            zklog.error("MerkleTreeBN128PerformanceTest() found different roots for tree=" + to_string(w) + " root=" + RawFr::field.toString(root, 16) + " referenceRoot=" + RawFr::field.toString(referenceRoot, 16));
+            numberOfErrors++;
+        }
+
+        free(source);
+    }
+
+    if (numberOfErrors == 0)
+    {
+        zklog.info("MerkleTreeBN128PerformanceTest() succeeded");
+    }
+    else
+    {
+        zklog.error("MerkleTreeBN128PerformanceTest() failed with errors=" + to_string(numberOfErrors));
+    }
+
+    return numberOfErrors;
+}
@@ -0,0 +1,11 @@
+#ifndef MERKLE_TREE_BN128_PERFORMANCE_TEST_HPP
+#define MERKLE_TREE_BN128_PERFORMANCE_TEST_HPP
+
+#include <cstdint>
+#include "config.hpp"
+
+// Builds the recursiveF BN128 merkle trees with the batched Poseidon_opt hash and with the per node one,
+// logs both times and checks that the roots match; returns the number of errors
+uint64_t MerkleTreeBN128PerformanceTest (const Config &config);
+
+#endif
@@ -0,0 +1,52 @@
+#include <vector>
+#include <cstring>
+#include "poseidon_opt_unit_tests.hpp"
+#include "poseidon_opt.hpp"
+#include "zklog.hpp"
+
+using namespace std;
+
+uint64_t PoseidonOptBatchTest (void)
+{
+    uint64_t numberOfErrors = 0;
+    uint64_t seed = 1;
+    Poseidon_opt p;
+
+    for (int t = 2; t <= 17; t++)
+    {
+        // Use a number of hashes that is not a multiple of the lanes, to check the last incomplete group
+        uint64_t nHashes = 2 * POSEIDON_OPT_LANES + 3;
+        vector<RawFr::Element> states(nHashes * t);
+        for (uint64_t i = 0; i < states.size(); i++)
+        {
+            for (uint64_t k = 0; k < 4; k++)
+            {
+                seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                states[i].v[k] = seed;
+            }
+            states[i].v[3] &= 0x0FFFFFFFFFFFFFFF; // Keep it lower than the prime
+        }
+
+        vector<RawFr::Element> results(nHashes);
+        p.hash(states.data(), nHashes, t, results.data());
+
+        for (uint64_t i = 0; i < nHashes; i++)
+        {
+            vector<RawFr::Element> state(states.begin() + i * t, states.begin() + (i + 1) * t);
+            RawFr::Element result;
+            p.hash(state, &result);
+            if (memcmp(&result, &results[i], sizeof(RawFr::Element)) != 0)
+            {
+                zklog.error("PoseidonOptBatchTest() found different results for t=" + to_string(t) + " i=" + to_string(i) + " batched=" + RawFr::field.toString(results[i], 16) + " expected=" + RawFr::field.toString(result, 16));
+                numberOfErrors++;
+            }
+        }
+    }
+
+    if (numberOfErrors == 0)
+    {
+        zklog.info("PoseidonOptBatchTest() succeeded");
+    }
+
+    return numberOfErrors;
+}
@@ -0,0 +1,9 @@
+#ifndef POSEIDON_OPT_UNIT_TESTS_HPP
+#define POSEIDON_OPT_UNIT_TESTS_HPP
+
+#include <stdint.h>
+
+// Checks that the batched Poseidon_opt hash matches the per state one for all state sizes; returns the number of errors
+uint64_t PoseidonOptBatchTest (void);
+
+#endif
@@ -12,6 +12,12 @@
 #include "database_cache_test.hpp"
 #include "hashdb_test.hpp"
 #include "key_utils_unit_tests.hpp"
+#include "zkin_stark_unit_tests.hpp"
+#include "poseidon_opt_unit_tests.hpp"
+#include "data_stream_test.hpp"
+#include "metrics_test.hpp"
+#include "executor_queue_test.hpp"
+#include "batch_execution_cache_test.hpp"
 
 
 uint64_t UnitTest (Goldilocks &fr, PoseidonGoldilocks &poseidon, const Config &config)
@@ -64,6 +70,30 @@ uint64_t UnitTest (Goldilocks &fr, PoseidonGoldilocks &poseidon, const Config &c
     splitKey9Test();
     TimerStopAndLog(SPLITKEY9_UNIT_TEST);
 
+    TimerStart(ZKIN_STARK_UNIT_TEST);
+    numberOfErrors += ZkinStarkTest();
+    TimerStopAndLog(ZKIN_STARK_UNIT_TEST);
+
+    TimerStart(POSEIDON_OPT_BATCH_UNIT_TEST);
+    numberOfErrors += PoseidonOptBatchTest();
+    TimerStopAndLog(POSEIDON_OPT_BATCH_UNIT_TEST);
+
+    TimerStart(DATA_STREAM_UNIT_TEST);
+    numberOfErrors += DataStreamTest();
+    TimerStopAndLog(DATA_STREAM_UNIT_TEST);
+
+    TimerStart(METRICS_UNIT_TEST);
+    numberOfErrors += MetricsTest();
+    TimerStopAndLog(METRICS_UNIT_TEST);
+
+    TimerStart(EXECUTOR_QUEUE_UNIT_TEST);
+    numberOfErrors += ExecutorQueueTest();
+    TimerStopAndLog(EXECUTOR_QUEUE_UNIT_TEST);
+
+    TimerStart(BATCH_EXECUTION_CACHE_UNIT_TEST);
+    numberOfErrors += BatchExecutionCacheTest(fr, config);
+    TimerStopAndLog(BATCH_EXECUTION_CACHE_UNIT_TEST);
+
     TimerStopAndLog(UNIT_TEST);
 
     if (numberOfErrors == 0)
@@ -0,0 +1,109 @@
+#include <string>
+#include <vector>
+#include "zkin_stark_unit_tests.hpp"
+#include "proof2zkinStark.hpp"
+#include "goldilocks_cubic_extension.hpp"
+#include "zklog.hpp"
+
+using namespace std;
+
+static void json2values (ordered_json &j, vector<uint64_t> &values)
+{
+    if (j.is_array())
+    {
+        for (uint64_t i = 0; i < j.size(); i++)
+        {
+            json2values(j[i], values);
+        }
+    }
+    else
+    {
+        values.push_back(stoull(j.get<string>()));
+    }
+}
+
+static void fillElements (Goldilocks::Element *pElements, uint64_t size, uint64_t &seed)
+{
+    for (uint64_t i = 0; i < size; i++)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        pElements[i] = Goldilocks::fromU64(seed);
+    }
+}
+
+uint64_t ZkinStarkTest (void)
+{
+    uint64_t numberOfErrors = 0;
+    uint64_t seed = 1;
+
+    // Build a small FRI proof: 3 steps, 4 queries; step 0 has trees cm1, cm2 (empty), cm3, cm4 and constants
+    uint64_t nQueries = 4;
+    uint64_t nSteps = 3;
+    FRIProof fproof(8, FIELD_EXTENSION, nSteps, 5, 0);
+    fillElements(&fproof.proofs.root1[0], HASH_SIZE, seed);
+    fillElements(&fproof.proofs.root2[0], HASH_SIZE, seed);
+    fillElements(&fproof.proofs.root3[0], HASH_SIZE, seed);
+    fillElements(&fproof.proofs.root4[0], HASH_SIZE, seed);
+    for (uint64_t i = 0; i < fproof.proofs.evals.size(); i++)
+    {
+        fillElements(&fproof.proofs.evals[i][0], fproof.proofs.evals[i].size(), seed);
+    }
+    for (uint64_t i = 0; i < fproof.proofs.fri.pol.size(); i++)
+    {
+        fillElements(&fproof.proofs.fri.pol[i][0], fproof.proofs.fri.pol[i].size(), seed);
+    }
+
+    uint64_t nLinears[5] = {7, 0, 3, 9, 5};
+    Goldilocks::Element buffer[64 + 6 * HASH_SIZE];
+    for (uint64_t s = 0; s < nSteps; s++)
+    {
+        ProofTree &tree = fproof.proofs.fri.trees[s];
+        fillElements(buffer, HASH_SIZE, seed);
+        tree.setRoot(buffer);
+        for (uint64_t q = 0; q < nQueries; q++)
+        {
+            vector<MerkleProof> queries;
+            uint64_t nTrees = (s == 0) ? 5 : 1;
+            for (uint64_t t = 0; t < nTrees; t++)
+            {
+                uint64_t linears = (s == 0) ? nLinears[t] : 12;
+                fillElements(buffer, linears + 6 * HASH_SIZE, seed);
+                queries.push_back(MerkleProof(linears, 6 - s, buffer));
+            }
+            tree.polQueries.push_back(queries);
+        }
+    }
+
+    // Generate the zkin in both formats
+    ordered_json jProof = fproof.proofs.proof2json();
+    ordered_json jZkin = proof2zkinStark(jProof);
+    ZkinStark zkin;
+    proof2zkinStark(fproof, zkin);
+
+    // Compare them
+    if (jZkin.size() != zkin.signals.size())
+    {
+        zklog.error("ZkinStarkTest() got " + to_string(zkin.signals.size()) + " binary signals but " + to_string(jZkin.size()) + " JSON signals");
+        numberOfErrors++;
+    }
+    for (uint64_t s = 0; s < zkin.signals.size(); s++)
+    {
+        ZkinSignal &signal = zkin.signals[s];
+        if (!jZkin.contains(signal.name))
+        {
+            zklog.error("ZkinStarkTest() found binary signal " + signal.name + " not present in JSON zkin");
+            numberOfErrors++;
+            continue;
+        }
+        vector<uint64_t> values;
+        json2values(jZkin[signal.name], values);
+        if (values != signal.values)
+        {
+            zklog.error("ZkinStarkTest() found different values in signal " + signal.name);
+            numberOfErrors++;
+        }
+    }
+
+    zklog.info("ZkinStarkTest() done, errors=" + to_string(numberOfErrors));
+    return numberOfErrors;
+}
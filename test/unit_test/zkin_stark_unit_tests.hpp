@@ -0,0 +1,9 @@
+#ifndef ZKIN_STARK_UNIT_TESTS_HPP
+#define ZKIN_STARK_UNIT_TESTS_HPP
+
+#include <stdint.h>
+
+// Checks that the binary zkin of a FRI proof matches its JSON zkin; returns the number of errors
+uint64_t ZkinStarkTest (void);
+
+#endif
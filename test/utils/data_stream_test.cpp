@@ -0,0 +1,516 @@
+#include <vector>
+#include <string>
+#include <string_view>
+#include <random>
+#include <sys/time.h>
+#include <gmpxx.h>
+#include "data_stream_test.hpp"
+#include "data_stream.hpp"
+#include "rlp.hpp"
+#include "scalar.hpp"
+#include "timer.hpp"
+#include "zklog.hpp"
+
+using namespace std;
+
+#define TEST_CHAIN_ID 1101
+#define NUMBER_OF_RLP_LISTS 1000
+#define NUMBER_OF_RLP_MUTATIONS 20000
+#define NUMBER_OF_TX_MUTATIONS 200
+#define NUMBER_OF_DATA_STREAM_MUTATIONS 100
+#define PERFORMANCE_BATCH_SIZE (120*1024)
+#define PERFORMANCE_ITERATIONS 100
+
+/*****************************************/
+/* Reference copying decoders, as before */
+/*****************************************/
+
+static bool refDecodeLength (const string &input, uint64_t &p, uint64_t &length, bool &list)
+{
+    if (p > input.size())
+    {
+        return false;
+    }
+    uint8_t prefix = input[p];
+    if (prefix <= 0x7f)
+    {
+        length = 1;
+        list = false;
+        return true;
+    }
+    if ((prefix <= 0xb7) || ((prefix >= 0xc0) && (prefix <= 0xf7)))
+    {
+        list = (prefix >= 0xc0);
+        length = prefix - (list ? 0xc0 : 0x80);
+        p++;
+        return (p + length) <= input.size();
+    }
+    list = (prefix >= 0xc0);
+    uint64_t lengthOfLength = prefix - (list ? 0xf7 : 0xb7);
+    p++;
+    if ((lengthOfLength > 8) || (p + lengthOfLength > input.size()))
+    {
+        return false;
+    }
+    length = 0;
+    for (uint64_t i = 0; i < lengthOfLength; i++)
+    {
+        length <<= 8;
+        length += (uint8_t)input[p];
+        p++;
+    }
+    return true;
+}
+
+static bool refDecodeList (const string &input, vector<string> &output)
+{
+    bool list;
+    uint64_t p = 0;
+    uint64_t length;
+    if (!refDecodeLength(input, p, length, list) || !list || ((p + length) != input.size()))
+    {
+        return false;
+    }
+    while (p < input.size())
+    {
+        if (!refDecodeLength(input, p, length, list) || list)
+        {
+            return false;
+        }
+        output.emplace_back(input.substr(p, length));
+        p += length;
+    }
+    return p == input.size();
+}
+
+// Transcodes a TX from Ethereum RLP format into ROM RLP format, copying every field, as transcodeTx() used to do
+static bool refTranscodeTx (const string &tx, uint32_t batchChainId, string &transcodedTx)
+{
+    vector<string> fields;
+    if (!refDecodeList(tx, fields) || (fields.size() != 9))
+    {
+        return false;
+    }
+    mpz_class vScalar;
+    ba2scalar(vScalar, fields[6]);
+    if (vScalar > ScalarMask64)
+    {
+        return false;
+    }
+    uint64_t txv = vScalar.get_ui();
+    uint64_t chainId = (txv - 35) / 2;
+    if (chainId != batchChainId)
+    {
+        return false;
+    }
+    uint64_t v = txv - chainId*2 - 35 + 27;
+    mpz_class r, s;
+    ba2scalar(r, fields[7]);
+    ba2scalar(s, fields[8]);
+    if ((r > ScalarMask256) || (s > ScalarMask256))
+    {
+        return false;
+    }
+    fields[6].clear();
+    const uint8_t * pChainId = (const uint8_t *)&batchChainId;
+    bool writing = false;
+    for (int64_t i = 3; i >= 0; i--)
+    {
+        if (writing || (pChainId[i] != 0))
+        {
+            fields[6] += pChainId[i];
+            writing = true;
+        }
+    }
+    fields[7].clear();
+    fields[8].clear();
+    if (!rlp::encodeList(fields, transcodedTx))
+    {
+        return false;
+    }
+    transcodedTx += scalar2ba32(r);
+    transcodedTx += scalar2ba32(s);
+    transcodedTx += (char)(uint8_t)v;
+    return true;
+}
+
+/********************/
+/* Random test data */
+/********************/
+
+static string randomBa (mt19937_64 &gen, uint64_t size)
+{
+    string ba;
+    for (uint64_t i = 0; i < size; i++)
+    {
+        ba.push_back((char)(gen() & 0xFF));
+    }
+    return ba;
+}
+
+// Returns the big-endian, minimal representation of a value, as RLP encodes scalars
+static string scalarBa (uint64_t value)
+{
+    string ba;
+    while (value > 0)
+    {
+        ba.insert(ba.begin(), (char)(value & 0xFF));
+        value >>= 8;
+    }
+    return ba;
+}
+
+// Returns a random legacy TX, RLP(nonce, gasPrice, gasLimit, to, value, data, v, r, s), with data up to maxDataSize
+static string randomTx (mt19937_64 &gen, uint64_t maxDataSize)
+{
+    vector<string> fields;
+    fields.emplace_back(scalarBa(gen() % 1000));
+    fields.emplace_back(scalarBa(gen() % 100000000000));
+    fields.emplace_back(scalarBa(21000 + gen() % 1000000));
+    fields.emplace_back((gen() % 8 == 0) ? string() : randomBa(gen, 20));
+    fields.emplace_back(scalarBa(gen() >> (gen() % 64)));
+    fields.emplace_back(randomBa(gen, (maxDataSize == 0) ? 0 : gen() % maxDataSize));
+    fields.emplace_back(scalarBa(TEST_CHAIN_ID*2 + 35 + gen() % 2));
+    fields.emplace_back(scalarBa(gen() % 256) + randomBa(gen, 31)); // r, sometimes with less than 32 bytes
+    fields.emplace_back(randomBa(gen, 32)); // s
+    string tx;
+    rlp::encodeList(fields, tx);
+    return tx;
+}
+
+static void appendBigEndian (string &data, uint64_t value, uint64_t size)
+{
+    for (int64_t i = size - 1; i >= 0; i--)
+    {
+        data.push_back((char)((value >> (8*i)) & 0xFF));
+    }
+}
+
+// Appends a data stream entry: packet type, length, entry type, entry number and data
+static void appendEntry (string &dataStream, uint8_t packetType, uint32_t entryType, uint64_t &number, const string &data)
+{
+    dataStream.push_back((char)packetType);
+    appendBigEndian(dataStream, 17 + data.size(), 4);
+    appendBigEndian(dataStream, entryType, 4);
+    appendBigEndian(dataStream, number, 8);
+    dataStream += data;
+    number++;
+}
+
+// Builds the data stream of a batch with random blocks of random TXs, until it contains at least minTxsSize bytes of
+// TXs, and returns the TXs in order; it also contains a bookmark and padding, which must be skipped
+static void randomDataStream (mt19937_64 &gen, uint64_t minTxsSize, uint64_t maxDataSize, string &dataStream, vector<string> &txs)
+{
+    uint64_t number = 0;
+    uint64_t blockNumber = 1 + gen() % 1000;
+    uint64_t txsSize = 0;
+    appendEntry(dataStream, 2, DATA_STREAM_ENTRY_BOOKMARK, number, randomBa(gen, 9));
+    do
+    {
+        string data;
+        appendBigEndian(data, 7, 8); // Batch number
+        appendBigEndian(data, blockNumber, 8);
+        appendBigEndian(data, 1700000000 + blockNumber, 8); // Timestamp
+        appendBigEndian(data, gen() % 10, 4); // Delta timestamp
+        appendBigEndian(data, gen() % 100, 4); // L1 info tree index
+        data += randomBa(gen, 32 + 32 + 20); // L1 block hash, global exit root and coinbase
+        appendBigEndian(data, 9, 2); // Fork ID
+        appendBigEndian(data, TEST_CHAIN_ID, 4);
+        appendEntry(dataStream, 2, DATA_STREAM_ENTRY_START_L2_BLOCK, number, data);
+
+        uint64_t nTxs = gen() % 8;
+        for (uint64_t t = 0; t < nTxs; t++)
+        {
+            string tx = randomTx(gen, maxDataSize);
+            data.clear();
+            data.push_back((char)(gen() % 256)); // Gas price percentage
+            data.push_back(1); // Is valid
+            data += randomBa(gen, 32); // State root
+            appendBigEndian(data, tx.size(), 4);
+            data += tx;
+            appendEntry(dataStream, 2, DATA_STREAM_ENTRY_L2_TX, number, data);
+            txsSize += tx.size();
+            txs.emplace_back(tx);
+        }
+
+        if (gen() % 4 == 0)
+        {
+            appendEntry(dataStream, 0, 0, number, randomBa(gen, gen() % 16)); // Padding
+        }
+
+        data.clear();
+        appendBigEndian(data, blockNumber, 8);
+        data += randomBa(gen, 64); // L2 block hash and state root
+        appendEntry(dataStream, 2, DATA_STREAM_ENTRY_END_L2_BLOCK, number, data);
+        blockNumber++;
+    } while (txsSize < minTxsSize);
+}
+
+// Transcodes the TXs of a data stream into batch L2 data, as dataStreamBatch2batchL2Data() used to do: copying the
+// encoded TX out of the data stream and decoding every field into a new string
+static bool refDataStream2batchL2Data (const string &dataStream, string &batchL2Data)
+{
+    DataStreamReader reader(dataStream);
+    DataStreamEntry entry;
+    bool bEnd;
+    batchL2Data.clear();
+    while ((reader.next(entry, bEnd) == ZKR_SUCCESS) && !bEnd)
+    {
+        if (entry.type == DATA_STREAM_ENTRY_START_L2_BLOCK)
+        {
+            batchL2Data.push_back(0x0b);
+            appendBigEndian(batchL2Data, entry.block.deltaTimestamp, 4);
+            appendBigEndian(batchL2Data, entry.block.l1InfoTreeIndex, 4);
+        }
+        else if (entry.type == DATA_STREAM_ENTRY_L2_TX)
+        {
+            string encodedTx(entry.tx.encodedTx);
+            string stateRoot = ba2string((const uint8_t *)entry.tx.stateRoot.data(), entry.tx.stateRoot.size());
+            string transcodedTx;
+            if (!refTranscodeTx(encodedTx, TEST_CHAIN_ID, transcodedTx))
+            {
+                return false;
+            }
+            batchL2Data += transcodedTx;
+            batchL2Data += entry.tx.gasPricePercentage;
+        }
+    }
+    return bEnd;
+}
+
+// Transcodes the TXs of a data stream into batch L2 data with the zero-copy decoders
+static bool dataStream2batchL2Data (const string &dataStream, string &batchL2Data)
+{
+    DataStreamReader reader(dataStream);
+    DataStreamEntry entry;
+    bool bEnd;
+    batchL2Data.clear();
+    while ((reader.next(entry, bEnd) == ZKR_SUCCESS) && !bEnd)
+    {
+        if (entry.type == DATA_STREAM_ENTRY_START_L2_BLOCK)
+        {
+            batchL2Data.push_back(0x0b);
+            appendBigEndian(batchL2Data, entry.block.deltaTimestamp, 4);
+            appendBigEndian(batchL2Data, entry.block.l1InfoTreeIndex, 4);
+        }
+        else if (entry.type == DATA_STREAM_ENTRY_L2_TX)
+        {
+            if (transcodeTx(entry.tx.encodedTx, TEST_CHAIN_ID, batchL2Data) != ZKR_SUCCESS)
+            {
+                return false;
+            }
+            batchL2Data += entry.tx.gasPricePercentage;
+        }
+    }
+    return bEnd;
+}
+
+/*********/
+/* Tests */
+/*********/
+
+// Compares the zero-copy RLP list decoder against the reference one, for a valid or invalid input
+static uint64_t compareDecodeList (const string &input)
+{
+    vector<string> refFields;
+    vector<string_view> fields;
+    bool bRefResult = refDecodeList(input, refFields);
+    bool bResult = rlp::decodeList(string_view(input), fields);
+    if (bRefResult != bResult)
+    {
+        zklog.error("DataStreamTest() decodeList() returned " + to_string(bResult) + " but reference returned " + to_string(bRefResult) + " input=" + ba2string(input));
+        return 1;
+    }
+    if (!bResult)
+    {
+        return 0;
+    }
+    bool bEqual = (refFields.size() == fields.size());
+    for (uint64_t i = 0; bEqual && (i < fields.size()); i++)
+    {
+        bEqual = (refFields[i] == fields[i]) &&
+                 (fields[i].data() >= input.data()) && (fields[i].data() + fields[i].size() <= input.data() + input.size());
+    }
+    if (!bEqual)
+    {
+        zklog.error("DataStreamTest() decodeList() returned different fields than reference input=" + ba2string(input));
+        return 1;
+    }
+    return 0;
+}
+
+// Returns a copy of the data with a random mutation: a changed byte, a truncation or some appended bytes
+static string mutate (mt19937_64 &gen, const string &data)
+{
+    string mutation = data;
+    switch (gen() % 4)
+    {
+        case 0:
+        case 1:
+            if (!mutation.empty())
+            {
+                mutation[gen() % mutation.size()] ^= (char)(1 + gen() % 255);
+            }
+            break;
+        case 2:
+            mutation.resize(mutation.empty() ? 0 : gen() % mutation.size());
+            break;
+        case 3:
+            mutation += randomBa(gen, 1 + gen() % 4);
+            break;
+    }
+    return mutation;
+}
+
+uint64_t DataStreamTest (void)
+{
+    uint64_t numberOfErrors = 0;
+    mt19937_64 gen(45);
+
+    // Encode random lists with both encoders, and decode them with both decoders
+    vector<string> encodedTxs;
+    for (uint64_t i = 0; i < NUMBER_OF_RLP_LISTS; i++)
+    {
+        vector<string> fields;
+        uint64_t nFields = gen() % 12;
+        for (uint64_t f = 0; f < nFields; f++)
+        {
+            uint64_t sizes[] = {0, 1, 1, 2, 20, 32, 55, 56, 200, 300};
+            fields.emplace_back(randomBa(gen, sizes[gen() % 10]));
+        }
+        string encoded;
+        rlp::encodeList(fields, encoded);
+        vector<string_view> fieldViews(fields.begin(), fields.end());
+        string encodedViews;
+        rlp::encodeList(fieldViews, encodedViews);
+        if (encoded != encodedViews)
+        {
+            zklog.error("DataStreamTest() encodeList() of string_view fields differs from encodeList() of string fields=" + ba2string(encoded));
+            numberOfErrors++;
+        }
+        numberOfErrors += compareDecodeList(encoded);
+        encodedTxs.emplace_back(encoded);
+        encodedTxs.emplace_back(randomTx(gen, 300));
+    }
+
+    // Decode random mutations of them with both decoders
+    for (uint64_t i = 0; i < NUMBER_OF_RLP_MUTATIONS; i++)
+    {
+        numberOfErrors += compareDecodeList(mutate(gen, encodedTxs[gen() % encodedTxs.size()]));
+    }
+
+    // Transcode random mutations of TXs with both transcoders
+    for (uint64_t i = 0; i < NUMBER_OF_TX_MUTATIONS; i++)
+    {
+        string tx = randomTx(gen, 300);
+        if (i % 2 == 1)
+        {
+            tx = mutate(gen, tx);
+        }
+        string refTranscodedTx;
+        string transcodedTx;
+        bool bRefResult = refTranscodeTx(tx, TEST_CHAIN_ID, refTranscodedTx);
+        bool bResult = (transcodeTx(tx, TEST_CHAIN_ID, transcodedTx) == ZKR_SUCCESS);
+        if ((bRefResult != bResult) || (bResult && (refTranscodedTx != transcodedTx)))
+        {
+            zklog.error("DataStreamTest() transcodeTx() differs from reference tx=" + ba2string(tx));
+            numberOfErrors++;
+        }
+    }
+
+    // Parse a data stream batch, and transcode it into batch L2 data
+    string dataStream;
+    vector<string> txs;
+    randomDataStream(gen, 16*1024, 300, dataStream, txs);
+    DataStreamBatch batch;
+    zkresult zkr = dataStream2batch(dataStream, batch);
+    vector<string> batchTxs;
+    for (uint64_t b = 0; b < batch.blocks.size(); b++)
+    {
+        for (uint64_t t = 0; t < batch.blocks[b].txs.size(); t++)
+        {
+            batchTxs.emplace_back(batch.blocks[b].txs[t].encodedTx);
+        }
+    }
+    if ((zkr != ZKR_SUCCESS) || (batch.batchNumber != 7) || (batch.forkId != 9) || (batch.chainId != TEST_CHAIN_ID) || (batchTxs != txs))
+    {
+        zklog.error("DataStreamTest() dataStream2batch() returned a different batch result=" + zkresult2string(zkr) + " " + batch.toString());
+        numberOfErrors++;
+    }
+    string batchL2Data;
+    string refBatchL2Data;
+    zkr = dataStreamBatch2batchL2Data(batch, batchL2Data);
+    if ((zkr != ZKR_SUCCESS) || !refDataStream2batchL2Data(dataStream, refBatchL2Data) || (batchL2Data != refBatchL2Data))
+    {
+        zklog.error("DataStreamTest() dataStreamBatch2batchL2Data() returned different batch L2 data than reference result=" + zkresult2string(zkr));
+        numberOfErrors++;
+    }
+
+    // Parse and transcode random mutations of the data stream with both decoders; they must not read out of bounds
+    for (uint64_t i = 0; i < NUMBER_OF_DATA_STREAM_MUTATIONS; i++)
+    {
+        string mutation = mutate(gen, dataStream);
+        bool bRefResult = refDataStream2batchL2Data(mutation, refBatchL2Data);
+        bool bResult = dataStream2batchL2Data(mutation, batchL2Data);
+        if ((bRefResult != bResult) || (bResult && (refBatchL2Data != batchL2Data)))
+        {
+            zklog.error("DataStreamTest() transcoding a mutated data stream differs from reference i=" + to_string(i));
+            numberOfErrors++;
+        }
+        dataStream2batch(mutation, batch);
+    }
+
+    zklog.info("DataStreamTest() done, errors=" + to_string(numberOfErrors));
+
+    return numberOfErrors;
+}
+
+uint64_t DataStreamPerformanceTest (const Config &config)
+{
+    uint64_t numberOfErrors = 0;
+    mt19937_64 gen(120);
+    struct timeval t;
+
+    TimerStart(DATA_STREAM_PERFORMANCE_TEST);
+
+    // Build a 120 KB batch of TXs with up to 1 KB of data
+    string dataStream;
+    vector<string> txs;
+    randomDataStream(gen, PERFORMANCE_BATCH_SIZE, 1024, dataStream, txs);
+
+    // Transcode it copying every field
+    string refBatchL2Data;
+    gettimeofday(&t, NULL);
+    for (uint64_t i = 0; i < PERFORMANCE_ITERATIONS; i++)
+    {
+        refDataStream2batchL2Data(dataStream, refBatchL2Data);
+    }
+    uint64_t copyTime = TimeDiff(t);
+
+    // Transcode it with the zero-copy decoders
+    string batchL2Data;
+    gettimeofday(&t, NULL);
+    for (uint64_t i = 0; i < PERFORMANCE_ITERATIONS; i++)
+    {
+        dataStream2batchL2Data(dataStream, batchL2Data);
+    }
+    uint64_t zeroCopyTime = TimeDiff(t);
+
+    if (batchL2Data != refBatchL2Data)
+    {
+        zklog.error("DataStreamPerformanceTest() got different batch L2 data from both decoders");
+        numberOfErrors++;
+    }
+
+    zklog.info("DataStreamPerformanceTest() dataStream=" + to_string(dataStream.size()) + " B txs=" + to_string(txs.size()) +
+        " batchL2Data=" + to_string(batchL2Data.size()) + " B iterations=" + to_string(PERFORMANCE_ITERATIONS) +
+        " copy=" + to_string(double(copyTime)/1000/PERFORMANCE_ITERATIONS) + " ms/batch" +
+        " zeroCopy=" + to_string(double(zeroCopyTime)/1000/PERFORMANCE_ITERATIONS) + " ms/batch" +
+        " speedup=" + to_string(zeroCopyTime == 0 ? 0 : double(copyTime)/zeroCopyTime));
+
+    TimerStopAndLog(DATA_STREAM_PERFORMANCE_TEST);
+
+    zklog.info("DataStreamPerformanceTest() done, errors=" + to_string(numberOfErrors));
+
+    return numberOfErrors;
+}
@@ -0,0 +1,15 @@
+#ifndef DATA_STREAM_TEST_HPP
+#define DATA_STREAM_TEST_HPP
+
+#include <cstdint>
+#include "config.hpp"
+
+// Fuzzing and differential test of the zero-copy RLP and data stream decoders against the previous copying decoders,
+// over random and mutated transactions and data streams; returns the number of errors
+uint64_t DataStreamTest (void);
+
+// Transcodes a 120 KB data stream batch into batch L2 data with the copying decoders and with the zero-copy ones, and
+// logs both times; returns the number of errors
+uint64_t DataStreamPerformanceTest (const Config &config);
+
+#endif
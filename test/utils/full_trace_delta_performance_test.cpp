@@ -0,0 +1,341 @@
+#include <vector>
+#include <cstring>
+#include <unordered_map>
+#include <gmpxx.h>
+#include "full_trace_delta_performance_test.hpp"
+#include "main_sm/fork_9/main/full_tracer.hpp"
+#include "main_sm/fork_9/main/context.hpp"
+#include "main_sm/fork_9/main/rom.hpp"
+#include "main_sm/fork_9/pols_generated/commit_pols.hpp"
+#include "full_trace_expander.hpp"
+#include "prover_request.hpp"
+#include "zkglobals.hpp"
+#include "scalar.hpp"
+#include "utils.hpp"
+#include "timer.hpp"
+#include "zklog.hpp"
+
+using namespace std;
+
+// Number of loop iterations of the simulated transaction; every iteration writes a new memory word
+#define NUMBER_OF_ITERATIONS 2048
+
+// Context of the simulated transaction, and offsets of the ROM variables read by the full tracer
+#define TRACE_CTX 1
+#define TRACE_CTX_OFFSET (TRACE_CTX*0x40000)
+#define TRACE_STACK_OFFSET (TRACE_CTX_OFFSET + 0x10000)
+#define TRACE_MEMORY_OFFSET (TRACE_CTX_OFFSET + 0x20000)
+#define TRACE_MEM_LENGTH_OFFSET 1
+#define TRACE_STORAGE_ADDR_OFFSET 2
+#define TRACE_BYTECODE_LENGTH_OFFSET 3
+
+// Context of the code deployed by the simulated CREATE, and number of opcodes that its trace must contain
+#define TRACE_CREATE_CTX 2
+#define TRACE_CREATE_STEPS 6
+
+// Returns a pseudo-random 256-bit word
+static mpz_class getTraceWord (uint64_t seed)
+{
+    mpz_class word = 0;
+    for (uint64_t i = 0; i < 8; i++)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        word = (word << 32) + (seed >> 32);
+    }
+    return word;
+}
+
+// Writes a word into the main SM memory, as the ROM does
+static void setTraceMemory (fork_9::Context &ctx, uint64_t address, const mpz_class &value)
+{
+    fork_9::Fea fea;
+    scalar2fea(ctx.fr, value, fea.fe0, fea.fe1, fea.fe2, fea.fe3, fea.fe4, fea.fe5, fea.fe6, fea.fe7);
+    ctx.mem[address] = fea;
+}
+
+// Calls FullTracer::onOpcode() for the given opcode
+static uint64_t traceOpcode (fork_9::Context &ctx, fork_9::FullTracer &fullTracer, fork_9::RomCommand &codeIdCmd, fork_9::RomCommand &opcodeCmd, uint64_t codeId)
+{
+    codeIdCmd.num = codeId;
+    zkresult zkr = fullTracer.onOpcode(ctx, opcodeCmd);
+    if (zkr != ZKR_SUCCESS)
+    {
+        zklog.error("FullTraceDeltaPerformanceTest() failed calling FullTracer::onOpcode() result=" + zkresult2string(zkr));
+        return 1;
+    }
+    return 0;
+}
+
+// Runs a simulated CREATE of empty code followed by more opcodes: the STOP of the empty code runs in a new context
+// and is dropped from the trace, so the opcodes after it must be encoded against the CREATE one
+static uint64_t traceCreateEmptyCode (fork_9::Context &ctx, fork_9::FullTracer &fullTracer, fork_9::RomCommand &codeIdCmd, fork_9::RomCommand &opcodeCmd, uint64_t sp)
+{
+    uint64_t numberOfErrors = 0;
+    fork_9::MainCommitPols &pols = ctx.pols;
+
+    // PUSH1 value, PUSH1 offset and PUSH1 size of the CREATE
+    for (uint64_t i = 0; i < 3; i++)
+    {
+        pols.SP[0] = fr.fromU64(sp);
+        numberOfErrors += traceOpcode(ctx, fullTracer, codeIdCmd, opcodeCmd, 0x60 /*PUSH1*/);
+        setTraceMemory(ctx, TRACE_STACK_OFFSET + sp++, (i == 0) ? getTraceWord(i) : 0);
+    }
+
+    // CREATE pops its arguments, and runs the empty code in a new context with an empty stack
+    pols.SP[0] = fr.fromU64(sp);
+    numberOfErrors += traceOpcode(ctx, fullTracer, codeIdCmd, opcodeCmd, 0xf0 /*CREATE*/);
+    sp -= 3;
+    pols.CTX[0] = fr.fromU64(TRACE_CREATE_CTX);
+    pols.SP[0] = fr.zero();
+    numberOfErrors += traceOpcode(ctx, fullTracer, codeIdCmd, opcodeCmd, 0x00 /*STOP*/);
+
+    // Back in the caller context, the created address is pushed, and then used
+    pols.CTX[0] = fr.fromU64(TRACE_CTX);
+    setTraceMemory(ctx, TRACE_STACK_OFFSET + sp++, getTraceWord(3));
+    pols.SP[0] = fr.fromU64(sp);
+    numberOfErrors += traceOpcode(ctx, fullTracer, codeIdCmd, opcodeCmd, 0x60 /*PUSH1*/);
+    setTraceMemory(ctx, TRACE_STACK_OFFSET + sp++, 1);
+    pols.SP[0] = fr.fromU64(sp);
+    numberOfErrors += traceOpcode(ctx, fullTracer, codeIdCmd, opcodeCmd, 0x01 /*ADD*/);
+
+    return numberOfErrors;
+}
+
+// Runs a simulated memory-heavy transaction through the fork 9 full tracer, calling onOpcode() at every opcode and
+// onUpdateStorage() at every SSTORE, as the main executor does: a loop that pushes a value and an offset, stores the
+// value in a new memory word, increments the loop counter, and writes a storage slot every 16 iterations; the trace
+// is recorded in delta mode or as full snapshots, depending on config.fullTracerDeltaTrace; if bCreateEmptyCode is
+// true, it runs traceCreateEmptyCode() instead of the loop
+static uint64_t recordTrace (const Config &config, bool bCreateEmptyCode, vector<Opcode> &trace)
+{
+    uint64_t numberOfErrors = 0;
+
+    // Allocate the committed polynomials for only 1 evaluation, as the executor does in fast mode
+    void * pAddress = calloc(fork_9::CommitPols::numPols()*sizeof(Goldilocks::Element), 1);
+    if (pAddress == NULL)
+    {
+        zklog.error("FullTraceDeltaPerformanceTest() failed calling calloc(" + to_string(fork_9::CommitPols::numPols()*sizeof(Goldilocks::Element)) + ")");
+        return 1;
+    }
+    fork_9::CommitPols commitPols(pAddress, 1);
+    fork_9::MainCommitPols &pols = commitPols.Main;
+
+    fork_9::Rom rom(config);
+    rom.memLengthOffset = TRACE_MEM_LENGTH_OFFSET;
+    rom.storageAddrOffset = TRACE_STORAGE_ADDR_OFFSET;
+    rom.bytecodeLengthOffset = TRACE_BYTECODE_LENGTH_OFFSET;
+
+    ProverRequest proverRequest(fr, config, prt_processBatch);
+    proverRequest.input.traceConfig.bEnabled = true;
+    proverRequest.input.traceConfig.bEnableMemory = true;
+    proverRequest.input.traceConfig.calculateFlags();
+
+    fork_9::Context ctx(fr, config, fec, fnec, pols, rom, proverRequest, NULL);
+    uint64_t step = 0;
+    ctx.pStep = &step;
+    ctx.pEvaluation = &step;
+    ctx.N = 1;
+
+    fork_9::FullTracer fullTracer(fr);
+
+    // Opcode event command: ${eventLog(onOpcode(<code ID>))}
+    fork_9::RomCommand codeIdCmd;
+    codeIdCmd.op = fork_9::op_number;
+    fork_9::RomCommand opcodeParamCmd;
+    opcodeParamCmd.params.push_back(&codeIdCmd);
+    fork_9::RomCommand opcodeCmd;
+    opcodeCmd.params.push_back(&opcodeParamCmd);
+
+    // Storage event command: ${eventLog(onUpdateStorage(C, D))}, with the key in C and the value in D
+    fork_9::RomCommand keyCmd;
+    keyCmd.reg = fork_9::reg_C;
+    fork_9::RomCommand valueCmd;
+    valueCmd.reg = fork_9::reg_D;
+    fork_9::RomCommand storageCmd;
+    storageCmd.params.push_back(&keyCmd);
+    storageCmd.params.push_back(&valueCmd);
+
+    pols.CTX[0] = fr.fromU64(TRACE_CTX);
+    setTraceMemory(ctx, TRACE_CTX_OFFSET + TRACE_STORAGE_ADDR_OFFSET, 1);
+
+    // The loop counter is the first stack word
+    uint64_t sp = 0;
+    setTraceMemory(ctx, TRACE_STACK_OFFSET + sp++, 0);
+
+    if (bCreateEmptyCode)
+    {
+        numberOfErrors += traceCreateEmptyCode(ctx, fullTracer, codeIdCmd, opcodeCmd, sp);
+    }
+
+    zkresult zkr;
+    for (uint64_t s = 0; !bCreateEmptyCode && (s < NUMBER_OF_ITERATIONS*4) && (numberOfErrors == 0); s++)
+    {
+        uint64_t iteration = s / 4;
+        bool bStorageWrite = ((s % 4) == 3) && ((iteration % 16) == 0);
+        const uint64_t codeIds[4] = {0x7f /*PUSH32*/, 0x61 /*PUSH2*/, 0x52 /*MSTORE*/, 0x01 /*ADD*/};
+        codeIdCmd.num = bStorageWrite ? 0x55 /*SSTORE*/ : codeIds[s % 4];
+        pols.SP[0] = fr.fromU64(sp);
+
+        zkr = fullTracer.onOpcode(ctx, opcodeCmd);
+        if (zkr != ZKR_SUCCESS)
+        {
+            zklog.error("FullTraceDeltaPerformanceTest() failed calling FullTracer::onOpcode() result=" + zkresult2string(zkr));
+            numberOfErrors++;
+            break;
+        }
+
+        switch (s % 4)
+        {
+            case 0: // PUSH32 value
+                setTraceMemory(ctx, TRACE_STACK_OFFSET + sp++, getTraceWord(s));
+                break;
+            case 1: // PUSH2 offset
+                setTraceMemory(ctx, TRACE_STACK_OFFSET + sp++, iteration*32);
+                break;
+            case 2: // MSTORE
+                ctx.mem[TRACE_MEMORY_OFFSET + iteration] = ctx.mem[TRACE_STACK_OFFSET + sp - 2];
+                setTraceMemory(ctx, TRACE_CTX_OFFSET + TRACE_MEM_LENGTH_OFFSET, (iteration + 1)*32);
+                sp -= 2;
+                break;
+            case 3: // Update the loop counter, and SSTORE every 16 iterations
+                setTraceMemory(ctx, TRACE_STACK_OFFSET, iteration + 1);
+                if (bStorageWrite)
+                {
+                    scalar2fea(fr, iteration / 16, pols.C0[0], pols.C1[0], pols.C2[0], pols.C3[0], pols.C4[0], pols.C5[0], pols.C6[0], pols.C7[0]);
+                    scalar2fea(fr, iteration, pols.D0[0], pols.D1[0], pols.D2[0], pols.D3[0], pols.D4[0], pols.D5[0], pols.D6[0], pols.D7[0]);
+                    zkr = fullTracer.onUpdateStorage(ctx, storageCmd);
+                    if (zkr != ZKR_SUCCESS)
+                    {
+                        zklog.error("FullTraceDeltaPerformanceTest() failed calling FullTracer::onUpdateStorage() result=" + zkresult2string(zkr));
+                        numberOfErrors++;
+                    }
+                }
+                break;
+        }
+    }
+
+    trace.swap(fullTracer.full_trace);
+
+    free(pAddress);
+
+    return numberOfErrors;
+}
+
+// Returns the number of bytes of the stack, memory and storage records of a trace
+static uint64_t getTraceSize (const vector<Opcode> &trace)
+{
+    uint64_t size = 0;
+    for (uint64_t s = 0; s < trace.size(); s++)
+    {
+        size += trace[s].stack.size()*sizeof(Bytes32) + trace[s].memory.size();
+        unordered_map<string, string>::const_iterator it;
+        for (it = trace[s].storage.begin(); it != trace[s].storage.end(); it++)
+        {
+            size += it->first.size() + it->second.size();
+        }
+        for (uint64_t i = 0; i < trace[s].storage_writes.size(); i++)
+        {
+            size += trace[s].storage_writes[i].address.size() + trace[s].storage_writes[i].key.size() + trace[s].storage_writes[i].value.size();
+        }
+    }
+    return size;
+}
+
+// Rebuilds the snapshots of the delta trace, as the executor service does when building the response, and checks that
+// they match the ones of the full trace; returns the number of errors
+static uint64_t compareTraces (const vector<Opcode> &fullTrace, const vector<Opcode> &deltaTrace)
+{
+    FullTraceExpander fullExpander;
+    FullTraceExpander deltaExpander;
+    for (uint64_t s = 0; s < fullTrace.size(); s++)
+    {
+        fullExpander.next(fullTrace[s]);
+        deltaExpander.next(deltaTrace[s]);
+        if (fullTrace[s].bDelta || !deltaTrace[s].bDelta)
+        {
+            zklog.error("FullTraceDeltaPerformanceTest() found a wrong bDelta at step=" + to_string(s));
+            return 1;
+        }
+        const vector<Bytes32> &fullStack = fullExpander.getStack();
+        const vector<Bytes32> &deltaStack = deltaExpander.getStack();
+        bool bEqual = (fullStack.size() == deltaStack.size()) &&
+                      (fullExpander.getStorage() == deltaExpander.getStorage()) &&
+                      (fullTrace[s].memory == deltaTrace[s].memory) &&
+                      (fullTrace[s].memory_offset == deltaTrace[s].memory_offset) &&
+                      (fullTrace[s].memory_size == deltaTrace[s].memory_size);
+        for (uint64_t i = 0; bEqual && (i < fullStack.size()); i++)
+        {
+            bEqual = (memcmp(fullStack[i].bytes, deltaStack[i].bytes, 32) == 0);
+        }
+        if (!bEqual)
+        {
+            zklog.error("FullTraceDeltaPerformanceTest() found a different snapshot at step=" + to_string(s) + " opcode=" + fullTrace[s].opcode);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+uint64_t FullTraceDeltaPerformanceTest (const Config &config)
+{
+    uint64_t numberOfErrors = 0;
+    struct timeval t;
+
+    TimerStart(FULL_TRACE_DELTA_PERFORMANCE_TEST);
+
+    Config fullConfig = config;
+    fullConfig.fullTracerDeltaTrace = false;
+    Config deltaConfig = config;
+    deltaConfig.fullTracerDeltaTrace = true;
+
+    vector<Opcode> fullTrace;
+    gettimeofday(&t, NULL);
+    numberOfErrors += recordTrace(fullConfig, false, fullTrace);
+    uint64_t fullTime = TimeDiff(t);
+
+    vector<Opcode> deltaTrace;
+    gettimeofday(&t, NULL);
+    numberOfErrors += recordTrace(deltaConfig, false, deltaTrace);
+    uint64_t deltaTime = TimeDiff(t);
+
+    if ((fullTrace.size() != NUMBER_OF_ITERATIONS*4) || (deltaTrace.size() != fullTrace.size()))
+    {
+        zklog.error("FullTraceDeltaPerformanceTest() got fullTrace.size=" + to_string(fullTrace.size()) + " deltaTrace.size=" + to_string(deltaTrace.size()) + " != " + to_string(NUMBER_OF_ITERATIONS*4));
+        numberOfErrors++;
+        TimerStopAndLog(FULL_TRACE_DELTA_PERFORMANCE_TEST);
+        return numberOfErrors;
+    }
+
+    // Rebuild the snapshots, as the executor service does when building the response, and compare them
+    gettimeofday(&t, NULL);
+    numberOfErrors += compareTraces(fullTrace, deltaTrace);
+    uint64_t expandTime = TimeDiff(t);
+
+    zklog.info("FullTraceDeltaPerformanceTest() steps=" + to_string(fullTrace.size()) +
+        " memoryWords=" + to_string(NUMBER_OF_ITERATIONS) +
+        " full=" + to_string(double(fullTime)/1000) + " ms " + to_string(getTraceSize(fullTrace)) + " B" +
+        " delta=" + to_string(double(deltaTime)/1000) + " ms " + to_string(getTraceSize(deltaTrace)) + " B" +
+        " expand=" + to_string(double(expandTime)/1000) + " ms" +
+        " speedup=" + to_string(deltaTime == 0 ? 0 : double(fullTime)/deltaTime));
+
+    // The STOP of a CREATE of empty code is dropped from the trace, and must not become the delta baseline
+    vector<Opcode> fullCreateTrace;
+    numberOfErrors += recordTrace(fullConfig, true, fullCreateTrace);
+    vector<Opcode> deltaCreateTrace;
+    numberOfErrors += recordTrace(deltaConfig, true, deltaCreateTrace);
+    if ((fullCreateTrace.size() != TRACE_CREATE_STEPS) || (deltaCreateTrace.size() != fullCreateTrace.size()))
+    {
+        zklog.error("FullTraceDeltaPerformanceTest() got fullCreateTrace.size=" + to_string(fullCreateTrace.size()) + " deltaCreateTrace.size=" + to_string(deltaCreateTrace.size()) + " != " + to_string(TRACE_CREATE_STEPS));
+        numberOfErrors++;
+    }
+    else
+    {
+        numberOfErrors += compareTraces(fullCreateTrace, deltaCreateTrace);
+    }
+
+    TimerStopAndLog(FULL_TRACE_DELTA_PERFORMANCE_TEST);
+
+    zklog.info("FullTraceDeltaPerformanceTest() done, errors=" + to_string(numberOfErrors));
+
+    return numberOfErrors;
+}
@@ -0,0 +1,13 @@
+#ifndef FULL_TRACE_DELTA_PERFORMANCE_TEST_HPP
+#define FULL_TRACE_DELTA_PERFORMANCE_TEST_HPP
+
+#include <cstdint>
+#include "config.hpp"
+
+// Drives the fork 9 FullTracer through a simulated memory-heavy transaction (a loop that keeps writing new memory words
+// and storage slots), recording its opcode trace as full snapshots and as delta records, logs both times and sizes, and
+// checks that the snapshots rebuilt by FullTraceExpander match the full ones, also after the STOP of a CREATE of empty
+// code, which is dropped from the trace; returns the number of errors
+uint64_t FullTraceDeltaPerformanceTest (const Config &config);
+
+#endif
@@ -0,0 +1,129 @@
+#include <pthread.h>
+#include "metrics_test.hpp"
+#include "metrics.hpp"
+#include "zklog.hpp"
+
+#define METRICS_TEST_THREADS 8
+#define METRICS_TEST_ITERATIONS 10000
+
+class MetricsTestThreadArgs
+{
+public:
+    uint64_t counter;
+    uint64_t histogram;
+};
+
+void * metricsTestThread (void * arg)
+{
+    MetricsTestThreadArgs * pArgs = (MetricsTestThreadArgs *)arg;
+    for (uint64_t i=1; i<=METRICS_TEST_ITERATIONS; i++)
+    {
+        metrics.add(pArgs->counter);
+        metrics.observe(pArgs->histogram, i);
+    }
+    return NULL;
+}
+
+uint64_t MetricsTest (void)
+{
+    uint64_t numberOfErrors = 0;
+
+    // Every value must be in a bucket whose lowest value is not greater than it, with the expected precision
+    uint64_t values[] = {0, 1, 31, 32, 33, 47, 48, 1000, 1023, 1024, 123456789, 0x7FFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF};
+    for (uint64_t i=0; i<sizeof(values)/sizeof(values[0]); i++)
+    {
+        uint64_t bucket = MetricsHistogram::getBucket(values[i]);
+        uint64_t lowestValue = MetricsHistogram::getBucketLowestValue(bucket);
+        if ((bucket >= METRICS_HISTOGRAM_BUCKETS) ||
+            (lowestValue > values[i]) ||
+            ((bucket + 1 < METRICS_HISTOGRAM_BUCKETS) && (MetricsHistogram::getBucketLowestValue(bucket + 1) <= values[i])) ||
+            ((values[i] - lowestValue) > (values[i] >> METRICS_HISTOGRAM_SUB_BUCKET_BITS)))
+        {
+            zklog.error("MetricsTest() got an invalid bucket=" + to_string(bucket) + " lowestValue=" + to_string(lowestValue) + " for value=" + to_string(values[i]));
+            numberOfErrors++;
+        }
+    }
+
+    // Registering the same metric twice must return the same id
+    MetricsTestThreadArgs args;
+    args.counter = metrics.registerCounter("zkprover_test_total", "test=\"metrics\"", "Metrics test counter");
+    args.histogram = metrics.registerHistogram("zkprover_test_us", "test=\"metrics\"", "Metrics test histogram");
+    if (metrics.registerCounter("zkprover_test_total", "test=\"metrics\"") != args.counter)
+    {
+        zklog.error("MetricsTest() got a different id when registering the same counter twice");
+        numberOfErrors++;
+    }
+    uint64_t initialCount = metrics.getCounter(args.counter);
+
+    // Record from several threads, and check the merged values
+    pthread_t threads[METRICS_TEST_THREADS];
+    for (uint64_t i=0; i<METRICS_TEST_THREADS; i++)
+    {
+        pthread_create(&threads[i], NULL, metricsTestThread, &args);
+    }
+    for (uint64_t i=0; i<METRICS_TEST_THREADS; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    uint64_t count = metrics.getCounter(args.counter) - initialCount;
+    if (count != METRICS_TEST_THREADS*METRICS_TEST_ITERATIONS)
+    {
+        zklog.error("MetricsTest() got counter=" + to_string(count) + " expected=" + to_string(METRICS_TEST_THREADS*METRICS_TEST_ITERATIONS));
+        numberOfErrors++;
+    }
+    vector<uint64_t> buckets;
+    uint64_t histogramCount, sum, max;
+    metrics.getHistogram(args.histogram, buckets, histogramCount, sum, max);
+    if ((histogramCount != METRICS_TEST_THREADS*METRICS_TEST_ITERATIONS) ||
+        (sum != METRICS_TEST_THREADS*(METRICS_TEST_ITERATIONS*(METRICS_TEST_ITERATIONS + 1)/2)) ||
+        (max != METRICS_TEST_ITERATIONS))
+    {
+        zklog.error("MetricsTest() got histogram count=" + to_string(histogramCount) + " sum=" + to_string(sum) + " max=" + to_string(max));
+        numberOfErrors++;
+    }
+    double quantiles[] = {0.5, 0.9, 0.99};
+    for (uint64_t i=0; i<sizeof(quantiles)/sizeof(quantiles[0]); i++)
+    {
+        uint64_t expected = quantiles[i]*METRICS_TEST_ITERATIONS;
+        uint64_t quantile = Metrics::getQuantile(buckets, histogramCount, max, quantiles[i]);
+        if ((quantile < expected) || ((quantile - expected) > (expected >> (METRICS_HISTOGRAM_SUB_BUCKET_BITS - 1))))
+        {
+            zklog.error("MetricsTest() got quantile=" + to_string(quantiles[i]) + " value=" + to_string(quantile) + " expected=" + to_string(expected));
+            numberOfErrors++;
+        }
+    }
+
+    // The shards of the finished threads must be reused, keeping their values
+    pthread_t thread;
+    pthread_create(&thread, NULL, metricsTestThread, &args);
+    pthread_join(thread, NULL);
+    count = metrics.getCounter(args.counter) - initialCount;
+    if (count != (METRICS_TEST_THREADS + 1)*METRICS_TEST_ITERATIONS)
+    {
+        zklog.error("MetricsTest() got counter=" + to_string(count) + " after reusing a shard");
+        numberOfErrors++;
+    }
+
+    // Check the Prometheus export
+    string output;
+    metrics.scrape(output);
+    string expectedLines[] = {
+        "# TYPE zkprover_test_total counter\n",
+        "zkprover_test_total{test=\"metrics\"} " + to_string(initialCount + count) + "\n",
+        "# TYPE zkprover_test_us summary\n",
+        "zkprover_test_us{test=\"metrics\",quantile=\"1\"} " + to_string(METRICS_TEST_ITERATIONS) + "\n",
+        "zkprover_test_us_count{test=\"metrics\"} " + to_string((METRICS_TEST_THREADS + 1)*METRICS_TEST_ITERATIONS) + "\n"
+    };
+    for (uint64_t i=0; i<sizeof(expectedLines)/sizeof(expectedLines[0]); i++)
+    {
+        if (output.find(expectedLines[i]) == string::npos)
+        {
+            zklog.error("MetricsTest() could not find in the scrape output the line=" + expectedLines[i]);
+            numberOfErrors++;
+        }
+    }
+
+    zklog.info("MetricsTest() done with errors=" + to_string(numberOfErrors));
+
+    return numberOfErrors;
+}
@@ -0,0 +1,10 @@
+#ifndef METRICS_TEST_HPP
+#define METRICS_TEST_HPP
+
+#include <stdint.h>
+
+// Checks the histogram buckets, the merge of the values recorded by several threads, the quantiles, and the
+// Prometheus export of the metrics registry; returns the number of errors
+uint64_t MetricsTest (void);
+
+#endif